@@ -0,0 +1,403 @@
+#pragma once
+// =================================================
+// 全局配置：引脚、采样参数、运行模式
+// 所有开关都用 #ifndef 包住，可以在 platformio.ini 的 build_flags 里覆盖
+// =================================================
+
+// -------- PDM 麦克风（I2S RX）--------
+#define I2S_MIC_PORT     I2S_NUM_0
+#define PDM_CLK_PIN      5
+#define PDM_DATA_PIN     4
+
+// -------- I2S DAC（PCM5102）--------
+#define I2S_SPK_PORT     I2S_NUM_1
+#define PIN_I2S_BCK      17
+#define PIN_I2S_WS       18
+#define PIN_I2S_DOUT     8
+
+// -------- 麦克风抽取 --------
+// PDM_DECIM_HW = S3 I2S 硬件 PDM→PCM（滤波器固定）
+// PDM_DECIM_SW = I2S 标准模式收原始位流（BCLK 当 PDM 时钟），软件 CIC + FIR 抽取
+//                （lib/audio_dsp/pdm_decimator.h），OSR 和通带可调；目前只支持 AUDIO_IO_LEGACY
+#define PDM_DECIM_HW     0
+#define PDM_DECIM_SW     1
+
+#ifndef PDM_DECIMATION
+#define PDM_DECIMATION   PDM_DECIM_HW
+#endif
+#ifndef PDM_OSR
+#define PDM_OSR          64      // 位时钟 = SAMPLE_RATE × PDM_OSR（64 → 2.82 MHz），16 的倍数，32 ~ 128
+#endif
+#ifndef PDM_PASSBAND
+#define PDM_PASSBAND     0.45f   // 通带边缘 / SAMPLE_RATE
+#endif
+// 仅 PDM_DECIM_SW：位流按 32 位立体声收，DMA 缓冲里左右两个槽的先后和线上不一定一致
+// （legacy 驱动 32 位立体声在部分芯片上左右是反的），反了每 64 位的两半互换，高频量化噪声被调制进通带，
+// OSR 64 时 SNR 从 70 dB 掉到 25 dB 左右（tools/pdm_bench 的“字序”一项）。上板对着 1 kHz 音调看底噪，明显发毛就改成 1
+#ifndef PDM_SW_SLOT_SWAP
+#define PDM_SW_SLOT_SWAP 0       // 1 = 抽取前每对 32 位字先交换
+#endif
+
+// =================================================
+#define SAMPLE_RATE      44100
+#define BUFFER_SAMPLES   8
+#define MIC_GAIN         3.0f   // AGC_ENABLE=0 时的固定增益，定点化为 Q4.12，必须 < 16
+
+// =================================================
+// 前置滤波（i2s_read 之后、增益之前），对应 audio_filter.py 的 SimpleAudioProcessor
+// 4 阶 Butterworth，系数在编译期设计（lib/audio_dsp/biquad_design.h）
+// =================================================
+#define FILTER_NONE      0
+#define FILTER_BANDPASS  1
+#define FILTER_LOWPASS   2
+#define FILTER_HIGHPASS  3
+
+#ifndef FILTER_TYPE
+#define FILTER_TYPE      FILTER_NONE
+#endif
+#ifndef FILTER_FREQ_LOW
+#define FILTER_FREQ_LOW  100.0    // 低切（Hz）
+#endif
+#ifndef FILTER_FREQ_HIGH
+#define FILTER_FREQ_HIGH 3000.0   // 高切（Hz）
+#endif
+
+// 0 = float DF2T，1 = Q4.28 定点 DF2T
+#ifndef FILTER_FIXED_POINT
+#define FILTER_FIXED_POINT 1
+#endif
+
+// 啸叫抑制（前置滤波之后、增益之前）：Goertzel 组检测持续窄带峰，自动部署陷波
+// 参数见 lib/audio_dsp/howl_suppressor.h
+#ifndef HOWL_ENABLE
+#define HOWL_ENABLE 0
+#endif
+
+// 爆音保护（i2s 读回来之后、所有处理和上行之前）：启动静音、跳变 / 饱和检测，在出问题的那一块里静音再淡入
+// 替代主机端“持续大音量就断开重连”的做法；参数见 lib/audio_dsp/pop_guard.h
+#ifndef POP_GUARD_ENABLE
+#define POP_GUARD_ENABLE 1
+#endif
+
+// 自动增益（啸叫抑制之后、交织之前），替代固定的 MIC_GAIN：调平到 AGC_TARGET_DB、跟踪噪底不放大噪声、
+// 前视限幅 + 软削波。全定点；前视让输出多延迟 AGC_LOOKAHEAD 个样本（默认 48，约 1.09 ms）
+// 参数见 lib/audio_dsp/agc.h
+#ifndef AGC_ENABLE
+#define AGC_ENABLE 1
+#endif
+
+// 运行时调参（lib/audio_dsp/runtime_chain.h）：前置滤波、输出增益 / 限幅、AGC 目标电平不用重新烧录，
+// 控制任务调 pipeline_set_*()，音频任务下一块开头无锁切换（滤波交叉淡化、增益斜坡，RT_RAMP_MS）。
+// 上面的 FILTER_* / MIC_GAIN / AGC_TARGET_DB 只是上电时的初值；
+// 打开时前置滤波固定用 Q4.28 定点（FILTER_FIXED_POINT 不起作用），0 = 全部编译期常量（原来的做法）
+#ifndef DSP_HOTSWAP_ENABLE
+#define DSP_HOTSWAP_ENABLE 1
+#endif
+#define DSP_PARAM_WAIT_MS  50     // 上一次修改还在淡化时，pipeline_set_*() 最多等这么久
+
+// 回环延迟实测：扬声器播一段扫频，麦克风采回后互相关找峰（lib/audio_dsp/latency_probe.h）
+// 测量期间输出被扫频 / 静音替换；扬声器要对着麦克风，环境尽量安静
+#ifndef LATENCY_CAL_ENABLE
+#define LATENCY_CAL_ENABLE 0
+#endif
+#define LATENCY_CAL_CHIRP      4096   // 扫频长度（样本，约 93 ms）
+#define LATENCY_CAL_MAX_DELAY  4096   // 可测最大延迟（样本，约 93 ms）
+#define LATENCY_CAL_BOOT_MS    1000   // 上电后多久测第一次（等 DMA / 麦克风稳定）
+#ifndef LATENCY_CAL_PERIOD_MS
+#define LATENCY_CAL_PERIOD_MS  0      // 之后的重测周期，0 = 只测一次
+#endif
+#define LATENCY_CAL_PRIO       1      // 互相关在这个任务里跑（IO 核），不占音频路径
+#define LATENCY_CAL_STACK      4096
+
+// PCM5102 经验内部延迟（ms）
+#define DAC_LATENCY_MS  0.8f
+
+// 日志周期
+#define LOG_INTERVAL_MS 1000
+
+// 遥测：音频任务用 CCOUNT 给 RX 等待 / DSP / TX 等待计时，写进无锁直方图；
+// 低优先级任务每周期取 p50/p99/max，UPLINK_FRAMED / UPLINK_SPECTRUM 下发二进制遥测帧
+// （tools/frame_dump 打印），其他模式打一行文本
+#define TELEMETRY_PERIOD_MS LOG_INTERVAL_MS
+#define TELEMETRY_PRIO      1
+#define TELEMETRY_STACK     4096
+
+// =================================================
+// 串口上行：把采集到的麦克风数据（增益前）发给 PC
+// UPLINK_OFF    = 不发，串口只输出日志
+// UPLINK_RAW    = 裸 int16 小端流（旧 python 脚本要自己找字节对齐）
+// UPLINK_FRAMED = lib/audio_proto/audio_frame.h 帧格式（magic/seq/时间戳/CRC）
+// UPLINK_SPECTRUM = 同样的帧格式，但不发音频，只发固件算好的对数频带电平
+//                   （FRAME_TYPE_SPECTRUM，show_voice.py 画图用），数据量约为音频的 1/70
+// =================================================
+#define UPLINK_OFF      0
+#define UPLINK_RAW      1
+#define UPLINK_FRAMED   2
+#define UPLINK_SPECTRUM 3
+
+#ifndef UPLINK_MODE
+#define UPLINK_MODE UPLINK_FRAMED
+#endif
+
+// 串口上是二进制帧流（文本日志会被解码端当垃圾字节跳过，遥测也走帧）
+#define UPLINK_BINARY (UPLINK_MODE == UPLINK_FRAMED || UPLINK_MODE == UPLINK_SPECTRUM)
+
+// 链路后端（lib/link/link.h）：上行帧、遥测、命令应答走哪个口
+// LINK_UART    = UART0，经板上 USB 转串口桥，SERIAL_BAUD（1.5 Mbaud 约 150 KB/s），日志和帧混在一起
+// LINK_USB_CDC = S3 原生 USB OTG 口上的 CDC-ACM（TinyUSB），主机上是 /dev/ttyACM* / cu.usbmodem*，
+//                主机工具照常当串口打开（波特率被忽略）；日志留在 UART0，帧流里不再夹文本。
+//                需要 -DARDUINO_USB_MODE=0（env:esp32-s3-usb）。S3 的 USB 只有全速（12 Mbit/s），
+//                CDC 实际约 1 MB/s，也省掉了转接芯片的缓冲延迟
+// USB Audio Class（主机直接看到录音设备）需要 TinyUSB 的音频类，Arduino core 预编译的 TinyUSB 没有带，这里不支持
+#define LINK_UART     0
+#define LINK_USB_CDC  1
+
+#ifndef LINK_TRANSPORT
+#define LINK_TRANSPORT LINK_UART
+#endif
+
+// 开启上行时串口波特率与 listen_realtime.py / to_voice.py 的 BAUD_RATE 一致；走 USB 时 UART0 只打日志
+#if UPLINK_MODE != UPLINK_OFF && LINK_TRANSPORT == LINK_UART
+#define SERIAL_BAUD 1500000
+#else
+#define SERIAL_BAUD 115200
+#endif
+#define SERIAL_TX_BUFFER  4096
+#define SERIAL_RX_BUFFER  1024   // 命令帧最长 COMMAND_RECORD_MAX_SIZE + 18 字节（USB CDC 的接收缓冲也用它）
+
+// 上行流采样率。PC 端脚本（listen_realtime.py / to_voice.py / show_voice.py）都按 48000 写，
+// 和 SAMPLE_RATE 不同时上行任务里做多相重采样（lib/audio_dsp/resampler.h，44100→48000 为 147:160 定比），
+// I2S 时钟和上行流速率互不牵连；设成 SAMPLE_RATE 则原样发送
+#ifndef UPLINK_SAMPLE_RATE
+#define UPLINK_SAMPLE_RATE 48000
+#endif
+
+// 帧内样本格式（仅 UPLINK_FRAMED）：SAMPLE_FMT_PCM16 / SAMPLE_FMT_ADPCM / SAMPLE_FMT_ULAW
+// 48 kHz 单声道：PCM16 768 kbit/s，µ-law 384 kbit/s，ADPCM 192 kbit/s
+#ifndef UPLINK_CODEC
+#define UPLINK_CODEC SAMPLE_FMT_PCM16
+#endif
+
+#define UPLINK_FRAME_SAMPLES  256   // 每帧样本数（48 kHz 约 5.3 ms）
+#define UPLINK_QUEUE_DEPTH    64    // DSP → 上行任务的块队列（2 的幂）
+#define UPLINK_PRIO           2     // 低于音频任务
+#define UPLINK_STACK          4096
+
+// =================================================
+// 命令通道（include/control.h）：主机经同一条链路（LINK_TRANSPORT）发 FRAME_TYPE_COMMAND 帧
+// （lib/audio_proto/command_record.h），读写运行时参数、开停音频上行、查统计、触发回环测量 / 事件捕获，
+// 主机端是 tools/audio_ctl。命令任务优先级高于上行和遥测，收到就处理、马上回应答帧。
+// 发送缓冲先进先出，插不了队，所以音频 / 频谱 / 遥测 / 捕获帧写之前先等积压降到链路的水位以下
+// （UART 是 CONTROL_BULK_WATERMARK）：应答最多排在这么多字节加一帧后面（1.5 Mbaud 下约 7 ms），
+// 而不是整个发送环（SERIAL_TX_BUFFER，约 27 ms）
+// 只在二进制帧模式（UPLINK_FRAMED / UPLINK_SPECTRUM）下启用，UPLINK_RAW / UPLINK_OFF 时忽略
+// =================================================
+#ifndef CONTROL_ENABLE
+#define CONTROL_ENABLE 1
+#endif
+#define CONTROL_ACTIVE         (CONTROL_ENABLE && UPLINK_BINARY)
+#define CONTROL_BULK_WATERMARK 512    // UART 链路，字节；至少要比一个 tick 里发得完的多（1.5 Mbaud 约 150 B/ms），否则链路会空转
+#define CONTROL_POLL_MS        2      // 命令任务查接收的周期
+#define CONTROL_PRIO           3      // 高于上行（2）和遥测（1），低于音频任务
+#define CONTROL_STACK          4096
+
+// 频谱帧（仅 UPLINK_SPECTRUM）：上行任务对采集数据（增益前）做 Hann 窗实数 FFT，
+// 50% 重叠，功率按对数频带平均，每 SPECTRUM_PERIOD_MS 发一帧（lib/audio_proto/spectrum_record.h）
+// 默认 64 带 × 20 帧/s ≈ 1.6 kB/s，44.1 kHz PCM16 上行是 88 kB/s
+#define SPECTRUM_FFT_SIZE   1024    // 2 的幂，≤ FFT_MAX_SIZE（频点间隔 43 Hz）
+#define SPECTRUM_HOP        512     // FFT 步进
+#define SPECTRUM_BANDS      64
+#define SPECTRUM_F_LO       50      // Hz
+#define SPECTRUM_F_HI       16000   // Hz
+#define SPECTRUM_PERIOD_MS  50
+
+// =================================================
+// 语音门控（lib/audio_dsp/vad.h）：只在有人说话时编码、发送和录音
+// 上行任务对采集数据（增益前）做 VAD；门打开时从 VAD_PREROLL_MS 之前开始补发，
+// 最后一个语音帧之后再发 VAD_HANGOVER_MS 才关。只管音频帧，频谱帧和遥测照常发。
+// 占空比（打开帧 / 总帧）在日志里打印，权重可以用 tools/vad_runner --train 按实际环境重新拟合
+// =================================================
+#ifndef VAD_ENABLE
+#define VAD_ENABLE 0
+#endif
+#define VAD_FRAME          512     // 判决帧长（2 的幂，≤ FFT_MAX_SIZE，约 11.6 ms）
+#define VAD_ONSET_FRAMES   2       // 连续几个语音帧才打开
+#ifndef VAD_HANGOVER_MS
+#define VAD_HANGOVER_MS    300
+#endif
+#ifndef VAD_PREROLL_MS
+#define VAD_PREROLL_MS     200
+#endif
+#define VAD_PREROLL_RING   16384   // 预录环（样本，2 的幂，≥ 预录 + 一块）
+#ifndef VAD_WEIGHTS
+#define VAD_WEIGHTS        kVadDefaultWeights   // 或 -DVAD_WEIGHTS='{bias, snr, flatness, zcr}'
+#endif
+
+// =================================================
+// 事件捕获（lib/capture/pretrigger_buffer.h）：PSRAM 里常驻最近 CAPTURE_PRE_MS 的采集数据，
+// 触发时连同之后 CAPTURE_POST_MS 一起作为一次捕获，拆成 FRAME_TYPE_CAPTURE 帧发串口 / 写录音
+// 环在上行任务里写和读，音频任务和触发方都不等待；读出限速为实时的 CAPTURE_DRAIN_PERCENT%，
+// 串口 1.5 Mbaud 约 150 KB/s，44.1 kHz PCM16 实时 88 KB/s，所以不要和 UPLINK_FRAMED 同时满速用
+// 需要带 PSRAM 的板子（env:esp32-s3-capture）
+// =================================================
+#ifndef CAPTURE_ENABLE
+#define CAPTURE_ENABLE 0
+#endif
+#ifndef CAPTURE_PRE_MS
+#define CAPTURE_PRE_MS        5000
+#endif
+#ifndef CAPTURE_POST_MS
+#define CAPTURE_POST_MS       2000
+#endif
+#define CAPTURE_CHUNK_SAMPLES 512     // 每帧样本数
+#define CAPTURE_DRAIN_PERCENT 150     // 读出速度（实时的百分比，必须 > 100）
+#ifndef CAPTURE_LEVEL_DBFS
+#define CAPTURE_LEVEL_DBFS    -6      // 峰值触发门限（增益前），回落到门限以下才重新待触发
+#endif
+#define CAPTURE_LEVEL_TRIGGER 1
+#define CAPTURE_VAD_TRIGGER   1       // VAD_ENABLE 时语音门控打开也触发
+
+// =================================================
+// 屏幕（TFT_eSPI）：RMS / 峰值电平表 + 滚动语谱图
+// 屏幕型号和引脚按 TFT_eSPI 的方式写在 platformio.ini 的 build_flags 里（见 env:esp32-s3-tft）
+// UI 任务在 UI_CORE 上以最低优先级运行，音频任务只往样本快照环里拷一块，
+// 推荐配 PIPELINE_DIRECT：音频全在 DSP 核，SPI DMA 和绘制都在另一个核
+// =================================================
+#ifndef UI_ENABLE
+#define UI_ENABLE 0
+#endif
+#define UI_FRAME_MS            33     // 电平表刷新周期（约 30 fps）
+#define UI_SPEC_COLUMN_FRAMES  3      // 每几帧给语谱图加一列（每列都要重推整个语谱图区域）
+#define UI_FFT_SIZE            512
+#define UI_SPEC_BANDS          48     // 语谱图频带数（SPECTRUM_F_LO ~ SPECTRUM_F_HI 对数等分）
+#define UI_RING_SAMPLES        4096   // 样本快照环（2 的幂，约 93 ms）
+#define UI_ROTATION            1      // 横屏
+#define UI_PRIO                1
+#define UI_STACK               4096
+#ifndef UI_CORE
+#define UI_CORE                PIPELINE_IO_CORE
+#endif
+
+// 每个 I2S 端口的 DMA 缓冲个数（每个 BUFFER_SAMPLES 帧）
+#define I2S_DMA_BUF_COUNT 4
+
+// =================================================
+// I2S 后端
+// AUDIO_IO_LEGACY  = 旧 driver/i2s.h，i2s_read / i2s_write 经驱动内部拷贝
+// AUDIO_IO_CHANNEL = IDF5 i2s channel API，DSP 直接读写 DMA 缓冲（需 Arduino core 3.x）
+// =================================================
+#define AUDIO_IO_LEGACY  0
+#define AUDIO_IO_CHANNEL 1
+
+#ifndef AUDIO_IO_BACKEND
+#define AUDIO_IO_BACKEND AUDIO_IO_LEGACY
+#endif
+
+// =================================================
+// 本地录音（掉电可恢复）+ 定期上传
+// 上行任务编好的帧按 4 KB 段写进原始 flash 分区（lib/flash_log），
+// 段头带序号和 CRC，上电扫描恢复；上传任务按周期连 WiFi，
+// 把未上传的段逐个发给 TCP 服务器（tools/upload_sink.py），收到确认后才标记
+// 已知问题：每写满一段就擦一个 4 KB 扇区，擦除期间 flash cache 关闭，两个核上不在 IRAM 的代码
+// 全部停住约 20~40 ms。音频任务和 I2S 回调都不在 IRAM，而 DMA 环默认只有 4 × 8 帧（0.7 ms），
+// 自适应缓冲的最高档 128 × 8 帧（23 ms）也盖不住，所以每次擦除都会丢一段采集、播一段静音 / 旧数据，
+// 计入 xrun 计数（RX overrun / TX underrun）；16 kHz ADPCM 下约每秒 2.3 次，录音期间输出会周期性咔哒。
+// 要消除得让 DMA 环盖住一次擦除（44.1 kHz 下约 1800 帧，延迟也多这么多），esp32-s3-recorder 没有这样配
+// =================================================
+#ifndef RECORDER_ENABLE
+#define RECORDER_ENABLE 0
+#endif
+
+// 录音分区是 partitions_recorder.csv 里的 reclog（8 MB flash：app 2 MB，其余 5.9 MB 全给录音），
+// 用 pio run -e esp32-s3-recorder 烧；上电发现分区比 RECORDER_PARTITION_BYTES 小就不启动录音。
+// 默认分区表的 spiffs 只有 1.5 MB，48 kHz PCM16 下只装得下 14 s
+#define RECORDER_PARTITION        "reclog"
+#define RECORDER_PARTITION_BYTES  0x5F0000
+// 编译期检查（src/recorder.cpp）：分区要装得下 编码后字节率 × 门控占空比 × UPLOAD_PERIOD_MS
+//   48 kHz PCM16：一帧 530 B，约 99 KB/s，一段 7 帧 37 ms，每秒擦 27 个扇区，5.9 MB 只录 57 s
+//   16 kHz ADPCM：一帧 150 B，约 9.4 KB/s，一段 27 帧 432 ms，每秒擦 2.3 个扇区（cache 停顿占 5~9%），
+//                 1519 段连续录 11 分钟，VAD 占空比 15% 时约 73 分钟
+// RECORDER_DUTY_PERCENT 是对 VAD 占空比的估计（日志里打印实测值），实际超出时最老的未上传段被覆盖（overwritten）
+#ifndef RECORDER_DUTY_PERCENT
+#define RECORDER_DUTY_PERCENT     (VAD_ENABLE ? 15 : 100)
+#endif
+#define RECORDER_PRIO        1
+#define RECORDER_STACK       4096
+
+#ifndef UPLOAD_PERIOD_MS
+#define UPLOAD_PERIOD_MS     (60UL * 60 * 1000)   // 一小时
+#endif
+#ifndef WIFI_SSID
+#define WIFI_SSID            ""
+#endif
+#ifndef WIFI_PASS
+#define WIFI_PASS            ""
+#endif
+#ifndef UPLOAD_HOST
+#define UPLOAD_HOST          "192.168.1.100"
+#endif
+#ifndef UPLOAD_PORT
+#define UPLOAD_PORT          9000
+#endif
+#define UPLOAD_STACK         6144
+
+// =================================================
+// 运行模式
+// PIPELINE_LOOP   = loop() 里串行 采集 → 处理 → 播放（原始实现）
+// PIPELINE_TASKS  = RX / DSP / TX 三个任务分核运行，中间用 SPSC 无锁队列连接
+// PIPELINE_DIRECT = 单个 DSP 任务直接在后端借出的缓冲上处理；
+//                   配合 AUDIO_IO_CHANNEL 时 RX/TX 由 DMA 中断驱动，全程零拷贝
+// =================================================
+#define PIPELINE_LOOP    0
+#define PIPELINE_TASKS   1
+#define PIPELINE_DIRECT  2
+
+#ifndef AUDIO_PIPELINE_MODE
+#define AUDIO_PIPELINE_MODE PIPELINE_TASKS
+#endif
+
+// 流水线队列深度（块数，必须是 2 的幂）
+#ifndef PIPELINE_QUEUE_DEPTH
+#define PIPELINE_QUEUE_DEPTH 8
+#endif
+
+// 核心分配：Arduino 的 loop() 跑在 core 1
+// RX/TX 两个 I/O 任务放 core 0，DSP 独占 core 1（loop 只做低优先级日志）
+#ifndef PIPELINE_IO_CORE
+#define PIPELINE_IO_CORE   0
+#endif
+#ifndef PIPELINE_DSP_CORE
+#define PIPELINE_DSP_CORE  1
+#endif
+
+#define PIPELINE_RX_PRIO   (configMAX_PRIORITIES - 2)
+#define PIPELINE_TX_PRIO   (configMAX_PRIORITIES - 2)
+#define PIPELINE_DSP_PRIO  (configMAX_PRIORITIES - 3)
+#define PIPELINE_STACK     4096
+
+// =================================================
+// 自适应缓冲：遥测任务每个窗口看 xrun 数和 DSP 负载（p99 耗时 / 块周期），
+// 在 BUFFER_LEVELS 各档之间升降块大小和 DMA 深度（带迟滞和冷却）；
+// 切换时输出先淡出，重建 I2S，再淡入，避免爆音
+// 只支持 PIPELINE_LOOP / PIPELINE_DIRECT（I/O 只由一个任务持有，重建时没人阻塞在驱动里）
+// =================================================
+#ifndef ADAPTIVE_BUFFER_ENABLE
+#define ADAPTIVE_BUFFER_ENABLE 0
+#endif
+
+// 档位 {块帧数, DMA 缓冲个数}，延迟从低到高，第 0 档就是上面的固定配置
+#define BUFFER_LEVELS { {BUFFER_SAMPLES, I2S_DMA_BUF_COUNT}, {16, 4}, {32, 4}, {64, 6}, {128, 8} }
+
+// 静态数组按最大块分配
+#if ADAPTIVE_BUFFER_ENABLE
+#define BUFFER_SAMPLES_MAX 128
+#else
+#define BUFFER_SAMPLES_MAX BUFFER_SAMPLES
+#endif
+
+#define BUFFER_GROW_XRUNS        1       // 窗口内 xrun 数 ≥ 它就升档
+#define BUFFER_GROW_LOAD         0.70f   // DSP 负载超过它就升档
+#define BUFFER_SHRINK_LOAD       0.30f   // 负载低于它、且连续干净才降档
+#define BUFFER_SHRINK_WINDOWS    30      // 降档需要的连续干净窗口数
+#define BUFFER_COOLDOWN_WINDOWS  3       // 切换后这么多个窗口不做判断
+#define BUFFER_FADE_MS           5       // 切换时淡出 / 淡入时长
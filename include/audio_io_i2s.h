@@ -0,0 +1,6 @@
+#pragma once
+#include <audio_io.h>
+#include "audio_config.h"
+
+// 按 AUDIO_IO_BACKEND 创建 I2S 后端（单例，未调用 begin）
+AudioIo* audio_io_create();
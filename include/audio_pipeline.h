@@ -0,0 +1,94 @@
+#pragma once
+#include <Arduino.h>
+#include <audio_io.h>
+#include <latency_probe.h>
+#include <runtime_chain.h>
+#include "audio_config.h"
+
+// =================================================
+// RX / DSP / TX 三任务流水线
+//
+//   rx_task (core 0) --[mic_q]--> dsp_task (core 1) --[spk_q]--> tx_task (core 0)
+//
+// 队列是 SPSC 无锁队列，任务之间只用任务通知唤醒，不加锁
+//
+// PIPELINE_DIRECT 模式下只有 dsp_task：
+//   io->acquire_rx → dsp_process_block → io->acquire_tx 的缓冲，中间不经过队列
+// =================================================
+
+// 麦克风块：单声道
+struct MicBlock {
+  uint32_t seq;          // 采集序号
+  uint32_t t_capture;    // i2s_read 返回时刻（micros）
+  uint16_t samples;
+  int16_t  data[BUFFER_SAMPLES_MAX];
+};
+
+// 扬声器块：左右声道交织
+struct SpkBlock {
+  uint32_t seq;
+  uint32_t t_capture;
+  uint16_t samples;      // 每声道样本数
+  alignas(4) int16_t data[BUFFER_SAMPLES_MAX * 2];   // gain_interleave 按 32 位写
+};
+
+// 运行统计：计数器只由对应任务写；max 字段由 loop() 每个日志周期清零
+// 各级耗时分布见 telemetry.h
+// （与任务写入偶尔交错，最多丢一次峰值，不影响音频路径）
+struct PipelineStats {
+  volatile uint32_t rx_blocks;
+  volatile uint32_t rx_dropped;     // mic_q 满，丢掉的采集块
+  volatile uint32_t dsp_blocks;
+  volatile uint32_t dsp_dropped;    // spk_q 满，丢掉的处理结果
+  volatile uint32_t tx_blocks;
+  volatile uint32_t latency_max_us; // 采集到送入 TX 的最大排队延迟
+  uint32_t howl_notches;            // 当前生效的啸叫陷波数
+  uint32_t howl_deployed;           // 累计部署次数
+  uint32_t pop_events;              // 爆音保护触发次数
+  uint32_t pop_muted_samples;       // 爆音保护累计静音样本（含启动）
+  float    agc_gain_db;             // 当前总增益（含限幅；AGC_ENABLE=0 时是 MIC_GAIN 或运行时设的输出增益）
+  float    agc_level_db;            // AGC 看到的输入电平（dBFS）
+  float    agc_floor_db;            // 跟踪到的噪底（dBFS）
+  uint32_t agc_soft_clipped;        // 累计软削波样本数
+};
+
+// 单块 DSP：单声道输入 → 爆音保护 → 滤波/啸叫抑制 → AGC → 输出增益 / 限幅 → 立体声交织输出
+// loop() 模式和流水线模式共用；out 需 4 字节对齐
+// 返回爆音保护之后的单声道块（POP_GUARD_ENABLE=0 时就是 in），上行和 UI 用它，不用原始采集；
+// 指向内部缓冲，下一次调用前有效
+const int16_t* dsp_process_block(const int16_t* in, int16_t* out, int samples);
+
+// 按 AUDIO_PIPELINE_MODE 创建任务（io 需已 begin）
+bool pipeline_start(AudioIo* io);
+
+// 读取统计快照（只读，不清任何字段；控制命令和 loop() 都会调）
+void pipeline_get_stats(PipelineStats* out);
+
+// 清零 latency_max_us：只由 loop() 每个日志周期调一次
+void pipeline_reset_latency_max();
+
+// 运行时调参（DSP_HOTSWAP_ENABLE）：只从一个控制任务调用（命令任务，见 control.h），音频任务下一块开头切换；
+// 不能在跑音频的任务里调（PIPELINE_LOOP 下就是 loop()），那样等待期间淡化不会推进
+// 上一次修改还在淡化时最多等 DSP_PARAM_WAIT_MS，超时或参数不合法返回 false
+//   filter   type 取 FILTER_*，4 阶 Butterworth，不用的频率随便填
+//   gain     输出增益（AGC 之后；AGC_ENABLE=0 时就是原来的 MIC_GAIN），< 16
+//   ceiling  输出限幅 dBFS，≥ 0 不限
+//   agc      AGC 目标电平 / 最大增益（dB），按 AGC_LEVEL_SLEW_DB 每秒挪过去
+//   params   一次换一整套（比如直接下发 biquad 系数，见 dsp_params_set_sos）
+bool pipeline_set_filter(int type, float lo_hz, float hi_hz);
+bool pipeline_set_gain(float gain);
+bool pipeline_set_ceiling(float ceiling_dbfs);
+bool pipeline_set_agc(float target_db, float max_gain_db);
+bool pipeline_set_params(const DspParams& p);
+void pipeline_get_params(DspParams* out);   // 最近一次发布成功的
+
+// 回环延迟测量（LATENCY_CAL_ENABLE）：arm 后下一块开始播扫频；
+// 录满后 poll 在调用方任务里做互相关，返回 true 表示 out 有新结果
+bool pipeline_arm_latency_probe();
+bool pipeline_poll_latency(LatencyResult* out);
+
+// 自适应缓冲（ADAPTIVE_BUFFER_ENABLE）
+// 遥测任务每个窗口调用：xruns = 本窗口新增 xrun，dsp_p99_ns = 本窗口 DSP p99
+void pipeline_tune_buffers(uint32_t xruns, uint32_t dsp_p99_ns);
+// 持有 io 的音频任务每块开头调用：档位要变时先淡出，静音后重建 io，再淡入
+void pipeline_service_reconfig(AudioIo* io);
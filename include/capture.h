@@ -0,0 +1,32 @@
+#pragma once
+#include <Arduino.h>
+#include "audio_config.h"
+#include <pretrigger_buffer.h>
+
+// =================================================
+// 事件捕获：PSRAM 触发前环形缓冲
+// 上行任务每块调 capture_feed() 写环、处理触发；再用 capture_read() 取出要发的块。
+// 任何任务（包括音频任务）都可以调 capture_trigger()：只是原子地挂一个请求，
+// 上行任务处理下一块时在那个位置定下触发点
+// =================================================
+
+struct CaptureStats {
+  uint32_t jobs;       // 开始的捕获次数
+  uint32_t busy;       // 上一次还没发完而被忽略的触发
+  uint32_t chunks;     // 已读出的块
+  uint32_t lost;       // 读得太慢被覆盖的样本
+};
+
+// 在 PSRAM 分配环（CAPTURE_ENABLE=0 时什么都不做）；分配失败返回 false
+bool capture_start();
+
+// 请求一次捕获，reason = CAPTURE_REASON_*。已有请求还没被处理时返回 false
+bool capture_trigger(uint8_t reason);
+
+// 上行任务：写入一块采集数据，处理电平触发和挂起的请求
+void capture_feed(const int16_t* mono, int samples, uint32_t t_capture);
+
+// 上行任务：按读出限速取下一块（最多 max 个样本），返回样本数，没有返回 0
+uint32_t capture_read(int16_t* out, uint32_t max, CaptureChunk* info);
+
+void capture_get_stats(CaptureStats* out);
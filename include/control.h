@@ -0,0 +1,27 @@
+#pragma once
+#include <Arduino.h>
+#include <audio_io.h>
+#include "audio_config.h"
+
+// =================================================
+// 命令通道（CONTROL_ENABLE），和上行帧共用一条链路（link_port()）
+// 命令任务每 CONTROL_POLL_MS 读一次链路接收，FrameDecoder 解出 FRAME_TYPE_COMMAND 帧，
+// 当场执行并写回 FRAME_TYPE_RESPONSE 帧；其他任务的大块数据都经 control_write_bulk() 写链路，
+// 让发送缓冲里的积压不超过链路的水位，应答不会排在几 KB 音频后面
+// 链路后端整段加锁写，两边的帧不会交错
+// =================================================
+
+struct ControlStats {
+  uint32_t commands;     // 收到的命令帧
+  uint32_t errors;       // 其中应答不是 CMD_OK 的
+  uint32_t bulk_waits;   // 大块数据为积压让路的次数
+};
+
+// 创建命令任务（CONTROL_ACTIVE=0 时什么都不做）；io 用来读当前块大小
+bool control_start(AudioIo* io);
+
+// 上行 / 遥测任务写帧用：积压超过水位时先等（vTaskDelay），再写链路
+// CONTROL_ACTIVE=0 时直接写
+void control_write_bulk(const uint8_t* data, size_t len);
+
+void control_get_stats(ControlStats* out);
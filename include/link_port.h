@@ -0,0 +1,7 @@
+#pragma once
+#include <link.h>
+#include "audio_config.h"
+
+// 按 LINK_TRANSPORT 取链路后端（单例，第一次调用时构造；setup() 里 begin 一次）
+// 上行 / 遥测 / 命令任务都经它收发帧，日志仍用 Serial
+Link* link_port();
@@ -0,0 +1,27 @@
+#pragma once
+#include <Arduino.h>
+#include "audio_config.h"
+
+// =================================================
+// 本地录音 + 批量上传
+// 上行任务调用 recorder_append() 把帧攒进 RAM 段（不碰 flash），
+// 段满后交给录音任务写 flash；上传任务按 UPLOAD_PERIOD_MS 清空待上传段
+// =================================================
+
+struct RecorderStats {
+  uint32_t segments;      // 写入 flash 的段
+  uint32_t pending;       // 待上传段
+  uint32_t uploaded;      // 本次上电后上传成功的段
+  uint32_t dropped;       // 录音任务来不及写而丢掉的帧
+  uint32_t overwritten;   // 未上传就被覆盖的段
+  uint32_t recovered;     // 上电时恢复出的有效段
+  uint32_t invalid;       // 上电时发现的损坏 / 掉电残段
+};
+
+// 挂载分区、恢复段日志、创建录音和上传任务
+bool recorder_start();
+
+// 在上行任务里调用：追加一个完整的帧
+void recorder_append(const uint8_t* frame, size_t len);
+
+void recorder_get_stats(RecorderStats* out);
@@ -0,0 +1,26 @@
+#pragma once
+#include <Arduino.h>
+#include <audio_io.h>
+#include <cycle_clock.h>
+#include <latency_hist.h>
+#include <telemetry_record.h>
+#include "audio_config.h"
+
+// =================================================
+// 遥测
+// 音频任务只调 telem_record()（几条指令，不打印、不加锁），
+// 每个 stage 只能由一个任务写；遥测任务按 TELEMETRY_PERIOD_MS 汇总发出
+// =================================================
+
+extern LatencyHistogram telem_hist[TELEM_STAGES];
+
+// stage 为 TELEM_STAGE_*，cycles 为 cycle_now() 之差
+static inline void telem_record(int stage, uint32_t cycles) {
+  telem_hist[stage].record(cycles);
+}
+
+// 创建遥测任务；io 用来读 DMA 溢出计数
+bool telemetry_start(AudioIo* io);
+
+// 回环实测延迟（latency_probe），随遥测一起发出
+void telemetry_set_loop_latency_us(int32_t us);
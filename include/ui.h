@@ -0,0 +1,24 @@
+#pragma once
+#include <Arduino.h>
+#include "audio_config.h"
+
+// =================================================
+// 屏幕：电平表 + 滚动语谱图（lib/ui/audio_ui.h）
+// 音频任务只调 ui_push()：往样本快照环里 memcpy 一块，不等待、不加锁；
+// UI 任务在 UI_CORE 上按 UI_FRAME_MS 自己取最近的样本算电平和频谱、DMA 推屏，
+// 画得慢了就跳过旧数据，绝不反压音频
+// =================================================
+
+struct UiStats {
+  uint32_t frames;    // 已渲染帧
+  uint32_t skipped;   // 落后太多跳过的样本段
+  uint32_t pixels;    // 最近一帧推送的像素
+};
+
+// 初始化屏幕并创建 UI 任务（UI_ENABLE=0 时什么都不做）
+bool ui_start();
+
+// 在音频任务里调用：提交一块单声道采集数据
+void ui_push(const int16_t* mono, int samples);
+
+void ui_get_stats(UiStats* out);
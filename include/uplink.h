@@ -0,0 +1,33 @@
+#pragma once
+#include <Arduino.h>
+#include "audio_config.h"
+
+// =================================================
+// 串口上行
+// DSP 侧只把块拷进 SPSC 队列（不阻塞），低优先级任务负责攒帧和写串口（control_write_bulk）
+// =================================================
+
+struct UplinkStats {
+  uint32_t frames;     // 已发送帧数
+  uint32_t dropped;    // 队列满丢掉的块数
+};
+
+// 语音门控（VAD_ENABLE）的占空统计
+struct VadStats {
+  uint32_t frames;          // VAD 判决过的帧数
+  uint32_t active_frames;   // 其中门控打开（在发 / 在录）的帧数
+  uint32_t segments;        // 打开过几次
+};
+
+// 创建上行任务（UPLINK_OFF 时什么都不做）
+bool uplink_start();
+
+// 在音频任务里调用：提交一块单声道采集数据
+void uplink_push(const int16_t* mono, int samples, uint32_t t_capture);
+
+// 音频 / 频谱帧写不写串口（命令通道的 CMD_STREAM_*），默认开；关掉时录音、事件捕获、遥测照常
+void uplink_set_streaming(bool on);
+bool uplink_streaming();
+
+void uplink_get_stats(UplinkStats* out);
+void uplink_get_vad_stats(VadStats* out);
@@ -0,0 +1,201 @@
+#include "agc.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include <esp_attr.h>
+#else
+#define IRAM_ATTR
+#endif
+
+// log2(1 + i/32)，Q16
+static const int32_t kLog2Tab[33] = {
+  0, 2909, 5732, 8473, 11136, 13727, 16248, 18704, 21098, 23433, 25711, 27936, 30109,
+  32234, 34312, 36346, 38336, 40286, 42196, 44068, 45904, 47705, 49472, 51207, 52911,
+  54584, 56229, 57845, 59434, 60997, 62534, 64047, 65536};
+
+// 2^(i/32)，Q30
+static const uint32_t kExp2Tab[33] = {
+  1073741824u, 1097253708u, 1121280436u, 1145833280u, 1170923762u, 1196563654u, 1222764986u,
+  1249540052u, 1276901417u, 1304861917u, 1333434672u, 1362633090u, 1392470869u, 1422962010u,
+  1454120821u, 1485961921u, 1518500250u, 1551751076u, 1585730000u, 1620452965u, 1655936265u,
+  1692196547u, 1729250827u, 1767116489u, 1805811301u, 1845353420u, 1885761398u, 1927054196u,
+  1969251188u, 2012372174u, 2056437387u, 2101467502u, 2147483648u};
+
+static const int32_t kGainOne = 1 << 20;   // Q20
+static const int32_t kDbFloor = -120 * 65536;
+
+// log2(x)，Q16；x > 0。表查 5 位、线性插值 16 位，误差 < 0.0003
+static int32_t log2_q16(uint64_t x) {
+  const int e = 63 - __builtin_clzll(x);
+  const uint32_t m = (uint32_t)((x << (63 - e)) >> 32);   // 最高位是前导 1
+  const uint32_t idx  = (m >> 26) & 31;
+  const uint32_t frac = (m >> 10) & 0xFFFF;
+  const int32_t a = kLog2Tab[idx], b = kLog2Tab[idx + 1];
+  return (e << 16) + a + (int32_t)(((int64_t)(b - a) * frac) >> 16);
+}
+
+// 10·log10 = 3.0103·log2
+static inline int32_t log2_to_db(int32_t l2) { return (int32_t)(((int64_t)l2 * 197283) >> 16); }
+
+// dB（Q16）→ 线性增益（Q20），适用于 -60 ~ +24 dB
+static int32_t db_to_gain(int32_t db) {
+  const int32_t l2 = (int32_t)(((int64_t)db * 10885) >> 16);   // dB / 6.0206
+  const int32_t i = l2 >> 16;                                  // 向下取整
+  const uint32_t f = (uint32_t)l2 & 0xFFFF;
+  const uint32_t idx = f >> 11, fr = f & 0x7FF;
+  const uint32_t a = kExp2Tab[idx], b = kExp2Tab[idx + 1];
+  const uint32_t v = a + (uint32_t)(((uint64_t)(b - a) * fr) >> 11);   // Q30，[1, 2)
+  const int sh = 10 - i;
+  if (sh >= 31) return 0;
+  return sh >= 0 ? (int32_t)(v >> sh) : (int32_t)(v << -sh);
+}
+
+static inline int32_t q16(float db) { return (int32_t)lrintf(db * 65536.0f); }
+
+static int32_t one_pole_k(float ms, float sample_rate) {
+  return (int32_t)lrintf((1.0f - expf(-AGC_CONTROL / (ms * 0.001f * sample_rate))) * 32768.0f);
+}
+
+Agc::Agc(float sample_rate) {
+  power_k_      = one_pole_k(AGC_POWER_MS, sample_rate);
+  attack_k_     = one_pole_k(AGC_ATTACK_MS, sample_rate);
+  release_k_    = one_pole_k(AGC_RELEASE_MS, sample_rate);
+  floor_down_k_ = one_pole_k(50.0f, sample_rate);
+  floor_rise_   = q16(AGC_FLOOR_RISE_DB * AGC_CONTROL / sample_rate);
+  hold_controls_ = (int32_t)(AGC_HOLD_MS * 0.001f * sample_rate / AGC_CONTROL);
+
+  target_db_   = q16(AGC_TARGET_DB);
+  max_gain_db_ = q16(AGC_MAX_GAIN_DB > 24.0f ? 24.0f : AGC_MAX_GAIN_DB);
+  min_gain_db_ = q16(AGC_MIN_GAIN_DB);
+  gate_db_     = q16(AGC_GATE_DB);
+  ceiling_db_  = q16(AGC_NOISE_CEILING_DB);
+  limit_db_    = q16(AGC_LIMIT_DB);
+  target_to_   = target_db_;
+  max_gain_to_ = max_gain_db_;
+  level_slew_  = q16(AGC_LEVEL_SLEW_DB * AGC_CONTROL / sample_rate);
+  reset();
+}
+
+void Agc::set_levels(float target_db, float max_gain_db) {
+  target_to_   = q16(target_db);
+  max_gain_to_ = q16(max_gain_db > 24.0f ? 24.0f : max_gain_db);
+}
+
+static inline int32_t slew(int32_t v, int32_t to, int32_t step) {
+  return to > v + step ? v + step : (to < v - step ? v - step : to);
+}
+
+void Agc::reset() {
+  memset(delay_, 0, sizeof(delay_));
+  dpos_   = 0;
+  count_  = 0;
+  sq_acc_ = 0;
+  power_  = 0;
+  env_db_     = target_db_;   // 从 0 dB 增益起步
+  hold_       = 0;
+  floor_db_   = kDbFloor;
+  have_floor_ = false;
+  lev_db_  = 0;
+  gain_db_ = 0;
+  g_ = g_target_ = kGainOne;
+  step_ = 0;
+  soft_clipped_ = 0;
+}
+
+void Agc::control() {
+  // ---------- 电平 ----------
+  const int64_t ms = (int64_t)((sq_acc_ << 8) / AGC_CONTROL);   // Q8
+  sq_acc_ = 0;
+  power_ = power_ == 0 ? ms : power_ + (((ms - power_) * power_k_) >> 15);
+  // 满量程方波的均方是 2^30，Q8 下 2^38
+  const int32_t level = power_ > 0 ? log2_to_db(log2_q16((uint64_t)power_) - (38 << 16)) : kDbFloor;
+
+  // 上升跟 attack；下降先保持 AGC_HOLD_MS（音节之间的停顿不让增益抽动），再按 release 回落
+  if (level > env_db_) {
+    env_db_ += (int32_t)(((int64_t)(level - env_db_) * attack_k_) >> 15);
+    hold_ = hold_controls_;
+  } else if (hold_ > 0) {
+    hold_--;
+  } else {
+    env_db_ += (int32_t)(((int64_t)(level - env_db_) * release_k_) >> 15);
+  }
+
+  // ---------- 噪底 ----------
+  if (!have_floor_) {
+    floor_db_   = level;
+    have_floor_ = true;
+  } else if (level < floor_db_) {
+    floor_db_ += (int32_t)(((int64_t)(level - floor_db_) * floor_down_k_) >> 15);
+  } else {
+    const int32_t up = level - floor_db_;
+    floor_db_ += up < floor_rise_ ? up : floor_rise_;
+  }
+
+  // ---------- 调平 ----------
+  target_db_   = slew(target_db_, target_to_, level_slew_);
+  max_gain_db_ = slew(max_gain_db_, max_gain_to_, level_slew_);
+  if (env_db_ > floor_db_ + gate_db_) {
+    int32_t want = target_db_ - env_db_;
+    if (want > max_gain_db_) want = max_gain_db_;
+    if (want > ceiling_db_ - floor_db_) want = ceiling_db_ - floor_db_;
+    if (want < min_gain_db_) want = min_gain_db_;
+    lev_db_ = want;
+  }
+
+  // ---------- 前视限幅：延迟线里的样本都还没输出 ----------
+  int32_t peak = 0;
+  for (int i = 0; i < AGC_LOOKAHEAD; i++) {
+    const int32_t a = delay_[i] < 0 ? -delay_[i] : delay_[i];
+    if (a > peak) peak = a;
+  }
+  int32_t total = lev_db_;
+  if (peak > 0) {
+    const int32_t peak_db = log2_to_db(log2_q16((uint64_t)peak * peak) - (30 << 16));
+    if (limit_db_ - peak_db < total) total = limit_db_ - peak_db;
+  }
+  gain_db_  = total;
+  g_target_ = db_to_gain(total);
+
+  // 降增益：AGC_LOOKAHEAD - AGC_CONTROL 个样本内到位（这期间新进来的样本最早也要再过这么久才输出），
+  //         上一段更陡的斜坡保留，保证它的期限；升增益：一个控制周期内过渡完
+  if (g_target_ < g_) {
+    int32_t s = (g_target_ - g_) / (AGC_LOOKAHEAD - AGC_CONTROL);
+    if (s == 0) s = -1;
+    step_ = step_ < s ? step_ : s;
+  } else {
+    step_ = (g_target_ - g_ + AGC_CONTROL - 1) / AGC_CONTROL;
+  }
+}
+
+void IRAM_ATTR Agc::process(const int16_t* in, int16_t* out, int n) {
+  static const int32_t kKnee  = (int32_t)(32768.0f * powf(10.0f, AGC_LIMIT_DB / 20.0f));
+  static const int32_t kRange = 32767 - kKnee;
+
+  for (int i = 0; i < n; i++) {
+    const int32_t x = in[i];
+    sq_acc_ += (uint32_t)(x * x);
+    const int32_t s = delay_[dpos_];
+    delay_[dpos_] = (int16_t)x;
+    if (++dpos_ == AGC_LOOKAHEAD) dpos_ = 0;
+
+    g_ += step_;
+    if ((step_ < 0 && g_ < g_target_) || (step_ > 0 && g_ > g_target_)) {
+      g_    = g_target_;
+      step_ = 0;
+    }
+    int32_t y = (s * (g_ >> 8)) >> 12;
+    if (y > kKnee || y < -kKnee) {
+      const int32_t o = (y < 0 ? -y : y) - kKnee;
+      const int32_t c = kKnee + (int32_t)((int64_t)kRange * o / (o + kRange));
+      y = y < 0 ? -c : c;
+      soft_clipped_++;
+    }
+    out[i] = (int16_t)y;
+
+    if (++count_ == AGC_CONTROL) {
+      count_ = 0;
+      control();
+    }
+  }
+}
@@ -0,0 +1,83 @@
+#pragma once
+// =================================================
+// 自动增益控制（AGC）+ 前视限幅 + 软削波，全定点
+// -------------------------------------------------
+// 每 AGC_CONTROL 个样本更新一次控制量，样本路径只有一次乘法、一次加法和一次比较：
+//   电平：输入功率一阶平滑（AGC_POWER_MS）后取 dB，上升按 AGC_ATTACK_MS 跟踪；
+//         下降先保持 AGC_HOLD_MS（盖住音节间的停顿），再按 AGC_RELEASE_MS 回落
+//   噪底：电平的最小值跟踪，低于噪底时快速跟下去，高于时每秒最多上升 AGC_FLOOR_RISE_DB
+//   调平：增益 = AGC_TARGET_DB - 电平，截到 [AGC_MIN_GAIN_DB, AGC_MAX_GAIN_DB]，
+//         并且不让噪底被放大到 AGC_NOISE_CEILING_DB 以上；电平离噪底不到 AGC_GATE_DB 时保持增益（不去追噪声）
+//   限幅：输出延迟 AGC_LOOKAHEAD 个样本，控制时看延迟线里还没输出的样本的峰值，
+//         增益不超过让峰值落在 AGC_LIMIT_DB 的值；降增益是线性斜坡，保证在那个峰值输出之前到位，
+//         升增益在一个控制周期内线性过渡（无拉链噪声）
+//   软削波：万一仍超过 AGC_LIMIT_DB（比如增益斜坡被截断），膝点以上按 knee + r·o/(o + r) 压缩，渐近满量程，不会硬削
+// 电平和增益在内部用 Q16 的 dB，增益落到样本上是 Q20 线性（乘之前取 Q12，最大 < 16 倍 ≈ 24 dB）
+// =================================================
+
+#include <stdint.h>
+
+#ifndef AGC_TARGET_DB
+#define AGC_TARGET_DB         -18.0f  // 目标电平（dBFS，相对满量程方波）
+#endif
+#ifndef AGC_MAX_GAIN_DB
+#define AGC_MAX_GAIN_DB       24.0f   // ≤ 24（Q12 增益上限 16 倍）
+#endif
+#define AGC_MIN_GAIN_DB       -12.0f
+#define AGC_ATTACK_MS         5.0f
+#define AGC_HOLD_MS           250.0f
+#define AGC_RELEASE_MS        400.0f
+#define AGC_POWER_MS          10.0f
+#define AGC_FLOOR_RISE_DB     3.0f    // 每秒
+#define AGC_GATE_DB           6.0f
+#define AGC_NOISE_CEILING_DB  -55.0f
+#define AGC_LIMIT_DB          -1.0f
+#define AGC_LEVEL_SLEW_DB     40.0f   // set_levels() 之后目标电平 / 最大增益每秒最多变化
+#ifndef AGC_LOOKAHEAD
+#define AGC_LOOKAHEAD         48      // 样本（44.1 kHz 下 1.09 ms，也是增加的延迟）
+#endif
+#define AGC_CONTROL           16      // 控制周期（样本），必须 < AGC_LOOKAHEAD
+
+static_assert(AGC_CONTROL < AGC_LOOKAHEAD, "AGC_CONTROL 必须小于 AGC_LOOKAHEAD，否则降增益来不及");
+
+class Agc {
+ public:
+  explicit Agc(float sample_rate);
+
+  // 单声道；可以原地（out == in）
+  void process(const int16_t* in, int16_t* out, int n);
+
+  // 观察用（dB），不要求和音频任务同步
+  float gain_db() const { return gain_db_ / 65536.0f; }
+  float level_db() const { return env_db_ / 65536.0f; }
+  float floor_db() const { return floor_db_ / 65536.0f; }
+  uint32_t soft_clipped() const { return soft_clipped_; }   // 进入软削波区的样本数
+
+  void reset();
+
+  // 运行时改目标电平 / 最大增益（和 process 同一个任务调用）；
+  // 控制环里按 AGC_LEVEL_SLEW_DB 每秒挪过去，增益不会跳变
+  void set_levels(float target_db, float max_gain_db);
+
+ private:
+  void control();
+
+  // 以 Q16 计
+  int32_t power_k_, attack_k_, release_k_, floor_down_k_;   // 一阶系数（Q15）
+  int32_t floor_rise_;                                      // 每个控制周期噪底最多上升（Q16 dB）
+  int32_t hold_controls_;                                   // AGC_HOLD_MS 折成控制周期数
+  int32_t target_db_, max_gain_db_, min_gain_db_, gate_db_, ceiling_db_, limit_db_;
+  int32_t target_to_, max_gain_to_, level_slew_;            // set_levels() 的目标和每个控制周期的步长
+
+  int16_t delay_[AGC_LOOKAHEAD];
+  int dpos_;
+  int count_;
+  uint64_t sq_acc_;   // 当前控制周期的平方和
+  int64_t power_;     // 平滑后的均方（Q8，样本平方 × 256）
+  int32_t env_db_, floor_db_, lev_db_, gain_db_;
+  int32_t hold_;      // 剩余保持的控制周期
+  bool have_floor_;
+
+  int32_t g_, step_, g_target_;   // 当前增益、每样本步长、目标（Q20）
+  uint32_t soft_clipped_;
+};
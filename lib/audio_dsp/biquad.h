@@ -0,0 +1,135 @@
+#pragma once
+// =================================================
+// biquad 级联（DF2T，转置直接 II 型）
+// -------------------------------------------------
+//   y  = b0 x + s1
+//   s1 = b1 x - a1 y + s2
+//   s2 = b2 x - a2 y
+//
+// 两种实现，段数 N 是模板参数：
+//   BiquadCascadeF32  float，原地处理 float 块
+//   BiquadCascadeQ28  定点，系数 Q4.28（int32，范围 ±8），状态 int64，
+//                     段间样本 int32 带 8 位小数保护位（低频段极点贴近单位圆，
+//                     只保留整数 LSB 反馈会把量化噪声放大几十 dB），
+//                     不饱和，最后输出时才饱和到 int16
+// 都按“段优先”处理：一段跑完整个块再进下一段，系数和状态在块内一直留在寄存器里，
+// 编译器可以把每段的块循环展开。
+// 没有做跨段向量化（第 k 段同时处理第 t-k 个样本的斜排流水线）：S3 的 FPU 是标量的，
+// PIE 向量指令只有 8/16 位整数乘加，装不下 Q4.28 系数和 int64 状态；斜排后 N 段的状态
+// 放不进寄存器，每个样本还要在段间搬一次，标量核上只会更慢
+// 系数用 biquad_design.h 在编译期设计
+// 精度：tools/biquad_bench（double 参考）+ tools/biquad_check.py（scipy lfilter）
+// =================================================
+
+#include <stdint.h>
+#include <string.h>
+#include "biquad_design.h"
+
+template <int N>
+class BiquadCascadeF32 {
+ public:
+  explicit BiquadCascadeF32(const Sos<N>& sos) {
+    memcpy(c_, sos.s, sizeof(c_));
+    reset();
+  }
+
+  void reset() {
+    memset(s1_, 0, sizeof(s1_));
+    memset(s2_, 0, sizeof(s2_));
+  }
+
+  void process(float* buf, int n) {
+    for (int k = 0; k < N; k++) {
+      const float b0 = c_[k].b0, b1 = c_[k].b1, b2 = c_[k].b2;
+      const float a1 = c_[k].a1, a2 = c_[k].a2;
+      float s1 = s1_[k], s2 = s2_[k];
+      for (int i = 0; i < n; i++) {
+        const float x = buf[i];
+        const float y = b0 * x + s1;
+        s1 = b1 * x - a1 * y + s2;
+        s2 = b2 * x - a2 * y;
+        buf[i] = y;
+      }
+      s1_[k] = s1;
+      s2_[k] = s2;
+    }
+  }
+
+  // int16 进 int16 出（饱和）
+  void process(const int16_t* in, int16_t* out, float* scratch, int n) {
+    for (int i = 0; i < n; i++) scratch[i] = in[i];
+    process(scratch, n);
+    for (int i = 0; i < n; i++) {
+      float v = scratch[i];
+      if (v > 32767) v = 32767;
+      if (v < -32768) v = -32768;
+      out[i] = (int16_t)v;
+    }
+  }
+
+ private:
+  BiquadCoeffs c_[N];
+  float s1_[N];
+  float s2_[N];
+};
+
+#define BIQUAD_Q_SHIFT    28
+#define BIQUAD_GUARD_BITS 8
+
+template <int N>
+class BiquadCascadeQ28 {
+ public:
+  explicit BiquadCascadeQ28(const Sos<N>& sos) {
+    for (int k = 0; k < N; k++) {
+      b0_[k] = to_q28(sos.s[k].b0);
+      b1_[k] = to_q28(sos.s[k].b1);
+      b2_[k] = to_q28(sos.s[k].b2);
+      a1_[k] = to_q28(sos.s[k].a1);
+      a2_[k] = to_q28(sos.s[k].a2);
+    }
+    reset();
+  }
+
+  void reset() {
+    memset(s1_, 0, sizeof(s1_));
+    memset(s2_, 0, sizeof(s2_));
+  }
+
+  // 原地处理 int32 块（int16 幅度左移 BIQUAD_GUARD_BITS，允许超出范围）
+  void process(int32_t* buf, int n) {
+    const int64_t round = (int64_t)1 << (BIQUAD_Q_SHIFT - 1);
+    for (int k = 0; k < N; k++) {
+      const int64_t b0 = b0_[k], b1 = b1_[k], b2 = b2_[k];
+      const int64_t a1 = a1_[k], a2 = a2_[k];
+      int64_t s1 = s1_[k], s2 = s2_[k];
+      for (int i = 0; i < n; i++) {
+        const int64_t x = buf[i];
+        const int32_t y = (int32_t)((b0 * x + s1 + round) >> BIQUAD_Q_SHIFT);
+        s1 = b1 * x - a1 * y + s2;
+        s2 = b2 * x - a2 * y;
+        buf[i] = y;
+      }
+      s1_[k] = s1;
+      s2_[k] = s2;
+    }
+  }
+
+  // int16 进 int16 出（饱和）
+  void process(const int16_t* in, int16_t* out, int32_t* scratch, int n) {
+    const int32_t round = 1 << (BIQUAD_GUARD_BITS - 1);
+    for (int i = 0; i < n; i++) scratch[i] = (int32_t)in[i] << BIQUAD_GUARD_BITS;
+    process(scratch, n);
+    for (int i = 0; i < n; i++) {
+      int32_t v = (scratch[i] + round) >> BIQUAD_GUARD_BITS;
+      out[i] = (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+    }
+  }
+
+ private:
+  static int32_t to_q28(float c) {
+    return (int32_t)(c * (float)(1 << BIQUAD_Q_SHIFT) + (c >= 0 ? 0.5f : -0.5f));
+  }
+
+  int32_t b0_[N], b1_[N], b2_[N], a1_[N], a2_[N];
+  int64_t s1_[N], s2_[N];
+};
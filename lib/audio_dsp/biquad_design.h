@@ -0,0 +1,120 @@
+#pragma once
+// =================================================
+// 编译期 Butterworth 设计，结果与 scipy.signal.butter(order, ..., output='sos')
+// 相同（双线性变换 + 预畸变），分段顺序和每段增益分配可能不同
+//
+//   constexpr auto sos = butter_lowpass<4>(44100, 3000);          // 2 段
+//   constexpr auto sos = butter_bandpass<4>(44100, 100, 3000);    // 4 段
+//
+// audio_filter.py 里 SimpleAudioProcessor 用的正是 4 阶 lowpass / highpass / bandpass
+// =================================================
+
+#include "cx_math.h"
+
+// 一段 biquad：H(z) = (b0 + b1 z^-1 + b2 z^-2) / (1 + a1 z^-1 + a2 z^-2)
+struct BiquadCoeffs {
+  float b0, b1, b2, a1, a2;
+};
+
+template <int N>
+struct Sos {
+  static constexpr int kSections = N;
+  BiquadCoeffs s[N];
+};
+
+namespace biquad_detail {
+
+// Butterworth 各极点对的 Q：1 / (2 cos(pi (2k+1) / (2 order)))
+constexpr double butter_q(int order, int k) {
+  return 1.0 / (2.0 * cx::cos(cx::kPi * (2 * k + 1) / (2.0 * order)));
+}
+
+// 一段在 e^{jw} 处的复响应
+constexpr cx::Complex eval(const BiquadCoeffs& c, double w) {
+  cx::Complex z1 = cx::expj(-w), z2 = cx::expj(-2 * w);
+  cx::Complex num = cx::Complex{c.b0, 0} + (double)c.b1 * z1 + (double)c.b2 * z2;
+  cx::Complex den = cx::Complex{1, 0} + (double)c.a1 * z1 + (double)c.a2 * z2;
+  return num / den;
+}
+
+}  // namespace biquad_detail
+
+// order 阶低通（order 为偶数）
+template <int ORDER>
+constexpr Sos<ORDER / 2> butter_lowpass(double fs, double fc) {
+  static_assert(ORDER % 2 == 0 && ORDER > 0, "只支持偶数阶");
+  Sos<ORDER / 2> sos = {};
+  const double K = cx::tan(cx::kPi * fc / fs);
+  for (int k = 0; k < ORDER / 2; k++) {
+    const double Q = biquad_detail::butter_q(ORDER, k);
+    const double norm = 1.0 / (1.0 + K / Q + K * K);
+    const double b0 = K * K * norm;
+    sos.s[k] = { (float)b0, (float)(2 * b0), (float)b0,
+                 (float)(2 * (K * K - 1) * norm),
+                 (float)((1 - K / Q + K * K) * norm) };
+  }
+  return sos;
+}
+
+// order 阶高通（order 为偶数）
+template <int ORDER>
+constexpr Sos<ORDER / 2> butter_highpass(double fs, double fc) {
+  static_assert(ORDER % 2 == 0 && ORDER > 0, "只支持偶数阶");
+  Sos<ORDER / 2> sos = {};
+  const double K = cx::tan(cx::kPi * fc / fs);
+  for (int k = 0; k < ORDER / 2; k++) {
+    const double Q = biquad_detail::butter_q(ORDER, k);
+    const double norm = 1.0 / (1.0 + K / Q + K * K);
+    sos.s[k] = { (float)norm, (float)(-2 * norm), (float)norm,
+                 (float)(2 * (K * K - 1) * norm),
+                 (float)((1 - K / Q + K * K) * norm) };
+  }
+  return sos;
+}
+
+// order 阶原型的带通（总阶数 2*order，与 scipy butter(order, [lo, hi], 'band') 一致）
+// 模拟原型极点 p 经 s → (s^2 + w0^2) / (B s) 映射成两个极点，
+// 每个极点和它的共轭组成一段，零点固定在 z = ±1
+template <int ORDER>
+constexpr Sos<ORDER> butter_bandpass(double fs, double f_lo, double f_hi) {
+  static_assert(ORDER % 2 == 0 && ORDER > 0, "只支持偶数阶");
+  Sos<ORDER> sos = {};
+  // 预畸变（双线性 s = (z-1)/(z+1)）
+  const double wl = cx::tan(cx::kPi * f_lo / fs);
+  const double wh = cx::tan(cx::kPi * f_hi / fs);
+  const double w0 = cx::sqrt(wl * wh);
+  const double B  = wh - wl;
+  const double wc = 2 * cx::atan(w0);   // 数字中心频率
+
+  int n = 0;
+  for (int k = 0; k < ORDER / 2; k++) {
+    // 左半平面上半部分的原型极点
+    const double theta = cx::kPi * (2 * k + ORDER + 1) / (2.0 * ORDER);
+    const cx::Complex p = cx::expj(theta);
+    const cx::Complex pb = B * p;
+    const cx::Complex d = cx::csqrt(pb * pb - cx::Complex{4 * w0 * w0, 0});
+    const cx::Complex s_pair[2] = { 0.5 * (pb + d), 0.5 * (pb - d) };
+
+    for (int j = 0; j < 2; j++) {
+      const cx::Complex one = {1, 0};
+      const cx::Complex z = (one + s_pair[j]) / (one - s_pair[j]);
+      BiquadCoeffs c = { 1, 0, -1,
+                         (float)(-2 * z.re),
+                         (float)(z.re * z.re + z.im * z.im) };
+      // 每段在中心频率处归一到 |H| = 1
+      const double g = 1.0 / cx::norm(biquad_detail::eval(c, wc));
+      c.b0 = (float)g;
+      c.b2 = (float)-g;
+      sos.s[n++] = c;
+    }
+  }
+
+  // 总响应在中心频率应为 +1，符号反了就翻第一段
+  cx::Complex total = {1, 0};
+  for (int i = 0; i < ORDER; i++) total = total * biquad_detail::eval(sos.s[i], wc);
+  if (total.re < 0) {
+    sos.s[0].b0 = -sos.s[0].b0;
+    sos.s[0].b2 = -sos.s[0].b2;
+  }
+  return sos;
+}
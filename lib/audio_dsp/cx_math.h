@@ -0,0 +1,74 @@
+#pragma once
+// =================================================
+// 编译期数学（C++14 constexpr）
+// 只给滤波器设计之类的 constexpr 函数用，运行时请用 <math.h>
+// =================================================
+
+namespace cx {
+
+constexpr double kPi = 3.14159265358979323846;
+
+constexpr double abs(double x) { return x < 0 ? -x : x; }
+
+constexpr double sqrt(double x) {
+  if (x <= 0) return 0;
+  double r = x > 1 ? x : 1;
+  for (int i = 0; i < 64; i++) r = 0.5 * (r + x / r);
+  return r;
+}
+
+// 先把 x 归约到 [-pi, pi]，再用泰勒级数
+constexpr double sin(double x) {
+  const double two_pi = 2 * kPi;
+  long long k = (long long)(x / two_pi + (x >= 0 ? 0.5 : -0.5));
+  x -= k * two_pi;
+  double term = x, sum = x;
+  for (int n = 1; n < 16; n++) {
+    term *= -x * x / ((2 * n) * (2 * n + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+constexpr double cos(double x) { return sin(x + kPi / 2); }
+constexpr double tan(double x) { return sin(x) / cos(x); }
+
+// 只用于小参数的 atan（级数 + 两次半角），够滤波器中心频率用
+constexpr double atan(double x) {
+  // atan(x) = 2 atan(x / (1 + sqrt(1 + x^2)))
+  double y = x / (1 + sqrt(1 + x * x));
+  y = y / (1 + sqrt(1 + y * y));
+  double term = y, sum = y;
+  for (int n = 1; n < 24; n++) {
+    term *= -y * y;
+    sum += term / (2 * n + 1);
+  }
+  return 4 * sum;
+}
+
+struct Complex {
+  double re, im;
+};
+
+constexpr Complex operator+(Complex a, Complex b) { return {a.re + b.re, a.im + b.im}; }
+constexpr Complex operator-(Complex a, Complex b) { return {a.re - b.re, a.im - b.im}; }
+constexpr Complex operator*(Complex a, Complex b) {
+  return {a.re * b.re - a.im * b.im, a.re * b.im + a.im * b.re};
+}
+constexpr Complex operator*(double k, Complex a) { return {k * a.re, k * a.im}; }
+constexpr Complex operator/(Complex a, Complex b) {
+  double d = b.re * b.re + b.im * b.im;
+  return {(a.re * b.re + a.im * b.im) / d, (a.im * b.re - a.re * b.im) / d};
+}
+constexpr double norm(Complex a) { return sqrt(a.re * a.re + a.im * a.im); }
+constexpr Complex expj(double w) { return {cos(w), sin(w)}; }
+
+// 主值平方根
+constexpr Complex csqrt(Complex a) {
+  double m = norm(a);
+  double re = sqrt((m + a.re) / 2);
+  double im = sqrt((m - a.re) / 2);
+  return {re, a.im < 0 ? -im : im};
+}
+
+}  // namespace cx
@@ -0,0 +1,71 @@
+#include "fft.h"
+#include <math.h>
+
+#if defined(ESP_PLATFORM)
+#include <esp_attr.h>
+#else
+#define IRAM_ATTR
+#endif
+
+RealFft::RealFft(int n) {
+  if (n < 16) n = 16;
+  if (n > FFT_MAX_SIZE) n = FFT_MAX_SIZE;
+  int bits = 0;
+  while ((2 << bits) <= n) bits++;
+  n_    = 1 << bits;
+  half_ = n_ / 2;
+
+  for (int k = 0; k < half_; k++) {
+    const double a = 2 * 3.14159265358979323846 * k / n_;
+    cos_[k] = (float)cos(a);
+    sin_[k] = (float)sin(a);
+  }
+  for (int i = 0; i < half_; i++) {
+    int r = 0;
+    for (int b = 0; b < bits - 1; b++) r |= ((i >> b) & 1) << (bits - 2 - b);
+    rev_[i] = (uint16_t)r;
+  }
+}
+
+void IRAM_ATTR RealFft::forward(const float* in, float* re, float* im) {
+  const int m = half_;
+
+  // 偶数样本 → 实部，奇数样本 → 虚部，同时做位反转
+  for (int i = 0; i < m; i++) {
+    zr_[rev_[i]] = in[2 * i];
+    zi_[rev_[i]] = in[2 * i + 1];
+  }
+
+  // m 点 radix-2 DIT；W_m^j = W_n^(2j)，在 n 点表里步进
+  for (int len = 2, tstep = n_ / 2; len <= m; len <<= 1, tstep >>= 1) {
+    const int h = len / 2;
+    for (int j = 0; j < h; j++) {
+      const float wr = cos_[j * tstep];
+      const float wi = -sin_[j * tstep];
+      for (int i = j; i < m; i += len) {
+        const int k = i + h;
+        const float tr = zr_[k] * wr - zi_[k] * wi;
+        const float ti = zr_[k] * wi + zi_[k] * wr;
+        zr_[k] = zr_[i] - tr;
+        zi_[k] = zi_[i] - ti;
+        zr_[i] += tr;
+        zi_[i] += ti;
+      }
+    }
+  }
+
+  // 拆分：E = (Z[k] + Z*[m-k]) / 2，O = (Z[k] - Z*[m-k]) / 2j，X[k] = E + W^k·O
+  re[0] = zr_[0] + zi_[0];
+  im[0] = 0;
+  re[m] = zr_[0] - zi_[0];
+  im[m] = 0;
+  for (int k = 1; k < m; k++) {
+    const float ar = zr_[k],     ai = zi_[k];
+    const float br = zr_[m - k], bi = -zi_[m - k];   // Z*[m-k]
+    const float er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+    const float or_ = 0.5f * (ai - bi), oi = -0.5f * (ar - br);
+    const float wr = cos_[k], wi = -sin_[k];
+    re[k] = er + or_ * wr - oi * wi;
+    im[k] = ei + or_ * wi + oi * wr;
+  }
+}
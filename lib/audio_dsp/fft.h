@@ -0,0 +1,31 @@
+#pragma once
+// =================================================
+// 实数 FFT（float，n = 2 的幂，16 ~ FFT_MAX_SIZE）
+// -------------------------------------------------
+// n 点实序列拆成奇偶两路当作 n/2 点复序列，做一次 radix-2 迭代 FFT，
+// 再用 X[k] = (Z[k] + Z*[n/2-k]) / 2 - j·W^k·(Z[k] - Z*[n/2-k]) / 2 拆回来，
+// 比直接算 n 点复数 FFT 省一半。旋转因子和位反转表在构造时算好
+// =================================================
+
+#include <stdint.h>
+
+#define FFT_MAX_SIZE 2048
+
+class RealFft {
+ public:
+  explicit RealFft(int n);
+
+  // in：n 个实数样本；re / im：n/2 + 1 个频点（0 ~ Nyquist），不做归一化
+  void forward(const float* in, float* re, float* im);
+
+  int size() const { return n_; }
+
+ private:
+  int n_;
+  int half_;
+  float cos_[FFT_MAX_SIZE / 2];     // W_n^k = cos - j·sin，k < n/2
+  float sin_[FFT_MAX_SIZE / 2];
+  uint16_t rev_[FFT_MAX_SIZE / 2];  // n/2 点的位反转
+  float zr_[FFT_MAX_SIZE / 2];
+  float zi_[FFT_MAX_SIZE / 2];
+};
@@ -0,0 +1,40 @@
+#include "gain_kernel.h"
+
+#if defined(ESP_PLATFORM)
+#include <esp_attr.h>
+#else
+#define IRAM_ATTR
+#endif
+
+// -------------------------------------------------
+// float 参考：与原 loop() 逐行一致
+// -------------------------------------------------
+void gain_interleave_float(const int16_t* in, int16_t* out, int n, float gain) {
+  for (int i = 0; i < n; i++) {
+    float s = in[i] * gain;
+    if (s > 32767) s = 32767;
+    if (s < -32768) s = -32768;
+    int16_t v = (int16_t)s;
+    out[i * 2]     = v;
+    out[i * 2 + 1] = v;
+  }
+}
+
+// Q27 → Q15，向零截断（与 float→int 转换相同）
+static inline int32_t q27_to_q15_trunc(int32_t acc) {
+  return acc >= 0 ? (acc >> GAIN_Q_SHIFT) : -((-acc) >> GAIN_Q_SHIFT);
+}
+
+// -------------------------------------------------
+// Q12 标量（固件默认）
+// -------------------------------------------------
+void IRAM_ATTR gain_interleave_q12_ref(const int16_t* in, int16_t* out, int n,
+                                       int32_t gain_q12) {
+  for (int i = 0; i < n; i++) {
+    int32_t v = q27_to_q15_trunc((int32_t)in[i] * gain_q12);
+    if (v > 32767) v = 32767;
+    if (v < -32768) v = -32768;
+    out[i * 2]     = (int16_t)v;
+    out[i * 2 + 1] = (int16_t)v;
+  }
+}
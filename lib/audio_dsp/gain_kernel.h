@@ -0,0 +1,49 @@
+#pragma once
+// =================================================
+// 定点增益 + 限幅 + 单声道→立体声交织
+// -------------------------------------------------
+// 样本是 Q15（int16），增益是无符号 Q4.12（int32，4096 = 1.0，最大 < 16x）
+// 乘积放在 32 位累加器里（Q27），向零截断后饱和到 Q15，
+// 与原来 float 路径的 (int16_t)clamp(x * gain) 结果一致：
+// 只要 gain * 512 是整数（3.0、8.0、1.5 ... 都是），两者逐位相同；
+// 更细的 Q12 增益在输出 ≥ 4096 时 float 尾数不够，偶尔差 1 LSB（tools/gain_bench 逐位扫过）
+//
+// 实现在编译期选择（GAIN_KERNEL_IMPL）：
+//   0 = float 参考（原始 loop() 写法）
+//   1 = Q12 标量实现
+// 没有另做展开 / SIMD 版：块只有 BUFFER_SAMPLES（8）个样本，开销在调用和访存上，
+// 2 样本展开 + CLAMPS 的版本在 tools/gain_bench 里和标量版一样快，已删掉；
+// S3 的 EE.VMUL.S16 乘数是有符号 16 位，放不下 ≥ 8x 的 Q12 增益，移位也是向下取整，
+// 做不到和 float 路径逐位一致的向零截断
+// =================================================
+
+#include <stdint.h>
+
+#define GAIN_KERNEL_FLOAT   0
+#define GAIN_KERNEL_Q12_REF 1
+
+#ifndef GAIN_KERNEL_IMPL
+#define GAIN_KERNEL_IMPL GAIN_KERNEL_Q12_REF
+#endif
+
+#define GAIN_Q_SHIFT 12
+#define GAIN_Q_ONE   (1 << GAIN_Q_SHIFT)
+
+// 浮点增益 → Q12（四舍五入），可在编译期求值
+constexpr int32_t gain_to_q12(float gain) {
+  return (int32_t)(gain * GAIN_Q_ONE + 0.5f);
+}
+
+// 两种实现都单独导出，方便主机上做逐位比对和计时
+void gain_interleave_float(const int16_t* in, int16_t* out, int n, float gain);
+void gain_interleave_q12_ref(const int16_t* in, int16_t* out, int n, int32_t gain_q12);
+
+// 按 GAIN_KERNEL_IMPL 选中的实现；gain_q12 由 gain_to_q12() 得到
+static inline void gain_interleave(const int16_t* in, int16_t* out, int n,
+                                   int32_t gain_q12) {
+#if GAIN_KERNEL_IMPL == GAIN_KERNEL_FLOAT
+  gain_interleave_float(in, out, n, (float)gain_q12 / GAIN_Q_ONE);
+#else
+  gain_interleave_q12_ref(in, out, n, gain_q12);
+#endif
+}
@@ -0,0 +1,54 @@
+#pragma once
+// =================================================
+// Q15 线性增益斜坡：淡入 / 淡出 / 立刻静音
+// -------------------------------------------------
+// 淡出到 0 后保持静音（直到 fade_in），淡入到 1.0 后直通。
+// apply() 在直通时直接返回、静音时 memset，只有斜坡进行中才逐样本乘。
+// 单声道和交织多声道共用（每帧所有声道同一个增益）
+// =================================================
+
+#include <stdint.h>
+#include <string.h>
+
+class GainRamp {
+ public:
+  static constexpr int32_t kUnity = 1 << 15;
+
+  // step：每帧增益变化量（Q15），kUnity / 斜坡帧数
+  explicit GainRamp(int32_t step, bool muted = false)
+      : step_(step > 0 ? step : 1), gain_(muted ? 0 : kUnity), dir_(0) {}
+
+  void fade_in()  { dir_ = 1; }
+  void fade_out() { dir_ = -1; }
+  void mute()     { gain_ = 0; dir_ = 0; }
+
+  int32_t gain() const { return gain_; }
+  int dir() const { return dir_; }   // -1 淡出 / 静音保持，+1 淡入，0 静止
+  bool unity() const { return gain_ == kUnity && dir_ == 0; }
+  bool silent() const { return gain_ == 0 && dir_ <= 0; }
+
+  void apply(int16_t* x, int frames, int channels = 1) {
+    if (unity()) return;
+    if (silent()) {
+      memset(x, 0, (size_t)frames * channels * sizeof(int16_t));
+      return;
+    }
+    for (int i = 0; i < frames; i++) {
+      gain_ += dir_ * step_;
+      if (gain_ <= 0) gain_ = 0;
+      if (gain_ >= kUnity) {
+        gain_ = kUnity;
+        dir_  = 0;
+      }
+      for (int c = 0; c < channels; c++) {
+        int16_t& s = x[i * channels + c];
+        s = (int16_t)((s * gain_) >> 15);
+      }
+    }
+  }
+
+ private:
+  int32_t step_;
+  int32_t gain_;
+  int dir_;
+};
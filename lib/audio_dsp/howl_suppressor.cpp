@@ -0,0 +1,164 @@
+#include "howl_suppressor.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include <esp_attr.h>
+#else
+#define IRAM_ATTR
+#endif
+
+static const float kPi = 3.14159265358979f;
+
+static inline float db_to_pow(float db) { return powf(10.0f, db / 10.0f); }
+
+HowlSuppressor::HowlSuppressor(float sample_rate) : fs_(sample_rate) {
+  bin_hz_ = fs_ / HOWL_FRAME;
+  first_bin_ = (int)(HOWL_FREQ_MIN / bin_hz_ + 0.5f);
+  for (int k = 0; k < HOWL_BINS; k++) {
+    coeff_[k] = 2.0f * cosf(2.0f * kPi * (first_bin_ + k) / HOWL_FRAME);
+  }
+  reset();
+}
+
+void HowlSuppressor::reset() {
+  memset(g1_, 0, sizeof(g1_));
+  memset(g2_, 0, sizeof(g2_));
+  memset(&stats_, 0, sizeof(stats_));
+  fill_ = 0;
+  cand_bin_ = -1;
+  cand_frames_ = 0;
+  onset_frame_ = 0;
+  active_ = 0;
+}
+
+void IRAM_ATTR HowlSuppressor::process(int16_t* buf, int n) {
+  for (int i = 0; i < n; i++) {
+    const float x = buf[i] * (1.0f / 32768.0f);
+
+    // 分析用陷波前的信号：陷波部署后啸叫能量还在环路里的话仍能被看到
+    for (int k = 0; k < HOWL_BINS; k++) {
+      const float s = x + coeff_[k] * g1_[k] - g2_[k];
+      g2_[k] = g1_[k];
+      g1_[k] = s;
+    }
+
+    float y = x;
+    for (int j = 0; j < active_; j++) {
+      Notch& nt = notches_[j];
+      const float out = nt.c.b0 * y + nt.s1;
+      nt.s1 = nt.c.b1 * y - nt.c.a1 * out + nt.s2;
+      nt.s2 = nt.c.b2 * y - nt.c.a2 * out;
+      y = out;
+    }
+
+    float v = y * 32768.0f;
+    if (v > 32767) v = 32767;
+    if (v < -32768) v = -32768;
+    buf[i] = (int16_t)v;
+
+    if (++fill_ == HOWL_FRAME) {
+      fill_ = 0;
+      analyze_frame();
+    }
+  }
+}
+
+void HowlSuppressor::analyze_frame() {
+  float pw[HOWL_BINS];
+  float sum = 0;
+  int peak = 0;
+  for (int k = 0; k < HOWL_BINS; k++) {
+    pw[k] = g1_[k] * g1_[k] + g2_[k] * g2_[k] - coeff_[k] * g1_[k] * g2_[k];
+    sum += pw[k];
+    if (pw[k] > pw[peak]) peak = k;
+    g1_[k] = g2_[k] = 0;
+  }
+  stats_.frames++;
+
+  // 释放超时的陷波
+  for (int j = 0; j < active_; ) {
+    if (++notches_[j].age >= HOWL_RELEASE_FRAMES) {
+      notches_[j] = notches_[--active_];
+      stats_.released++;
+    } else {
+      j++;
+    }
+  }
+
+  // 满量程正弦在 N 点 Goertzel 上的功率约 (N/2)^2
+  const float full = (HOWL_FRAME / 2.0f) * (HOWL_FRAME / 2.0f);
+  const float avg  = sum / HOWL_BINS;
+  const float lo   = peak >= 2 ? pw[peak - 2] : pw[peak];
+  const float hi   = peak + 2 < HOWL_BINS ? pw[peak + 2] : pw[peak];
+  const float nb   = lo > hi ? lo : hi;
+
+  const bool howl =
+      pw[peak] >= full * db_to_pow(HOWL_MIN_POWER_DB) &&
+      pw[peak] >= avg * db_to_pow(HOWL_PAPR_DB) &&
+      pw[peak] >= nb * db_to_pow(HOWL_PNPR_DB);
+
+  if (!howl) {
+    cand_bin_ = -1;
+    cand_frames_ = 0;
+    return;
+  }
+  if (cand_bin_ >= 0 && abs(peak - cand_bin_) <= 1) {
+    cand_frames_++;
+  } else {
+    if (cand_bin_ < 0) onset_frame_ = stats_.frames;
+    cand_frames_ = 1;
+  }
+  cand_bin_ = peak;
+  if (cand_frames_ < HOWL_PERSIST) return;
+
+  // 抛物线插值（对数幅度）细化峰值位置
+  float delta = 0;
+  if (peak > 0 && peak < HOWL_BINS - 1) {
+    const float a = logf(pw[peak - 1] + 1e-12f);
+    const float b = logf(pw[peak] + 1e-12f);
+    const float c = logf(pw[peak + 1] + 1e-12f);
+    const float den = a - 2 * b + c;
+    if (den < 0) delta = 0.5f * (a - c) / den;
+  }
+  deploy((first_bin_ + peak + delta) * bin_hz_);
+  stats_.last_detect_ms = (uint32_t)((stats_.frames - onset_frame_ + 1) * (HOWL_FRAME * 1000.0f) / fs_);
+  cand_bin_ = -1;
+  cand_frames_ = 0;
+}
+
+void HowlSuppressor::deploy(float freq) {
+  // 已有相近的陷波就刷新它
+  for (int j = 0; j < active_; j++) {
+    if (fabsf(notches_[j].freq - freq) < bin_hz_ * 0.5f) {
+      notches_[j].age = 0;
+      return;
+    }
+  }
+
+  int slot = active_;
+  if (active_ < HOWL_MAX_NOTCHES) {
+    active_++;
+  } else {
+    slot = 0;
+    for (int j = 1; j < active_; j++) {
+      if (notches_[j].age > notches_[slot].age) slot = j;
+    }
+  }
+
+  // RBJ 陷波
+  const float w0 = 2.0f * kPi * freq / fs_;
+  const float alpha = sinf(w0) / (2.0f * HOWL_NOTCH_Q);
+  const float norm = 1.0f / (1.0f + alpha);
+  Notch& nt = notches_[slot];
+  nt.c.b0 = norm;
+  nt.c.b1 = -2.0f * cosf(w0) * norm;
+  nt.c.b2 = norm;
+  nt.c.a1 = nt.c.b1;
+  nt.c.a2 = (1.0f - alpha) * norm;
+  nt.s1 = nt.s2 = 0;
+  nt.freq = freq;
+  nt.age = 0;
+  stats_.deployed++;
+}
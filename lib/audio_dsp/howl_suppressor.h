@@ -0,0 +1,87 @@
+#pragma once
+// =================================================
+// 啸叫（声反馈）抑制
+// -------------------------------------------------
+// 检测：HOWL_BINS 个 Goertzel 滤波器覆盖 HOWL_FREQ_MIN 起的一段频带，
+//   每来一个样本就推进一次（每样本 HOWL_BINS 次乘加，开销均摊，没有突发），
+//   每 HOWL_FRAME 个样本出一次功率谱，判定条件：
+//   - 峰值 / 平均（PAPR）≥ HOWL_PAPR_DB
+//   - 峰值 / 左右第 2 个邻居（PNPR）≥ HOWL_PNPR_DB
+//   - 峰值功率高于绝对门限
+//   - 同一位置（±1 bin）连续 HOWL_PERSIST 帧
+// 抑制：在抛物线插值得到的峰值频率上部署 RBJ 陷波 biquad（DF2T，零额外延迟），
+//   最多 HOWL_MAX_NOTCHES 个，满了替换最老的；HOWL_RELEASE_FRAMES 帧后释放，
+//   啸叫还在的话会重新检测并部署
+// 闭环仿真（抑制时间、附加延迟）见 tools/howl_bench
+// =================================================
+
+#include <stdint.h>
+#include "biquad_design.h"
+
+#ifndef HOWL_FRAME
+#define HOWL_FRAME          512     // 44.1 kHz 下 bin 宽约 86 Hz，11.6 ms 一帧
+#endif
+#ifndef HOWL_BINS
+#define HOWL_BINS           64
+#endif
+#ifndef HOWL_FREQ_MIN
+#define HOWL_FREQ_MIN       300.0f
+#endif
+#define HOWL_PAPR_DB        12.0f
+#define HOWL_PNPR_DB        10.0f
+#define HOWL_MIN_POWER_DB   -50.0f  // 相对满量程正弦
+#define HOWL_PERSIST        4       // 约 46 ms
+#define HOWL_MAX_NOTCHES    4
+#define HOWL_NOTCH_Q        30.0f
+#define HOWL_RELEASE_FRAMES 860     // 约 10 s
+
+struct HowlStats {
+  uint32_t frames;           // 分析帧数
+  uint32_t deployed;         // 累计部署的陷波数
+  uint32_t released;         // 超时释放的陷波数
+  uint32_t last_detect_ms;   // 最近一次部署：从啸叫条件开始成立（中途换 bin 不重新计时）到部署
+};
+
+class HowlSuppressor {
+ public:
+  explicit HowlSuppressor(float sample_rate);
+
+  // 原地处理：先按当前陷波滤波，再把输入送去分析
+  void process(int16_t* buf, int n);
+
+  int notch_count() const { return active_; }
+  float notch_freq(int i) const { return notches_[i].freq; }
+  const HowlStats& stats() const { return stats_; }
+
+  void reset();
+
+ private:
+  struct Notch {
+    BiquadCoeffs c;
+    float s1, s2;
+    float freq;
+    uint32_t age;   // 部署后经过的帧数
+  };
+
+  void analyze_frame();
+  void deploy(float freq);
+
+  float fs_;
+  float bin_hz_;
+  int first_bin_;
+
+  // Goertzel 状态
+  float coeff_[HOWL_BINS];
+  float g1_[HOWL_BINS];
+  float g2_[HOWL_BINS];
+  int fill_;
+
+  // 候选跟踪
+  int cand_bin_;
+  int cand_frames_;
+  uint32_t onset_frame_;   // 啸叫条件这一轮开始成立的帧号（stats_.frames）
+
+  Notch notches_[HOWL_MAX_NOTCHES];
+  int active_;
+  HowlStats stats_;
+};
@@ -0,0 +1,97 @@
+#include "latency_probe.h"
+#include <math.h>
+#include <string.h>
+
+static const float kPi = 3.14159265358979f;
+
+LatencyProbe::LatencyProbe(float sample_rate, int chirp_len, int max_delay,
+                           float f0, float f1, float level)
+    : fs_(sample_rate), chirp_len_(chirp_len), max_delay_(max_delay),
+      capture_len_(chirp_len + max_delay), pos_(0), state_(IDLE) {
+  chirp_   = new int16_t[chirp_len_];
+  capture_ = new int16_t[capture_len_];
+  corr_    = new float[max_delay_];
+
+  // 线性扫频，两端各 10% 汉宁渐变，避免咔哒声
+  const float T = chirp_len_ / fs_;
+  const float k = (f1 - f0) / T;
+  const int taper = chirp_len_ / 10;
+  for (int i = 0; i < chirp_len_; i++) {
+    const float t = i / fs_;
+    float w = 1.0f;
+    if (i < taper) w = 0.5f - 0.5f * cosf(kPi * i / taper);
+    if (i >= chirp_len_ - taper) w = 0.5f - 0.5f * cosf(kPi * (chirp_len_ - 1 - i) / taper);
+    const float v = level * w * sinf(2 * kPi * (f0 * t + 0.5f * k * t * t));
+    chirp_[i] = (int16_t)(v * 32767.0f);
+  }
+}
+
+LatencyProbe::~LatencyProbe() {
+  delete[] chirp_;
+  delete[] capture_;
+  delete[] corr_;
+}
+
+bool LatencyProbe::arm() {
+  int expected = IDLE;
+  return state_.compare_exchange_strong(expected, ARMED,
+                                        std::memory_order_acq_rel);
+}
+
+bool LatencyProbe::process(const int16_t* mic, int16_t* spk_mono, int n) {
+  int st = state_.load(std::memory_order_acquire);
+  if (st == ARMED) {
+    pos_ = 0;
+    st = RUNNING;
+    state_.store(RUNNING, std::memory_order_relaxed);
+  }
+  if (st != RUNNING) return false;
+
+  for (int i = 0; i < n; i++) {
+    const int p = pos_ + i;
+    spk_mono[i] = p < chirp_len_ ? chirp_[p] : 0;
+    if (p < capture_len_) capture_[p] = mic[i];
+  }
+  pos_ += n;
+  if (pos_ >= capture_len_) state_.store(CAPTURED, std::memory_order_release);
+  return true;
+}
+
+LatencyResult LatencyProbe::analyze() {
+  LatencyResult r = {false, 0, 0, 0};
+  if (state_.load(std::memory_order_acquire) != CAPTURED) return r;
+
+  // 直接互相关：max_delay × chirp_len 次乘加，4096×4096 在 S3 上约 0.1~0.2 s
+  int best_d = 0;
+  for (int d = 0; d < max_delay_; d++) {
+    const int16_t* m = capture_ + d;
+    int64_t acc = 0;
+    for (int i = 0; i < chirp_len_; i++) acc += (int32_t)chirp_[i] * m[i];
+    corr_[d] = (float)acc;
+    if (fabsf(corr_[d]) > fabsf(corr_[best_d])) best_d = d;
+  }
+  const float best = corr_[best_d];
+
+  // 旁瓣：主峰 ±1 ms 以外的最大值
+  const int guard = (int)(fs_ / 1000.0f);
+  float side = 0;
+  for (int d = 0; d < max_delay_; d++) {
+    if (d > best_d - guard && d < best_d + guard) continue;
+    if (fabsf(corr_[d]) > side) side = fabsf(corr_[d]);
+  }
+
+  float delta = 0;
+  if (best_d > 0 && best_d < max_delay_ - 1) {
+    const float ym = corr_[best_d - 1], yp = corr_[best_d + 1];
+    const float den = ym - 2 * best + yp;
+    if (den != 0) delta = 0.5f * (ym - yp) / den;
+  }
+
+  r.delay_samples = best_d + delta;
+  r.delay_ms      = r.delay_samples * 1000.0f / fs_;
+  r.confidence    = side > 0 ? fabsf(best) / side : 0;
+  r.valid         = best != 0 && r.confidence >= 3.0f;
+
+  state_.store(IDLE, std::memory_order_release);
+  return r;
+}
@@ -0,0 +1,60 @@
+#pragma once
+// =================================================
+// 回环延迟测量：TX 播一段扫频，RX 采回来做互相关
+// -------------------------------------------------
+// 流程（状态用原子变量在控制任务和 DSP 任务之间交接）：
+//   控制任务 arm()            IDLE     → ARMED
+//   DSP      process() 首次   ARMED    → RUNNING：输出被替换为扫频，之后静音，
+//                                         同时录下 chirp_len + max_delay 个麦克风样本
+//   DSP      录满             RUNNING  → CAPTURED
+//   控制任务 analyze()        CAPTURED → IDLE：互相关找峰（耗时，不要在音频任务里调）
+//
+// 测到的是“DSP 写出第一个样本”到“DSP 读到它的回声”之间的样本数，
+// 包含 TX 队列 + DMA + DAC + 声学路径 + 麦克风 / PDM 抽取 + RX DMA，
+// 也就是直通时真实的输入→输出延迟
+// 合成回声上的精度 / 置信度测试见 tools/latency_bench
+// =================================================
+
+#include <atomic>
+#include <stdint.h>
+
+struct LatencyResult {
+  bool  valid;
+  float delay_samples;   // 抛物线插值后的亚样本延迟
+  float delay_ms;
+  float confidence;      // 主峰 / 旁瓣最大值，< 3 基本不可信
+};
+
+class LatencyProbe {
+ public:
+  enum State : int { IDLE = 0, ARMED, RUNNING, CAPTURED };
+
+  // chirp_len / max_delay 单位是样本；缓冲在构造时一次分配
+  LatencyProbe(float sample_rate, int chirp_len, int max_delay,
+               float f0 = 300.0f, float f1 = 8000.0f, float level = 0.5f);
+  ~LatencyProbe();
+
+  bool arm();
+  State state() const { return (State)state_.load(std::memory_order_acquire); }
+
+  // DSP 每块调用：mic 为本块原始采集；测量进行中返回 true，
+  // 此时 spk_mono 被写成探测信号（扫频或静音），调用方用它替换输出
+  bool process(const int16_t* mic, int16_t* spk_mono, int n);
+
+  // 在控制任务里调用：状态为 CAPTURED 时计算结果并回到 IDLE
+  LatencyResult analyze();
+
+  const int16_t* chirp() const { return chirp_; }
+  int chirp_len() const { return chirp_len_; }
+
+ private:
+  float fs_;
+  int chirp_len_;
+  int max_delay_;
+  int capture_len_;
+  int pos_;
+  int16_t* chirp_;
+  int16_t* capture_;
+  float* corr_;
+  std::atomic<int> state_;
+};
@@ -0,0 +1,148 @@
+#include "pdm_decimator.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include <esp_attr.h>
+#else
+#define IRAM_ATTR
+#endif
+
+static const double kPi = 3.14159265358979323846;
+
+// 零阶修正贝塞尔函数（Kaiser 窗）
+static double bessel_i0(double x) {
+  double sum = 1, term = 1;
+  for (int k = 1; k < 30; k++) {
+    term *= (x / (2 * k)) * (x / (2 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+PdmDecimator::PdmDecimator(int osr, float passband) {
+  if (osr < 2 * PDM_CIC_DECIM) osr = 2 * PDM_CIC_DECIM;
+  if (osr > PDM_OSR_MAX) osr = PDM_OSR_MAX;
+  osr_   = osr / PDM_CIC_DECIM * PDM_CIC_DECIM;
+  decim_ = osr_ / PDM_CIC_DECIM;
+
+  // ---------- CIC：4 个长 16 的矩形窗卷积 ----------
+  int32_t h[PDM_CIC_LEN] = {1};
+  int len = 1;
+  for (int s = 0; s < PDM_CIC_ORDER; s++) {
+    int32_t t[PDM_CIC_LEN] = {0};
+    for (int i = 0; i < len; i++)
+      for (int j = 0; j < PDM_CIC_DECIM; j++) t[i + j] += h[i];
+    len += PDM_CIC_DECIM - 1;
+    memcpy(h, t, sizeof(h));
+  }
+  cic_gain_ = 0;
+  for (int i = 0; i < PDM_CIC_LEN; i++) cic_gain_ += h[i];
+
+#if PDM_CIC_KERNEL == PDM_CIC_KERNEL_LUT
+  // 位 k（bit0 最新）对应 h[k]；字节 p 覆盖 k = 8p .. 8p+7
+  for (int p = 0; p < 8; p++) {
+    for (int v = 0; v < 256; v++) {
+      int32_t acc = 0;
+      for (int j = 0; j < 8; j++) {
+        const int k = 8 * p + j;
+        if (((v >> j) & 1) && k < PDM_CIC_LEN) acc += h[k];
+      }
+      lut_[p][v] = acc;
+    }
+  }
+#else
+  int32_t hmax = 0;
+  for (int i = 0; i < PDM_CIC_LEN; i++) if (h[i] > hmax) hmax = h[i];
+  nplanes_ = 0;
+  while ((1 << nplanes_) <= hmax) nplanes_++;
+  for (int b = 0; b < nplanes_; b++) {
+    planes_[b] = 0;
+    for (int k = 0; k < PDM_CIC_LEN; k++)
+      if ((h[k] >> b) & 1) planes_[b] |= 1ull << k;
+  }
+#endif
+
+  // ---------- FIR：Kaiser 窗 sinc（约 80 dB），截止在通带 / 阻带中点 ----------
+  // 频率都按 FIR 输入速率（= decim_ × 输出采样率）归一化
+  const int n = PDM_FIR_TAPS_PER_DECIM * decim_ + 1;
+  const double fc   = 0.5 / decim_;                 // 输出 Nyquist，通带 / 阻带关于它对称
+  const double beta = 7.86;
+  // 设计用的临时数组（lp n 个 + full n + 2 个 double，osr 128 时约 6 KB）从堆上借，设计完就还：
+  // 放静态区会永久占着内部 RAM，放栈上又会撑爆调用方的任务栈
+  double* const lp   = new double[2 * n + 2];
+  double* const full = lp + n;
+  for (int i = 0; i < n; i++) {
+    const double m = i - (n - 1) / 2.0;
+    const double sinc = m == 0 ? 2 * fc : sin(2 * kPi * fc * m) / (kPi * m);
+    const double r = 2.0 * i / (n - 1) - 1;
+    lp[i] = sinc * bessel_i0(beta * sqrt(1 - r * r)) / bessel_i0(beta);
+  }
+
+  // CIC 在通带边缘的下垂，用 3 阶 [-a, 1+2a, -a] 补回来
+  const double x = passband / decim_;               // 通带边缘，FIR 输入速率归一化
+  const double num = sin(kPi * x), den = PDM_CIC_DECIM * sin(kPi * x / PDM_CIC_DECIM);
+  const double droop = pow(num / den, PDM_CIC_ORDER);
+  const double a = (1 / droop - 1) / (2 * (1 - cos(2 * kPi * x)));
+  const double comp[3] = {-a, 1 + 2 * a, -a};
+
+  taps_ = n + 2;
+  double sum = 0;
+  for (int i = 0; i < taps_; i++) full[i] = 0;
+  for (int i = 0; i < n; i++)
+    for (int j = 0; j < 3; j++) full[i + j] += lp[i] * comp[j];
+  for (int i = 0; i < taps_; i++) sum += full[i];
+
+  // CIC 直流增益 Σh = 16^4，位值 ±1 → 满量程
+  const double scale = 1.0 / (sum * cic_gain_);
+  for (int i = 0; i < taps_; i++) fir_[i] = (float)(full[i] * scale);
+  delete[] lp;
+
+  reset();
+}
+
+void PdmDecimator::reset() {
+  reg_   = 0xAAAAAAAAAAAAAAAAull;   // 交替位 = 0 电平
+  pos_   = 0;
+  phase_ = 0;
+  memset(hist_, 0, sizeof(hist_));
+}
+
+inline void PdmDecimator::push_cic(int32_t v, int16_t* out, int* n) {
+  pos_ = pos_ == 0 ? taps_ - 1 : pos_ - 1;
+  hist_[pos_] = hist_[pos_ + taps_] = (float)v;
+  if (++phase_ < decim_) return;
+  phase_ = 0;
+
+  const float* w = hist_ + pos_;   // w[0] 最新
+  float acc = 0;
+  for (int i = 0; i < taps_; i++) acc += fir_[i] * w[i];
+
+  int32_t s = (int32_t)lrintf(acc * 32767.0f);
+  if (s > 32767) s = 32767;
+  if (s < -32768) s = -32768;
+  out[(*n)++] = (int16_t)s;
+}
+
+int IRAM_ATTR PdmDecimator::process(const uint32_t* words, int nwords, int16_t* out) {
+  int n = 0;
+  for (int i = 0; i < nwords; i++) {
+    const uint32_t w = words[i];
+    for (int half = 0; half < 2; half++) {
+      reg_ = (reg_ << 16) | (half == 0 ? (w >> 16) : (w & 0xFFFF));
+      const uint64_t r = reg_;
+      int32_t ones = 0;
+#if PDM_CIC_KERNEL == PDM_CIC_KERNEL_LUT
+      ones = lut_[0][(uint8_t)r]         + lut_[1][(uint8_t)(r >> 8)]  +
+             lut_[2][(uint8_t)(r >> 16)] + lut_[3][(uint8_t)(r >> 24)] +
+             lut_[4][(uint8_t)(r >> 32)] + lut_[5][(uint8_t)(r >> 40)] +
+             lut_[6][(uint8_t)(r >> 48)] + lut_[7][(uint8_t)(r >> 56)];
+#else
+      for (int b = 0; b < nplanes_; b++)
+        ones += __builtin_popcountll(r & planes_[b]) << b;
+#endif
+      push_cic(2 * ones - cic_gain_, out, &n);   // 单极性 → 双极性
+    }
+  }
+  return n;
+}
@@ -0,0 +1,85 @@
+#pragma once
+// =================================================
+// 软件 PDM 抽取：1 bit 位流 → int16 PCM
+// -------------------------------------------------
+// 第一级：4 阶 CIC，抽取 16，直接按冲激响应 h（长 61）对最近 64 个位求加权和，
+//   不需要逐位积分，没有溢出问题。内核在编译期选择（PDM_CIC_KERNEL）：
+//   POPCOUNT：h 按二进制位拆成位平面掩码，输出 = Σ_b popcount(位 & 平面 b) << b，
+//             有硬件 popcount 的平台（x86 / ARM 主机）最快
+//   LUT     ：64 位按字节查表，输出 = Σ_p T[p][字节 p]，8 次查表（表 8 KB），
+//             Xtensa 没有 popcount 指令，用这个（默认）
+//   两者逐位相同
+// 第二级：多相 FIR，抽取 osr/16
+//   Kaiser 窗 sinc 低通，卷上 3 阶 CIC 下垂补偿 [-a, 1+2a, -a]，
+//   a 按通带边缘处的 CIC 衰减算出，使通带边缘增益回到 1
+//
+// 位流格式：32 位字，高位先到（I2S 标准模式按 MSB 先移位），1 = +1，0 = -1
+// osr = 位时钟 / 输出采样率，取 16 的倍数，32 ~ 128
+// 合成位流上的 SNR / 通带 / 混叠测试见 tools/pdm_bench
+// =================================================
+
+#include <stdint.h>
+
+#define PDM_CIC_KERNEL_POPCOUNT 0
+#define PDM_CIC_KERNEL_LUT      1
+
+#ifndef PDM_CIC_KERNEL
+#if defined(__XTENSA__)
+#define PDM_CIC_KERNEL PDM_CIC_KERNEL_LUT
+#else
+#define PDM_CIC_KERNEL PDM_CIC_KERNEL_POPCOUNT
+#endif
+#endif
+
+#define PDM_CIC_ORDER     4
+#define PDM_CIC_DECIM     16
+#define PDM_CIC_LEN       (PDM_CIC_ORDER * (PDM_CIC_DECIM - 1) + 1)   // 61 ≤ 64
+#define PDM_CIC_PLANES    13     // 最大系数 < 2^13
+#define PDM_OSR_MAX       128
+#define PDM_FIR_TAPS_PER_DECIM 48                                    // FIR 长度 ≈ 48 × (osr/16)
+#define PDM_FIR_MAX_TAPS  (PDM_FIR_TAPS_PER_DECIM * (PDM_OSR_MAX / PDM_CIC_DECIM) + 3)
+
+// 原地交换每对 32 位字（立体声 DMA 缓冲里两个槽的先后和线上相反时用，见 PDM_SW_SLOT_SWAP），
+// 奇数个字时最后一个不动
+static inline void pdm_swap_slots(uint32_t* words, int nwords) {
+  for (int i = 0; i + 1 < nwords; i += 2) {
+    const uint32_t t = words[i];
+    words[i] = words[i + 1];
+    words[i + 1] = t;
+  }
+}
+
+class PdmDecimator {
+ public:
+  // passband = 通带边缘 / 输出采样率（阻带从 1 - passband 开始）
+  explicit PdmDecimator(int osr, float passband = 0.45f);
+
+  // 输入 nwords 个 32 位字，输出写到 out，返回输出样本数
+  // 每次调用的位数不必是 osr 的整数倍，余下的相位留到下次
+  int process(const uint32_t* words, int nwords, int16_t* out);
+
+  void reset();
+
+  int osr() const { return osr_; }
+  int fir_taps() const { return taps_; }
+
+ private:
+  inline void push_cic(int32_t v, int16_t* out, int* n);
+
+  int osr_;
+  int decim_;                       // FIR 抽取倍数 = osr / 16
+  uint64_t reg_;                    // 最近 64 个位，bit0 最新
+#if PDM_CIC_KERNEL == PDM_CIC_KERNEL_LUT
+  int32_t lut_[8][256];             // lut_[p][v] = 字节 p 取值 v 时的贡献
+#else
+  uint64_t planes_[PDM_CIC_PLANES];
+  int nplanes_;
+#endif
+  int32_t cic_gain_;                // Σh
+
+  float fir_[PDM_FIR_MAX_TAPS];
+  int taps_;
+  float hist_[2 * PDM_FIR_MAX_TAPS];   // 双份环形缓冲，窗口永远连续
+  int pos_;
+  int phase_;
+};
@@ -0,0 +1,93 @@
+#include "pop_guard.h"
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include <esp_attr.h>
+#else
+#define IRAM_ATTR
+#endif
+
+PopGuard::PopGuard(uint32_t sample_rate)
+    : ramp_(GainRamp::kUnity / (int32_t)(sample_rate * POP_RAMP_MS / 1000), true) {
+  startup_samples_ = (int32_t)(sample_rate * POP_STARTUP_MS / 1000);
+  hold_samples_    = (int32_t)(sample_rate * POP_HOLD_MS / 1000);
+  env_  = 0;
+  prev_ = 0;
+  stats_ = PopStats{};
+  restart();
+}
+
+void PopGuard::restart() {
+  ramp_.mute();
+  startup_ = startup_samples_ > 0 ? startup_samples_ : 1;
+  hold_    = 0;
+}
+
+void IRAM_ATTR PopGuard::process(const int16_t* in, int16_t* out, int n) {
+  // ---------- 检测：第一个坏样本的位置 ----------
+  int32_t thresh = (int32_t)((env_ >> 8) * POP_JUMP_RATIO);
+  if (thresh < POP_JUMP_MIN) thresh = POP_JUMP_MIN;
+
+  int bad = -1;
+  bool by_clip = false;
+  int clipped = 0;
+  int64_t sum_d = 0;
+  int32_t prev = prev_;
+  for (int i = 0; i < n; i++) {
+    const int32_t x = in[i];
+    const int32_t d = x > prev ? x - prev : prev - x;
+    prev = x;
+    sum_d += d;
+    if (bad >= 0) continue;
+    if (d > thresh) {
+      bad = i;
+    } else if ((x >= POP_CLIP_LEVEL || x <= -POP_CLIP_LEVEL) && ++clipped >= POP_CLIP_SAMPLES) {
+      bad     = i - POP_CLIP_SAMPLES + 1 > 0 ? i - POP_CLIP_SAMPLES + 1 : 0;
+      by_clip = true;
+    }
+  }
+  // 启动时 prev_ 是 0，第一块的台阶不算数（反正在启动静音里）
+  prev_ = prev;
+  env_ += ((sum_d << 8) - env_ * n) >> POP_ENV_SHIFT;
+
+  if (out != in) memcpy(out, in, n * sizeof(int16_t));
+
+  // ---------- 启动静音 ----------
+  if (startup_ > 0) {
+    memset(out, 0, n * sizeof(int16_t));
+    stats_.muted_samples += n;
+    startup_ -= n;
+    if (startup_ <= 0) ramp_.fade_in();
+    return;
+  }
+
+  // ---------- 坏块：淡到坏样本为止，之后静音 ----------
+  if (bad >= 0) {
+    if (hold_ == 0 && ramp_.gain() > 0) {
+      stats_.events++;
+      if (by_clip) stats_.clips++;
+      else stats_.jumps++;
+    }
+    const int32_t g0 = ramp_.gain();
+    for (int i = 0; i < bad; i++) out[i] = (int16_t)((out[i] * (g0 * (bad - i) / (bad + 1))) >> 15);
+    memset(out + bad, 0, (n - bad) * sizeof(int16_t));
+    ramp_.mute();
+    hold_ = hold_samples_ > 0 ? hold_samples_ : 1;
+    stats_.muted_samples += n - bad;
+    return;
+  }
+
+  // ---------- 保持静音，到时淡入 ----------
+  if (hold_ > 0) {
+    memset(out, 0, n * sizeof(int16_t));
+    stats_.muted_samples += n;
+    hold_ -= n;
+    if (hold_ <= 0) {
+      hold_ = 0;
+      ramp_.fade_in();
+    }
+    return;
+  }
+
+  ramp_.apply(out, n);
+}
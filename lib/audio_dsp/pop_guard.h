@@ -0,0 +1,63 @@
+#pragma once
+// =================================================
+// 爆音保护：启动爆音、DMA 垃圾数据、饱和突发，在出问题的那一块里就静音
+// -------------------------------------------------
+// 放在 i2s 读回来之后、所有处理和上行之前（单声道）。
+// 检测（逐样本，没有前视）：
+//   跳变：相邻样本差 |x[i] - x[i-1]| 超过 max(POP_JUMP_MIN, POP_JUMP_RATIO × 平均差分)，
+//         平均差分按块一阶跟踪（时间常数 2^POP_ENV_SHIFT 个样本，约 190 ms）。
+//         正常信号的单样本跳变受带宽限制，远小于满量程；垃圾数据 / 拔插 / 位错是突然的大台阶
+//   饱和：一块里 |x| ≥ POP_CLIP_LEVEL 的样本数达到 POP_CLIP_SAMPLES
+//   （没有前视：削顶之前那段上升沿还是会放过去，要再早只能加延迟）
+// 动作：从块开头到第一个坏样本之前线性淡到 0，坏样本起静音；
+//   最后一次检测后保持静音 POP_HOLD_MS，再用 POP_RAMP_MS 淡入
+// 启动（以及 restart() 之后，比如 I2S 重建）先静音 POP_STARTUP_MS，再淡入；这段时间只学习平均差分
+// 平均差分在静音期间照样跟踪：持续的大信号（真有人大声说话）过一会儿就会放行，
+// 不会像主机上那样因为“持续大音量”一直断开
+// =================================================
+
+#include <stdint.h>
+#include "gain_ramp.h"
+
+#ifndef POP_STARTUP_MS
+#define POP_STARTUP_MS    100     // 上电 / 重建后静音（麦克风和 DMA 稳定时间）
+#endif
+#ifndef POP_JUMP_MIN
+#define POP_JUMP_MIN      12000   // 单样本跳变绝对门限（约 -8.7 dBFS）
+#endif
+#define POP_JUMP_RATIO    16      // 相对平均差分的倍数（24 dB）
+#define POP_ENV_SHIFT     13      // 平均差分跟踪时间常数 2^13 样本
+#define POP_CLIP_LEVEL    32000
+#define POP_CLIP_SAMPLES  3
+#define POP_HOLD_MS       20
+#define POP_RAMP_MS       5
+
+struct PopStats {
+  uint32_t events;         // 检测到的爆音事件（静音期间的重复检测不算）
+  uint32_t jumps;          // 其中由跳变触发的
+  uint32_t clips;          // 其中由饱和触发的
+  uint32_t muted_samples;  // 累计静音样本（含启动）
+};
+
+class PopGuard {
+ public:
+  explicit PopGuard(uint32_t sample_rate);
+
+  // 单声道；可以原地（out == in）
+  void process(const int16_t* in, int16_t* out, int n);
+
+  // 重新走一遍启动静音（I2S 重建之后调用）
+  void restart();
+
+  bool muted() const { return ramp_.gain() == 0; }
+  const PopStats& stats() const { return stats_; }
+
+ private:
+  GainRamp ramp_;
+  int32_t startup_samples_, hold_samples_;
+  int32_t startup_;   // 剩余启动静音样本
+  int32_t hold_;      // 剩余保持静音样本
+  int64_t env_;       // 平均 |差分|，Q8
+  int32_t prev_;
+  PopStats stats_;
+};
@@ -0,0 +1,123 @@
+#include "resampler.h"
+#include <math.h>
+#include <string.h>
+
+#if defined(ESP_PLATFORM)
+#include <esp_attr.h>
+#else
+#define IRAM_ATTR
+#endif
+
+static const double kPi = 3.14159265358979323846;
+static const int kArbShift = 32 - 7;   // Q32 相位 → 相号（RESAMPLE_ARB_PHASES = 128）
+static_assert((1 << (32 - kArbShift)) == RESAMPLE_ARB_PHASES, "kArbShift 和 RESAMPLE_ARB_PHASES 不一致");
+static_assert(RESAMPLE_ARB_PHASES < RESAMPLE_MAX_PHASES, "系数表放不下 ARBITRARY 的相数");
+
+// 零阶修正贝塞尔函数（Kaiser 窗）
+static double bessel_i0(double x) {
+  double sum = 1, term = 1;
+  for (int k = 1; k < 30; k++) {
+    term *= (x / (2 * k)) * (x / (2 * k));
+    sum += term;
+  }
+  return sum;
+}
+
+static uint32_t gcd(uint32_t a, uint32_t b) {
+  while (b) { uint32_t t = a % b; a = b; b = t; }
+  return a;
+}
+
+Resampler::Resampler(uint32_t in_rate, uint32_t out_rate, Mode mode) {
+  const uint32_t g = gcd(in_rate, out_rate);
+  in_step_  = in_rate / g;    // M
+  out_step_ = out_rate / g;   // L
+  if (mode == AUTO) mode = out_step_ <= RESAMPLE_MAX_PHASES ? FIXED : ARBITRARY;
+  if (mode == FIXED && out_step_ > RESAMPLE_MAX_PHASES) mode = ARBITRARY;
+  mode_   = mode;
+  phases_ = mode == FIXED ? out_step_ : RESAMPLE_ARB_PHASES;
+  step_   = (uint64_t)(((double)in_rate / out_rate) * 4294967296.0 + 0.5);
+
+  // ---------- 原型：Kaiser 窗 sinc（约 75 dB），t 以输入样本为单位，中心在 TAPS/2 ----------
+  // 第 p 相第 j 个抽头（乘 x[n-j]）到输出时刻的距离是 p/P + j
+  const double fc   = RESAMPLE_CUTOFF * (out_rate < in_rate ? (double)out_rate / in_rate : 1.0);
+  const double beta = 7.3;
+  const double half = RESAMPLE_TAPS / 2.0;
+  const uint32_t rows = mode_ == FIXED ? phases_ : phases_ + 1;
+  for (uint32_t p = 0; p < rows; p++) {
+    double row[RESAMPLE_TAPS];
+    double sum = 0;
+    for (int j = 0; j < RESAMPLE_TAPS; j++) {
+      const double u = (double)p / phases_ + j - half;
+      const double sinc = u == 0 ? 2 * fc : sin(2 * kPi * fc * u) / (kPi * u);
+      const double r = u / half;
+      row[j] = r * r >= 1 ? 0 : sinc * bessel_i0(beta * sqrt(1 - r * r)) / bessel_i0(beta);
+      sum += row[j];
+    }
+    // 每相单独归一到 Σ = 1.0（Q15 32768），各相直流增益一致，不会把相位抖动调制成噪声
+    int32_t qsum = 0;
+    int jmax = 0;
+    for (int j = 0; j < RESAMPLE_TAPS; j++) {
+      const int32_t q = (int32_t)lrint(row[j] / sum * 32768.0);
+      h_[p][RESAMPLE_TAPS - 1 - j] = (int16_t)(q > 32767 ? 32767 : q);
+      qsum += h_[p][RESAMPLE_TAPS - 1 - j];
+      if (fabs(row[j]) > fabs(row[jmax])) jmax = j;
+    }
+    h_[p][RESAMPLE_TAPS - 1 - jmax] += (int16_t)(32768 - qsum);   // 舍入误差补到最大的抽头上
+  }
+  reset();
+}
+
+void Resampler::reset() {
+  memset(hist_, 0, sizeof(hist_));
+  pos_   = 0;
+  phase_ = 0;
+}
+
+void Resampler::set_ratio(double ratio) {
+  if (mode_ != ARBITRARY || ratio <= 0) return;
+  step_     = (uint64_t)(4294967296.0 / ratio + 0.5);
+  in_step_  = 1 << 16;
+  out_step_ = (uint32_t)ceil(ratio * 65536.0);
+}
+
+inline int32_t Resampler::dot(const int16_t* x, const int16_t* h) const {
+  int32_t acc = 0;
+  for (int j = 0; j < RESAMPLE_TAPS; j++) acc += (int32_t)x[j] * h[j];
+  return acc;
+}
+
+static inline int16_t round_q15(int32_t acc) {
+  acc = (acc + (1 << 14)) >> 15;
+  if (acc > 32767) acc = 32767;
+  if (acc < -32768) acc = -32768;
+  return (int16_t)acc;
+}
+
+int IRAM_ATTR Resampler::process(const int16_t* in, int n, int16_t* out) {
+  int produced = 0;
+  for (int i = 0; i < n; i++) {
+    hist_[pos_] = hist_[pos_ + RESAMPLE_TAPS] = in[i];
+    if (++pos_ == RESAMPLE_TAPS) pos_ = 0;
+    const int16_t* x = hist_ + pos_;   // 最老 → 最新
+
+    if (mode_ == FIXED) {
+      while (phase_ < out_step_) {
+        out[produced++] = round_q15(dot(x, h_[phase_]));
+        phase_ += in_step_;
+      }
+      phase_ -= out_step_;
+    } else {
+      while (phase_ < (1ull << 32)) {
+        const uint32_t p  = (uint32_t)(phase_ >> kArbShift);
+        const int32_t  mu = (int32_t)(phase_ >> (kArbShift - 15)) & 0x7FFF;
+        const int32_t  a  = dot(x, h_[p]);
+        const int32_t  b  = dot(x, h_[p + 1]);
+        out[produced++] = round_q15(a + (int32_t)(((int64_t)(b - a) * mu) >> 15));
+        phase_ += step_;
+      }
+      phase_ -= 1ull << 32;
+    }
+  }
+  return produced;
+}
@@ -0,0 +1,66 @@
+#pragma once
+// =================================================
+// 多相重采样：int16 单声道，in_rate → out_rate
+// -------------------------------------------------
+// 原型低通：Kaiser 窗 sinc，每相 RESAMPLE_TAPS 个抽头，截止在 min(in, out) 的
+//   RESAMPLE_CUTOFF 处，系数 Q15，累加 int32（每相 Σ|h| < 2，不会溢出）
+// 两种模式：
+//   FIXED     ：in:out 约分成 M:L（44100:48000 → 147:160），L ≤ RESAMPLE_MAX_PHASES 时可用。
+//               L 相系数表，相位按整数步进，没有累积误差
+//   ARBITRARY ：任意比例（可以运行时用 set_ratio 微调，跟踪时钟漂移）。
+//               RESAMPLE_ARB_PHASES 相系数表，相邻两相的输出按小数相位线性插值，
+//               每个输出要算两次点积
+//   AUTO      ：能 FIXED 就 FIXED，否则 ARBITRARY
+//
+// 相位约定：推入 x[n] 后，产生所有落在 [n, n+1) 上的输出；第 p 相（p/L 个样本处）
+//   y = Σ_j h[p + jL] · x[n - j]，整体群延迟 RESAMPLE_TAPS / 2 个输入样本
+// =================================================
+
+#include <stdint.h>
+
+#ifndef RESAMPLE_TAPS
+#define RESAMPLE_TAPS        48     // 每相抽头数（约 75 dB 阻带）
+#endif
+#define RESAMPLE_MAX_PHASES  160    // FIXED 模式的 L 上限（147:160 正好放下）
+#define RESAMPLE_ARB_PHASES  128    // ARBITRARY 模式的相数（2 的幂）
+#define RESAMPLE_CUTOFF      0.45   // 截止 = RESAMPLE_CUTOFF × min(in, out)
+
+class Resampler {
+ public:
+  enum Mode { AUTO, FIXED, ARBITRARY };
+
+  Resampler(uint32_t in_rate, uint32_t out_rate, Mode mode = AUTO);
+
+  // 输入 n 个样本，输出写到 out（容量至少 max_output(n)），返回输出样本数
+  // 余下的小数相位留到下次，块长任意
+  int process(const int16_t* in, int n, int16_t* out);
+
+  // n 个输入最多产生的输出数
+  int max_output(int n) const { return (int)((uint64_t)n * out_step_ / in_step_) + 2; }
+
+  // 仅 ARBITRARY：把比例改成 out/in = ratio（相对设计值别偏太多，滤波器不重算）
+  void set_ratio(double ratio);
+
+  void reset();
+
+  Mode mode() const { return mode_; }
+  uint32_t phases() const { return phases_; }
+
+ private:
+  inline int32_t dot(const int16_t* x, const int16_t* h) const;
+
+  Mode mode_;
+  uint32_t phases_;       // FIXED: L；ARBITRARY: RESAMPLE_ARB_PHASES
+  // FIXED：phase_ 以 1/L 输入样本为单位，每个输出 += in_step_（M），越过 L 就要下一个输入
+  // ARBITRARY：phase_ 是 Q32 小数位置，每个输出 += step_
+  uint32_t in_step_;
+  uint32_t out_step_;
+  uint64_t step_;
+  uint64_t phase_;
+
+  // 系数按相存放、按时间倒序（h_[p][0] 乘最老的样本），点积对着历史窗口顺序走
+  // ARBITRARY 多存一相（第 P 相 = 第 0 相移一个样本），插值不用回绕
+  int16_t h_[RESAMPLE_MAX_PHASES + 1][RESAMPLE_TAPS];
+  int16_t hist_[2 * RESAMPLE_TAPS];   // 双份环形缓冲，窗口永远连续
+  int pos_;
+};
@@ -0,0 +1,216 @@
+#include "runtime_chain.h"
+#include <math.h>
+#include <string.h>
+#include "biquad_design.h"
+#include "gain_kernel.h"
+
+#if defined(ESP_PLATFORM)
+#include <esp_attr.h>
+#else
+#define IRAM_ATTR
+#endif
+
+#define RT_RAMP_FRAC 10
+
+// =================================================
+// 控制任务一侧
+// =================================================
+static int32_t to_q28(float c) {
+  return (int32_t)(c * (float)(1 << BIQUAD_Q_SHIFT) + (c >= 0 ? 0.5f : -0.5f));
+}
+
+bool dsp_params_set_sos(DspParams* p, const BiquadCoeffs* s, int sections) {
+  if (sections < 0 || sections > RT_MAX_SECTIONS) return false;
+  for (int k = 0; k < sections; k++) {
+    const BiquadCoeffs& c = s[k];
+    // 稳定三角形：|a2| < 1，|a1| < 1 + a2；Q4.28 只能表示 ±8
+    if (!(fabsf(c.a2) < 1.0f && fabsf(c.a1) < 1.0f + c.a2)) return false;
+    if (!(fabsf(c.b0) < 8.0f && fabsf(c.b1) < 8.0f && fabsf(c.b2) < 8.0f)) return false;
+  }
+  // 没用到的段清零，音频任务按 memcmp 判断系数是否变了
+  memset(p->sos, 0, sizeof(p->sos));
+  for (int k = 0; k < sections; k++) {
+    p->sos[k] = {to_q28(s[k].b0), to_q28(s[k].b1), to_q28(s[k].b2), to_q28(s[k].a1), to_q28(s[k].a2)};
+  }
+  p->sections = sections;
+  return true;
+}
+
+bool dsp_params_set_butter(DspParams* p, float sample_rate, int type, float lo_hz, float hi_hz) {
+  const float nyq = sample_rate / 2;
+  switch (type) {
+    case RT_FILTER_NONE:
+      return dsp_params_set_sos(p, nullptr, 0);
+    case RT_FILTER_BANDPASS: {
+      if (!(lo_hz > 0 && lo_hz < hi_hz && hi_hz < nyq)) return false;
+      const auto sos = butter_bandpass<4>(sample_rate, lo_hz, hi_hz);
+      return dsp_params_set_sos(p, sos.s, sos.kSections);
+    }
+    case RT_FILTER_LOWPASS: {
+      if (!(hi_hz > 0 && hi_hz < nyq)) return false;
+      const auto sos = butter_lowpass<4>(sample_rate, hi_hz);
+      return dsp_params_set_sos(p, sos.s, sos.kSections);
+    }
+    case RT_FILTER_HIGHPASS: {
+      if (!(lo_hz > 0 && lo_hz < nyq)) return false;
+      const auto sos = butter_highpass<4>(sample_rate, lo_hz);
+      return dsp_params_set_sos(p, sos.s, sos.kSections);
+    }
+  }
+  return false;
+}
+
+bool dsp_params_set_gain(DspParams* p, float gain) {
+  if (!(gain >= 0.0f && gain < 16.0f)) return false;
+  p->gain_q12 = gain_to_q12(gain);
+  return true;
+}
+
+void dsp_params_set_ceiling(DspParams* p, float ceiling_dbfs) {
+  p->ceiling = ceiling_dbfs >= 0 ? 32767 : (int32_t)lrintf(32767.0f * powf(10.0f, ceiling_dbfs / 20.0f));
+}
+
+// =================================================
+// 音频任务一侧
+// =================================================
+static inline int32_t clamp_ceiling(int32_t c) {
+  return c > 32767 ? 32767 : (c < 0 ? 0 : c);
+}
+
+RuntimeChain::RuntimeChain(uint32_t sample_rate, const DspParams& initial, float ramp_ms)
+    : swap_(initial) {
+  ramp_len_ = (int32_t)(sample_rate * ramp_ms / 1000);
+  memset(s1_, 0, sizeof(s1_));
+  memset(s2_, 0, sizeof(s2_));
+  bank_  = 0;
+  xfade_ = 0;
+  xw_    = 0;
+  xstep_ = ramp_len_ > 0 ? 32768 / ramp_len_ : 0;
+  g_ = initial.gain_q12 << RT_RAMP_FRAC;
+  c_ = clamp_ceiling(initial.ceiling) << RT_RAMP_FRAC;
+  g_step_ = c_step_ = 0;
+  ramp_ = 0;
+}
+
+bool RuntimeChain::update() {
+  const DspParams* p = swap_.acquire();
+  if (p == nullptr) return false;
+  const DspParams& old = swap_.previous();
+
+  // ---------- 输出级：从当前值斜坡过去 ----------
+  const int32_t g_to = p->gain_q12 << RT_RAMP_FRAC;
+  const int32_t c_to = clamp_ceiling(p->ceiling) << RT_RAMP_FRAC;
+  if (ramp_len_ > 0 && (g_to != g_ || c_to != c_)) {
+    g_step_ = (g_to - g_) / ramp_len_;
+    c_step_ = (c_to - c_) / ramp_len_;
+    ramp_   = ramp_len_;
+  } else {
+    g_ = g_to;
+    c_ = c_to;
+    ramp_ = 0;
+  }
+
+  // ---------- 滤波：系数变了才换状态组、交叉淡化 ----------
+  const bool same = p->sections == old.sections &&
+                    memcmp(p->sos, old.sos, sizeof(RtSection) * p->sections) == 0;
+  if (!same) {
+    const int nb = 1 - bank_;
+    if (p->sections == old.sections) {
+      memcpy(s1_[nb], s1_[bank_], sizeof(s1_[nb]));
+      memcpy(s2_[nb], s2_[bank_], sizeof(s2_[nb]));
+    } else {
+      memset(s1_[nb], 0, sizeof(s1_[nb]));
+      memset(s2_[nb], 0, sizeof(s2_[nb]));
+    }
+    bank_ = nb;
+    if (ramp_len_ > 0) {
+      xfade_ = ramp_len_;
+      xw_    = 0;
+      return true;   // 旧系数淡化完才放手
+    }
+  }
+  swap_.release();
+  return true;
+}
+
+// 段优先，和 BiquadCascadeQ28::process 同样的算术
+static inline void cascade(const DspParams& p, int64_t* s1, int64_t* s2, int32_t* buf, int n) {
+  const int64_t round = (int64_t)1 << (BIQUAD_Q_SHIFT - 1);
+  for (int k = 0; k < p.sections; k++) {
+    const int64_t b0 = p.sos[k].b0, b1 = p.sos[k].b1, b2 = p.sos[k].b2;
+    const int64_t a1 = p.sos[k].a1, a2 = p.sos[k].a2;
+    int64_t z1 = s1[k], z2 = s2[k];
+    for (int i = 0; i < n; i++) {
+      const int64_t x = buf[i];
+      const int32_t y = (int32_t)((b0 * x + z1 + round) >> BIQUAD_Q_SHIFT);
+      z1 = b1 * x - a1 * y + z2;
+      z2 = b2 * x - a2 * y;
+      buf[i] = y;
+    }
+    s1[k] = z1;
+    s2[k] = z2;
+  }
+}
+
+void RuntimeChain::filter_chunk(const int16_t* in, int16_t* out, int n) {
+  int32_t cur[RT_CHUNK];
+  for (int i = 0; i < n; i++) cur[i] = (int32_t)in[i] << BIQUAD_GUARD_BITS;
+
+  if (xfade_ > 0) {
+    int32_t old[RT_CHUNK];
+    memcpy(old, cur, n * sizeof(int32_t));
+    cascade(swap_.previous(), s1_[1 - bank_], s2_[1 - bank_], old, n);
+    cascade(params(), s1_[bank_], s2_[bank_], cur, n);
+    for (int i = 0; i < n; i++) {
+      if (xfade_ > 0) {
+        xw_ = --xfade_ > 0 ? xw_ + xstep_ : 32768;
+      }
+      cur[i] = (int32_t)(((int64_t)old[i] * (32768 - xw_) + (int64_t)cur[i] * xw_) >> 15);
+    }
+    if (xfade_ == 0) swap_.release();
+  } else {
+    cascade(params(), s1_[bank_], s2_[bank_], cur, n);
+  }
+
+  const int32_t round = 1 << (BIQUAD_GUARD_BITS - 1);
+  for (int i = 0; i < n; i++) {
+    const int32_t v = (cur[i] + round) >> BIQUAD_GUARD_BITS;
+    out[i] = (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+  }
+}
+
+const int16_t* IRAM_ATTR RuntimeChain::filter(const int16_t* in, int16_t* work, int n) {
+  if (params().sections == 0 && xfade_ == 0) return in;
+  for (int pos = 0; pos < n; pos += RT_CHUNK) {
+    const int m = n - pos < RT_CHUNK ? n - pos : RT_CHUNK;
+    filter_chunk(in + pos, work + pos, m);
+  }
+  return work;
+}
+
+void IRAM_ATTR RuntimeChain::output(const int16_t* in, int16_t* out, int n) {
+  // 稳态、不限幅：和固定增益时同一个内核
+  if (ramp_ == 0 && c_ >= (32767 << RT_RAMP_FRAC)) {
+    gain_interleave(in, out, n, g_ >> RT_RAMP_FRAC);
+    return;
+  }
+  for (int i = 0; i < n; i++) {
+    if (ramp_ > 0) {
+      if (--ramp_ > 0) {
+        g_ += g_step_;
+        c_ += c_step_;
+      } else {
+        g_ = params().gain_q12 << RT_RAMP_FRAC;
+        c_ = clamp_ceiling(params().ceiling) << RT_RAMP_FRAC;
+      }
+    }
+    const int32_t g = g_ >> RT_RAMP_FRAC, c = c_ >> RT_RAMP_FRAC;
+    const int32_t acc = (int32_t)in[i] * g;
+    int32_t v = acc >= 0 ? (acc >> GAIN_Q_SHIFT) : -((-acc) >> GAIN_Q_SHIFT);   // 向零截断，同 gain_interleave
+    const int32_t lo = c >= 32767 ? -32768 : -c;
+    if (v > c) v = c;
+    if (v < lo) v = lo;
+    out[2 * i]     = (int16_t)v;
+    out[2 * i + 1] = (int16_t)v;
+  }
+}
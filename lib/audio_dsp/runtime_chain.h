@@ -0,0 +1,94 @@
+#pragma once
+// =================================================
+// 运行时可调的 DSP 级：前置滤波 + 输出增益 / 限幅，参数不用重新烧录就能换
+// -------------------------------------------------
+// 对应 audio_filter.py 里 SimpleAudioProcessor.update_filter / update_gain。
+// 一整套参数（DspParams）由控制任务算好、量化好，经 ParamSwap 双缓冲发布；
+// 音频任务每块开头 update() 一次原子读，有新参数就在块边界切换：
+//   滤波：系数变了时另一组状态从当前状态起步，新旧两组并行跑 RT_RAMP_MS，
+//         输出按 Q15 线性权重交叉淡化，之后只跑新的（淡化期间旧系数留在旧槽位里，淡化完才放手）
+//   增益 / 限幅：从当前值线性斜坡到新值，同样 RT_RAMP_MS
+// 稳态时滤波和 BiquadCascadeQ28 逐位相同，输出级没有限幅时直接走 gain_interleave
+// 音频路径上没有锁、没有浮点、不设计滤波器；设计和量化都在 dsp_params_* 里（控制任务调用）
+// =================================================
+
+#include <stdint.h>
+#include <param_swap.h>
+#include "biquad.h"
+
+#define RT_MAX_SECTIONS  4       // 4 阶带通 = 4 段
+#ifndef RT_RAMP_MS
+#define RT_RAMP_MS       5.0f    // 交叉淡化 / 斜坡时长
+#endif
+#define RT_CHUNK         32      // 内部按这么多样本一段处理（栈上暂存）
+
+// 滤波类型，取值和 audio_config.h 的 FILTER_* 相同
+#define RT_FILTER_NONE      0
+#define RT_FILTER_BANDPASS  1
+#define RT_FILTER_LOWPASS   2
+#define RT_FILTER_HIGHPASS  3
+
+// 一段 biquad，Q4.28（和 BiquadCascadeQ28 同样的量化）
+struct RtSection {
+  int32_t b0, b1, b2, a1, a2;
+};
+
+struct DspParams {
+  int32_t   sections;                // 前置滤波段数，0 = 直通
+  RtSection sos[RT_MAX_SECTIONS];
+  int32_t   gain_q12;                // 输出增益 Q4.12（< 16 倍）
+  int32_t   ceiling;                 // 输出限幅（int16 幅度），≥ 32767 = 不限
+  float     agc_target_db;           // 链外的级用的门限，音频任务在 update() 返回 true 时自己取
+  float     agc_max_gain_db;
+};
+
+// ---------- 控制任务一侧：设计 / 量化 / 检查 ----------
+
+// 系数不稳定（极点不在单位圆内）或段数超出时返回 false，p 不变
+bool dsp_params_set_sos(DspParams* p, const BiquadCoeffs* s, int sections);
+// 4 阶 Butterworth（和编译期 FILTER_TYPE 同一套设计）；频率不合理时返回 false
+bool dsp_params_set_butter(DspParams* p, float sample_rate, int type, float lo_hz, float hi_hz);
+// 增益超出 [0, 16) 时返回 false
+bool dsp_params_set_gain(DspParams* p, float gain);
+// ceiling_dbfs ≥ 0 表示不限
+void dsp_params_set_ceiling(DspParams* p, float ceiling_dbfs);
+
+class RuntimeChain {
+ public:
+  // ramp_ms = 0 时硬切换（只给主机对比用）
+  RuntimeChain(uint32_t sample_rate, const DspParams& initial, float ramp_ms = RT_RAMP_MS);
+
+  // ---------- 控制任务 ----------
+
+  // 上一套参数还在淡化时返回 false（稍后重试）
+  bool publish(const DspParams& p) { return swap_.publish(p); }
+  bool busy() const { return swap_.busy(); }
+
+  // ---------- 音频任务 ----------
+
+  // 块开头调用；换了新参数返回 true（链外的级据此更新，比如 AGC 门限）
+  bool update();
+  const DspParams& params() const { return swap_.current(); }
+  bool switching() const { return xfade_ > 0 || ramp_ > 0; }
+
+  // 前置滤波，单声道；直通时直接返回 in，否则写 work 并返回 work（work 可以就是 in）
+  const int16_t* filter(const int16_t* in, int16_t* work, int n);
+  // 增益 + 限幅 + 单声道→立体声交织；out 需 4 字节对齐
+  void output(const int16_t* in, int16_t* out, int n);
+
+ private:
+  void filter_chunk(const int16_t* in, int16_t* out, int n);
+
+  ParamSwap<DspParams> swap_;
+  int32_t ramp_len_;
+
+  // 滤波：两组状态，bank_ 给当前系数用；淡化时 1 - bank_ 给旧系数用
+  int64_t s1_[2][RT_MAX_SECTIONS], s2_[2][RT_MAX_SECTIONS];
+  int bank_;
+  int32_t xfade_;        // 剩余淡化样本
+  int32_t xw_, xstep_;   // 新系数的权重（Q15）和每样本步长
+
+  // 输出级：增益 Q12 和限幅都再左移 10 位做斜坡（每样本步长不至于被截成 0）
+  int32_t g_, g_step_, c_, c_step_;
+  int32_t ramp_;         // 剩余斜坡样本
+};
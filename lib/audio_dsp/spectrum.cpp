@@ -0,0 +1,83 @@
+#include "spectrum.h"
+#include <math.h>
+#include <string.h>
+
+SpectrumAnalyzer::SpectrumAnalyzer(uint32_t sample_rate, int fft_size, int hop, int bands,
+                                   float f_lo, float f_hi)
+    : fft_(fft_size), sample_rate_(sample_rate) {
+  const int n = fft_.size();
+  hop_   = hop < 1 ? 1 : (hop > n ? n : hop);
+  bands_ = bands < 1 ? 1 : (bands > SPECTRUM_MAX_BANDS ? SPECTRUM_MAX_BANDS : bands);
+
+  // 周期 Hann 窗（50% 重叠时逐点相加恰好为常数）
+  for (int i = 0; i < n; i++) window_[i] = 0.5f - 0.5f * cosf(2 * 3.14159265f * i / n);
+
+  // 频带 → 频点区间
+  const float df = (float)sample_rate / n;
+  if (f_hi > sample_rate * 0.5f) f_hi = sample_rate * 0.5f;
+  if (f_lo < df) f_lo = df;
+  if (f_lo >= f_hi) f_lo = f_hi * 0.5f;
+  const float ratio = f_hi / f_lo;
+  for (int k = 0; k < bands_; k++) {
+    const float lo = f_lo * powf(ratio, (float)k / bands_);
+    const float hi = f_lo * powf(ratio, (float)(k + 1) / bands_);
+    int b0 = (int)(lo / df + 0.5f);
+    int b1 = (int)(hi / df + 0.5f);
+    if (b0 > n / 2) b0 = n / 2;
+    if (b1 <= b0) b1 = b0 + 1;
+    band_lo_[k] = (uint16_t)b0;
+    band_hi_[k] = (uint16_t)b1;
+  }
+
+  // 满幅正弦过 Hann 窗后单边谱的总功率：A² · N² · 3/32
+  ref_power_ = 32767.0f * 32767.0f * (float)n * n * 3.0f / 32.0f;
+
+  memset(hist_, 0, sizeof(hist_));
+  fill_ = n - hop_;   // 第一帧攒满 hop 个就出，前面当作静音
+  memset(acc_, 0, sizeof(acc_));
+  frames_ = 0;
+}
+
+int SpectrumAnalyzer::push(const int16_t* x, int n) {
+  const int size = fft_.size();
+  int done = 0;
+  for (int i = 0; i < n; ) {
+    int take = size - fill_;
+    if (take > n - i) take = n - i;
+    for (int j = 0; j < take; j++) hist_[fill_ + j] = x[i + j];
+    fill_ += take;
+    i     += take;
+    if (fill_ < size) break;
+
+    analyze();
+    done++;
+    memmove(hist_, hist_ + hop_, (size - hop_) * sizeof(float));
+    fill_ = size - hop_;
+  }
+  return done;
+}
+
+void SpectrumAnalyzer::analyze() {
+  const int n = fft_.size();
+  for (int i = 0; i < n; i++) frame_[i] = hist_[i] * window_[i];
+  fft_.forward(frame_, re_, im_);
+
+  for (int k = 0; k < bands_; k++) {
+    float p = 0;
+    for (int b = band_lo_[k]; b < band_hi_[k]; b++) p += re_[b] * re_[b] + im_[b] * im_[b];
+    acc_[k] += p;
+  }
+  if (frames_ < UINT16_MAX) frames_++;
+}
+
+bool SpectrumAnalyzer::read(float* db, uint16_t* frames_averaged) {
+  if (frames_ == 0) return false;
+  const float scale = 1.0f / (ref_power_ * frames_);
+  for (int k = 0; k < bands_; k++) {
+    db[k] = 10.0f * log10f(acc_[k] * scale + 1e-14f);
+    acc_[k] = 0;
+  }
+  if (frames_averaged) *frames_averaged = frames_;
+  frames_ = 0;
+  return true;
+}
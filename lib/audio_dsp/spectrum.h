@@ -0,0 +1,55 @@
+#pragma once
+// =================================================
+// 流式频谱：Hann 窗实数 FFT + 重叠 + 对数频带
+// -------------------------------------------------
+// 样本按块推入，每攒够 hop 个新样本就对最近 fft_size 个做一次 FFT
+// （hop = fft_size / 2 即 50% 重叠，Hann 窗下各样本权重和恒定）。
+// 各 FFT 的功率按频带累加，read() 时取平均换成 dB 并清零，
+// 所以读取周期和 FFT 节拍无关，慢读就是多帧平均。
+//
+// 频带：f_lo ~ f_hi 之间按对数等分成 bands 份，每份覆盖落在其中的 FFT 频点；
+//   低频带比频点间隔还窄时至少取一个频点（相邻带可能取到同一个频点）
+// dB 参考：满幅正弦的能量全落在一个频带里时为 0 dBFS
+// =================================================
+
+#include <stdint.h>
+#include "fft.h"
+
+#define SPECTRUM_MAX_BANDS 128
+
+class SpectrumAnalyzer {
+ public:
+  SpectrumAnalyzer(uint32_t sample_rate, int fft_size, int hop, int bands,
+                   float f_lo, float f_hi);
+
+  // 推入 n 个样本，返回这次完成的 FFT 次数
+  int push(const int16_t* x, int n);
+
+  // 取上次 read 以来的平均频带电平（dBFS，bands() 个），清空累加；没有新 FFT 返回 false
+  bool read(float* db, uint16_t* frames_averaged = nullptr);
+
+  int bands() const { return bands_; }
+  int fft_size() const { return fft_.size(); }
+  uint32_t sample_rate() const { return sample_rate_; }
+
+ private:
+  void analyze();
+
+  RealFft fft_;
+  uint32_t sample_rate_;
+  int hop_;
+  int bands_;
+  uint16_t band_lo_[SPECTRUM_MAX_BANDS];   // 频点区间 [lo, hi)
+  uint16_t band_hi_[SPECTRUM_MAX_BANDS];
+  float ref_power_;                        // 0 dBFS 对应的频带功率
+
+  float window_[FFT_MAX_SIZE];
+  float hist_[FFT_MAX_SIZE];               // 最近 fft_size 个样本（线性，满了整体前移 hop）
+  int fill_;
+  float frame_[FFT_MAX_SIZE];
+  float re_[FFT_MAX_SIZE / 2 + 1];
+  float im_[FFT_MAX_SIZE / 2 + 1];
+
+  float acc_[SPECTRUM_MAX_BANDS];
+  uint16_t frames_;
+};
@@ -0,0 +1,277 @@
+#pragma once
+// =================================================
+// 编译期 DSP 流水线（header-only）
+// -------------------------------------------------
+// 级的类型、个数、样本类型 T 和块长 N 都是模板参数，process() 只有一个块循环，
+// 每个样本依次穿过所有级（样本优先），级之间不落地到缓冲；
+// 全部内联后编译器能把整条链融合成一段直线代码，N 小的时候整个块循环展开
+//
+//   using Chain = StaticPipeline<int32_t, 8, InterleaveStereo<int32_t>,
+//                                Biquad<int32_t, 2>, Gain<int32_t>, Limiter<int32_t>, Meter<int32_t>>;
+//   static Chain chain(Biquad<int32_t, 2>(kSos), Gain<int32_t>(3.0f), Limiter<int32_t>(-1.0f),
+//                      Meter<int32_t>());
+//   chain.process(mic, spk);            // 正好 N 个样本
+//   chain.stage<3>().peak();            // 按下标取级
+//
+// 样本类型：
+//   int32_t  int16 幅度左移 BIQUAD_GUARD_BITS（和 BiquadCascadeQ28 一样），级之间不饱和，出口才饱和
+//   float    int16 幅度，出口截断饱和（和 BiquadCascadeF32 一样）
+// 级：一个 T tick(T) 成员；出口（Sink）：put(out, i, v) 写第 i 帧，kChannels 是每帧写几个 int16
+// 加级 = 写一个带 tick() 的类，放进模板参数表；不用改任何循环
+// =================================================
+
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+#include <tuple>
+#include <utility>
+
+#include "biquad.h"
+#include "gain_kernel.h"
+
+// =================================================
+// 样本类型
+// =================================================
+template <typename T>
+struct SampleTraits;
+
+template <>
+struct SampleTraits<int32_t> {
+  static constexpr int kShift = BIQUAD_GUARD_BITS;
+  static inline int32_t from_i16(int16_t x) { return (int32_t)x << kShift; }
+  static inline int16_t to_i16(int32_t v) {
+    v = (v + (1 << (kShift - 1))) >> kShift;
+    return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+  }
+  static inline int32_t from_level(float full_scale_ratio) {
+    return (int32_t)(full_scale_ratio * 32767.0f * (1 << kShift));
+  }
+};
+
+template <>
+struct SampleTraits<float> {
+  static inline float from_i16(int16_t x) { return x; }
+  static inline int16_t to_i16(float v) {
+    if (v > 32767) v = 32767;
+    if (v < -32768) v = -32768;
+    return (int16_t)v;
+  }
+  static inline float from_level(float full_scale_ratio) { return full_scale_ratio * 32767.0f; }
+};
+
+// =================================================
+// 级
+// =================================================
+
+// 增益：int32 用 Q4.12（和 gain_kernel 一样，< 16 倍），float 直接乘
+template <typename T>
+class Gain;
+
+template <>
+class Gain<int32_t> {
+ public:
+  explicit Gain(float gain = 1.0f) { set(gain); }
+  void set(float gain) { q12_ = gain_to_q12(gain); }
+  int32_t tick(int32_t v) const { return (int32_t)(((int64_t)v * q12_) >> GAIN_Q_SHIFT); }
+
+ private:
+  int32_t q12_;
+};
+
+template <>
+class Gain<float> {
+ public:
+  explicit Gain(float gain = 1.0f) : g_(gain) {}
+  void set(float gain) { g_ = gain; }
+  float tick(float v) const { return v * g_; }
+
+ private:
+  float g_;
+};
+
+// biquad 级联（DF2T），系数来自 biquad_design.h；和 BiquadCascadeQ28 / F32 逐位相同，只是样本优先
+template <typename T, int S>
+class Biquad;
+
+template <int S>
+class Biquad<int32_t, S> {
+ public:
+  explicit Biquad(const Sos<S>& sos) {
+    for (int k = 0; k < S; k++) {
+      b0_[k] = to_q28(sos.s[k].b0);
+      b1_[k] = to_q28(sos.s[k].b1);
+      b2_[k] = to_q28(sos.s[k].b2);
+      a1_[k] = to_q28(sos.s[k].a1);
+      a2_[k] = to_q28(sos.s[k].a2);
+      s1_[k] = s2_[k] = 0;
+    }
+  }
+
+  int32_t tick(int32_t v) {
+    const int64_t round = (int64_t)1 << (BIQUAD_Q_SHIFT - 1);
+    for (int k = 0; k < S; k++) {
+      const int64_t x = v;
+      v = (int32_t)((b0_[k] * x + s1_[k] + round) >> BIQUAD_Q_SHIFT);
+      s1_[k] = b1_[k] * x - a1_[k] * v + s2_[k];
+      s2_[k] = b2_[k] * x - a2_[k] * v;
+    }
+    return v;
+  }
+
+ private:
+  static int64_t to_q28(float c) {
+    return (int32_t)(c * (float)(1 << BIQUAD_Q_SHIFT) + (c >= 0 ? 0.5f : -0.5f));
+  }
+
+  int64_t b0_[S], b1_[S], b2_[S], a1_[S], a2_[S];
+  int64_t s1_[S], s2_[S];
+};
+
+template <int S>
+class Biquad<float, S> {
+ public:
+  explicit Biquad(const Sos<S>& sos) {
+    for (int k = 0; k < S; k++) {
+      c_[k] = sos.s[k];
+      s1_[k] = s2_[k] = 0;
+    }
+  }
+
+  float tick(float x) {
+    for (int k = 0; k < S; k++) {
+      const BiquadCoeffs& c = c_[k];
+      const float y = c.b0 * x + s1_[k];
+      s1_[k] = c.b1 * x - c.a1 * y + s2_[k];
+      s2_[k] = c.b2 * x - c.a2 * y;
+      x = y;
+    }
+    return x;
+  }
+
+ private:
+  BiquadCoeffs c_[S];
+  float s1_[S], s2_[S];
+};
+
+// 限幅：超过 ±ceiling 直接削（ceiling 按 dBFS 给）
+template <typename T>
+class Limiter {
+ public:
+  explicit Limiter(float ceiling_dbfs = 0.0f)
+      : hi_(SampleTraits<T>::from_level(powf(10.0f, ceiling_dbfs / 20.0f))) {}
+  T tick(T v) const { return v > hi_ ? hi_ : (v < -hi_ ? -hi_ : v); }
+
+ private:
+  T hi_;
+};
+
+// 电平表：峰值和平方和一直累加，read_reset() 清零（读数按 int16 幅度）
+// int32 的平方和用整数累加（按 int16 幅度取整后平方），不会像 float 累加那样把整条链串成一条依赖链
+template <typename T>
+class Meter;
+
+template <>
+class Meter<int32_t> {
+ public:
+  int32_t tick(int32_t v) {
+    const int32_t a = v < 0 ? -v : v;
+    peak_ = a > peak_ ? a : peak_;
+    const int64_t q = v >> SampleTraits<int32_t>::kShift;
+    sumsq_ += (uint64_t)(q * q);
+    count_++;
+    return v;
+  }
+
+  float peak() const { return (float)peak_ / (1 << SampleTraits<int32_t>::kShift); }
+  float rms() const { return count_ ? sqrtf((float)((double)sumsq_ / count_)) : 0.0f; }
+  void read_reset() { peak_ = 0; sumsq_ = 0; count_ = 0; }
+
+ private:
+  int32_t peak_ = 0;
+  uint64_t sumsq_ = 0;
+  uint32_t count_ = 0;
+};
+
+template <>
+class Meter<float> {
+ public:
+  float tick(float v) {
+    const float a = v < 0 ? -v : v;
+    peak_ = a > peak_ ? a : peak_;
+    sumsq_ += v * v;
+    count_++;
+    return v;
+  }
+
+  float peak() const { return peak_; }
+  float rms() const { return count_ ? sqrtf(sumsq_ / count_) : 0.0f; }
+  void read_reset() { peak_ = 0; sumsq_ = 0; count_ = 0; }
+
+ private:
+  float peak_ = 0;
+  float sumsq_ = 0;
+  uint32_t count_ = 0;
+};
+
+// =================================================
+// 出口
+// =================================================
+template <typename T>
+struct MonoOut {
+  static constexpr int kChannels = 1;
+  void put(int16_t* out, int i, T v) const { out[i] = SampleTraits<T>::to_i16(v); }
+};
+
+// 单声道 → 左右相同的交织立体声
+template <typename T>
+struct InterleaveStereo {
+  static constexpr int kChannels = 2;
+  void put(int16_t* out, int i, T v) const {
+    const int16_t s = SampleTraits<T>::to_i16(v);
+    out[2 * i]     = s;
+    out[2 * i + 1] = s;
+  }
+};
+
+// =================================================
+// 流水线
+// =================================================
+template <typename T, int N, typename Sink, typename... Stages>
+class StaticPipeline {
+  static_assert(N > 0, "块长必须为正");
+
+ public:
+  using Sample = T;
+  static constexpr int kBlock    = N;
+  static constexpr int kChannels = Sink::kChannels;
+
+  explicit StaticPipeline(Stages... stages) : stages_(std::move(stages)...) {}
+
+  template <size_t I>
+  auto& stage() { return std::get<I>(stages_); }
+  Sink& sink() { return sink_; }
+
+  // 正好 N 个样本，块循环长度是常量
+  void process(const int16_t* in, int16_t* out) { run(in, out, N); }
+
+  // 运行时块长（不足 N 的尾巴、或者块长会变的场合）；同一条链，循环次数不是常量
+  void process(const int16_t* in, int16_t* out, int n) { run(in, out, n); }
+
+ private:
+  inline __attribute__((always_inline)) void run(const int16_t* in, int16_t* out, int n) {
+    for (int i = 0; i < n; i++) {
+      T v = SampleTraits<T>::from_i16(in[i]);
+      v = tick_all(v, std::index_sequence_for<Stages...>{});
+      sink_.put(out, i, v);
+    }
+  }
+
+  template <size_t... I>
+  inline __attribute__((always_inline)) T tick_all(T v, std::index_sequence<I...>) {
+    ((v = std::get<I>(stages_).tick(v)), ...);
+    return v;
+  }
+
+  std::tuple<Stages...> stages_;
+  Sink sink_;
+};
@@ -0,0 +1,94 @@
+#include "vad.h"
+#include <math.h>
+
+Vad::Vad(uint32_t sample_rate, int frame_size, int onset_frames, int hangover_frames,
+         const VadWeights& w)
+    : fft_(frame_size), sample_rate_(sample_rate), w_(w) {
+  n_ = fft_.size();
+  onset_frames_    = onset_frames < 1 ? 1 : onset_frames;
+  hangover_frames_ = hangover_frames < 0 ? 0 : hangover_frames;
+
+  for (int i = 0; i < n_; i++) window_[i] = 0.5f - 0.5f * cosf(2 * 3.14159265f * i / n_);
+
+  const float df = (float)sample_rate / n_;
+  bin_lo_ = (int)(300.0f / df + 0.5f);
+  bin_hi_ = (int)(4000.0f / df + 0.5f);
+  if (bin_lo_ < 1) bin_lo_ = 1;
+  if (bin_hi_ > n_ / 2) bin_hi_ = n_ / 2;
+  if (bin_hi_ <= bin_lo_) bin_hi_ = bin_lo_ + 1;
+
+  floor_rise_ = powf(10.0f, VAD_FLOOR_RISE_DB * n_ / sample_rate / 10.0f);
+  reset();
+}
+
+void Vad::reset() {
+  fill_       = 0;
+  have_floor_ = false;
+  run_        = 0;
+  hang_       = 0;
+  active_     = false;
+  feat_       = {-120.0f, 0, 1.0f, 0, -1.0f};
+}
+
+int Vad::push(const int16_t* x, int n) {
+  int frames = 0;
+  for (int i = 0; i < n; i++) {
+    frame_[fill_++] = x[i];
+    if (fill_ < n_) continue;
+    fill_ = 0;
+    analyze();
+    frames++;
+  }
+  return frames;
+}
+
+void Vad::analyze() {
+  // ---------- 能量、过零率（时域）----------
+  float sumsq = 0;
+  int crossings = 0;
+  for (int i = 0; i < n_; i++) {
+    sumsq += frame_[i] * frame_[i];
+    if (i > 0 && ((frame_[i] >= 0) != (frame_[i - 1] >= 0))) crossings++;
+  }
+  const float e_db = 10.0f * log10f(sumsq / n_ / (32768.0f * 32768.0f) + 1e-12f);
+  feat_.energy_db = e_db;
+  feat_.zcr       = (float)crossings / n_;
+
+  // ---------- 语音频段：逐频点噪声谱 → 白化后的 SNR 和平坦度 ----------
+  // 噪声谱逐频点跟踪最小值（比噪声低时快速跟下去，高时每帧最多乘 floor_rise_）。
+  // 用 p/噪声 算平坦度，任何颜色的稳态噪声（粉红、交流声泄漏、风扇低频）白化后都接近平坦，
+  // 剩下的起伏才是新出现的谐波结构；SNR 取白化后的均值，低于 300 Hz 的交流声和风扇不计入
+  for (int i = 0; i < n_; i++) frame_[i] *= window_[i];
+  fft_.forward(frame_, re_, im_);
+  float log_sum = 0, sum = 0;
+  for (int k = bin_lo_; k < bin_hi_; k++) {
+    const float p = re_[k] * re_[k] + im_[k] * im_[k] + 1e-3f;
+    float& nk = noise_[k];
+    if (!have_floor_ || p < nk) {
+      nk = have_floor_ ? nk + 0.2f * (p - nk) : p;
+    } else {
+      const float up = nk * floor_rise_;
+      nk = p < up ? p : up;
+    }
+    const float r = p / nk;
+    log_sum += logf(r);
+    sum     += r;
+  }
+  have_floor_ = true;
+  const int bins = bin_hi_ - bin_lo_;
+  feat_.flatness = expf(log_sum / bins) / (sum / bins);
+  feat_.snr_db   = 10.0f * log10f(sum / bins);
+
+  // ---------- 打分和门控 ----------
+  feat_.score = w_.bias + w_.snr * feat_.snr_db +
+                w_.flatness * log10f(feat_.flatness + 1e-6f) + w_.zcr * feat_.zcr;
+  if (feat_.score > 0) {
+    if (++run_ >= onset_frames_) {
+      active_ = true;
+      hang_   = hangover_frames_;
+    }
+  } else {
+    run_ = 0;
+    if (active_ && hang_-- <= 0) active_ = false;
+  }
+}
@@ -0,0 +1,85 @@
+#pragma once
+// =================================================
+// 语音活动检测（VAD）
+// -------------------------------------------------
+// 每 frame_size 个样本（不重叠，44.1 kHz 下 512 点 ≈ 11.6 ms）加 Hann 窗做一次 FFT，在 300 ~ 4000 Hz 上
+// 逐频点跟踪噪声谱（最小值跟踪：低于噪声时快速跟下去，高于时每秒最多上升 VAD_FLOOR_RISE_DB，
+// 长时间的稳态声音最终会被当作噪声），用 功率/噪声 白化后算：
+//   snr_db   ：白化功率的均值（dB）。300 Hz 以下的交流声、风扇低频不计入
+//   flatness ：白化功率的几何均值 / 算术均值。稳态噪声不论什么颜色都接近平坦，新出现的谐波结构远小于 1
+//   zcr      ：时域过零率（每样本），清音 / 嘶声偏高，浊音偏低
+// energy_db 是整帧的 dBFS，只用于观察
+// 帧判决是一个线性打分（相当于一个只有一层的小模型，权重可以用 tools/vad_runner --train 拟合）：
+//   score = bias + w_snr·snr_db + w_flatness·log10(flatness) + w_zcr·zcr，score > 0 为语音帧
+// 状态：连续 onset_frames 个语音帧才打开，最后一个语音帧之后保持 hangover_frames 帧才关闭
+// =================================================
+
+#include <stdint.h>
+#include "fft.h"
+
+#ifndef VAD_FLOOR_RISE_DB
+#define VAD_FLOOR_RISE_DB 2.0f   // 噪底每秒最多上升
+#endif
+
+struct VadFeatures {
+  float energy_db;   // dBFS
+  float snr_db;
+  float flatness;
+  float zcr;
+  float score;
+};
+
+struct VadWeights {
+  float bias;
+  float snr;
+  float flatness;    // 乘 log10(flatness)
+  float zcr;
+};
+
+// 默认值由 tools/vad_runner --train 在内置合成语料上拟合（白化 SNR 因最小值跟踪有约 10 dB 的正偏置，bias 抵掉它）
+static constexpr VadWeights kVadDefaultWeights = {-8.9f, 0.57f, -2.0f, -1.2f};
+
+class Vad {
+ public:
+  Vad(uint32_t sample_rate, int frame_size, int onset_frames, int hangover_frames,
+      const VadWeights& w = kVadDefaultWeights);
+
+  // 推入 n 个样本，返回这次判决了多少帧；每帧之后 active() / last() 更新
+  int push(const int16_t* x, int n);
+
+  // 带起判和拖尾的门控状态
+  bool active() const { return active_; }
+  // 最近一帧的特征和原始判决（不含拖尾）
+  const VadFeatures& last() const { return feat_; }
+  bool last_speech() const { return feat_.score > 0; }
+
+  void set_weights(const VadWeights& w) { w_ = w; }
+  int frame_size() const { return n_; }
+
+  void reset();
+
+ private:
+  void analyze();
+
+  RealFft fft_;
+  uint32_t sample_rate_;
+  int n_;
+  int onset_frames_;
+  int hangover_frames_;
+  VadWeights w_;
+  int bin_lo_, bin_hi_;   // flatness 用的频点区间
+  float floor_rise_;      // 每帧噪声谱最大上升倍数
+
+  float frame_[FFT_MAX_SIZE];
+  float window_[FFT_MAX_SIZE];
+  float re_[FFT_MAX_SIZE / 2 + 1];
+  float im_[FFT_MAX_SIZE / 2 + 1];
+  int fill_;
+
+  float noise_[FFT_MAX_SIZE / 2 + 1];   // 逐频点噪声功率
+  bool have_floor_;
+  int run_;        // 连续语音帧数
+  int hang_;       // 剩余拖尾帧数
+  bool active_;
+  VadFeatures feat_;
+};
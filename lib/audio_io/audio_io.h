@@ -0,0 +1,70 @@
+#pragma once
+// =================================================
+// 音频 I/O 抽象层
+// -------------------------------------------------
+// 采集和播放都以“借用缓冲区”的方式交给 DSP：
+//   acquire_rx → 读 → release_rx
+//   acquire_tx → 写 → commit_tx
+// 后端如果能直接交出 DMA 内存（IDF5 i2s channel API），DSP 就原地处理，
+// 不再经过 i2s_read / i2s_write 的驱动内部拷贝
+//
+// 后端：
+//   I2sLegacyIo   旧 driver/i2s.h，内部仍是 i2s_read/i2s_write（src/）
+//   I2sChannelIo  IDF5 i2s channel API + DMA 事件回调，零拷贝（src/）
+//   SimAudioIo    主机替身，只依赖标准库（audio_io_sim.h）
+// =================================================
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 一块采集数据（单声道），内存归后端所有，release_rx() 之前有效
+struct RxBuffer {
+  const int16_t* data;
+  uint16_t samples;
+  uint32_t seq;        // 后端维护的块序号
+  uint32_t t_capture;  // 采集完成时刻（us）
+};
+
+// DMA 环溢出计数（自启动以来累计）
+struct XrunStats {
+  uint32_t rx_overruns;    // 采集块没被及时取走，被 DMA 覆盖 / 丢弃
+  uint32_t tx_underruns;   // 播放缓冲没及时写入，DMA 播了静音或旧数据
+};
+
+// 零拷贝后端 DMA 环的最小深度：一个缓冲在 DMA 手里、一个在 DSP 手里，至少还要一个能排队
+#define AUDIO_IO_MIN_DMA_DEPTH 3
+
+// 零拷贝后端（DMA 中断往就绪队列里推缓冲指针）取块前调用：
+// 环有 depth 个缓冲，队列里排了超过 depth - 2 个时，最老的那些已经或马上会被 DMA 下一圈重用，
+// 逐个丢掉（Queue::discard，见 SpscQueue），返回丢掉的个数
+template <typename Queue>
+uint32_t audio_io_drop_stale(Queue& q, uint8_t depth) {
+  uint32_t dropped = 0;
+  while (q.size() > (size_t)depth - 2 && q.discard()) dropped++;
+  return dropped;
+}
+
+class AudioIo {
+ public:
+  virtual ~AudioIo() {}
+
+  virtual bool begin() = 0;
+
+  // 等待下一块采集数据，超时返回 false
+  virtual bool acquire_rx(RxBuffer* out, uint32_t timeout_ms) = 0;
+  virtual void release_rx() = 0;
+
+  // 等待一块可写的播放缓冲（左右交织，可写 block_frames() 帧），超时返回 nullptr
+  virtual int16_t* acquire_tx(uint32_t timeout_ms) = 0;
+  virtual void commit_tx(uint16_t frames) = 0;
+
+  // 每块的帧数（= 每声道样本数）
+  virtual uint16_t block_frames() const = 0;
+
+  // 溢出计数快照，任意任务可调
+  virtual void xrun_stats(XrunStats* out) = 0;
+
+  // 运行时改块大小和 DMA 深度：停掉并重建两个端口，返回时已恢复运行，播放从静音开始
+  // 调用方必须是唯一使用这个 io 的任务，输出应已淡出；失败时 io 不可用
+  virtual bool reconfigure(uint16_t block_frames, uint8_t dma_depth) = 0;
+};
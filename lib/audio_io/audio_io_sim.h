@@ -0,0 +1,143 @@
+#pragma once
+// =================================================
+// 主机替身后端：没有 I2S 也能驱动整条 DSP 链
+// - 采集数据由 source 回调按块生成
+// - 播放数据追加到 played（左右交织）
+// - 没有真实时钟，用“硬件节拍”模拟 DMA 环：
+//     每个节拍 RX 环多一块待取，TX 环播掉一块
+//   acquire_rx 没有待取块时走一拍（相当于等 DMA），commit_tx 时 TX 环满也走一拍，
+//   正常按块读写时两边锁步，不会溢出
+// - stall(n) 模拟调用方卡住 n 个块时长：RX 环满了丢最老的块，TX 环空了播静音，
+//   分别计入 xrun_stats()，用来验证溢出计数和上层的恢复逻辑
+// - zero_copy = true 时按 I2sChannelIo 的方式记账：每拍“中断”往 SpscQueue 里推一个
+//   RX 块序号和一个 TX 空闲缓冲，acquire_rx / acquire_tx 先用 audio_io_drop_stale 跳过过期的，
+//   跳过的个数计入 xrun_stats()；队列和跳过逻辑都是固件里那一份
+// 只给主机程序 include，固件不会编译到它；用法见 test/test_audio_io_sim
+// =================================================
+
+#include <functional>
+#include <vector>
+#include <spsc_queue.h>
+#include "audio_io.h"
+
+class SimAudioIo : public AudioIo {
+ public:
+  // 生成一块单声道采集数据
+  typedef std::function<void(int16_t* mono, uint16_t samples, uint32_t seq)> Source;
+
+  // ring = 模拟的 DMA 缓冲个数（对应 I2S_DMA_BUF_COUNT）
+  SimAudioIo(uint16_t block_frames, Source source, int ring = 4, bool zero_copy = false)
+      : block_(block_frames), ring_(ring), zero_copy_(zero_copy), source_(source),
+        rx_buf_(block_frames), tx_buf_(block_frames * 2) {}
+
+  bool begin() override { return true; }
+
+  bool acquire_rx(RxBuffer* out, uint32_t) override {
+    uint32_t seq;
+    if (zero_copy_) {
+      xrun_.rx_overruns += audio_io_drop_stale(rx_ready_, ring_);
+      // 和 I2sChannelIo 一样以 read_slot() 为空作为“等 DMA”的条件
+      const uint32_t* slot = rx_ready_.read_slot();
+      if (slot == nullptr) {
+        tick();
+        slot = rx_ready_.read_slot();
+      }
+      seq = *slot;
+    } else {
+      if (rx_pending_ == 0) tick();
+      seq = hw_seq_ - rx_pending_;   // 环里最老的一块
+      rx_pending_--;
+    }
+    if (source_) source_(rx_buf_.data(), block_, seq);
+    out->data      = rx_buf_.data();
+    out->samples   = block_;
+    out->seq       = seq;
+    out->t_capture = 0;
+    return true;
+  }
+  void release_rx() override {
+    if (zero_copy_) rx_ready_.commit_read();
+  }
+
+  int16_t* acquire_tx(uint32_t) override {
+    if (zero_copy_) {
+      xrun_.tx_underruns += audio_io_drop_stale(tx_free_, ring_);
+      if (tx_free_.read_slot() == nullptr) tick();
+    }
+    return tx_buf_.data();
+  }
+  void commit_tx(uint16_t frames) override {
+    if (zero_copy_) {
+      tx_free_.commit_read();
+    } else {
+      if (tx_queued_ == ring_) tick();   // TX 环满：等 DMA 播掉一块
+      tx_queued_++;
+      tx_started_ = true;
+    }
+    played.insert(played.end(), tx_buf_.begin(), tx_buf_.begin() + frames * 2);
+  }
+
+  uint16_t block_frames() const override { return block_; }
+
+  void xrun_stats(XrunStats* out) override { *out = xrun_; }
+
+  // 环清空重来，计数保留
+  bool reconfigure(uint16_t block_frames, uint8_t dma_depth) override {
+    block_ = block_frames;
+    ring_  = dma_depth;
+    rx_buf_.assign(block_frames, 0);
+    tx_buf_.assign(block_frames * 2, 0);
+    rx_pending_ = 0;
+    tx_queued_  = 0;
+    tx_started_ = false;
+    while (rx_ready_.discard()) {}
+    while (tx_free_.discard()) {}
+    reconfigures++;
+    return true;
+  }
+
+  // 调用方卡住 blocks 个块时长，硬件照常跑
+  void stall(int blocks) {
+    for (int i = 0; i < blocks; i++) tick();
+  }
+
+  std::vector<int16_t> played;
+  int reconfigures = 0;
+
+ private:
+  // 硬件走一拍：采满一块、播掉一块
+  void tick() {
+    if (zero_copy_) {
+      // on_recv / on_sent：队列满了推不进，同样计数
+      if (!rx_ready_.push(hw_seq_)) xrun_.rx_overruns++;
+      if (!tx_free_.push(0)) xrun_.tx_underruns++;
+      hw_seq_++;
+      return;
+    }
+    hw_seq_++;
+    if (rx_pending_ == ring_) {
+      xrun_.rx_overruns++;   // 最老的一块被覆盖
+    } else {
+      rx_pending_++;
+    }
+    if (tx_queued_ > 0) {
+      tx_queued_--;
+    } else if (tx_started_) {
+      xrun_.tx_underruns++;   // 没数据可播
+    }
+  }
+
+  uint16_t block_;
+  int ring_;
+  bool zero_copy_;
+  Source source_;
+  uint32_t hw_seq_ = 0;
+  int rx_pending_ = 0;
+  int tx_queued_ = 0;
+  bool tx_started_ = false;
+  XrunStats xrun_ = {};
+  SpscQueue<uint32_t, 16> rx_ready_;   // zero_copy：已采满、待取的块序号
+  SpscQueue<uint8_t, 16> tx_free_;     // zero_copy：已播完、可重写的缓冲
+  std::vector<int16_t> rx_buf_;
+  std::vector<int16_t> tx_buf_;
+};
@@ -0,0 +1,49 @@
+#include "buffer_controller.h"
+
+BufferController::BufferController(const BufferLevel* levels, int count,
+                                   float sample_rate,
+                                   const BufferControllerConfig& cfg)
+    : levels_(levels), count_(count), fs_(sample_rate), cfg_(cfg),
+      level_(0), clean_(0), cooldown_(0), shrink_need_(cfg.shrink_windows),
+      last_was_shrink_(false), last_load_(0) {}
+
+bool BufferController::update(uint32_t xruns, uint32_t dsp_p99_ns) {
+  const float period_ns = levels_[level_].block_frames * 1e9f / fs_;
+  last_load_ = dsp_p99_ns / period_ns;
+
+  if (cooldown_ > 0) {
+    cooldown_--;
+    return false;
+  }
+
+  if ((xruns >= cfg_.grow_xruns || last_load_ > cfg_.grow_load) &&
+      level_ < count_ - 1) {
+    level_++;
+    clean_ = 0;
+    if (last_was_shrink_ && shrink_need_ < cfg_.shrink_windows * 16) shrink_need_ *= 2;
+    last_was_shrink_ = false;
+    cooldown_ = cfg_.cooldown_windows;
+    return true;
+  }
+
+  if (xruns == 0 && last_load_ < cfg_.shrink_load) {
+    if (++clean_ >= shrink_need_ && level_ > 0) {
+      // 上一次降档撑住了，退避归位
+      if (last_was_shrink_) shrink_need_ = cfg_.shrink_windows;
+      level_--;
+      clean_ = 0;
+      last_was_shrink_ = true;
+      cooldown_ = cfg_.cooldown_windows;
+      return true;
+    }
+  } else {
+    clean_ = 0;
+  }
+  return false;
+}
+
+void BufferController::force_level(int level) {
+  level_    = level;
+  clean_    = 0;
+  cooldown_ = cfg_.cooldown_windows;
+}
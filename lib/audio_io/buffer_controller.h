@@ -0,0 +1,59 @@
+#pragma once
+// =================================================
+// 块大小 / DMA 深度控制律（纯逻辑，主机可跑）
+// -------------------------------------------------
+// 每个统计窗口调用一次 update()：
+//   升档：窗口内 xrun ≥ grow_xruns，或 DSP 负载 > grow_load，立即升一档
+//   降档：负载 < shrink_load 且无 xrun 的窗口连续 shrink_windows 个，降一档
+//   负载在两个阈值之间时干净计数清零，不升不降（迟滞带）
+//   切换后 cooldown_windows 个窗口不判断：重建 I2S 本身会带来几个 xrun，
+//   新档位的负载也要等直方图换成新数据
+//   降档后紧接着又升档，说明小一档撑不住：降档要求的干净窗口数翻倍（最多 16 倍），
+//   避免在两档之间周期性来回切；下一次降档成功时退避归位
+// 负载 = DSP p99 耗时 / 块周期（块帧数 / 采样率）
+// 脚本化的主机测试见 tools/bufctl_bench
+// =================================================
+
+#include <stdint.h>
+
+struct BufferLevel {
+  uint16_t block_frames;
+  uint8_t  dma_depth;
+};
+
+struct BufferControllerConfig {
+  uint32_t grow_xruns;
+  float    grow_load;
+  float    shrink_load;
+  int      shrink_windows;
+  int      cooldown_windows;
+};
+
+class BufferController {
+ public:
+  BufferController(const BufferLevel* levels, int count, float sample_rate,
+                   const BufferControllerConfig& cfg);
+
+  // xruns = 本窗口新增的 RX overrun + TX underrun，dsp_p99_ns = 本窗口 DSP p99
+  // 返回 true 表示档位变了，新档位见 current()
+  bool update(uint32_t xruns, uint32_t dsp_p99_ns);
+
+  // 外部没能切到目标档位时，把控制器拉回实际档位（重新进入冷却）
+  void force_level(int level);
+
+  int level() const { return level_; }
+  const BufferLevel& current() const { return levels_[level_]; }
+  float last_load() const { return last_load_; }
+
+ private:
+  const BufferLevel* levels_;
+  int count_;
+  float fs_;
+  BufferControllerConfig cfg_;
+  int level_;
+  int clean_;
+  int cooldown_;
+  int shrink_need_;
+  bool last_was_shrink_;
+  float last_load_;
+};
@@ -0,0 +1,123 @@
+#include "adpcm.h"
+
+static const int16_t kStepTable[89] = {
+  7, 8, 9, 10, 11, 12, 13, 14, 16, 17,
+  19, 21, 23, 25, 28, 31, 34, 37, 41, 45,
+  50, 55, 60, 66, 73, 80, 88, 97, 107, 118,
+  130, 143, 157, 173, 190, 209, 230, 253, 279, 307,
+  337, 371, 408, 449, 494, 544, 598, 658, 724, 796,
+  876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066,
+  2272, 2499, 2749, 3024, 3327, 3660, 4026, 4428, 4871, 5358,
+  5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+  15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+static const int8_t kIndexTable[16] = {
+  -1, -1, -1, -1, 2, 4, 6, 8,
+  -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+static inline int clamp_index(int idx) {
+  return idx < 0 ? 0 : (idx > 88 ? 88 : idx);
+}
+
+static inline int32_t clamp16(int32_t v) {
+  return v > 32767 ? 32767 : (v < -32768 ? -32768 : v);
+}
+
+// 编码和解码共用的重建步骤，保证两端状态逐位一致
+static inline void adpcm_update(AdpcmState* st, uint8_t nibble) {
+  int step = kStepTable[st->index];
+  int diff = step >> 3;
+  if (nibble & 4) diff += step;
+  if (nibble & 2) diff += step >> 1;
+  if (nibble & 1) diff += step >> 2;
+  int32_t pred = (nibble & 8) ? st->predictor - diff : st->predictor + diff;
+  st->predictor = (int16_t)clamp16(pred);
+  st->index = (uint8_t)clamp_index(st->index + kIndexTable[nibble]);
+}
+
+uint8_t adpcm_encode_sample(AdpcmState* st, int16_t sample) {
+  int step = kStepTable[st->index];
+  int diff = sample - st->predictor;
+  uint8_t nibble = 0;
+  if (diff < 0) {
+    nibble = 8;
+    diff = -diff;
+  }
+  if (diff >= step)        { nibble |= 4; diff -= step; }
+  if (diff >= (step >> 1)) { nibble |= 2; diff -= step >> 1; }
+  if (diff >= (step >> 2)) { nibble |= 1; }
+  adpcm_update(st, nibble);
+  return nibble;
+}
+
+int16_t adpcm_decode_sample(AdpcmState* st, uint8_t nibble) {
+  adpcm_update(st, nibble & 0x0F);
+  return st->predictor;
+}
+
+size_t adpcm_encode_block(AdpcmState* st, const int16_t* in, size_t n,
+                          uint8_t* out) {
+  out[0] = (uint8_t)st->predictor;
+  out[1] = (uint8_t)((uint16_t)st->predictor >> 8);
+  out[2] = st->index;
+  out[3] = 0;
+
+  uint8_t* p = out + ADPCM_BLOCK_HEADER;
+  size_t i = 0;
+  for (; i + 2 <= n; i += 2) {
+    uint8_t lo = adpcm_encode_sample(st, in[i]);
+    uint8_t hi = adpcm_encode_sample(st, in[i + 1]);
+    *p++ = (uint8_t)(lo | (hi << 4));
+  }
+  if (i < n) *p++ = adpcm_encode_sample(st, in[i]);
+  return (size_t)(p - out);
+}
+
+size_t adpcm_decode_block(const uint8_t* in, size_t len, int16_t* out,
+                          size_t max_samples) {
+  if (len < ADPCM_BLOCK_HEADER || in[2] > 88) return 0;
+  AdpcmState st;
+  st.predictor = (int16_t)(in[0] | (in[1] << 8));
+  st.index     = in[2];
+
+  size_t n = 0;
+  for (size_t i = ADPCM_BLOCK_HEADER; i < len && n < max_samples; i++) {
+    out[n++] = adpcm_decode_sample(&st, in[i] & 0x0F);
+    if (n < max_samples) out[n++] = adpcm_decode_sample(&st, in[i] >> 4);
+  }
+  return n;
+}
+
+// -------------------------------------------------
+// G.711 µ-law
+// -------------------------------------------------
+#define ULAW_BIAS 0x84
+#define ULAW_CLIP 32635
+
+uint8_t ulaw_encode(int16_t sample) {
+  int32_t s = sample;
+  uint8_t sign = 0;
+  if (s < 0) {
+    s = -s;
+    sign = 0x80;
+  }
+  if (s > ULAW_CLIP) s = ULAW_CLIP;
+  s += ULAW_BIAS;
+
+  int exponent = 7;
+  for (int32_t mask = 0x4000; (s & mask) == 0 && exponent > 0; mask >>= 1) {
+    exponent--;
+  }
+  int mantissa = (s >> (exponent + 3)) & 0x0F;
+  return (uint8_t)~(sign | (exponent << 4) | mantissa);
+}
+
+int16_t ulaw_decode(uint8_t code) {
+  code = ~code;
+  int exponent = (code >> 4) & 0x07;
+  int mantissa = code & 0x0F;
+  int32_t s = (((mantissa << 3) + ULAW_BIAS) << exponent) - ULAW_BIAS;
+  return (int16_t)((code & 0x80) ? -s : s);
+}
@@ -0,0 +1,43 @@
+#pragma once
+// =================================================
+// 上行压缩编解码（固件和主机共用）
+//
+// IMA-ADPCM：4 bit/样本（相对 PCM16 压缩 4:1）
+//   块格式（每个帧 payload 一块，可独立解码）：
+//     [0..1] predictor  int16 小端，块起始预测值
+//     [2]    index      步长表下标（0..88）
+//     [3]    保留 = 0
+//     [4..]  每字节两个样本，低半字节在前；样本数为奇数时最后高半字节补 0
+//
+// G.711 µ-law：8 bit/样本（2:1），逐样本独立，无状态
+// =================================================
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ADPCM_BLOCK_HEADER 4
+
+struct AdpcmState {
+  int16_t predictor;
+  uint8_t index;
+};
+
+// 流式编解码：状态跨调用保持
+uint8_t adpcm_encode_sample(AdpcmState* st, int16_t sample);
+int16_t adpcm_decode_sample(AdpcmState* st, uint8_t nibble);
+
+// 一块的编码后字节数
+static inline size_t adpcm_block_bytes(size_t samples) {
+  return ADPCM_BLOCK_HEADER + (samples + 1) / 2;
+}
+
+// 编一块：先写 st 当前状态作为块头，再编码 n 个样本，st 随之更新
+size_t adpcm_encode_block(AdpcmState* st, const int16_t* in, size_t n,
+                          uint8_t* out);
+
+// 解一块：状态取自块头；返回解出的样本数（最多 max_samples）
+size_t adpcm_decode_block(const uint8_t* in, size_t len, int16_t* out,
+                          size_t max_samples);
+
+uint8_t ulaw_encode(int16_t sample);
+int16_t ulaw_decode(uint8_t code);
@@ -0,0 +1,55 @@
+#include "audio_frame.h"
+#include <string.h>
+#include "crc.h"
+
+static inline void put16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+static inline void put32(uint8_t* p, uint32_t v) {
+  put16(p, (uint16_t)v);
+  put16(p + 2, (uint16_t)(v >> 16));
+}
+static inline uint16_t get16(const uint8_t* p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+static inline uint32_t get32(const uint8_t* p) {
+  return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+size_t frame_encode(uint8_t* out, size_t cap, const FrameHeader& h,
+                    const uint8_t* payload) {
+  if (h.length > FRAME_MAX_PAYLOAD) return 0;
+  const size_t total = frame_size(h.length);
+  if (cap < total) return 0;
+
+  out[0] = FRAME_MAGIC0;
+  out[1] = FRAME_MAGIC1;
+  out[2] = h.type;
+  out[3] = h.format;
+  put16(out + 4, h.seq);
+  put16(out + 6, h.length);
+  put32(out + 8, h.timestamp);
+  put16(out + 12, h.samples);
+  out[14] = h.channels;
+  out[15] = crc8(out, 15);
+
+  if (h.length) memcpy(out + FRAME_HEADER_SIZE, payload, h.length);
+  put16(out + FRAME_HEADER_SIZE + h.length,
+        crc16_ccitt(out, FRAME_HEADER_SIZE + h.length));
+  return total;
+}
+
+bool frame_parse_header(const uint8_t* in, FrameHeader* h) {
+  if (in[0] != FRAME_MAGIC0 || in[1] != FRAME_MAGIC1) return false;
+  if (crc8(in, 15) != in[15]) return false;
+
+  h->type      = in[2];
+  h->format    = in[3];
+  h->seq       = get16(in + 4);
+  h->length    = get16(in + 6);
+  h->timestamp = get32(in + 8);
+  h->samples   = get16(in + 12);
+  h->channels  = in[14];
+  return h->length <= FRAME_MAX_PAYLOAD;
+}
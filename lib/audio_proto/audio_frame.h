@@ -0,0 +1,66 @@
+#pragma once
+// =================================================
+// 串口音频帧格式（所有多字节字段小端）
+//
+//  偏移  长度  字段
+//   0     2    magic      0xA5 0x5A
+//   2     1    type       FRAME_TYPE_*
+//   3     1    format     SAMPLE_FMT_*
+//   4     2    seq        帧序号，每帧 +1，回绕
+//   6     2    length     payload 字节数（≤ FRAME_MAX_PAYLOAD）
+//   8     4    timestamp  首样本采集时刻（us）
+//  12     2    samples    每声道样本数
+//  14     1    channels
+//  15     1    hcrc       CRC-8(字节 0..14)
+//  16     N    payload
+//  16+N   2    crc        CRC-16/CCITT(字节 0..16+N-1)
+//
+// 帧头自带 CRC-8：接收端在 magic 之后 16 字节就能判断是不是假同步，
+// 不必等完整 payload，失步后每帧 O(1) 重新锁定
+// =================================================
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FRAME_MAGIC0        0xA5
+#define FRAME_MAGIC1        0x5A
+#define FRAME_HEADER_SIZE   16
+#define FRAME_TRAILER_SIZE  2
+#define FRAME_MAX_PAYLOAD   2048
+#define FRAME_MAX_SIZE      (FRAME_HEADER_SIZE + FRAME_MAX_PAYLOAD + FRAME_TRAILER_SIZE)
+
+// 帧类型
+#define FRAME_TYPE_AUDIO      0x01
+#define FRAME_TYPE_TELEMETRY  0x02   // payload 见 telemetry_record.h，seq 独立计数
+#define FRAME_TYPE_SPECTRUM   0x03   // payload 见 spectrum_record.h，seq 独立计数
+#define FRAME_TYPE_CAPTURE    0x04   // 事件捕获块，payload 见 capture_record.h，seq 独立计数
+#define FRAME_TYPE_COMMAND    0x05   // 主机 → 板子的命令，payload 见 command_record.h，seq = 请求号
+#define FRAME_TYPE_RESPONSE   0x06   // 板子 → 主机的应答，seq 原样带回请求号
+
+// 样本格式
+#define SAMPLE_FMT_PCM16    0x01   // int16 小端
+#define SAMPLE_FMT_ADPCM    0x02   // IMA-ADPCM 块，见 adpcm.h
+#define SAMPLE_FMT_ULAW     0x03   // G.711 µ-law，每样本 1 字节
+
+struct FrameHeader {
+  uint8_t  type;
+  uint8_t  format;
+  uint16_t seq;
+  uint16_t length;
+  uint32_t timestamp;
+  uint16_t samples;
+  uint8_t  channels;
+};
+
+// 整帧大小
+static inline size_t frame_size(uint16_t payload_len) {
+  return FRAME_HEADER_SIZE + payload_len + FRAME_TRAILER_SIZE;
+}
+
+// 把 header + payload 编成一帧写到 out（容量至少 frame_size(h.length)）
+// 返回帧长度，容量不够或 payload 超长返回 0
+size_t frame_encode(uint8_t* out, size_t cap, const FrameHeader& h,
+                    const uint8_t* payload);
+
+// 解析并校验帧头（magic + hcrc + length 上限），不看 payload
+bool frame_parse_header(const uint8_t* in, FrameHeader* h);
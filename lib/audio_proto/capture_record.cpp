@@ -0,0 +1,37 @@
+#include "capture_record.h"
+#include <string.h>
+
+static inline void put16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+static inline void put32(uint8_t* p, uint32_t v) {
+  put16(p, (uint16_t)v);
+  put16(p + 2, (uint16_t)(v >> 16));
+}
+static inline uint16_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static inline uint32_t get32(const uint8_t* p) { return get16(p) | ((uint32_t)get16(p + 2) << 16); }
+
+size_t capture_encode(const CaptureRecord& r, uint8_t* out, size_t cap) {
+  if (cap < CAPTURE_HEADER_SIZE) return 0;
+  memset(out, 0, CAPTURE_HEADER_SIZE);
+  out[0] = CAPTURE_VERSION;
+  out[1] = r.reason;
+  put16(out + 2, r.job);
+  put32(out + 4, r.sample_rate);
+  put32(out + 8, r.offset);
+  put32(out + 12, r.trigger);
+  out[16] = r.flags;
+  return CAPTURE_HEADER_SIZE;
+}
+
+bool capture_decode(const uint8_t* in, size_t len, CaptureRecord* r) {
+  if (len < CAPTURE_HEADER_SIZE || in[0] < 1) return false;
+  r->reason      = in[1];
+  r->job         = get16(in + 2);
+  r->sample_rate = get32(in + 4);
+  r->offset      = get32(in + 8);
+  r->trigger     = get32(in + 12);
+  r->flags       = in[16];
+  return true;
+}
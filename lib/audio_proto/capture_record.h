@@ -0,0 +1,47 @@
+#pragma once
+// =================================================
+// 事件捕获块：FRAME_TYPE_CAPTURE 帧的 payload（小端）
+// 一次触发（一个 job）拆成若干帧发出，帧头的 timestamp 是块首样本的采集时刻、samples 是块内样本数
+//
+//  偏移  长度  字段
+//   0     1    version      CAPTURE_VERSION
+//   1     1    reason       CAPTURE_REASON_*
+//   2     2    job          捕获序号，每次触发 +1
+//   4     4    sample_rate  Hz
+//   8     4    offset       块首样本在本次捕获里的位置
+//  12     4    trigger      触发点在本次捕获里的位置（= 实际拿到的触发前样本数）
+//  16     1    flags        CAPTURE_FLAG_*
+//  17     3    保留（0）
+//  20     N    int16 PCM 小端
+//
+// 新字段只往保留字节和 PCM 之前追加并升 version
+// =================================================
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CAPTURE_VERSION      1
+#define CAPTURE_HEADER_SIZE  20
+
+#define CAPTURE_REASON_MANUAL  0
+#define CAPTURE_REASON_LEVEL   1   // 峰值越过门限
+#define CAPTURE_REASON_VAD     2   // 语音门控打开
+
+#define CAPTURE_FLAG_FIRST   0x01
+#define CAPTURE_FLAG_LAST    0x02
+#define CAPTURE_FLAG_LOST    0x04   // 这一块之前有样本来不及发、已被覆盖（offset 会跳）
+
+struct CaptureRecord {
+  uint8_t  reason;
+  uint16_t job;
+  uint32_t sample_rate;
+  uint32_t offset;
+  uint32_t trigger;
+  uint8_t  flags;
+};
+
+// 编码块头到 out，返回 CAPTURE_HEADER_SIZE；cap 不够返回 0（PCM 由调用方接在后面）
+size_t capture_encode(const CaptureRecord& r, uint8_t* out, size_t cap);
+
+// 解码块头；版本或长度不对返回 false。PCM 从 in + CAPTURE_HEADER_SIZE 开始
+bool capture_decode(const uint8_t* in, size_t len, CaptureRecord* r);
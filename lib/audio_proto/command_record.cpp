@@ -0,0 +1,142 @@
+#include "command_record.h"
+#include <string.h>
+
+static inline void put16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+static inline void put32(uint8_t* p, uint32_t v) {
+  put16(p, (uint16_t)v);
+  put16(p + 2, (uint16_t)(v >> 16));
+}
+static inline uint16_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static inline uint32_t get32(const uint8_t* p) { return get16(p) | ((uint32_t)get16(p + 2) << 16); }
+
+size_t command_encode(const CommandRecord& r, uint8_t* out, size_t cap) {
+  if (r.count > COMMAND_MAX_ITEMS) return 0;
+  const size_t len = COMMAND_HEADER_SIZE + COMMAND_ITEM_SIZE * r.count;
+  if (cap < len) return 0;
+  out[0] = COMMAND_VERSION;
+  out[1] = r.op;
+  out[2] = r.status;
+  out[3] = r.count;
+  for (int i = 0; i < r.count; i++) {
+    uint8_t* p = out + COMMAND_HEADER_SIZE + COMMAND_ITEM_SIZE * i;
+    uint32_t bits;
+    memcpy(&bits, &r.item[i].value, sizeof(bits));
+    put16(p, r.item[i].id);
+    put16(p + 2, 0);
+    put32(p + 4, bits);
+  }
+  return len;
+}
+
+size_t device_stats_encode(const DeviceStatsRecord& s, uint8_t* out, size_t cap) {
+  if (cap < DEVICE_STATS_SIZE) return 0;
+  out[0] = DEVICE_STATS_VERSION;
+  out[1] = s.flags;
+  put16(out + 2, 0);
+  const uint32_t v[15] = {s.uptime_ms,      s.rx_blocks,    s.rx_dropped,
+                          s.dsp_blocks,     s.dsp_dropped,  s.tx_blocks,
+                          s.uplink_frames,  s.uplink_dropped, s.pop_events,
+                          s.howl_notches,   (uint32_t)s.agc_gain_cdb, (uint32_t)s.agc_level_cdb,
+                          s.cmd_frames,     s.cmd_errors,   s.bulk_waits};
+  for (int i = 0; i < 15; i++) put32(out + 4 + 4 * i, v[i]);
+  return DEVICE_STATS_SIZE;
+}
+
+static bool stats_decode(const uint8_t* in, size_t len, DeviceStatsRecord* s) {
+  if (len < DEVICE_STATS_SIZE || in[0] < 1) return false;
+  s->flags          = in[1];
+  s->uptime_ms      = get32(in + 4);
+  s->rx_blocks      = get32(in + 8);
+  s->rx_dropped     = get32(in + 12);
+  s->dsp_blocks     = get32(in + 16);
+  s->dsp_dropped    = get32(in + 20);
+  s->tx_blocks      = get32(in + 24);
+  s->uplink_frames  = get32(in + 28);
+  s->uplink_dropped = get32(in + 32);
+  s->pop_events     = get32(in + 36);
+  s->howl_notches   = get32(in + 40);
+  s->agc_gain_cdb   = (int32_t)get32(in + 44);
+  s->agc_level_cdb  = (int32_t)get32(in + 48);
+  s->cmd_frames     = get32(in + 52);
+  s->cmd_errors     = get32(in + 56);
+  s->bulk_waits     = get32(in + 60);
+  return true;
+}
+
+bool command_decode(const uint8_t* in, size_t len, CommandRecord* r,
+                    DeviceStatsRecord* stats, bool* has_stats) {
+  if (has_stats) *has_stats = false;
+  if (len < COMMAND_HEADER_SIZE || in[0] < 1) return false;
+  r->op     = in[1];
+  r->status = in[2];
+  r->count  = in[3];
+  const size_t items = COMMAND_HEADER_SIZE + COMMAND_ITEM_SIZE * (size_t)r->count;
+  if (r->count > COMMAND_MAX_ITEMS || len < items) return false;
+  for (int i = 0; i < r->count; i++) {
+    const uint8_t* p = in + COMMAND_HEADER_SIZE + COMMAND_ITEM_SIZE * i;
+    const uint32_t bits = get32(p + 4);
+    r->item[i].id = get16(p);
+    memcpy(&r->item[i].value, &bits, sizeof(bits));
+  }
+  if (stats && stats_decode(in + items, len - items, stats) && has_stats) *has_stats = true;
+  return true;
+}
+
+// =================================================
+// 名字表
+// =================================================
+struct ParamName {
+  uint16_t id;
+  const char* name;
+  bool writable;
+};
+
+static const ParamName kParams[] = {
+    {PARAM_GAIN, "gain", true},
+    {PARAM_CEILING_DB, "ceiling", true},
+    {PARAM_FILTER, "filter", true},
+    {PARAM_FILTER_LO, "lo", true},
+    {PARAM_FILTER_HI, "hi", true},
+    {PARAM_AGC_TARGET_DB, "agc_target", true},
+    {PARAM_AGC_MAX_DB, "agc_max_gain", true},
+    {PARAM_STREAM, "stream", true},
+    {PARAM_SAMPLE_RATE, "sample_rate", false},
+    {PARAM_UPLINK_RATE, "uplink_rate", false},
+    {PARAM_BLOCK, "block", false},
+};
+
+static const ParamName* find_param(uint16_t id) {
+  for (const ParamName& p : kParams)
+    if (p.id == id) return &p;
+  return nullptr;
+}
+
+const char* command_param_name(uint16_t id) {
+  const ParamName* p = find_param(id);
+  return p ? p->name : nullptr;
+}
+
+uint16_t command_param_id(const char* name) {
+  for (const ParamName& p : kParams)
+    if (strcmp(p.name, name) == 0) return p.id;
+  return 0;
+}
+
+bool command_param_writable(uint16_t id) {
+  const ParamName* p = find_param(id);
+  return p && p->writable;
+}
+
+const char* command_op_name(uint8_t op) {
+  static const char* const names[] = {nullptr, "ping", "get", "set", "stream_start",
+                                      "stream_stop", "stats", "calibrate", "capture"};
+  return op < sizeof(names) / sizeof(names[0]) ? names[op] : nullptr;
+}
+
+const char* command_status_name(uint8_t status) {
+  static const char* const names[] = {"ok", "unknown", "bad args", "unsupported", "busy"};
+  return status < sizeof(names) / sizeof(names[0]) ? names[status] : "?";
+}
@@ -0,0 +1,118 @@
+#pragma once
+// =================================================
+// 命令 / 应答：FRAME_TYPE_COMMAND（主机 → 板子）和 FRAME_TYPE_RESPONSE（板子 → 主机）的 payload（小端）
+// 和音频帧走同一个串口、同一种帧格式；帧头 seq 是主机给的请求号，应答原样带回，
+// 应答帧头的 timestamp 是板子处理时的 micros()
+//
+//  偏移  长度  字段
+//   0     1    version   COMMAND_VERSION
+//   1     1    op        CMD_*
+//   2     1    status    CMD_OK / CMD_ERR_*（命令里填 0）
+//   3     1    count     后面的参数项数（≤ COMMAND_MAX_ITEMS）
+//   4   8×N    每项：id u16，保留 u16，value f32
+//  CMD_STATS 的应答在参数项之后接 DeviceStatsRecord（DEVICE_STATS_SIZE 字节）
+//
+//  CMD_GET   命令列出要读的 id（0 项 = 全部），应答带回各项当前值
+//  CMD_SET   命令里的各项一起生效（一次发布，要么全成要么全不成），应答带回设置后的值
+//  其余命令不带参数项
+//
+// 新字段只往末尾追加并升 version；新参数只加 id，旧工具按名字表认不出的就打印编号
+// =================================================
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define COMMAND_VERSION    1
+#define COMMAND_HEADER_SIZE 4
+#define COMMAND_ITEM_SIZE  8
+#define COMMAND_MAX_ITEMS  16
+
+// 操作
+#define CMD_PING          1
+#define CMD_GET           2
+#define CMD_SET           3
+#define CMD_STREAM_START  4   // 恢复音频 / 频谱上行
+#define CMD_STREAM_STOP   5   // 停发音频 / 频谱（录音、捕获、遥测照常），控制链路上只剩应答和遥测
+#define CMD_STATS         6
+#define CMD_CALIBRATE     7   // 马上测一次回环延迟，结果随遥测帧的 loop_latency_us 送回
+#define CMD_CAPTURE       8   // 手动触发一次事件捕获
+
+// 应答状态
+#define CMD_OK               0
+#define CMD_ERR_UNKNOWN      1   // 不认识的 op 或参数 id
+#define CMD_ERR_ARGS         2   // 参数值不合法 / payload 格式不对
+#define CMD_ERR_UNSUPPORTED  3   // 固件没编进这个功能
+#define CMD_ERR_BUSY         4   // 上一次修改还在淡化 / 测量还没做完，稍后重试
+
+// 参数 id
+#define PARAM_GAIN          1   // 输出增益（倍）
+#define PARAM_CEILING_DB    2   // 输出限幅 dBFS，0 = 不限
+#define PARAM_FILTER        3   // 前置滤波类型 FILTER_*（0 无 / 1 带通 / 2 低通 / 3 高通）
+#define PARAM_FILTER_LO     4   // Hz
+#define PARAM_FILTER_HI     5   // Hz
+#define PARAM_AGC_TARGET_DB 6
+#define PARAM_AGC_MAX_DB    7
+#define PARAM_STREAM        8   // 1 = 在发音频，可写（同 CMD_STREAM_*）
+#define PARAM_SAMPLE_RATE   9   // 只读：采集采样率
+#define PARAM_UPLINK_RATE   10  // 只读：上行流采样率
+#define PARAM_BLOCK         11  // 只读：当前 I/O 块（每声道样本）
+
+struct CommandItem {
+  uint16_t id;
+  float    value;
+};
+
+struct CommandRecord {
+  uint8_t op;
+  uint8_t status;
+  uint8_t count;
+  CommandItem item[COMMAND_MAX_ITEMS];
+};
+
+#define COMMAND_RECORD_MAX_SIZE (COMMAND_HEADER_SIZE + COMMAND_ITEM_SIZE * COMMAND_MAX_ITEMS)
+
+// 板子运行统计（CMD_STATS 应答）
+//   0     1    version  DEVICE_STATS_VERSION
+//   1     1    flags    DEVICE_STATS_STREAMING
+//   2     2    保留
+//   4   4×15   下面的字段依次（u32，AGC 两项是 i32 的 0.01 dB）
+struct DeviceStatsRecord {
+  uint8_t  flags;
+  uint32_t uptime_ms;
+  uint32_t rx_blocks;
+  uint32_t rx_dropped;
+  uint32_t dsp_blocks;
+  uint32_t dsp_dropped;
+  uint32_t tx_blocks;
+  uint32_t uplink_frames;
+  uint32_t uplink_dropped;
+  uint32_t pop_events;
+  uint32_t howl_notches;
+  int32_t  agc_gain_cdb;
+  int32_t  agc_level_cdb;
+  uint32_t cmd_frames;      // 收到的命令帧
+  uint32_t cmd_errors;      // 其中应答不是 CMD_OK 的
+  uint32_t bulk_waits;      // 音频等帧因为串口发送积压让路的次数
+};
+
+#define DEVICE_STATS_VERSION    1
+#define DEVICE_STATS_SIZE       (4 + 4 * 15)
+#define DEVICE_STATS_STREAMING  0x01
+
+// 编码到 out，返回字节数；cap 不够或项数超出返回 0
+size_t command_encode(const CommandRecord& r, uint8_t* out, size_t cap);
+
+// 解码；版本、长度或项数不对返回 false。stats 非空且后面跟着统计记录时一起解出，
+// 否则 *has_stats = false（两个指针都可以是 nullptr）
+bool command_decode(const uint8_t* in, size_t len, CommandRecord* r,
+                    DeviceStatsRecord* stats = nullptr, bool* has_stats = nullptr);
+
+// 统计记录接在 command_encode 的结果后面；cap 不够返回 0
+size_t device_stats_encode(const DeviceStatsRecord& s, uint8_t* out, size_t cap);
+
+// 名字表（主机工具和日志用）：未知 id 返回 nullptr，未知名字返回 0
+const char* command_param_name(uint16_t id);
+uint16_t command_param_id(const char* name);
+bool command_param_writable(uint16_t id);
+const char* command_op_name(uint8_t op);
+const char* command_status_name(uint8_t status);
@@ -0,0 +1,13 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// CRC-8（多项式 0x07，初值 0），用于帧头快速校验
+uint8_t crc8(const uint8_t* data, size_t len);
+
+// CRC-16/CCITT-FALSE（多项式 0x1021，初值 0xFFFF），用于整帧校验
+// crc 参数可接力计算：crc16_ccitt(b, n2, crc16_ccitt(a, n1))
+uint16_t crc16_ccitt(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF);
+
+// CRC-32（IEEE 802.3，与 zlib.crc32 相同），用于 flash 段和上传校验
+uint32_t crc32_ieee(const uint8_t* data, size_t len, uint32_t crc = 0);
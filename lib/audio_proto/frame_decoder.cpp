@@ -0,0 +1,88 @@
+#include "frame_decoder.h"
+#include <string.h>
+#include "crc.h"
+
+void FrameDecoder::reset() {
+  memset(&stats_, 0, sizeof(stats_));
+  have_seq_ = false;
+  last_seq_ = 0;
+  rd_ = wr_ = 0;
+}
+
+void FrameDecoder::push(const uint8_t* data, size_t len) {
+  while (len > 0) {
+    // 缓冲尾部不够时把未解析数据挪到开头
+    if (wr_ == sizeof(buf_)) {
+      memmove(buf_, buf_ + rd_, wr_ - rd_);
+      wr_ -= rd_;
+      rd_ = 0;
+    }
+    size_t n = sizeof(buf_) - wr_;
+    if (n > len) n = len;
+    memcpy(buf_ + wr_, data, n);
+    wr_  += n;
+    data += n;
+    len  -= n;
+    process();
+  }
+}
+
+void FrameDecoder::process() {
+  for (;;) {
+    size_t avail = wr_ - rd_;
+    if (avail < 2) break;
+
+    const uint8_t* p = buf_ + rd_;
+
+    // ---------- 找 magic ----------
+    if (p[0] != FRAME_MAGIC0 || p[1] != FRAME_MAGIC1) {
+      const uint8_t* m = (const uint8_t*)memchr(p + 1, FRAME_MAGIC0, avail - 1);
+      size_t skip = m ? (size_t)(m - p) : avail;
+      stats_.skipped_bytes += skip;
+      rd_ += skip;
+      continue;
+    }
+
+    // ---------- 帧头 ----------
+    if (avail < FRAME_HEADER_SIZE) break;
+    FrameHeader h;
+    if (!frame_parse_header(p, &h)) {
+      stats_.header_errors++;
+      stats_.skipped_bytes++;
+      rd_++;
+      continue;
+    }
+
+    // ---------- 整帧 ----------
+    const size_t total = frame_size(h.length);
+    if (avail < total) break;
+
+    const uint8_t* t = p + FRAME_HEADER_SIZE + h.length;
+    uint16_t crc = (uint16_t)(t[0] | (t[1] << 8));
+    if (crc16_ccitt(p, FRAME_HEADER_SIZE + h.length) != crc) {
+      stats_.crc_errors++;
+      stats_.skipped_bytes++;
+      rd_++;
+      continue;
+    }
+
+    // 丢帧只按音频帧的 seq 统计，其他类型各自计数
+    if (h.type == FRAME_TYPE_AUDIO) {
+      if (have_seq_) {
+        uint16_t lost = (uint16_t)(h.seq - last_seq_ - 1);
+        if (lost) {
+          stats_.gaps++;
+          stats_.lost_frames += lost;
+        }
+      }
+      have_seq_ = true;
+      last_seq_ = h.seq;
+    }
+    stats_.frames++;
+
+    cb_(h, p + FRAME_HEADER_SIZE, ctx_);
+    rd_ += total;
+  }
+
+  if (rd_ == wr_) rd_ = wr_ = 0;
+}
@@ -0,0 +1,48 @@
+#pragma once
+// =================================================
+// 流式帧解码器（主机和固件通用，不分配内存）
+// -------------------------------------------------
+// 任意切分的字节流喂给 push()，每解出一帧回调一次
+// - 锁定状态下每帧只检查一次 magic + 帧头 CRC，O(1)
+// - 帧头或整帧 CRC 错误时前移一个字节，用 memchr 找下一个 magic
+// - 按音频帧的 seq 统计丢帧数（gap）
+// 同一个字节流里夹杂的文本日志会被当作垃圾字节跳过
+// =================================================
+
+#include "audio_frame.h"
+
+struct FrameDecoderStats {
+  uint32_t frames;          // 校验通过的帧
+  uint32_t header_errors;   // magic 对但帧头 CRC 错
+  uint32_t crc_errors;      // 帧头对但整帧 CRC 错
+  uint32_t gaps;            // 检测到的序号跳变次数
+  uint32_t lost_frames;     // 按序号推算丢掉的帧数
+  uint64_t skipped_bytes;   // 不属于任何有效帧的字节
+};
+
+class FrameDecoder {
+ public:
+  typedef void (*Callback)(const FrameHeader& h, const uint8_t* payload,
+                           void* ctx);
+
+  FrameDecoder(Callback cb, void* ctx) : cb_(cb), ctx_(ctx) { reset(); }
+
+  void push(const uint8_t* data, size_t len);
+  void reset();
+
+  const FrameDecoderStats& stats() const { return stats_; }
+
+ private:
+  void process();
+
+  Callback cb_;
+  void* ctx_;
+  FrameDecoderStats stats_;
+  bool have_seq_;
+  uint16_t last_seq_;
+
+  // [rd_, wr_) 是尚未解析的数据
+  size_t rd_;
+  size_t wr_;
+  uint8_t buf_[FRAME_MAX_SIZE * 2];
+};
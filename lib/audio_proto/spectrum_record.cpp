@@ -0,0 +1,46 @@
+#include "spectrum_record.h"
+#include <string.h>
+
+static inline void put16(uint8_t* p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+static inline void put32(uint8_t* p, uint32_t v) {
+  put16(p, (uint16_t)v);
+  put16(p + 2, (uint16_t)(v >> 16));
+}
+static inline uint16_t get16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static inline uint32_t get32(const uint8_t* p) { return get16(p) | ((uint32_t)get16(p + 2) << 16); }
+
+size_t spectrum_encode(const SpectrumRecord& r, uint8_t* out, size_t cap) {
+  if (r.bands > SPECTRUM_RECORD_MAX_BANDS) return 0;
+  const size_t len = SPECTRUM_HEADER_SIZE + r.bands;
+  if (cap < len) return 0;
+
+  out[0] = SPECTRUM_VERSION;
+  out[1] = r.bands;
+  put16(out + 2, r.fft_size);
+  put32(out + 4, r.sample_rate);
+  put16(out + 8, r.f_lo);
+  put16(out + 10, r.f_hi);
+  put16(out + 12, r.frames);
+  put16(out + 14, r.hop);
+  memcpy(out + SPECTRUM_HEADER_SIZE, r.level, r.bands);
+  return len;
+}
+
+bool spectrum_decode(const uint8_t* in, size_t len, SpectrumRecord* r) {
+  if (len < SPECTRUM_HEADER_SIZE || in[0] < 1) return false;
+  const int bands = in[1];
+  if (bands > SPECTRUM_RECORD_MAX_BANDS || len < SPECTRUM_HEADER_SIZE + (size_t)bands) return false;
+
+  r->bands       = (uint8_t)bands;
+  r->fft_size    = get16(in + 2);
+  r->sample_rate = get32(in + 4);
+  r->f_lo        = get16(in + 8);
+  r->f_hi        = get16(in + 10);
+  r->frames      = get16(in + 12);
+  r->hop         = get16(in + 14);
+  memcpy(r->level, in + SPECTRUM_HEADER_SIZE, bands);
+  return true;
+}
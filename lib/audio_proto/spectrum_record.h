@@ -0,0 +1,49 @@
+#pragma once
+// =================================================
+// 频谱记录：FRAME_TYPE_SPECTRUM 帧的 payload（小端）
+//
+//  偏移  长度  字段
+//   0     1    version      SPECTRUM_VERSION
+//   1     1    bands        频带数 N
+//   2     2    fft_size
+//   4     4    sample_rate  分析用的采样率（Hz）
+//   8     2    f_lo         频带范围（Hz），N 个频带在 [f_lo, f_hi] 上按对数等分
+//  10     2    f_hi
+//  12     2    frames       这条记录平均了多少次 FFT
+//  14     2    hop          FFT 步进（样本）
+//  16     N    level        每频带电平，-0.5 dB 一档：0 = 0 dBFS，255 = -127.5 dBFS 及以下
+//
+// 新字段只往末尾追加并升 version（level 之后）
+// =================================================
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SPECTRUM_VERSION      1
+#define SPECTRUM_HEADER_SIZE  16
+#define SPECTRUM_RECORD_MAX_BANDS 128
+
+struct SpectrumRecord {
+  uint8_t  bands;
+  uint16_t fft_size;
+  uint32_t sample_rate;
+  uint16_t f_lo;
+  uint16_t f_hi;
+  uint16_t frames;
+  uint16_t hop;
+  uint8_t  level[SPECTRUM_RECORD_MAX_BANDS];
+};
+
+// dBFS → level（截到 0 ~ 255）
+static inline uint8_t spectrum_level(float db) {
+  const float v = -2.0f * db + 0.5f;
+  return v <= 0 ? 0 : (v >= 255 ? 255 : (uint8_t)v);
+}
+
+static inline float spectrum_db(uint8_t level) { return -0.5f * level; }
+
+// 编码到 out，返回字节数；cap 不够返回 0
+size_t spectrum_encode(const SpectrumRecord& r, uint8_t* out, size_t cap);
+
+// 解码；版本或长度不对返回 false
+bool spectrum_decode(const uint8_t* in, size_t len, SpectrumRecord* r);
@@ -0,0 +1,58 @@
+#include "telemetry_record.h"
+#include <string.h>
+
+static inline void put32(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+static inline uint32_t get32(const uint8_t* p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+size_t telemetry_encode(const TelemetryRecord& r, uint8_t* out, size_t cap) {
+  if (cap < TELEMETRY_RECORD_SIZE) return 0;
+
+  out[0] = TELEMETRY_VERSION;
+  out[1] = TELEM_STAGES;
+  out[2] = out[3] = 0;
+  put32(out + 4, r.uptime_ms);
+  put32(out + 8, (uint32_t)r.loop_latency_us);
+
+  uint8_t* p = out + 12;
+  for (int i = 0; i < TELEM_STAGES; i++, p += 16) {
+    put32(p,      r.stage[i].count);
+    put32(p + 4,  r.stage[i].p50_ns);
+    put32(p + 8,  r.stage[i].p99_ns);
+    put32(p + 12, r.stage[i].max_ns);
+  }
+  put32(p,     r.rx_overruns);
+  put32(p + 4, r.tx_underruns);
+  return TELEMETRY_RECORD_SIZE;
+}
+
+bool telemetry_decode(const uint8_t* in, size_t len, TelemetryRecord* r) {
+  if (len < 12 || in[0] < 1) return false;
+  const int stages = in[1];
+  if (len < 12 + 16 * (size_t)stages) return false;
+
+  memset(r, 0, sizeof(*r));
+  r->uptime_ms       = get32(in + 4);
+  r->loop_latency_us = (int32_t)get32(in + 8);
+
+  const uint8_t* p = in + 12;
+  for (int i = 0; i < stages; i++, p += 16) {
+    if (i >= TELEM_STAGES) continue;
+    r->stage[i].count  = get32(p);
+    r->stage[i].p50_ns = get32(p + 4);
+    r->stage[i].p99_ns = get32(p + 8);
+    r->stage[i].max_ns = get32(p + 12);
+  }
+
+  if (in[0] >= 2 && p + 8 <= in + len) {
+    r->rx_overruns  = get32(p);
+    r->tx_underruns = get32(p + 4);
+  }
+  return true;
+}
@@ -0,0 +1,52 @@
+#pragma once
+// =================================================
+// 遥测记录：FRAME_TYPE_TELEMETRY 帧的 payload（小端）
+//
+//  偏移  长度  字段
+//   0     1    version        TELEMETRY_VERSION
+//   1     1    stages         后面的级数
+//   2     2    reserved
+//   4     4    uptime_ms
+//   8     4    loop_latency_us 回环实测延迟，-1 = 未测
+//  12   16×N   每级：count, p50_ns, p99_ns, max_ns（u32）
+//  v2 起追加：
+//   +0    4    rx_overruns    采集 DMA 溢出累计
+//   +4    4    tx_underruns   播放 DMA 欠载累计
+//
+// 新字段只往末尾追加并升 version；解码端按 stages 跳过不认识的级，
+// 忽略多出来的尾部，旧工具能读新固件
+// =================================================
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TELEMETRY_VERSION 2
+
+// 各级编号
+#define TELEM_STAGE_RX_WAIT  0   // 等 RX DMA 块
+#define TELEM_STAGE_DSP      1   // dsp_process_block
+#define TELEM_STAGE_TX_WAIT  2   // 等 TX DMA 空位 + 写入
+#define TELEM_STAGES         3
+
+struct TelemetryStage {
+  uint32_t count;
+  uint32_t p50_ns;
+  uint32_t p99_ns;
+  uint32_t max_ns;
+};
+
+struct TelemetryRecord {
+  uint32_t uptime_ms;
+  int32_t  loop_latency_us;
+  TelemetryStage stage[TELEM_STAGES];
+  uint32_t rx_overruns;
+  uint32_t tx_underruns;
+};
+
+#define TELEMETRY_RECORD_SIZE (12 + 16 * TELEM_STAGES + 8)
+
+// 编码到 out，返回字节数；cap 不够返回 0
+size_t telemetry_encode(const TelemetryRecord& r, uint8_t* out, size_t cap);
+
+// 解码；版本或长度不对返回 false，旧版本缺的字段填 0
+bool telemetry_decode(const uint8_t* in, size_t len, TelemetryRecord* r);
@@ -0,0 +1,81 @@
+#include "pretrigger_buffer.h"
+#include <string.h>
+
+PretriggerBuffer::PretriggerBuffer(int16_t* storage, uint32_t capacity, uint32_t sample_rate)
+    : buf_(storage), cap_(capacity), sample_rate_(sample_rate) {
+  head_ = written_ = 0;
+  base_idx_ = base_t_ = 0;
+  busy_ = false;
+  job_ = 0;
+  reason_ = 0;
+  pending_flags_ = 0;
+  start_ = trig_ = end_ = rd_ = 0;
+  lost_ = 0;
+}
+
+void PretriggerBuffer::write(const int16_t* x, uint32_t n, uint32_t t_capture) {
+  base_idx_ = head_;
+  base_t_   = t_capture;
+  if (n > cap_) {   // 比环还长只留最后 cap_ 个
+    head_ += n - cap_;
+    x     += n - cap_;
+    n      = cap_;
+  }
+  const uint32_t pos = head_ & (cap_ - 1);
+  const uint32_t first = n < cap_ - pos ? n : cap_ - pos;
+  memcpy(buf_ + pos, x, first * sizeof(int16_t));
+  memcpy(buf_, x + first, (n - first) * sizeof(int16_t));
+  head_ += n;
+  written_ = written_ + n < cap_ ? written_ + n : cap_;
+}
+
+bool PretriggerBuffer::trigger(uint8_t reason, uint32_t pre, uint32_t post) {
+  if (busy_) return false;
+  if (pre > written_) pre = written_;
+  trig_   = head_;
+  start_  = trig_ - pre;
+  end_    = trig_ + post;
+  rd_     = start_;
+  reason_ = reason;
+  job_++;
+  pending_flags_ = CAPTURE_FLAG_FIRST;
+  busy_ = end_ != start_;
+  return true;
+}
+
+uint32_t PretriggerBuffer::read(int16_t* out, uint32_t max, CaptureChunk* info) {
+  if (!busy_) return 0;
+
+  // 读得太慢：最老的有效样本是 head_ - cap_
+  if (head_ - rd_ > cap_) {
+    const uint32_t skip = head_ - cap_ - rd_;
+    lost_ += skip;
+    rd_   += skip;
+    pending_flags_ |= CAPTURE_FLAG_LOST;
+  }
+
+  const uint32_t limit = (int32_t)(end_ - head_) > 0 ? head_ : end_;
+  uint32_t n = limit - rd_;
+  if (n > max) n = max;
+  if (n == 0 || (n < max && rd_ + n != end_)) return 0;   // 凑满一块再给，最后一块除外
+
+  const uint32_t pos = rd_ & (cap_ - 1);
+  const uint32_t first = n < cap_ - pos ? n : cap_ - pos;
+  memcpy(out, buf_ + pos, first * sizeof(int16_t));
+  memcpy(out + first, buf_, (n - first) * sizeof(int16_t));
+
+  info->job     = job_;
+  info->reason  = reason_;
+  info->offset  = rd_ - start_;
+  info->trigger = trig_ - start_;
+  info->t_first = base_t_ + (int32_t)((int64_t)(int32_t)(rd_ - base_idx_) * 1000000 / (int64_t)sample_rate_);
+  info->flags   = pending_flags_;
+  pending_flags_ = 0;
+
+  rd_ += n;
+  if (rd_ == end_) {
+    info->flags |= CAPTURE_FLAG_LAST;
+    busy_ = false;
+  }
+  return n;
+}
@@ -0,0 +1,62 @@
+#pragma once
+// =================================================
+// 触发前环形缓冲（事件捕获）
+// -------------------------------------------------
+// 一直往环里写最近 capacity 个样本；trigger() 在当前写入位置打一个触发点，
+// 把 [触发 - pre, 触发 + post) 定为一次捕获（job）。触发前的部分已经在环里，
+// 触发后的部分边录边读：read() 每次给出已录到、还没读过的一段。
+// 写者从不等待：读得比写慢、要读的样本被覆盖时跳到最老的有效样本，块上标 CAPTURE_FLAG_LOST。
+// 读速只要不低于实时，读位置离写位置就不会超过 pre，所以 capacity ≥ pre + 一次 write 的最大块即可。
+// 不带锁：write / trigger / read 要在同一个任务里调用（固件里是上行任务，见 src/capture.cpp）。
+// 存储由调用方给，可以在 PSRAM
+// =================================================
+
+#include <stddef.h>
+#include <stdint.h>
+#include <capture_record.h>
+
+struct CaptureChunk {
+  uint16_t job;
+  uint8_t  reason;     // CAPTURE_REASON_*
+  uint8_t  flags;      // CAPTURE_FLAG_*
+  uint32_t offset;     // 块首样本在本次捕获里的位置
+  uint32_t trigger;    // 触发点在本次捕获里的位置
+  uint32_t t_first;    // 块首样本采集时刻（us），按采样率从最近一次 write 的时间戳推算
+};
+
+class PretriggerBuffer {
+ public:
+  // storage：capacity 个样本，capacity 是 2 的幂
+  PretriggerBuffer(int16_t* storage, uint32_t capacity, uint32_t sample_rate);
+
+  // 追加 n 个样本，t_capture 是这块首样本的采集时刻（us）
+  void write(const int16_t* x, uint32_t n, uint32_t t_capture);
+
+  // 在当前写入位置触发：捕获触发前 pre 个、触发后 post 个样本。
+  // pre 截到已写入的样本数和 capacity；上一次捕获还没读完返回 false
+  bool trigger(uint8_t reason, uint32_t pre, uint32_t post);
+
+  // 读下一块，返回样本数：攒够 max 个已录到的样本才给（本次捕获的最后一块可以不满），否则返回 0
+  uint32_t read(int16_t* out, uint32_t max, CaptureChunk* info);
+
+  bool busy() const { return busy_; }
+  uint32_t capacity() const { return cap_; }
+  uint32_t lost_samples() const { return lost_; }   // 累计被覆盖没读到的样本
+
+ private:
+  int16_t* buf_;
+  uint32_t cap_;
+  uint32_t sample_rate_;
+
+  uint32_t head_;       // 已写入样本总数（回绕计数）
+  uint32_t written_;    // 同上，但封顶 cap_，用来截 pre
+  uint32_t base_idx_;   // 最近一次 write 的首样本序号和时间戳
+  uint32_t base_t_;
+
+  bool     busy_;
+  uint16_t job_;
+  uint8_t  reason_;
+  uint8_t  pending_flags_;
+  uint32_t start_, trig_, end_, rd_;
+  uint32_t lost_;
+};
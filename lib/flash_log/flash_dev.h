@@ -0,0 +1,20 @@
+#pragma once
+// =================================================
+// 原始 NOR flash 抽象
+// - 擦除以扇区为单位，擦除后全为 0xFF
+// - 写入只能把 1 变成 0（多次写同一位置 = 按位与）
+// 固件用 esp_partition 实现（src/），主机用 RamFlash 模拟（ram_flash.h）
+// =================================================
+
+#include <stddef.h>
+#include <stdint.h>
+
+class FlashDev {
+ public:
+  virtual ~FlashDev() {}
+  virtual bool read(uint32_t addr, void* buf, size_t len) = 0;
+  virtual bool write(uint32_t addr, const void* buf, size_t len) = 0;
+  virtual bool erase_sector(uint32_t addr) = 0;
+  virtual uint32_t size() const = 0;
+  virtual uint32_t sector_size() const = 0;
+};
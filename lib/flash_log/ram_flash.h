@@ -0,0 +1,64 @@
+#pragma once
+// =================================================
+// 主机用 RAM flash 模拟器
+// - 严格按 NOR 语义：写入是按位与，擦除恢复 0xFF
+// - cut_power_after(n)：再写 / 擦 n 个字节后“掉电”，之后所有写擦都失败，
+//   掉电那一次写只落下前一部分，用来验证段日志的崩溃恢复（tools/seglog_crash）
+// 只给主机程序 include，固件不会编译到它
+// =================================================
+
+#include <string.h>
+#include <vector>
+#include "flash_dev.h"
+
+class RamFlash : public FlashDev {
+ public:
+  RamFlash(uint32_t size, uint32_t sector = 4096)
+      : mem_(size, 0xFF), sector_(sector) {}
+
+  bool read(uint32_t addr, void* buf, size_t len) override {
+    if (addr + len > mem_.size()) return false;
+    memcpy(buf, &mem_[addr], len);
+    return true;
+  }
+
+  bool write(uint32_t addr, const void* buf, size_t len) override {
+    if (addr + len > mem_.size()) return false;
+    const uint8_t* p = (const uint8_t*)buf;
+    for (size_t i = 0; i < len; i++) {
+      if (!spend()) return false;
+      mem_[addr + i] &= p[i];
+    }
+    return true;
+  }
+
+  bool erase_sector(uint32_t addr) override {
+    if (addr % sector_ || addr >= mem_.size()) return false;
+    for (uint32_t i = 0; i < sector_; i++) {
+      if (!spend()) return false;
+      mem_[addr + i] = 0xFF;
+    }
+    erase_count++;
+    return true;
+  }
+
+  uint32_t size() const override { return (uint32_t)mem_.size(); }
+  uint32_t sector_size() const override { return sector_; }
+
+  // 再允许 bytes 字节的写 / 擦，之后掉电；传负数恢复供电
+  void cut_power_after(long bytes) { budget_ = bytes; }
+
+  uint32_t erase_count = 0;
+
+ private:
+  bool spend() {
+    if (budget_ < 0) return true;
+    if (budget_ == 0) return false;
+    budget_--;
+    return true;
+  }
+
+  std::vector<uint8_t> mem_;
+  uint32_t sector_;
+  long budget_ = -1;
+};
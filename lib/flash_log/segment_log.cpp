@@ -0,0 +1,174 @@
+#include "segment_log.h"
+#include <string.h>
+#include <crc.h>
+
+static inline void put32(uint8_t* p, uint32_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+  p[2] = (uint8_t)(v >> 16);
+  p[3] = (uint8_t)(v >> 24);
+}
+static inline uint32_t get32(const uint8_t* p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// 段 CRC 覆盖 seq、length 和 payload，段头字段被掉电写坏也能发现
+static uint32_t seg_crc_begin(uint32_t seq, uint32_t length) {
+  uint8_t b[8];
+  put32(b, seq);
+  put32(b + 4, length);
+  return crc32_ieee(b, sizeof(b));
+}
+
+SegmentLog::~SegmentLog() {
+  delete[] seq_;
+  delete[] state_;
+}
+
+bool SegmentLog::load_header(uint32_t sector, SegmentInfo* info, bool* uploaded) {
+  uint8_t h[SEGLOG_HEADER_SIZE];
+  if (!dev_->read(addr(sector), h, sizeof(h))) return false;
+  if (get32(h) != SEGLOG_MAGIC) return false;
+
+  info->sector = sector;
+  info->seq    = get32(h + 4);
+  info->length = get32(h + 8);
+  info->crc    = get32(h + 12);
+  *uploaded    = get32(h + 16) != 0xFFFFFFFFu;
+  if (info->length > max_payload()) return false;
+
+  // 分块读 payload 复核 CRC，不占大栈
+  uint32_t crc = seg_crc_begin(info->seq, info->length);
+  uint8_t chunk[256];
+  for (uint32_t off = 0; off < info->length; off += sizeof(chunk)) {
+    uint32_t n = info->length - off;
+    if (n > sizeof(chunk)) n = sizeof(chunk);
+    if (!dev_->read(addr(sector) + SEGLOG_HEADER_SIZE + off, chunk, n)) return false;
+    crc = crc32_ieee(chunk, n, crc);
+  }
+  return crc == info->crc;
+}
+
+bool SegmentLog::mount() {
+  sectors_ = dev_->size() / dev_->sector_size();
+  if (sectors_ < 2) return false;
+
+  delete[] seq_;
+  delete[] state_;
+  seq_   = new uint32_t[sectors_];
+  state_ = new uint8_t[sectors_];
+  memset(&stats_, 0, sizeof(stats_));
+
+  bool any = false;
+  uint32_t newest_seq = 0;
+  uint32_t newest_sector = 0;
+
+  for (uint32_t s = 0; s < sectors_; s++) {
+    SegmentInfo info;
+    bool uploaded = false;
+    seq_[s]   = 0;
+    state_[s] = SLOT_EMPTY;
+
+    uint32_t magic = 0;
+    dev_->read(addr(s), &magic, sizeof(magic));
+    if (!load_header(s, &info, &uploaded)) {
+      // 全 0xFF 是空扇区；有 magic 但校验不过是掉电残段或损坏
+      if (magic != 0xFFFFFFFFu) stats_.invalid++;
+      continue;
+    }
+
+    seq_[s]   = info.seq;
+    state_[s] = uploaded ? SLOT_UPLOADED : SLOT_PENDING;
+    stats_.valid++;
+    if (!uploaded) stats_.pending++;
+
+    if (!any || (int32_t)(info.seq - newest_seq) > 0) {
+      newest_seq    = info.seq;
+      newest_sector = s;
+      any = true;
+    }
+  }
+
+  next_seq_    = any ? newest_seq + 1 : 0;
+  next_sector_ = any ? (newest_sector + 1) % sectors_ : 0;
+  return true;
+}
+
+bool SegmentLog::append(const uint8_t* data, size_t len) {
+  if (!seq_ || len > max_payload()) return false;
+
+  const uint32_t s = next_sector_;
+  next_sector_ = (s + 1) % sectors_;
+
+  if (state_[s] != SLOT_EMPTY) {
+    stats_.valid--;
+    if (state_[s] == SLOT_PENDING) {
+      stats_.pending--;
+      stats_.overwritten++;
+    }
+    state_[s] = SLOT_EMPTY;
+  }
+
+  const uint32_t seq = next_seq_++;
+  uint8_t h[16];
+  put32(h,      SEGLOG_MAGIC);
+  put32(h + 4,  seq);
+  put32(h + 8,  (uint32_t)len);
+  put32(h + 12, crc32_ieee(data, len, seg_crc_begin(seq, (uint32_t)len)));
+
+  // 段头最后写：它落盘才算提交
+  if (!dev_->erase_sector(addr(s)) ||
+      !dev_->write(addr(s) + SEGLOG_HEADER_SIZE, data, len) ||
+      !dev_->write(addr(s), h, sizeof(h))) {
+    stats_.write_errors++;
+    return false;
+  }
+
+  seq_[s]   = seq;
+  state_[s] = SLOT_PENDING;
+  stats_.valid++;
+  stats_.pending++;
+  return true;
+}
+
+bool SegmentLog::oldest_pending(SegmentInfo* out) const {
+  bool found = false;
+  uint32_t best = 0;
+  for (uint32_t s = 0; s < sectors_; s++) {
+    if (state_[s] != SLOT_PENDING) continue;
+    if (!found || (int32_t)(seq_[s] - seq_[best]) < 0) {
+      best = s;
+      found = true;
+    }
+  }
+  if (!found) return false;
+
+  uint8_t h[16];
+  if (!dev_->read(addr(best), h, sizeof(h))) return false;
+  out->sector = best;
+  out->seq    = get32(h + 4);
+  out->length = get32(h + 8);
+  out->crc    = get32(h + 12);
+  return true;
+}
+
+bool SegmentLog::read(const SegmentInfo& info, uint8_t* buf) const {
+  if (!dev_->read(addr(info.sector) + SEGLOG_HEADER_SIZE, buf, info.length)) {
+    return false;
+  }
+  return crc32_ieee(buf, info.length, seg_crc_begin(info.seq, info.length)) == info.crc;
+}
+
+bool SegmentLog::mark_uploaded(const SegmentInfo& info) {
+  if (state_[info.sector] != SLOT_PENDING || seq_[info.sector] != info.seq) {
+    return false;
+  }
+  const uint32_t zero = 0;
+  if (!dev_->write(addr(info.sector) + 16, &zero, sizeof(zero))) {
+    stats_.write_errors++;
+    return false;
+  }
+  state_[info.sector] = SLOT_UPLOADED;
+  stats_.pending--;
+  return true;
+}
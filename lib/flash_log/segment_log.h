@@ -0,0 +1,80 @@
+#pragma once
+// =================================================
+// 掉电安全的 flash 段日志（环形）
+// -------------------------------------------------
+// 每个扇区放一个段：
+//   [0..15]  SegHeader  magic / seq / length / crc32(seq+length+payload)
+//   [16..19] 上传标记   0xFFFFFFFF = 待上传，写 0 = 已上传（NOR 不用擦就能改）
+//   [32..]   payload
+// 写入顺序：擦扇区 → 写 payload → 最后写 SegHeader
+// 任何一步掉电，段头要么是 0xFF 要么 CRC 不过，mount() 时当作空扇区，
+// 最多丢掉正在写的那一段
+//
+// 扇区写满后覆盖最老的段（不管是否已上传，覆盖未上传的计入 overwritten）
+// 上传流程：oldest_pending → read → 发送并确认 → mark_uploaded
+// 不是线程安全的，调用方自己加锁
+// =================================================
+
+#include "flash_dev.h"
+
+#define SEGLOG_MAGIC       0x474F4C41u   // "ALOG"
+#define SEGLOG_HEADER_SIZE 32
+
+// 上传线协议（TCP，小端）：
+//   设备 → 服务器  UPLOAD_MAGIC, seq, length, crc32, payload[length]
+//   服务器 → 设备  UPLOAD_ACK（校验通过并落盘）或 UPLOAD_NAK
+#define UPLOAD_MAGIC 0x444C5055u   // "UPLD"
+#define UPLOAD_ACK   0x06
+#define UPLOAD_NAK   0x15
+
+struct SegmentInfo {
+  uint32_t sector;   // 扇区下标
+  uint32_t seq;
+  uint32_t length;
+  uint32_t crc;
+};
+
+struct SegmentLogStats {
+  uint32_t valid;        // 有效段
+  uint32_t pending;      // 待上传
+  uint32_t overwritten;  // 未上传就被覆盖的段
+  uint32_t invalid;      // mount 时发现的损坏段（含掉电残段）
+  uint32_t write_errors;
+};
+
+class SegmentLog {
+ public:
+  explicit SegmentLog(FlashDev* dev) : dev_(dev) {}
+  ~SegmentLog();
+
+  // 扫描全部扇区，恢复序号和写指针
+  bool mount();
+
+  size_t max_payload() const { return dev_->sector_size() - SEGLOG_HEADER_SIZE; }
+
+  // 写一个完整段，len ≤ max_payload()
+  bool append(const uint8_t* data, size_t len);
+
+  // 最老的待上传段
+  bool oldest_pending(SegmentInfo* out) const;
+  // 读段 payload 到 buf（容量 ≥ info.length），并复核 CRC
+  bool read(const SegmentInfo& info, uint8_t* buf) const;
+  bool mark_uploaded(const SegmentInfo& info);
+
+  const SegmentLogStats& stats() const { return stats_; }
+  uint32_t next_seq() const { return next_seq_; }
+
+ private:
+  enum : uint8_t { SLOT_EMPTY = 0, SLOT_PENDING = 1, SLOT_UPLOADED = 2 };
+
+  bool load_header(uint32_t sector, SegmentInfo* info, bool* uploaded);
+  uint32_t addr(uint32_t sector) const { return sector * dev_->sector_size(); }
+
+  FlashDev* dev_;
+  uint32_t sectors_ = 0;
+  uint32_t* seq_ = nullptr;     // 每个扇区的段序号
+  uint8_t*  state_ = nullptr;   // SLOT_*
+  uint32_t next_sector_ = 0;
+  uint32_t next_seq_ = 0;
+  SegmentLogStats stats_ = {};
+};
@@ -0,0 +1,53 @@
+#pragma once
+// =================================================
+// 上行链路抽象层：帧字节流的出口、命令的入口
+// -------------------------------------------------
+// 上行 / 遥测 / 捕获帧和命令应答都经它写，命令任务经它读；
+// 帧格式（audio_frame.h）和主机解码端都不关心下面是哪种口
+//
+// 后端：
+//   UartLink    UART0，经板上 USB 转串口桥（SERIAL_BAUD）（src/）
+//   UsbCdcLink  S3 原生 USB OTG 上的 CDC-ACM（TinyUSB，全速），主机上是 /dev/ttyACM*（src/）
+//   SimLink     主机替身：按链路速率和发送缓冲大小建模，只依赖标准库（link_sim.h）
+// =================================================
+
+#include <stddef.h>
+#include <stdint.h>
+
+class Link {
+ public:
+  virtual ~Link() {}
+
+  virtual bool begin() = 0;
+
+  // 整段写进发送缓冲，缓冲满时阻塞；后端保证同一时刻只有一个写者，不同任务写的帧不会交错
+  // 主机没连上时可以丢弃，返回实际写入的字节数
+  virtual size_t write(const uint8_t* data, size_t len) = 0;
+
+  // 发送缓冲里还没上线的字节数
+  virtual size_t tx_queued() = 0;
+
+  // 大块数据写之前要等积压降到这个水位以下：应答最多排在水位 + 一帧后面
+  virtual size_t bulk_watermark() const = 0;
+
+  // 非阻塞读，返回读到的字节数
+  virtual size_t read(uint8_t* data, size_t cap) = 0;
+
+  // 主机端口开着（UART 总是 true，CDC 看 DTR）；没连上时积压不会下降，大块数据不等
+  virtual bool connected() = 0;
+
+  virtual const char* name() const = 0;
+};
+
+// 大块数据（音频 / 频谱 / 遥测 / 捕获帧）：积压超过水位时先 yield() 让路一个节拍再看
+// （固件 vTaskDelay(1)，主机 sleep 1 ms）；返回是否等过
+template <typename Yield>
+bool link_write_bulk(Link& link, const uint8_t* data, size_t len, Yield yield) {
+  bool waited = false;
+  while (link.connected() && link.tx_queued() > link.bulk_watermark()) {
+    waited = true;
+    yield();
+  }
+  link.write(data, len);
+  return waited;
+}
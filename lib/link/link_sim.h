@@ -0,0 +1,109 @@
+#pragma once
+// =================================================
+// 主机替身链路：没有板子也能跑固件同一套写法（link_write_bulk + 直接写应答）
+// - write() 进一个先进先出的发送缓冲，满了就阻塞（和 Serial.write / USBCDC::write 一样）
+// - 调用方每毫秒调一次 tick()，按模型取出这一毫秒能上线的字节，自己写到 pty / 管道
+//     UART：波特率 / 10 字节每秒，连续放
+//     USB 全速 CDC：主机每个 1 ms 帧轮询一次 bulk IN，一帧最多若干个 64 字节包
+// - 接收方向由调用方把读到的字节 feed() 进来，read() 取走
+// 模型参数见 kSimLinkUart / kSimLinkUsbFs；只给主机程序 include，固件不会编译到它
+// =================================================
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+#include "link.h"
+
+struct SimLinkModel {
+  const char* name;
+  size_t bytes_per_ms;   // 链路上每毫秒能发出去的字节
+  size_t tx_buffer;      // 发送缓冲（UART 驱动环 / TinyUSB CDC 发送 FIFO）
+  size_t watermark;      // bulk_watermark()
+};
+
+// UART0 1.5 Mbaud，SERIAL_TX_BUFFER / CONTROL_BULK_WATERMARK
+static const SimLinkModel kSimLinkUart = {"UART 1.5 Mbaud", 150, 4096, 512};
+// 全速 bulk 每帧理论最多 19 包，主机控制器 + CDC 驱动实际约 16 包（1 MB/s）。
+// 板上 TinyUSB 的 CDC 发送 FIFO 只有几十字节，USBCDC::write 在帧内边发边补、整帧持锁；
+// 这里按 1 ms 一拍建模，缓冲取一帧能发的量，水位和缓冲相同（大块数据不等，应答排在正在写的那一帧后面）
+static const SimLinkModel kSimLinkUsbFs = {"USB FS CDC", 16 * 64, 16 * 64, 16 * 64};
+
+class SimLink : public Link {
+ public:
+  explicit SimLink(const SimLinkModel& m) : m_(m) {}
+
+  bool begin() override { return true; }
+
+  size_t write(const uint8_t* data, size_t len) override {
+    std::lock_guard<std::mutex> w(write_mu_);   // 整帧一个写者
+    for (size_t off = 0; off < len;) {
+      std::unique_lock<std::mutex> lk(mu_);
+      cv_.wait(lk, [&] { return closed_ || tx_.size() < m_.tx_buffer; });
+      if (closed_) return off;
+      const size_t n = std::min(len - off, m_.tx_buffer - tx_.size());
+      tx_.insert(tx_.end(), data + off, data + off + n);
+      off += n;
+    }
+    return len;
+  }
+
+  size_t tx_queued() override {
+    std::lock_guard<std::mutex> lk(mu_);
+    return tx_.size();
+  }
+
+  size_t bulk_watermark() const override { return m_.watermark; }
+
+  size_t read(uint8_t* data, size_t cap) override {
+    std::lock_guard<std::mutex> lk(mu_);
+    const size_t n = std::min(cap, rx_.size());
+    std::copy(rx_.begin(), rx_.begin() + n, data);
+    rx_.erase(rx_.begin(), rx_.begin() + n);
+    return n;
+  }
+
+  bool connected() override {
+    std::lock_guard<std::mutex> lk(mu_);
+    return !closed_;   // 关掉之后 link_write_bulk 不再等水位
+  }
+  const char* name() const override { return m_.name; }
+
+  // ---------- 替身一侧 ----------
+
+  // 过了 1 ms：取出这一毫秒上线的字节（最多 cap）
+  size_t tick(uint8_t* out, size_t cap) {
+    size_t n;
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      n = std::min(std::min(cap, m_.bytes_per_ms), tx_.size());
+      std::copy(tx_.begin(), tx_.begin() + n, out);
+      tx_.erase(tx_.begin(), tx_.begin() + n);
+    }
+    if (n > 0) cv_.notify_all();
+    return n;
+  }
+
+  void feed(const uint8_t* data, size_t len) {
+    std::lock_guard<std::mutex> lk(mu_);
+    rx_.insert(rx_.end(), data, data + len);
+  }
+
+  // 唤醒阻塞在 write 里的线程，之后的写入都丢弃
+  void close() {
+    {
+      std::lock_guard<std::mutex> lk(mu_);
+      closed_ = true;
+    }
+    cv_.notify_all();
+  }
+
+  const SimLinkModel& model() const { return m_; }
+
+ private:
+  const SimLinkModel m_;
+  std::mutex write_mu_, mu_;
+  std::condition_variable cv_;
+  std::vector<uint8_t> tx_, rx_;
+  bool closed_ = false;
+};
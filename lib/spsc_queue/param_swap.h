@@ -0,0 +1,77 @@
+#pragma once
+// =================================================
+// 参数双缓冲：控制任务发布，音频任务无锁取用
+// -------------------------------------------------
+// 两个槽位 + 两个计数：
+//   pub_  控制任务已发布的序号（最新参数在 slot_[pub_ & 1]）
+//   ack_  音频任务已放手的序号（之前的槽位都可以重写）
+// 音频任务在块开头 acquire()：有新发布就切到新槽位，旧槽位仍然归它（交叉淡化要用旧系数），
+// 用完调 release()；在此之前控制任务的 publish() 返回 false，不会去写音频任务还在读的槽位。
+// 音频任务一侧只有原子读写，不等待、不拷贝；等待全在控制任务一侧
+// - publish 只能在一个任务里调用，acquire/release/current 只能在另一个任务里调用
+// =================================================
+
+#include <atomic>
+#include <stdint.h>
+
+#ifndef SPSC_CACHE_LINE
+#define SPSC_CACHE_LINE 64
+#endif
+
+template <typename T>
+class ParamSwap {
+ public:
+  explicit ParamSwap(const T& initial) {
+    slot_[0] = initial;
+    slot_[1] = initial;
+  }
+
+  // ---------- 控制任务 ----------
+
+  // 上一次发布还没被音频任务放手时返回 false（稍后重试）
+  bool publish(const T& p) {
+    const uint32_t seq = pub_.load(std::memory_order_relaxed);
+    if (ack_.load(std::memory_order_acquire) != seq) return false;
+    slot_[(seq + 1) & 1] = p;
+    pub_.store(seq + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool busy() const {
+    return ack_.load(std::memory_order_acquire) != pub_.load(std::memory_order_relaxed);
+  }
+
+  // ---------- 音频任务 ----------
+
+  // 有新发布时切过去并返回新参数，否则返回 nullptr；
+  // 返回非空之后旧参数（previous()）保持有效，直到 release()
+  const T* acquire() {
+    if (held_) return nullptr;
+    const uint32_t seq = pub_.load(std::memory_order_acquire);
+    if (seq == seen_) return nullptr;
+    seen_ = seq;
+    held_ = true;
+    return &slot_[seq & 1];
+  }
+
+  // 不再读旧参数
+  void release() {
+    if (!held_) return;
+    held_ = false;
+    ack_.store(seen_, std::memory_order_release);
+  }
+
+  const T& current() const { return slot_[seen_ & 1]; }
+  const T& previous() const { return slot_[(seen_ + 1) & 1]; }
+  bool held() const { return held_; }
+
+ private:
+  // 控制任务写
+  alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> pub_{0};
+  // 音频任务写
+  alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> ack_{0};
+  uint32_t seen_ = 0;
+  bool held_ = false;
+
+  T slot_[2];
+};
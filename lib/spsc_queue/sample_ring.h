@@ -0,0 +1,73 @@
+#pragma once
+// =================================================
+// 样本快照环：单写者、读者不反压
+// -------------------------------------------------
+// 和 SpscQueue 不同，写者从不等待也从不丢数据：环满了直接覆盖最老的样本。
+// 读者按绝对样本序号取一段，取完再看一眼写者声明的覆盖位置，
+// 如果这段在拷贝期间已被覆盖就返回 false（seqlock 的思路），读者跳到更新的位置重来。
+// 适合显示这类“只要最近的数据、慢了就跳”的消费者：音频任务只多一次 memcpy 和一次原子写
+// =================================================
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifndef SPSC_CACHE_LINE
+#define SPSC_CACHE_LINE 64
+#endif
+
+template <size_t N>
+class SampleRing {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SampleRing: N 必须是 2 的幂");
+
+ public:
+  static constexpr size_t kCapacity = N;
+
+  // ---------- 写者 ----------
+
+  void write(const int16_t* x, size_t n) {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    if (n > N) {   // 比环还长只留最后 N 个，序号照样算上
+      head += (uint32_t)(n - N);
+      x    += n - N;
+      n     = N;
+    }
+    // 先声明要覆盖到哪（seqlock 的“写开始”），读者据此判断拷贝是否被踩
+    claim_.store(head + (uint32_t)n, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    const size_t pos = head & (N - 1);
+    const size_t first = n < N - pos ? n : N - pos;
+    memcpy(buf_ + pos, x, first * sizeof(int16_t));
+    memcpy(buf_, x + first, (n - first) * sizeof(int16_t));
+    head_.store(head + (uint32_t)n, std::memory_order_release);
+  }
+
+  // ---------- 读者 ----------
+
+  // 已写入的样本总数（回绕计数）
+  uint32_t head() const { return head_.load(std::memory_order_acquire); }
+
+  // 拷贝序号 [from, from + n) 的样本；还没写到或已被覆盖返回 false
+  bool read(uint32_t from, size_t n, int16_t* out) const {
+    if (n > N) return false;
+    const uint32_t h0 = head_.load(std::memory_order_acquire);
+    if ((uint32_t)(h0 - from) < n || (uint32_t)(h0 - from) > N) return false;
+
+    const size_t pos = from & (N - 1);
+    const size_t first = n < N - pos ? n : N - pos;
+    memcpy(out, buf_ + pos, first * sizeof(int16_t));
+    memcpy(out + first, buf_, (n - first) * sizeof(int16_t));
+
+    // 拷贝期间写者可能追上来（包括正在写、还没发布的那一块）：
+    // 写者声明覆盖到的位置离 from 不超过 N 才算有效
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const uint32_t c = claim_.load(std::memory_order_relaxed);
+    return (uint32_t)(c - from) <= N;
+  }
+
+ private:
+  alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> claim_{0};
+  int16_t buf_[N];
+};
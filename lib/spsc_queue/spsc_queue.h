@@ -0,0 +1,105 @@
+#pragma once
+// =================================================
+// 单生产者 / 单消费者（SPSC）无锁环形队列
+// -------------------------------------------------
+// - 只依赖 <atomic>，固件和主机都能编译；双线程压力测试见 test/test_spsc_queue（pio test -e native）
+// - push 侧只能在一个任务里调用，pop 侧只能在另一个任务里调用
+// - 容量 N 必须是 2 的幂，实际可存 N 个元素（head/tail 用自由增长计数）
+// - 除了拷贝式 push/pop，还提供 write_slot/read_slot 原地读写，
+//   音频块可以直接在队列内存里生成和消费，不再多拷一次
+// =================================================
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifndef SPSC_CACHE_LINE
+#define SPSC_CACHE_LINE 64
+#endif
+
+template <typename T, size_t N>
+class SpscQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue: N 必须是 2 的幂");
+
+ public:
+  static constexpr size_t kCapacity = N;
+
+  // ---------- 生产者侧 ----------
+
+  // 取得下一个可写槽位，队列满返回 nullptr
+  T* write_slot() {
+    const uint32_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_cache_ >= N) {
+      tail_cache_ = tail_.load(std::memory_order_acquire);
+      if (head - tail_cache_ >= N) return nullptr;
+    }
+    return &buf_[head & (N - 1)];
+  }
+
+  // 发布 write_slot() 写好的槽位
+  void commit_write() {
+    head_.store(head_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  bool push(const T& item) {
+    T* slot = write_slot();
+    if (!slot) return false;
+    *slot = item;
+    commit_write();
+    return true;
+  }
+
+  // ---------- 消费者侧 ----------
+
+  // 取得最早的一个可读槽位，队列空返回 nullptr
+  T* read_slot() {
+    const uint32_t tail = tail_.load(std::memory_order_relaxed);
+    if (tail == head_cache_) {
+      head_cache_ = head_.load(std::memory_order_acquire);
+      if (tail == head_cache_) return nullptr;
+    }
+    return &buf_[tail & (N - 1)];
+  }
+
+  // 归还 read_slot() 读完的槽位
+  void commit_read() {
+    tail_.store(tail_.load(std::memory_order_relaxed) + 1,
+                std::memory_order_release);
+  }
+
+  bool pop(T& out) {
+    T* slot = read_slot();
+    if (!slot) return false;
+    out = *slot;
+    commit_read();
+    return true;
+  }
+
+  // 丢掉最早的一个元素，队列空返回 false
+  // 必须经 read_slot() 刷新 head 缓存，不能直接 commit_read()：
+  // tail 越过缓存的 head 之后，read_slot() 会把还没发布的槽位当成可读
+  bool discard() {
+    if (!read_slot()) return false;
+    commit_read();
+    return true;
+  }
+
+  // ---------- 任意一侧（只是快照，仅用于统计）----------
+
+  size_t size() const {
+    return head_.load(std::memory_order_acquire) -
+           tail_.load(std::memory_order_acquire);
+  }
+  bool empty() const { return size() == 0; }
+
+ private:
+  // 生产者独占的行：head_ 和它缓存的 tail
+  alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> head_{0};
+  uint32_t tail_cache_ = 0;
+  // 消费者独占的行：tail_ 和它缓存的 head
+  alignas(SPSC_CACHE_LINE) std::atomic<uint32_t> tail_{0};
+  uint32_t head_cache_ = 0;
+
+  alignas(SPSC_CACHE_LINE) T buf_[N];
+};
@@ -0,0 +1,30 @@
+#pragma once
+// =================================================
+// CPU 周期计数器
+// ESP32-S3：读 CCOUNT 寄存器，单条指令，240 MHz 下约 17.9 s 回绕。
+//   CCOUNT 每核独立，只能在同一个（固定核的）任务里求差
+// 主机：steady_clock 的纳秒数，按 1000 MHz 看待
+// =================================================
+
+#include <stdint.h>
+
+#if defined(__XTENSA__)
+
+static inline uint32_t cycle_now() {
+  uint32_t c;
+  __asm__ __volatile__("rsr.ccount %0" : "=a"(c));
+  return c;
+}
+
+#else
+
+#include <chrono>
+
+#define CYCLE_CLOCK_HOST_MHZ 1000
+
+static inline uint32_t cycle_now() {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif
@@ -0,0 +1,94 @@
+#pragma once
+// =================================================
+// 定长桶延迟直方图（单写者 / 单读者，无锁）
+//
+// 桶按 2 的幂分段，每段再等分 HIST_SUB 份：
+//   [0,8) 每个值一个桶，之后 [8,16) [16,32) ... 各 8 个桶，相对误差 ≤ 12.5%
+//   覆盖整个 uint32，共 240 个桶
+//
+// 写者（音频任务）：record() = clz + 移位 + 几次 relaxed 读写，不用原子 RMW
+// 读者（遥测任务）：window() 和上次的计数求差得到本窗口分布，写者那边从不清零；
+//   max 由读者 exchange 清零，和写者交错时最多丢一个窗口的峰值
+// 分桶往返、窗口求差、百分位的测试见 test/test_latency_hist
+// =================================================
+
+#include <atomic>
+#include <stdint.h>
+
+#define HIST_SUB_BITS 3
+#define HIST_SUB      (1 << HIST_SUB_BITS)
+#define HIST_BUCKETS  ((32 - HIST_SUB_BITS + 1) * HIST_SUB)
+
+struct HistSummary {
+  uint32_t count;   // 本窗口样本数
+  uint32_t p50;
+  uint32_t p99;
+  uint32_t max;
+};
+
+class LatencyHistogram {
+ public:
+  static inline int bucket_of(uint32_t v) {
+    if (v < HIST_SUB) return (int)v;
+    const int e = 31 - __builtin_clz(v);   // e ≥ HIST_SUB_BITS
+    return (e - HIST_SUB_BITS + 1) * HIST_SUB +
+           (int)((v >> (e - HIST_SUB_BITS)) & (HIST_SUB - 1));
+  }
+
+  // 桶的下界和宽度
+  static inline uint32_t bucket_low(int i) {
+    if (i < HIST_SUB) return (uint32_t)i;
+    const int e = i / HIST_SUB + HIST_SUB_BITS - 1;
+    return (uint32_t)(HIST_SUB + i % HIST_SUB) << (e - HIST_SUB_BITS);
+  }
+  static inline uint32_t bucket_width(int i) {
+    if (i < HIST_SUB) return 1;
+    return 1u << (i / HIST_SUB - 1);
+  }
+
+  void record(uint32_t v) {
+    std::atomic<uint32_t>& c = counts_[bucket_of(v)];
+    c.store(c.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (v > max_.load(std::memory_order_relaxed))
+      max_.store(v, std::memory_order_relaxed);
+  }
+
+  // 读者：本窗口（上次调用以来）的摘要，百分位取桶中点
+  HistSummary window() {
+    uint32_t diff[HIST_BUCKETS];
+    uint32_t total = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+      const uint32_t c = counts_[i].load(std::memory_order_relaxed);
+      diff[i] = c - prev_[i];
+      prev_[i] = c;
+      total += diff[i];
+    }
+
+    HistSummary s;
+    s.count = total;
+    s.max   = max_.exchange(0, std::memory_order_relaxed);
+    s.p50   = percentile(diff, total, 50, s.max);
+    s.p99   = percentile(diff, total, 99, s.max);
+    return s;
+  }
+
+ private:
+  static uint32_t percentile(const uint32_t* diff, uint32_t total, int pct,
+                             uint32_t max) {
+    if (total == 0) return 0;
+    const uint64_t rank = ((uint64_t)total * pct + 99) / 100;   // 向上取整
+    uint64_t acc = 0;
+    for (int i = 0; i < HIST_BUCKETS; i++) {
+      acc += diff[i];
+      if (acc >= rank) {
+        const uint32_t mid = bucket_low(i) + bucket_width(i) / 2;
+        return mid < max ? mid : max;
+      }
+    }
+    return max;
+  }
+
+  std::atomic<uint32_t> counts_[HIST_BUCKETS] = {};
+  std::atomic<uint32_t> max_{0};
+  uint32_t prev_[HIST_BUCKETS] = {};
+};
@@ -0,0 +1,179 @@
+#include "audio_ui.h"
+#include <string.h>
+
+// 电平表几何（行）
+static const int kRmsY   = 2;
+static const int kRmsH   = 8;
+static const int kPeakY  = 12;
+static const int kPeakH  = 4;
+static const int kSepY   = 19;   // 分隔线
+static const int kSpecY  = 21;   // 语谱图起始行
+static const int kMarkerW = 2;
+
+static const uint16_t kBackground = rgb565(0, 0, 0);
+static const uint16_t kSeparator  = rgb565(64, 64, 64);
+static const uint16_t kMarker     = rgb565(255, 255, 255);
+
+AudioUi::AudioUi(Display* display, int bands) : d_(display) {
+  w_ = d_->width()  < UI_MAX_WIDTH ? d_->width()  : UI_MAX_WIDTH;
+  h_ = d_->height() < UI_MAX_WIDTH ? d_->height() : UI_MAX_WIDTH;
+  bands_  = bands < 1 ? 1 : (bands > UI_MAX_BANDS ? UI_MAX_BANDS : bands);
+  spec_y_ = kSpecY;
+  spec_h_ = h_ > kSpecY ? h_ - kSpecY : 0;
+
+  // 低频在下：最底行是第 0 带
+  for (int r = 0; r < spec_h_; r++) row_band_[r] = (uint8_t)((spec_h_ - 1 - r) * bands_ / spec_h_);
+
+  // 色阶：黑 → 紫 → 红 → 黄 → 白，分段线性
+  static const uint8_t kStops[5][3] = {
+    {0, 0, 0}, {80, 0, 120}, {220, 30, 40}, {255, 200, 0}, {255, 255, 255}};
+  for (int i = 0; i < 256; i++) {
+    const int seg = i * 4 / 256;
+    const int t   = i * 4 - seg * 256;   // 0 ~ 255
+    uint8_t c[3];
+    for (int k = 0; k < 3; k++)
+      c[k] = (uint8_t)(kStops[seg][k] + (kStops[seg + 1][k] - kStops[seg][k]) * t / 256);
+    palette_[i] = rgb565(c[0], c[1], c[2]);
+  }
+
+  memset(cols_, 0, sizeof(cols_));
+  col_head_   = 0;
+  spec_dirty_ = true;
+  hold_db_    = UI_METER_FLOOR_DB;
+  hold_age_   = 0;
+  rms_px_ = peak_px_ = hold_px_ = 0;
+  drawn_rms_ = drawn_peak_ = drawn_hold_ = 0;
+  first_     = true;
+  strip_sel_ = 0;
+  pushed_    = 0;
+}
+
+int AudioUi::level_px(float db) const {
+  if (db <= UI_METER_FLOOR_DB) return 0;
+  if (db >= 0) return w_;
+  return (int)((db - UI_METER_FLOOR_DB) / -UI_METER_FLOOR_DB * w_ + 0.5f);
+}
+
+void AudioUi::set_levels(float peak_db, float rms_db) {
+  if (peak_db >= hold_db_) {
+    hold_db_  = peak_db;
+    hold_age_ = 0;
+  } else if (++hold_age_ > UI_PEAK_HOLD_FRAMES) {
+    hold_db_ -= UI_PEAK_DECAY_DB;
+    if (hold_db_ < peak_db) hold_db_ = peak_db;
+  }
+  rms_px_  = level_px(rms_db);
+  peak_px_ = level_px(peak_db);
+  hold_px_ = level_px(hold_db_);
+  if (hold_px_ > w_ - kMarkerW) hold_px_ = w_ - kMarkerW;
+}
+
+void AudioUi::add_column(const float* band_db) {
+  uint8_t* col = cols_[col_head_];
+  for (int b = 0; b < bands_; b++) {
+    float v = (band_db[b] - UI_SPEC_FLOOR_DB) / -UI_SPEC_FLOOR_DB * 255.0f;
+    col[b] = v <= 0 ? 0 : (v >= 255 ? 255 : (uint8_t)v);
+  }
+  if (++col_head_ == w_) col_head_ = 0;
+  spec_dirty_ = true;
+}
+
+uint16_t* AudioUi::next_buffer() {
+  strip_sel_ ^= 1;
+  return strip_[strip_sel_];
+}
+
+void AudioUi::push(int x, int y, int w, int h, uint16_t* buf) {
+  d_->push_rect(x, y, w, h, buf);
+  pushed_ += (uint32_t)(w * h);
+}
+
+// 电平条 [x0, x1) 这一段：lit 以左点亮，marker 处画保持线（-1 = 没有）
+void AudioUi::draw_meter_row(int y, int h, int x0, int x1, int lit, int marker) {
+  if (x1 <= x0) return;
+  const int yellow = level_px(-18.0f), red = level_px(-6.0f);
+  uint16_t* buf = next_buffer();
+  const int w = x1 - x0;
+  for (int i = 0; i < w; i++) {
+    const int x = x0 + i;
+    uint16_t c;
+    if (marker >= 0 && x >= marker && x < marker + kMarkerW) {
+      c = kMarker;
+    } else if (x < lit) {
+      c = x < yellow ? rgb565(0, 220, 60) : (x < red ? rgb565(240, 200, 0) : rgb565(240, 40, 30));
+    } else {
+      c = x < yellow ? rgb565(0, 40, 12) : (x < red ? rgb565(48, 40, 0) : rgb565(48, 8, 6));
+    }
+    buf[i] = c;
+  }
+  for (int r = 1; r < h; r++) memcpy(buf + r * w, buf, w * sizeof(uint16_t));
+  push(x0, y, w, h, buf);
+}
+
+void AudioUi::draw_spectrogram() {
+  for (int y0 = 0; y0 < spec_h_; y0 += UI_STRIP_ROWS) {
+    const int rows = spec_h_ - y0 < UI_STRIP_ROWS ? spec_h_ - y0 : UI_STRIP_ROWS;
+    uint16_t* buf = next_buffer();
+    for (int r = 0; r < rows; r++) {
+      const int band = row_band_[y0 + r];
+      uint16_t* line = buf + r * w_;
+      // 最老的一列在最左：先画 [col_head_, w_)，再画 [0, col_head_)
+      int x = 0;
+      for (int c = col_head_; c < w_; c++) line[x++] = palette_[cols_[c][band]];
+      for (int c = 0; c < col_head_; c++) line[x++] = palette_[cols_[c][band]];
+    }
+    push(0, spec_y_ + y0, w_, rows, buf);
+  }
+}
+
+uint32_t AudioUi::render() {
+  pushed_ = 0;
+  d_->begin_frame();
+
+  if (first_) {
+    // 整屏清底 + 分隔线，电平条整条重画
+    for (int y0 = 0; y0 < spec_y_; y0 += UI_STRIP_ROWS) {
+      const int rows = spec_y_ - y0 < UI_STRIP_ROWS ? spec_y_ - y0 : UI_STRIP_ROWS;
+      uint16_t* buf = next_buffer();
+      for (int r = 0; r < rows; r++) {
+        const uint16_t c = y0 + r == kSepY ? kSeparator : kBackground;
+        for (int x = 0; x < w_; x++) buf[r * w_ + x] = c;
+      }
+      push(0, y0, w_, rows, buf);
+    }
+    draw_meter_row(kRmsY, kRmsH, 0, w_, rms_px_, -1);
+    draw_meter_row(kPeakY, kPeakH, 0, w_, peak_px_, hold_px_);
+    spec_dirty_ = true;
+    first_ = false;
+  } else {
+    // RMS 条：只推新旧长度之间的一段
+    const int r0 = rms_px_ < drawn_rms_ ? rms_px_ : drawn_rms_;
+    const int r1 = rms_px_ < drawn_rms_ ? drawn_rms_ : rms_px_;
+    draw_meter_row(kRmsY, kRmsH, r0, r1, rms_px_, -1);
+
+    // 峰值条：峰值长度和保持线新旧位置覆盖的最小区间
+    if (peak_px_ != drawn_peak_ || hold_px_ != drawn_hold_) {
+      int p0 = peak_px_ < drawn_peak_ ? peak_px_ : drawn_peak_;
+      int p1 = peak_px_ < drawn_peak_ ? drawn_peak_ : peak_px_;
+      if (hold_px_ != drawn_hold_) {
+        const int m0 = hold_px_ < drawn_hold_ ? hold_px_ : drawn_hold_;
+        const int m1 = (hold_px_ < drawn_hold_ ? drawn_hold_ : hold_px_) + kMarkerW;
+        if (p1 <= p0) { p0 = m0; p1 = m1; }
+        if (m0 < p0) p0 = m0;
+        if (m1 > p1) p1 = m1;
+      }
+      draw_meter_row(kPeakY, kPeakH, p0, p1, peak_px_, hold_px_);
+    }
+  }
+  drawn_rms_  = rms_px_;
+  drawn_peak_ = peak_px_;
+  drawn_hold_ = hold_px_;
+
+  if (spec_dirty_ && spec_h_ > 0) {
+    draw_spectrogram();
+    spec_dirty_ = false;
+  }
+
+  d_->end_frame();
+  return pushed_;
+}
@@ -0,0 +1,76 @@
+#pragma once
+// =================================================
+// 电平表 + 滚动语谱图的绘制逻辑（与屏幕驱动无关，见 display.h）
+// -------------------------------------------------
+//   ┌──────────────────────────────┐
+//   │ ████████████░░░░░░░░  RMS    │  电平表：-60 ~ 0 dBFS，绿 / 黄（-18）/ 红（-6）
+//   │ ██████████████░░░|░░  峰值   │  细条 = 瞬时峰值，竖线 = 峰值保持
+//   ├──────────────────────────────┤
+//   │   语谱图（横轴时间，最新在右；│
+//   │   纵轴对数频带，低频在下）    │
+//   └──────────────────────────────┘
+//
+// 脏矩形：
+//   - 电平条只推上一帧和这一帧长度之间变化的那一段（每帧通常几十个像素）
+//   - 语谱图每来一列整体左移一格，只有这时才重推整个区域
+//   - 第一帧整屏清底
+// 所有像素在两块条带缓冲里合成后推出，一块在 DMA 时合成另一块
+// =================================================
+
+#include <stdint.h>
+#include "display.h"
+
+#define UI_MAX_WIDTH        320    // 屏幕宽、高的上限
+#define UI_MAX_BANDS        64
+#define UI_STRIP_ROWS       8      // 条带缓冲行数（每块 UI_MAX_WIDTH × 8 像素）
+
+#define UI_METER_FLOOR_DB   -60.0f
+#define UI_SPEC_FLOOR_DB    -90.0f // 语谱图色阶下限
+#define UI_PEAK_HOLD_FRAMES 30     // 峰值保持多少帧后开始回落
+#define UI_PEAK_DECAY_DB    0.5f   // 之后每帧回落
+
+class AudioUi {
+ public:
+  AudioUi(Display* display, int bands);
+
+  // 每帧调用一次：这一帧的瞬时峰值和 RMS（dBFS）
+  void set_levels(float peak_db, float rms_db);
+
+  // 语谱图追加一列（bands 个 dBFS）
+  void add_column(const float* band_db);
+
+  // 把变化推到屏幕，返回这一帧推了多少像素
+  uint32_t render();
+
+  int spectrogram_top() const { return spec_y_; }
+
+ private:
+  int level_px(float db) const;
+  void draw_meter_row(int y, int h, int x0, int x1, int lit, int marker);
+  void draw_spectrogram();
+  uint16_t* next_buffer();
+  void push(int x, int y, int w, int h, uint16_t* buf);
+
+  Display* d_;
+  int w_, h_;
+  int bands_;
+  int spec_y_, spec_h_;
+  uint32_t pushed_;
+
+  // 电平表状态：期望值和屏幕上已画的值
+  float hold_db_;
+  int hold_age_;
+  int rms_px_, peak_px_, hold_px_;
+  int drawn_rms_, drawn_peak_, drawn_hold_;
+  bool first_;
+
+  // 语谱图：环形列缓冲，col_head_ 是最老的一列（画在最左）
+  uint8_t cols_[UI_MAX_WIDTH][UI_MAX_BANDS];
+  int col_head_;
+  bool spec_dirty_;
+  uint8_t row_band_[UI_MAX_WIDTH];   // 语谱图行 → 频带（屏幕宽高都不超过 UI_MAX_WIDTH）
+
+  uint16_t palette_[256];
+  uint16_t strip_[2][UI_MAX_WIDTH * UI_STRIP_ROWS];
+  int strip_sel_;
+};
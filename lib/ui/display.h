@@ -0,0 +1,33 @@
+#pragma once
+// =================================================
+// 显示设备抽象：只有“把一块 RGB565 像素推到矩形里”这一个操作
+// -------------------------------------------------
+// 绘制逻辑（audio_ui.h）自己在小条带缓冲里合成像素，再整块推出去，
+// 所以后端可以直接走 SPI DMA（TFT_eSPI::pushImageDMA），主机上换成内存帧缓冲。
+//
+// 约定：
+// - push_rect 可以是异步的：pixels 在下一次 push_rect 或 end_frame 返回前必须保持有效，
+//   调用方用两块缓冲交替（一块在 DMA，一块在合成）
+// - 后端可以就地改写 pixels（比如字节序交换），调用方推完就当它已消费
+// - 每帧的 push_rect 都夹在 begin_frame / end_frame 之间
+// =================================================
+
+#include <stdint.h>
+
+class Display {
+ public:
+  virtual ~Display() {}
+
+  virtual int width() const = 0;
+  virtual int height() const = 0;
+
+  virtual void begin_frame() {}
+  virtual void push_rect(int x, int y, int w, int h, uint16_t* pixels) = 0;
+  // 等所有推送完成
+  virtual void end_frame() {}
+};
+
+// 8 位分量 → RGB565
+static constexpr uint16_t rgb565(uint8_t r, uint8_t g, uint8_t b) {
+  return (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+}
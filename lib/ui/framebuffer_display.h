@@ -0,0 +1,75 @@
+#pragma once
+// =================================================
+// 主机替身显示：内存帧缓冲，记录每帧推了哪些矩形
+// 用来在没有屏幕的情况下跑绘制逻辑：检查像素、统计脏矩形面积、导出 PPM 看效果
+// 只给主机程序 include，固件不会编译到它
+// =================================================
+
+#include <stdio.h>
+#include <vector>
+#include "display.h"
+
+class FramebufferDisplay : public Display {
+ public:
+  struct Rect { int x, y, w, h; };
+
+  FramebufferDisplay(int w, int h) : fb(w * h, 0), w_(w), h_(h) {}
+
+  int width() const override { return w_; }
+  int height() const override { return h_; }
+
+  void begin_frame() override {
+    rects.clear();
+    in_frame_ = true;
+  }
+
+  void push_rect(int x, int y, int w, int h, uint16_t* pixels) override {
+    if (!in_frame_ || x < 0 || y < 0 || x + w > w_ || y + h > h_) {
+      errors++;
+      return;
+    }
+    for (int r = 0; r < h; r++)
+      for (int c = 0; c < w; c++) fb[(y + r) * w_ + x + c] = pixels[r * w + c];
+    // 模拟 DMA 后端就地改写：调用方要是推完还拿这块缓冲当数据用，马上能看出来
+    for (int i = 0; i < w * h; i++) pixels[i] = 0xDEAD;
+    rects.push_back({x, y, w, h});
+    pixels_pushed += (uint64_t)w * h;
+  }
+
+  void end_frame() override {
+    in_frame_ = false;
+    frames++;
+  }
+
+  uint16_t at(int x, int y) const { return fb[y * w_ + x]; }
+
+  // 本帧推过的像素数
+  uint64_t frame_pixels() const {
+    uint64_t n = 0;
+    for (const Rect& r : rects) n += (uint64_t)r.w * r.h;
+    return n;
+  }
+
+  bool save_ppm(const char* path) const {
+    FILE* f = fopen(path, "wb");
+    if (!f) return false;
+    fprintf(f, "P6\n%d %d\n255\n", w_, h_);
+    for (uint16_t p : fb) {
+      const uint8_t rgb[3] = {(uint8_t)((p >> 8) & 0xF8), (uint8_t)((p >> 3) & 0xFC),
+                              (uint8_t)(p << 3)};
+      fwrite(rgb, 1, 3, f);
+    }
+    fclose(f);
+    return true;
+  }
+
+  std::vector<uint16_t> fb;     // 行优先 RGB565
+  std::vector<Rect> rects;      // 当前帧的脏矩形
+  uint64_t pixels_pushed = 0;   // 累计
+  uint32_t frames = 0;
+  uint32_t errors = 0;          // 越界或帧外推送
+
+ private:
+  int w_, h_;
+  bool in_frame_ = false;
+};
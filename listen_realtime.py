@@ -1,9 +1,12 @@
+# 只适用于 -DUPLINK_MODE=UPLINK_RAW 编的固件（裸 int16 流）。默认固件是 UPLINK_FRAMED 帧流，
+# 用 ./tools/bin/rt_player 或 ./tools/bin/frame_dump 收；连上后会先探测，看到 A5 5A 帧头直接报错退出
 import sounddevice as sd
 import numpy as np
 import serial
 import time
 import sys
 import argparse
+from src.raw_stream import check_raw_stream
 
 # 与ESP32代码匹配的配置
 # SERIAL_PORT = '/dev/cu.wchusbserial59090740691'
@@ -34,6 +37,7 @@ def main(gain_db=0.0):
         
         # 清空缓冲区
         ser.reset_input_buffer()
+        check_raw_stream(ser)
         time.sleep(0.5)
         
         # 创建音频输出流
@@ -1,176 +1,149 @@
 import serial
+import struct
+import binascii
 import numpy as np
 import matplotlib.pyplot as plt
 from matplotlib.animation import FuncAnimation
 import time
 
+# 固件需要编译成 UPLINK_MODE=UPLINK_SPECTRUM：FFT 在 ESP32 上做，串口上只有频谱帧
+# （lib/audio_proto/audio_frame.h + spectrum_record.h），这里只负责解帧和画图
+
 # Configuration parameters
 SERIAL_PORT = '/dev/cu.wchusbserial59090740691'  # Change to your serial port
 BAUD_RATE = 1500000                      # Must match ESP32 baud rate
-BUFFER_SIZE = 4096                       # Buffer size for better frequency resolution
-SAMPLE_RATE = 48000                     # Sampling rate
-PLOT_REFRESH_RATE = 300                  # Plot refresh rate (ms)
-MAX_FREQ = 1200                         # Maximum frequency to display
+PLOT_REFRESH_RATE = 100                  # Plot refresh rate (ms)
+WATERFALL_ROWS = 200                     # 瀑布图保留的帧数（50 ms 一帧 ≈ 10 s）
+FLOOR_DB = -100                          # 显示下限
+
+FRAME_MAGIC = b'\xA5\x5A'
+FRAME_HEADER = struct.Struct('<2sBBHHIHBB')   # magic type format seq length timestamp samples channels hcrc
+FRAME_TYPE_SPECTRUM = 0x03
+SPECTRUM_HEADER = struct.Struct('<BBHIHHHH')  # version bands fft_size sample_rate f_lo f_hi frames hop
 
 # Initialize serial port
 try:
-    ser = serial.Serial(SERIAL_PORT, BAUD_RATE, timeout=1)
+    ser = serial.Serial(SERIAL_PORT, BAUD_RATE, timeout=0.05)
     print(f"Successfully connected to serial port {SERIAL_PORT}")
-    
+
     # 清空串口缓冲区
     ser.reset_input_buffer()
     time.sleep(0.1)  # 等待缓冲区清空
-    
+
 except serial.SerialException as e:
     print(f"Failed to open serial port {SERIAL_PORT}: {e}")
     exit(1)
 
+rx_buffer = bytearray()
+stats = {'frames': 0, 'crc_errors': 0}
+
+
+def read_spectra():
+    """从串口缓冲里解出所有完整的频谱帧，返回 [(header, levels_db)]"""
+    rx_buffer.extend(ser.read(ser.in_waiting or 1))
+    out = []
+    while True:
+        start = rx_buffer.find(FRAME_MAGIC)
+        if start < 0:
+            del rx_buffer[:-1]
+            return out
+        del rx_buffer[:start]
+        if len(rx_buffer) < FRAME_HEADER.size:
+            return out
+        _, ftype, _, _, length, _, _, _, _ = FRAME_HEADER.unpack_from(rx_buffer)
+        total = FRAME_HEADER.size + length + 2
+        if length > 2048:
+            del rx_buffer[:1]          # 假同步
+            continue
+        if len(rx_buffer) < total:
+            return out
+        # CRC-16/CCITT-FALSE 覆盖帧头和 payload
+        crc = struct.unpack_from('<H', rx_buffer, total - 2)[0]
+        if binascii.crc_hqx(bytes(rx_buffer[:total - 2]), 0xFFFF) != crc:
+            stats['crc_errors'] += 1
+            del rx_buffer[:1]
+            continue
+        payload = bytes(rx_buffer[FRAME_HEADER.size:total - 2])
+        del rx_buffer[:total]
+        if ftype != FRAME_TYPE_SPECTRUM or len(payload) < SPECTRUM_HEADER.size:
+            continue               # 遥测帧等其他类型
+        hdr = SPECTRUM_HEADER.unpack_from(payload)
+        bands = hdr[1]
+        levels = np.frombuffer(payload, dtype=np.uint8, count=bands, offset=SPECTRUM_HEADER.size)
+        out.append((hdr, -0.5 * levels.astype(np.float32)))
+        stats['frames'] += 1
+
+
+# 等第一帧拿到频带参数
+print("等待频谱帧（固件需 UPLINK_MODE=UPLINK_SPECTRUM）...")
+first = []
+while not first:
+    first = read_spectra()
+(version, BANDS, FFT_SIZE, SAMPLE_RATE, F_LO, F_HI, _, HOP), _ = first[-1]
+print(f"频谱: {BANDS} 带, {F_LO}-{F_HI} Hz, FFT {FFT_SIZE} 点, hop {HOP}, 采样率 {SAMPLE_RATE} Hz")
+
+# 频带在 [F_LO, F_HI] 上按对数等分，画在几何中心
+edges = F_LO * (F_HI / F_LO) ** (np.arange(BANDS + 1) / BANDS)
+centers = np.sqrt(edges[:-1] * edges[1:])
+
 # Create figure and subplots
-fig, (ax_time, ax_freq) = plt.subplots(2, 1, figsize=(12, 8))
+fig, (ax_freq, ax_fall) = plt.subplots(2, 1, figsize=(12, 8))
 plt.subplots_adjust(hspace=0.5)
 
-# Time domain plot settings
-x_time = np.arange(0, BUFFER_SIZE)
-line_time, = ax_time.plot(x_time, np.zeros(BUFFER_SIZE), 'b-', lw=1)
-ax_time.set_title('Time Domain Signal')
-ax_time.set_xlim(0, BUFFER_SIZE)
-ax_time.set_ylim(-40000, 40000)
-ax_time.set_xlabel('Sample Points')
-ax_time.set_ylabel('Amplitude')
-ax_time.grid(True)
-
-# Frequency domain plot settings
-N = BUFFER_SIZE
-xf = np.fft.fftfreq(N, 1/SAMPLE_RATE)[:N//2]
-# Find index where frequency exceeds MAX_FREQ
-max_idx = np.argmax(xf > MAX_FREQ) if any(xf > MAX_FREQ) else len(xf)
-xf = xf[:max_idx]
-line_freq, = ax_freq.plot(xf, np.zeros(len(xf)), 'r-', lw=1)  # Linear scale
-ax_freq.set_title(f'Frequency Domain (FFT, 0-{MAX_FREQ}Hz)')
-ax_freq.set_xlim(0, MAX_FREQ)
-ax_freq.set_ylim(0, 2e6)              # Adjust based on your signal amplitude
+# 当前频谱 + 峰值保持
+line_freq, = ax_freq.semilogx(centers, np.full(BANDS, FLOOR_DB), 'r-', lw=1.5, label='level')
+line_peak, = ax_freq.semilogx(centers, np.full(BANDS, FLOOR_DB), 'k:', lw=1, label='peak hold')
+ax_freq.set_title(f'Spectrum ({BANDS} log bands, computed on ESP32)')
+ax_freq.set_xlim(F_LO, F_HI)
+ax_freq.set_ylim(FLOOR_DB, 0)
 ax_freq.set_xlabel('Frequency (Hz)')
-ax_freq.set_ylabel('Magnitude')
-ax_freq.grid(True)
-
-# Data buffer
-audio_buffer = np.zeros(BUFFER_SIZE, dtype=np.int16)
-
-# 同步状态变量
-sync_lost = False
-sync_attempts = 0
-MAX_SYNC_ATTEMPTS = 10
-
-def find_sync():
-    """寻找数据同步点"""
-    global sync_attempts
-    
-    print("寻找数据同步点...")
-    sync_buffer = bytearray()
-    
-    # 读取足够的数据来寻找同步模式
-    while len(sync_buffer) < BUFFER_SIZE * 4:
-        sync_buffer.extend(ser.read(ser.in_waiting or 1))
-    
-    # 寻找可能的同步模式（连续几个接近0的采样值）
-    best_position = 0
-    best_score = 0
-    
-    for start in range(0, len(sync_buffer) - BUFFER_SIZE * 2, 2):
-        try:
-            # 尝试从不同位置解析数据
-            test_data = np.frombuffer(sync_buffer[start:start + BUFFER_SIZE * 2], dtype=np.int16)
-            
-            # 计算同步分数：数据不应该全是极值
-            extreme_count = np.sum(np.abs(test_data) > 30000)
-            zero_crossings = np.sum(np.diff(np.signbit(test_data)))
-            
-            score = zero_crossings - extreme_count * 10
-            
-            if score > best_score:
-                best_score = score
-                best_position = start
-        
-        except ValueError:
-            continue
-    
-    # 丢弃最佳位置之前的数据
-    if best_position > 0:
-        ser.read(best_position)
-        print(f"丢弃 {best_position} 字节数据以实现同步")
-    
-    return best_score > 0
+ax_freq.set_ylabel('Level (dBFS)')
+ax_freq.grid(True, which='both')
+ax_freq.legend(loc='upper right')
+
+# 瀑布图：横轴频带，纵轴时间（最新在下）
+waterfall = np.full((WATERFALL_ROWS, BANDS), FLOOR_DB, dtype=np.float32)
+img = ax_fall.imshow(waterfall, aspect='auto', origin='upper', vmin=FLOOR_DB, vmax=0,
+                     cmap='magma', extent=[0, BANDS, WATERFALL_ROWS, 0])
+tick_bands = np.linspace(0, BANDS - 1, 6).astype(int)
+ax_fall.set_xticks(tick_bands + 0.5)
+ax_fall.set_xticklabels([f'{centers[b]:.0f}' for b in tick_bands])
+ax_fall.set_title('Spectrogram')
+ax_fall.set_xlabel('Frequency (Hz)')
+ax_fall.set_ylabel('Frames ago')
+
+peak = np.full(BANDS, FLOOR_DB, dtype=np.float32)
+
 
 def init():
     """Initialize animation"""
-    line_time.set_ydata(np.zeros(BUFFER_SIZE))
-    line_freq.set_ydata(np.zeros(len(xf)))
-    return line_time, line_freq
+    return line_freq, line_peak, img
+
 
 def update(frame):
     """Update plots"""
-    global audio_buffer, sync_lost, sync_attempts
-    
-    # 检查同步状态
-    if sync_lost and sync_attempts < MAX_SYNC_ATTEMPTS:
-        if find_sync():
-            sync_lost = False
-            print("同步恢复成功")
-        else:
-            sync_attempts += 1
-        return line_time, line_freq
-    
-    # Read data from serial port
-    bytes_to_read = BUFFER_SIZE * 2
-    raw_data = ser.read(bytes_to_read)
-    
-    if len(raw_data) == bytes_to_read:
-        try:
-            # Convert to numpy array
-            audio_buffer = np.frombuffer(raw_data, dtype=np.int16)
-            
-            # 检查数据是否合理（同步检测）
-            max_val = np.max(np.abs(audio_buffer))
-            zero_crossings = np.sum(np.diff(np.signbit(audio_buffer)))
-            
-            # 如果数据全是极值或没有过零，认为同步丢失
-            if max_val > 32000 and zero_crossings < 10:
-                sync_lost = True
-                sync_attempts = 0
-                print("检测到同步丢失，尝试重新同步...")
-                return line_time, line_freq
-            
-            # Update time domain plot
-            line_time.set_ydata(audio_buffer)
-            
-            # Apply window function to reduce spectral leakage
-            window = np.hanning(BUFFER_SIZE)
-            windowed_data = audio_buffer * window
-            
-            # Calculate FFT
-            fft_data = np.abs(np.fft.fft(windowed_data)[:N//2])
-            fft_data = fft_data[:max_idx]  # Truncate to MAX_FREQ
-            
-            # Update frequency domain plot
-            line_freq.set_ydata(fft_data)
-            
-        except Exception as e:
-            print(f"数据处理错误: {e}")
-            sync_lost = True
-    
-    elif len(raw_data) > 0:
-        # 读取到不完整的数据包，丢弃并重新同步
-        print(f"收到不完整数据包: {len(raw_data)}/{bytes_to_read} 字节")
-        sync_lost = True
-    
-    return line_time, line_freq
+    global waterfall, peak
+
+    for hdr, levels in read_spectra():
+        if hdr[1] != BANDS:
+            continue
+        levels = np.maximum(levels, FLOOR_DB)
+        line_freq.set_ydata(levels)
+        peak = np.maximum(peak - 0.5, levels)   # 峰值每帧回落 0.5 dB
+        waterfall = np.roll(waterfall, -1, axis=0)
+        waterfall[-1] = levels
+
+    line_peak.set_ydata(peak)
+    img.set_data(waterfall)
+    return line_freq, line_peak, img
+
 
 # Create animation
 ani = FuncAnimation(
-    fig, 
-    update, 
+    fig,
+    update,
     init_func=init,
-    interval=PLOT_REFRESH_RATE, 
+    interval=PLOT_REFRESH_RATE,
     blit=True,
     cache_frame_data=False
 )
@@ -183,6 +156,8 @@ try:
 except KeyboardInterrupt:
     print("程序被用户中断")
 
+print(f"频谱帧 {stats['frames']}，CRC 错误 {stats['crc_errors']}")
+
 # Close serial port
 ser.close()
-print("Serial port closed")
\ No newline at end of file
+print("Serial port closed")
@@ -0,0 +1,233 @@
+#include "audio_io_i2s.h"
+
+#if AUDIO_IO_BACKEND == AUDIO_IO_CHANNEL
+
+#if PDM_DECIMATION == PDM_DECIM_SW
+#error "PDM_DECIM_SW 目前只在 AUDIO_IO_LEGACY 后端实现（零拷贝路径里 DMA 缓冲是位流，不能直接交给 DSP）"
+#endif
+
+#include <Arduino.h>
+#include <esp_timer.h>
+#include <driver/i2s_pdm.h>
+#include <driver/i2s_std.h>
+#include <spsc_queue.h>
+
+// =================================================
+// IDF5 i2s channel API 后端（零拷贝）
+// -------------------------------------------------
+// - RX：on_recv 回调在中断里把刚填满的 DMA 缓冲地址放进 rx_ready_，
+//       DSP 直接读 DMA 内存
+// - TX：关闭 auto_clear，on_sent 回调把刚发完的 DMA 缓冲地址放进 tx_free_，
+//       DSP 直接把下一轮要播的数据写进去；DMA 环绕一圈后自动播出
+// - 不调用 i2s_channel_read / i2s_channel_write，驱动内部队列满了只会丢指针
+// DMA 环有 depth_ 个缓冲（默认 I2S_DMA_BUF_COUNT），DSP 必须在环绕一圈之内处理完一块
+//
+// 溢出检测（驱动的 on_recv_q_ovf / on_send_q_ovf 针对它自己的消息队列，
+// 这里从不读那个队列，它们每块都会触发，没有意义）：
+// - RX overrun：ISR 推不进 rx_ready_，或 acquire_rx 跳过已被覆盖的块
+// - TX underrun：ISR 推不进 tx_free_，或 acquire_tx 跳过来不及写的缓冲
+//   （auto_clear 关闭，这些缓冲会把上一圈的旧数据再播一遍）
+// 每个计数器只有一个写者（ISR 或 DSP 任务），读时相加
+// =================================================
+
+static_assert(I2S_DMA_BUF_COUNT >= AUDIO_IO_MIN_DMA_DEPTH && I2S_DMA_BUF_COUNT <= 16,
+              "AUDIO_IO_CHANNEL：I2S_DMA_BUF_COUNT 需在 3~16（跳过过期块的阈值是深度 - 2，指针队列 16 个槽）");
+
+// IDF 5.3 起事件里直接给 dma_buf，之前是二级指针 data
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 3, 0)
+#define I2S_EVT_BUF(e) ((e)->dma_buf)
+#else
+#define I2S_EVT_BUF(e) (*(e)->data)
+#endif
+
+class I2sChannelIo : public AudioIo {
+ public:
+  // 任一步失败都删掉已建的通道、两个句柄回到 NULL（fail()），之后 reconfigure() 可以安全重试
+  bool begin() override {
+    // -------- I2S RX - PDM 麦克风 --------
+    i2s_chan_config_t rx_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_MIC_PORT, I2S_ROLE_MASTER);
+    rx_cfg.dma_desc_num  = depth_;
+    rx_cfg.dma_frame_num = block_;
+    if (i2s_new_channel(&rx_cfg, NULL, &rx_chan_) != ESP_OK) return fail();
+
+    i2s_pdm_rx_config_t pdm_cfg = {
+      .clk_cfg  = I2S_PDM_RX_CLK_DEFAULT_CONFIG(SAMPLE_RATE),
+      .slot_cfg = I2S_PDM_RX_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_16BIT, I2S_SLOT_MODE_MONO),
+      .gpio_cfg = {
+        .clk = (gpio_num_t)PDM_CLK_PIN,
+        .din = (gpio_num_t)PDM_DATA_PIN,
+        .invert_flags = { .clk_inv = false },
+      },
+    };
+    if (i2s_channel_init_pdm_rx_mode(rx_chan_, &pdm_cfg) != ESP_OK) return fail();
+
+    i2s_event_callbacks_t rx_cbs = {};
+    rx_cbs.on_recv = on_recv;
+    i2s_channel_register_event_callback(rx_chan_, &rx_cbs, this);
+
+    // -------- I2S TX - PCM5102 --------
+    i2s_chan_config_t tx_cfg = I2S_CHANNEL_DEFAULT_CONFIG(I2S_SPK_PORT, I2S_ROLE_MASTER);
+    tx_cfg.dma_desc_num  = depth_;
+    tx_cfg.dma_frame_num = block_;
+    tx_cfg.auto_clear    = false;   // 缓冲由 DSP 原地改写，驱动不能清零
+    if (i2s_new_channel(&tx_cfg, &tx_chan_, NULL) != ESP_OK) return fail();
+
+    i2s_std_config_t std_cfg = {
+      .clk_cfg  = I2S_STD_CLK_DEFAULT_CONFIG(SAMPLE_RATE),
+      .slot_cfg = I2S_STD_PHILIPS_SLOT_DEFAULT_CONFIG(I2S_DATA_BIT_WIDTH_16BIT, I2S_SLOT_MODE_STEREO),
+      .gpio_cfg = {
+        .mclk = I2S_GPIO_UNUSED,
+        .bclk = (gpio_num_t)PIN_I2S_BCK,
+        .ws   = (gpio_num_t)PIN_I2S_WS,
+        .dout = (gpio_num_t)PIN_I2S_DOUT,
+        .din  = I2S_GPIO_UNUSED,
+        .invert_flags = { .mclk_inv = false, .bclk_inv = false, .ws_inv = false },
+      },
+    };
+    if (i2s_channel_init_std_mode(tx_chan_, &std_cfg) != ESP_OK) return fail();
+
+    i2s_event_callbacks_t tx_cbs = {};
+    tx_cbs.on_sent = on_sent;
+    i2s_channel_register_event_callback(tx_chan_, &tx_cbs, this);
+
+    // 先开 TX（DMA 缓冲初始为 0，播静音），再开 RX
+    if (i2s_channel_enable(tx_chan_) != ESP_OK) return fail();
+    tx_enabled_ = true;
+    if (i2s_channel_enable(rx_chan_) != ESP_OK) return fail();
+    rx_enabled_ = true;
+    return true;
+  }
+
+  // 两个通道删掉重建；回调已注销后再清空指针队列（此时只剩消费端在读）
+  bool reconfigure(uint16_t block_frames, uint8_t dma_depth) override {
+    close_channels();
+    while (rx_ready_.discard()) {}
+    while (tx_free_.discard()) {}
+    block_ = block_frames;
+    depth_ = clamp_depth(dma_depth);
+    return begin();
+  }
+
+  bool acquire_rx(RxBuffer* out, uint32_t timeout_ms) override {
+    if (!rx_waiter_) rx_waiter_ = xTaskGetCurrentTaskHandle();
+
+    // 排队太久的块对应的 DMA 缓冲已经被下一圈覆盖，直接跳过
+    rx_skipped_ += audio_io_drop_stale(rx_ready_, depth_);
+
+    RxBuffer* b;
+    while ((b = rx_ready_.read_slot()) == NULL) {
+      if (ulTaskNotifyTake(pdTRUE, to_ticks(timeout_ms)) == 0) return false;
+    }
+    *out = *b;
+    return true;
+  }
+  void release_rx() override { rx_ready_.commit_read(); }
+
+  int16_t* acquire_tx(uint32_t timeout_ms) override {
+    if (!tx_waiter_) tx_waiter_ = xTaskGetCurrentTaskHandle();
+
+    // 同理：太早发出的空闲缓冲马上就要再次播出，来不及写，跳过
+    tx_skipped_ += audio_io_drop_stale(tx_free_, depth_);
+
+    int16_t** slot;
+    while ((slot = tx_free_.read_slot()) == NULL) {
+      if (ulTaskNotifyTake(pdTRUE, to_ticks(timeout_ms)) == 0) return NULL;
+    }
+    return *slot;
+  }
+  // 数据已经在 DMA 内存里，归还槽位即可
+  void commit_tx(uint16_t) override { tx_free_.commit_read(); }
+
+  uint16_t block_frames() const override { return block_; }
+
+  void xrun_stats(XrunStats* out) override {
+    out->rx_overruns  = rx_isr_drops_ + rx_skipped_;
+    out->tx_underruns = tx_isr_drops_ + tx_skipped_;
+  }
+
+ private:
+  // 删掉已建的通道（只 disable 已启用的），NULL 句柄跳过
+  void close_channels() {
+    if (rx_chan_) {
+      if (rx_enabled_) i2s_channel_disable(rx_chan_);
+      i2s_del_channel(rx_chan_);
+    }
+    if (tx_chan_) {
+      if (tx_enabled_) i2s_channel_disable(tx_chan_);
+      i2s_del_channel(tx_chan_);
+    }
+    rx_chan_ = tx_chan_ = NULL;
+    rx_enabled_ = tx_enabled_ = false;
+  }
+
+  bool fail() {
+    close_channels();
+    return false;
+  }
+
+  // 少于 AUDIO_IO_MIN_DMA_DEPTH 时跳过阈值为 0（每块都丢）或下溢；多于队列容量时 ISR 推不进
+  static uint8_t clamp_depth(uint8_t d) {
+    if (d < AUDIO_IO_MIN_DMA_DEPTH) return AUDIO_IO_MIN_DMA_DEPTH;
+    if (d > kQueueDepth) return kQueueDepth;
+    return d;
+  }
+
+  static TickType_t to_ticks(uint32_t ms) {
+    return ms == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(ms);
+  }
+
+  static bool IRAM_ATTR on_recv(i2s_chan_handle_t, i2s_event_data_t* e, void* ctx) {
+    I2sChannelIo* self = (I2sChannelIo*)ctx;
+    RxBuffer* b = self->rx_ready_.write_slot();
+    if (b == NULL) {
+      self->rx_isr_drops_++;
+      self->rx_seq_++;   // 序号照样前进，消费端能看到缺口
+      return false;
+    }
+    b->data      = (const int16_t*)I2S_EVT_BUF(e);
+    b->samples   = e->size / sizeof(int16_t);
+    b->seq       = self->rx_seq_++;
+    b->t_capture = (uint32_t)esp_timer_get_time();
+    self->rx_ready_.commit_write();
+
+    BaseType_t woken = pdFALSE;
+    if (self->rx_waiter_) vTaskNotifyGiveFromISR(self->rx_waiter_, &woken);
+    return woken == pdTRUE;
+  }
+
+  static bool IRAM_ATTR on_sent(i2s_chan_handle_t, i2s_event_data_t* e, void* ctx) {
+    I2sChannelIo* self = (I2sChannelIo*)ctx;
+    if (!self->tx_free_.push((int16_t*)I2S_EVT_BUF(e))) {
+      self->tx_isr_drops_++;
+      return false;
+    }
+
+    BaseType_t woken = pdFALSE;
+    if (self->tx_waiter_) vTaskNotifyGiveFromISR(self->tx_waiter_, &woken);
+    return woken == pdTRUE;
+  }
+
+  i2s_chan_handle_t rx_chan_ = NULL;
+  i2s_chan_handle_t tx_chan_ = NULL;
+  bool rx_enabled_ = false;
+  bool tx_enabled_ = false;
+  static constexpr uint8_t kQueueDepth = 16;
+  SpscQueue<RxBuffer, kQueueDepth> rx_ready_;   // ISR → DSP：刚采满的 DMA 缓冲
+  SpscQueue<int16_t*, kQueueDepth> tx_free_;    // ISR → DSP：刚播完、可以重写的 DMA 缓冲
+  volatile TaskHandle_t rx_waiter_ = NULL;
+  volatile TaskHandle_t tx_waiter_ = NULL;
+  uint32_t rx_seq_ = 0;
+  uint16_t block_ = BUFFER_SAMPLES;
+  uint8_t  depth_ = I2S_DMA_BUF_COUNT;   // AUDIO_IO_MIN_DMA_DEPTH ~ kQueueDepth
+  volatile uint32_t rx_isr_drops_ = 0;
+  volatile uint32_t tx_isr_drops_ = 0;
+  volatile uint32_t rx_skipped_   = 0;
+  volatile uint32_t tx_skipped_   = 0;
+};
+
+AudioIo* audio_io_create() {
+  static I2sChannelIo io;
+  return &io;
+}
+
+#endif  // AUDIO_IO_BACKEND == AUDIO_IO_CHANNEL
@@ -0,0 +1,196 @@
+#include "audio_io_i2s.h"
+
+#if AUDIO_IO_BACKEND == AUDIO_IO_LEGACY
+
+#include <Arduino.h>
+#include <driver/i2s.h>
+#include <pdm_decimator.h>
+
+// 软件抽取时 RX 按 32 位立体声帧收位流：帧率 = 位时钟 / 64
+#define PDM_RAW_FRAME_RATE (SAMPLE_RATE * PDM_OSR / 64)
+
+// =================================================
+// 旧 driver/i2s.h 后端
+// 驱动内部有自己的 DMA 缓冲，这里只能 i2s_read / i2s_write 拷贝进出
+// 溢出靠驱动事件队列：RX_Q_OVF = 采集块被丢，TX_Q_OVF = 没有新数据，
+// DMA 播了 auto_clear 清零的缓冲
+// =================================================
+
+// 驱动每完成一块也会发一个 DONE 事件，队列满时丢最老的事件，
+// 所以每块都要排空一次，否则 OVF 事件会被 DONE 挤掉
+#define I2S_EVENT_QUEUE_LEN 8
+
+class I2sLegacyIo : public AudioIo {
+ public:
+  bool begin() override {
+#if PDM_DECIMATION == PDM_DECIM_SW
+    // -------- I2S RX - 原始 PDM 位流（标准模式，BCLK 当 PDM 时钟）--------
+    // 每帧左右两个 32 位槽 = 64 个位时钟，两个槽都收，内存里就是连续位流
+    i2s_config_t mic_config = {
+      .mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX),
+      .sample_rate = PDM_RAW_FRAME_RATE,
+      .bits_per_sample = I2S_BITS_PER_SAMPLE_32BIT,
+      .channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT,
+      .communication_format = I2S_COMM_FORMAT_STAND_MSB,   // 无 1 位延迟
+      .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
+      .dma_buf_count = depth_,
+      .dma_buf_len = block_ * PDM_OSR / 64,
+      .use_apll = true,
+      .tx_desc_auto_clear = false,
+      .fixed_mclk = 0
+    };
+
+    i2s_pin_config_t mic_pins = {
+      .mck_io_num = I2S_PIN_NO_CHANGE,
+      .bck_io_num = PDM_CLK_PIN,
+      .ws_io_num  = I2S_PIN_NO_CHANGE,
+      .data_out_num = I2S_PIN_NO_CHANGE,
+      .data_in_num  = PDM_DATA_PIN
+    };
+
+    if (i2s_driver_install(I2S_MIC_PORT, &mic_config, I2S_EVENT_QUEUE_LEN, &rx_events_) != ESP_OK) return false;
+    i2s_set_pin(I2S_MIC_PORT, &mic_pins);
+    i2s_set_clk(I2S_MIC_PORT, PDM_RAW_FRAME_RATE,
+                I2S_BITS_PER_SAMPLE_32BIT,
+                I2S_CHANNEL_STEREO);
+    pdm_.reset();   // 两个槽在缓冲里的先后见 PDM_SW_SLOT_SWAP
+#else
+    // -------- I2S RX - PDM 麦克风（硬件抽取）--------
+    i2s_config_t mic_config = {
+      .mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_PDM),
+      .sample_rate = SAMPLE_RATE,
+      .bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT,
+      .channel_format = I2S_CHANNEL_FMT_ONLY_LEFT,
+      .communication_format = I2S_COMM_FORMAT_STAND_I2S,
+      .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
+      .dma_buf_count = depth_,
+      .dma_buf_len = block_,
+      .use_apll = true,
+      .tx_desc_auto_clear = false,
+      .fixed_mclk = 0
+    };
+
+    i2s_pin_config_t mic_pins = {
+      .mck_io_num = I2S_PIN_NO_CHANGE,
+      .bck_io_num = I2S_PIN_NO_CHANGE,
+      .ws_io_num  = PDM_CLK_PIN,
+      .data_out_num = I2S_PIN_NO_CHANGE,
+      .data_in_num  = PDM_DATA_PIN
+    };
+
+    if (i2s_driver_install(I2S_MIC_PORT, &mic_config, I2S_EVENT_QUEUE_LEN, &rx_events_) != ESP_OK) return false;
+    i2s_set_pin(I2S_MIC_PORT, &mic_pins);
+    i2s_set_clk(I2S_MIC_PORT, SAMPLE_RATE,
+                I2S_BITS_PER_SAMPLE_16BIT,
+                I2S_CHANNEL_MONO);
+#endif
+
+    // -------- I2S TX - PCM5102 --------
+    i2s_config_t spk_config = {
+      .mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX),
+      .sample_rate = SAMPLE_RATE,
+      .bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT,
+      .channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT,
+      .communication_format = I2S_COMM_FORMAT_STAND_I2S,
+      .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
+      .dma_buf_count = depth_,
+      .dma_buf_len = block_,
+      .use_apll = false,
+      .tx_desc_auto_clear = true,
+      .fixed_mclk = 0
+    };
+
+    i2s_pin_config_t spk_pins = {
+      .mck_io_num = I2S_PIN_NO_CHANGE,
+      .bck_io_num = PIN_I2S_BCK,
+      .ws_io_num  = PIN_I2S_WS,
+      .data_out_num = PIN_I2S_DOUT,
+      .data_in_num  = I2S_PIN_NO_CHANGE
+    };
+
+    if (i2s_driver_install(I2S_SPK_PORT, &spk_config, I2S_EVENT_QUEUE_LEN, &tx_events_) != ESP_OK) return false;
+    i2s_set_pin(I2S_SPK_PORT, &spk_pins);
+    return true;
+  }
+
+  // 驱动整个卸载重装，事件队列也跟着重建
+  bool reconfigure(uint16_t block_frames, uint8_t dma_depth) override {
+    i2s_driver_uninstall(I2S_MIC_PORT);
+    i2s_driver_uninstall(I2S_SPK_PORT);
+    block_ = block_frames;
+    depth_ = dma_depth;
+    return begin();
+  }
+
+  bool acquire_rx(RxBuffer* out, uint32_t timeout_ms) override {
+    size_t bytes_read = 0;
+#if PDM_DECIMATION == PDM_DECIM_SW
+    i2s_read(I2S_MIC_PORT, pdm_raw_, block_ * PDM_OSR / 8, &bytes_read,
+             timeout_ms == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms));
+    rx_overruns_ += drain(rx_events_, I2S_EVENT_RX_Q_OVF);
+    if (bytes_read == 0) return false;
+#if PDM_SW_SLOT_SWAP
+    pdm_swap_slots(pdm_raw_, bytes_read / sizeof(uint32_t));   // 32 位立体声每帧 8 字节，总是成对
+#endif
+    out->samples   = pdm_.process(pdm_raw_, bytes_read / sizeof(uint32_t), rx_buf_);
+#else
+    i2s_read(I2S_MIC_PORT, rx_buf_, block_ * sizeof(int16_t), &bytes_read,
+             timeout_ms == UINT32_MAX ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms));
+    rx_overruns_ += drain(rx_events_, I2S_EVENT_RX_Q_OVF);
+    if (bytes_read == 0) return false;
+    out->samples   = bytes_read / sizeof(int16_t);
+#endif
+    out->data      = rx_buf_;
+    out->seq       = rx_seq_++;
+    out->t_capture = micros();
+    return true;
+  }
+  void release_rx() override {}
+
+  int16_t* acquire_tx(uint32_t) override { return tx_buf_; }
+  void commit_tx(uint16_t frames) override {
+    size_t bytes_written = 0;
+    i2s_write(I2S_SPK_PORT, tx_buf_, frames * 2 * sizeof(int16_t),
+              &bytes_written, portMAX_DELAY);
+    tx_underruns_ += drain(tx_events_, I2S_EVENT_TX_Q_OVF);
+  }
+
+  uint16_t block_frames() const override { return block_; }
+
+  void xrun_stats(XrunStats* out) override {
+    out->rx_overruns  = rx_overruns_;
+    out->tx_underruns = tx_underruns_;
+  }
+
+ private:
+  // 不等待地取完队列里的事件，返回其中 ovf 类型的个数
+  static uint32_t drain(QueueHandle_t q, i2s_event_type_t ovf) {
+    i2s_event_t e;
+    uint32_t n = 0;
+    while (xQueueReceive(q, &e, 0) == pdTRUE) {
+      if (e.type == ovf) n++;
+    }
+    return n;
+  }
+
+  uint16_t block_ = BUFFER_SAMPLES;
+  uint8_t  depth_ = I2S_DMA_BUF_COUNT;
+  int16_t rx_buf_[BUFFER_SAMPLES_MAX];
+#if PDM_DECIMATION == PDM_DECIM_SW
+  uint32_t pdm_raw_[BUFFER_SAMPLES_MAX * PDM_OSR / 32];
+  PdmDecimator pdm_{PDM_OSR, PDM_PASSBAND};
+#endif
+  alignas(4) int16_t tx_buf_[BUFFER_SAMPLES_MAX * 2];
+  uint32_t rx_seq_ = 0;
+  QueueHandle_t rx_events_ = NULL;
+  QueueHandle_t tx_events_ = NULL;
+  volatile uint32_t rx_overruns_  = 0;   // 只由 RX 任务写
+  volatile uint32_t tx_underruns_ = 0;   // 只由 TX 任务写
+};
+
+AudioIo* audio_io_create() {
+  static I2sLegacyIo io;
+  return &io;
+}
+
+#endif  // AUDIO_IO_BACKEND == AUDIO_IO_LEGACY
@@ -0,0 +1,500 @@
+#include "audio_pipeline.h"
+#include <atomic>
+#include <spsc_queue.h>
+#include <gain_kernel.h>
+#include <biquad.h>
+#include <howl_suppressor.h>
+#include <agc.h>
+#include <pop_guard.h>
+#include <gain_ramp.h>
+#include <runtime_chain.h>
+#include <buffer_controller.h>
+#include "uplink.h"
+#include "ui.h"
+#include "telemetry.h"
+
+static SpscQueue<MicBlock, PIPELINE_QUEUE_DEPTH> mic_q;
+static SpscQueue<SpkBlock, PIPELINE_QUEUE_DEPTH> spk_q;
+
+static AudioIo* io = NULL;
+
+static TaskHandle_t rx_handle  = NULL;
+static TaskHandle_t dsp_handle = NULL;
+static TaskHandle_t tx_handle  = NULL;
+
+static PipelineStats stats = {};
+
+#if ADAPTIVE_BUFFER_ENABLE && AUDIO_PIPELINE_MODE == PIPELINE_TASKS
+#error "ADAPTIVE_BUFFER_ENABLE 需要 PIPELINE_LOOP 或 PIPELINE_DIRECT：TASKS 模式下 RX/TX 两个任务同时阻塞在 io 里，没法安全重建"
+#endif
+
+// =================================================
+// DSP
+// =================================================
+static_assert(MIC_GAIN >= 0.0f && MIC_GAIN < 16.0f, "MIC_GAIN 超出 Q4.12 范围 [0, 16)，增益乘积会溢出 int32");
+static constexpr int32_t MIC_GAIN_Q12 = gain_to_q12(MIC_GAIN);
+static constexpr int32_t UNITY_Q12    = gain_to_q12(1.0f);
+
+#if DSP_HOTSWAP_ENABLE
+static_assert(RT_FILTER_BANDPASS == FILTER_BANDPASS && RT_FILTER_LOWPASS == FILTER_LOWPASS &&
+              RT_FILTER_HIGHPASS == FILTER_HIGHPASS && RT_FILTER_NONE == FILTER_NONE,
+              "RT_FILTER_* 和 FILTER_* 取值要一致");
+
+// 上电初值就是编译期配置
+static DspParams initial_params() {
+  DspParams p = {};
+  dsp_params_set_butter(&p, SAMPLE_RATE, FILTER_TYPE, FILTER_FREQ_LOW, FILTER_FREQ_HIGH);
+  p.gain_q12 = AGC_ENABLE ? UNITY_Q12 : MIC_GAIN_Q12;
+  p.ceiling  = 32767;
+  p.agc_target_db   = AGC_TARGET_DB;
+  p.agc_max_gain_db = AGC_MAX_GAIN_DB;
+  return p;
+}
+
+static RuntimeChain rt_chain(SAMPLE_RATE, initial_params());
+static DspParams rt_shadow = initial_params();   // 控制任务那边最近一次发布成功的参数
+#elif FILTER_TYPE != FILTER_NONE
+#if FILTER_TYPE == FILTER_BANDPASS
+static constexpr auto kFilterSos = butter_bandpass<4>(SAMPLE_RATE, FILTER_FREQ_LOW, FILTER_FREQ_HIGH);
+#elif FILTER_TYPE == FILTER_LOWPASS
+static constexpr auto kFilterSos = butter_lowpass<4>(SAMPLE_RATE, FILTER_FREQ_HIGH);
+#elif FILTER_TYPE == FILTER_HIGHPASS
+static constexpr auto kFilterSos = butter_highpass<4>(SAMPLE_RATE, FILTER_FREQ_LOW);
+#endif
+#if FILTER_FIXED_POINT
+static BiquadCascadeQ28<kFilterSos.kSections> prefilter(kFilterSos);
+static int32_t filter_scratch[BUFFER_SAMPLES_MAX];
+#else
+static BiquadCascadeF32<kFilterSos.kSections> prefilter(kFilterSos);
+static float filter_scratch[BUFFER_SAMPLES_MAX];
+#endif
+#endif
+
+#if HOWL_ENABLE
+static HowlSuppressor howl(SAMPLE_RATE);
+#endif
+
+#if AGC_ENABLE
+static Agc agc(SAMPLE_RATE);
+#endif
+
+#if POP_GUARD_ENABLE
+static PopGuard pop_guard(SAMPLE_RATE);
+static int16_t guarded[BUFFER_SAMPLES_MAX];   // 保护后的单声道，DSP / 上行 / UI 共用
+#endif
+
+#if LATENCY_CAL_ENABLE
+static LatencyProbe probe(SAMPLE_RATE, LATENCY_CAL_CHIRP, LATENCY_CAL_MAX_DELAY);
+#endif
+
+#if ADAPTIVE_BUFFER_ENABLE
+// 切换档位时的输出淡入淡出，只由持有 io 的音频任务读写
+static GainRamp fade(GainRamp::kUnity / (SAMPLE_RATE * BUFFER_FADE_MS / 1000));
+#endif
+
+// raw 是 DMA 里的原始采集（回环测量要看没被静音过的回声），in 是爆音保护之后的
+static void dsp_chain(const int16_t* raw, const int16_t* in, int16_t* out, int samples) {
+  static int16_t work[BUFFER_SAMPLES_MAX];   // 原地处理的级用它，不改 DMA 里的采集数据
+
+#if LATENCY_CAL_ENABLE
+  // 测量中：录原始采集，输出整块换成探测信号（不过滤波/增益，避免回声被再次放出去）
+  if (probe.process(raw, work, samples)) {
+    gain_interleave(work, out, samples, UNITY_Q12);
+    return;
+  }
+#endif
+
+#if DSP_HOTSWAP_ENABLE
+  // 块开头取新参数：没有新参数时只是一次原子读
+  if (rt_chain.update()) {
+#if AGC_ENABLE
+    agc.set_levels(rt_chain.params().agc_target_db, rt_chain.params().agc_max_gain_db);
+#endif
+  }
+  in = rt_chain.filter(in, work, samples);
+#elif FILTER_TYPE != FILTER_NONE
+  prefilter.process(in, work, filter_scratch, samples);
+  in = work;
+#endif
+
+#if HOWL_ENABLE
+  if (in != work) memcpy(work, in, samples * sizeof(int16_t));
+  howl.process(work, samples);
+  in = work;
+#endif
+
+#if AGC_ENABLE
+  agc.process(in, work, samples);   // in 可能就是 work，AGC 支持原地
+  in = work;
+#endif
+
+#if DSP_HOTSWAP_ENABLE
+  rt_chain.output(in, out, samples);
+#elif AGC_ENABLE
+  gain_interleave(in, out, samples, UNITY_Q12);
+#else
+  gain_interleave(in, out, samples, MIC_GAIN_Q12);
+#endif
+}
+
+const int16_t* dsp_process_block(const int16_t* in, int16_t* out, int samples) {
+  const int16_t* mono = in;
+#if POP_GUARD_ENABLE
+  pop_guard.process(in, guarded, samples);
+  mono = guarded;
+#endif
+  dsp_chain(in, mono, out, samples);
+#if ADAPTIVE_BUFFER_ENABLE
+  fade.apply(out, samples, 2);
+#endif
+  return mono;
+}
+
+// =================================================
+// 运行时调参：控制任务一侧（只从一个任务调用）
+// =================================================
+bool pipeline_set_params(const DspParams& p) {
+#if DSP_HOTSWAP_ENABLE
+  const uint32_t t0 = millis();
+  while (!rt_chain.publish(p)) {
+    if (millis() - t0 >= DSP_PARAM_WAIT_MS) return false;
+    vTaskDelay(1);
+  }
+  rt_shadow = p;
+  return true;
+#else
+  return false;
+#endif
+}
+
+void pipeline_get_params(DspParams* out) {
+#if DSP_HOTSWAP_ENABLE
+  *out = rt_shadow;
+#else
+  *out = DspParams{};
+#endif
+}
+
+bool pipeline_set_filter(int type, float lo_hz, float hi_hz) {
+  DspParams p;
+  pipeline_get_params(&p);
+  return dsp_params_set_butter(&p, SAMPLE_RATE, type, lo_hz, hi_hz) && pipeline_set_params(p);
+}
+
+bool pipeline_set_gain(float gain) {
+  DspParams p;
+  pipeline_get_params(&p);
+  return dsp_params_set_gain(&p, gain) && pipeline_set_params(p);
+}
+
+bool pipeline_set_ceiling(float ceiling_dbfs) {
+  DspParams p;
+  pipeline_get_params(&p);
+  dsp_params_set_ceiling(&p, ceiling_dbfs);
+  return pipeline_set_params(p);
+}
+
+bool pipeline_set_agc(float target_db, float max_gain_db) {
+  if (!(target_db < 0 && max_gain_db >= 0)) return false;
+  DspParams p;
+  pipeline_get_params(&p);
+  p.agc_target_db   = target_db;
+  p.agc_max_gain_db = max_gain_db;
+  return pipeline_set_params(p);
+}
+
+// =================================================
+// 自适应缓冲：遥测任务出决策，音频任务在块边界执行
+// =================================================
+#if ADAPTIVE_BUFFER_ENABLE
+static constexpr BufferLevel kBufferLevels[] = BUFFER_LEVELS;
+static constexpr int kBufferLevelCount = sizeof(kBufferLevels) / sizeof(kBufferLevels[0]);
+
+// 零拷贝后端按“深度 - 2”跳过过期块，深度至少 AUDIO_IO_MIN_DMA_DEPTH
+static constexpr int kMinDmaDepth = AUDIO_IO_BACKEND == AUDIO_IO_CHANNEL ? AUDIO_IO_MIN_DMA_DEPTH : 2;
+
+static constexpr bool levels_fit(int i = 0) {
+  return i == kBufferLevelCount ||
+         (kBufferLevels[i].block_frames <= BUFFER_SAMPLES_MAX &&
+          kBufferLevels[i].dma_depth >= kMinDmaDepth && kBufferLevels[i].dma_depth <= 16 &&
+          levels_fit(i + 1));
+}
+static_assert(levels_fit(), "BUFFER_LEVELS：块帧数不能超过 BUFFER_SAMPLES_MAX，DMA 深度需在 2~16（AUDIO_IO_CHANNEL 为 3~16）");
+static BufferController buffer_ctl(kBufferLevels, kBufferLevelCount, SAMPLE_RATE,
+                                   {BUFFER_GROW_XRUNS, BUFFER_GROW_LOAD, BUFFER_SHRINK_LOAD,
+                                    BUFFER_SHRINK_WINDOWS, BUFFER_COOLDOWN_WINDOWS});
+static std::atomic<int> wanted_level{0};          // 遥测任务写
+static std::atomic<int> active_level{0};          // 音频任务写
+static std::atomic<uint32_t> reconfig_failures{0};
+static int muted_blocks = 0;
+#endif
+
+void pipeline_tune_buffers(uint32_t xruns, uint32_t dsp_p99_ns) {
+#if ADAPTIVE_BUFFER_ENABLE
+  // 重建失败时音频任务已退回原档位，控制器跟着对齐
+  static uint32_t seen_failures = 0;
+  const uint32_t failures = reconfig_failures.load(std::memory_order_acquire);
+  if (failures != seen_failures) {
+    seen_failures = failures;
+    buffer_ctl.force_level(active_level.load(std::memory_order_relaxed));
+    Serial.println("❌ I2S 重建失败，退回原档位");
+    return;
+  }
+
+  if (!buffer_ctl.update(xruns, dsp_p99_ns)) return;
+  const BufferLevel& lv = buffer_ctl.current();
+  wanted_level.store(buffer_ctl.level(), std::memory_order_release);
+  Serial.printf("🔧 缓冲切到 %u 帧 × %u（xrun=%u，DSP 负载 %.0f%%）\n",
+                lv.block_frames, lv.dma_depth, xruns, buffer_ctl.last_load() * 100);
+#endif
+}
+
+void pipeline_service_reconfig(AudioIo* audio_io) {
+#if ADAPTIVE_BUFFER_ENABLE
+  const int want = wanted_level.load(std::memory_order_acquire);
+  const int cur_level = active_level.load(std::memory_order_relaxed);
+  if (want == cur_level) return;
+
+  // 1. 淡出
+  if (fade.dir() >= 0) {
+    fade.fade_out();
+    muted_blocks = 0;
+    return;
+  }
+  if (fade.gain() > 0) return;
+
+  // 2. 再写满一圈静音，把 DMA 环里残留的淡出尾巴播完
+  const BufferLevel& cur = kBufferLevels[cur_level];
+  if (muted_blocks++ < cur.dma_depth) return;
+
+  // 3. 重建 io；失败就退回原档位
+  const BufferLevel& lv = kBufferLevels[want];
+  if (audio_io->reconfigure(lv.block_frames, lv.dma_depth)) {
+    active_level.store(want, std::memory_order_relaxed);
+  } else {
+    audio_io->reconfigure(cur.block_frames, cur.dma_depth);
+    int expected = want;   // 不再重试；遥测任务看到失败计数后对齐控制器
+    wanted_level.compare_exchange_strong(expected, cur_level);
+    reconfig_failures.fetch_add(1, std::memory_order_release);
+  }
+
+  // 4. 淡入；重建后头几块 DMA 数据不可信，输入侧重新走一遍启动静音
+#if POP_GUARD_ENABLE
+  pop_guard.restart();
+#endif
+  fade.fade_in();
+#endif
+}
+
+// =================================================
+// 1️⃣ RX：只负责把 DMA 数据搬进 mic_q，永远不等下游
+// =================================================
+static void rx_task(void* arg) {
+  static MicBlock scratch;   // 队列满时仍要读空 DMA，读到这里丢弃
+
+  for (;;) {
+    MicBlock* blk = mic_q.write_slot();
+    const bool dropped = (blk == NULL);
+    if (dropped) blk = &scratch;
+
+    RxBuffer rb;
+    uint32_t c0 = cycle_now();
+    if (!io->acquire_rx(&rb, UINT32_MAX)) continue;
+    telem_record(TELEM_STAGE_RX_WAIT, cycle_now() - c0);
+    memcpy(blk->data, rb.data, rb.samples * sizeof(int16_t));
+    blk->seq       = rb.seq;
+    blk->t_capture = rb.t_capture;
+    blk->samples   = rb.samples;
+    io->release_rx();
+
+    if (dropped) {
+      stats.rx_dropped++;
+      continue;
+    }
+    mic_q.commit_write();
+    stats.rx_blocks++;
+    xTaskNotifyGive(dsp_handle);
+  }
+}
+
+// =================================================
+// 2️⃣ DSP：被 RX 唤醒后把 mic_q 里的块全部处理完
+// =================================================
+static void dsp_task(void* arg) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    MicBlock* in;
+    while ((in = mic_q.read_slot()) != NULL) {
+      SpkBlock* out = spk_q.write_slot();
+      if (out == NULL) {
+        // TX 跟不上：丢最老的输入，保持延迟有界
+        stats.dsp_dropped++;
+        mic_q.commit_read();
+        continue;
+      }
+
+      uint32_t c0 = cycle_now();
+      const int16_t* mono = dsp_process_block(in->data, out->data, in->samples);
+      telem_record(TELEM_STAGE_DSP, cycle_now() - c0);
+      uplink_push(mono, in->samples, in->t_capture);
+      ui_push(mono, in->samples);
+
+      out->seq       = in->seq;
+      out->t_capture = in->t_capture;
+      out->samples   = in->samples;
+      mic_q.commit_read();
+      spk_q.commit_write();
+      xTaskNotifyGive(tx_handle);
+
+      stats.dsp_blocks++;
+    }
+  }
+}
+
+// =================================================
+// 3️⃣ TX：把 spk_q 里的块写进 DMA
+// =================================================
+static void tx_task(void* arg) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    SpkBlock* blk;
+    while ((blk = spk_q.read_slot()) != NULL) {
+      uint32_t queued = micros() - blk->t_capture;
+      if (queued > stats.latency_max_us) stats.latency_max_us = queued;
+
+      uint32_t c0 = cycle_now();
+      int16_t* dst = io->acquire_tx(UINT32_MAX);
+      if (dst) {
+        memcpy(dst, blk->data, blk->samples * 2 * sizeof(int16_t));
+        io->commit_tx(blk->samples);
+      }
+      telem_record(TELEM_STAGE_TX_WAIT, cycle_now() - c0);
+      spk_q.commit_read();
+      stats.tx_blocks++;
+    }
+  }
+}
+
+// =================================================
+// DIRECT：单任务在后端借出的缓冲上原地处理
+// =================================================
+static void direct_task(void* arg) {
+  for (;;) {
+    pipeline_service_reconfig(io);
+
+    RxBuffer rb;
+    uint32_t c0 = cycle_now();
+    if (!io->acquire_rx(&rb, UINT32_MAX)) continue;
+    uint32_t c1 = cycle_now();
+    telem_record(TELEM_STAGE_RX_WAIT, c1 - c0);
+    stats.rx_blocks++;
+
+    int16_t* dst = io->acquire_tx(UINT32_MAX);
+    uint32_t c2 = cycle_now();
+    if (dst == NULL) {
+      stats.dsp_dropped++;
+      io->release_rx();
+      continue;
+    }
+
+    const int16_t* mono = dsp_process_block(rb.data, dst, rb.samples);
+    uint32_t c3 = cycle_now();
+    uplink_push(mono, rb.samples, rb.t_capture);
+    ui_push(mono, rb.samples);
+
+    io->release_rx();
+    io->commit_tx(rb.samples);
+    uint32_t c4 = cycle_now();
+    telem_record(TELEM_STAGE_DSP, c3 - c2);
+    telem_record(TELEM_STAGE_TX_WAIT, (c2 - c1) + (c4 - c3));
+
+    uint32_t queued = micros() - rb.t_capture;
+    stats.dsp_blocks++;
+    stats.tx_blocks++;
+    if (queued > stats.latency_max_us) stats.latency_max_us = queued;
+  }
+}
+
+bool pipeline_start(AudioIo* audio_io) {
+  io = audio_io;
+
+#if AUDIO_PIPELINE_MODE == PIPELINE_DIRECT
+  return xTaskCreatePinnedToCore(direct_task, "audio_dsp", PIPELINE_STACK, NULL,
+                                 PIPELINE_DSP_PRIO, &dsp_handle,
+                                 PIPELINE_DSP_CORE) == pdPASS;
+#else
+  // 消费者先建，保证生产者通知时句柄已有效
+  if (xTaskCreatePinnedToCore(tx_task, "audio_tx", PIPELINE_STACK, NULL,
+                              PIPELINE_TX_PRIO, &tx_handle,
+                              PIPELINE_IO_CORE) != pdPASS) return false;
+  if (xTaskCreatePinnedToCore(dsp_task, "audio_dsp", PIPELINE_STACK, NULL,
+                              PIPELINE_DSP_PRIO, &dsp_handle,
+                              PIPELINE_DSP_CORE) != pdPASS) return false;
+  if (xTaskCreatePinnedToCore(rx_task, "audio_rx", PIPELINE_STACK, NULL,
+                              PIPELINE_RX_PRIO, &rx_handle,
+                              PIPELINE_IO_CORE) != pdPASS) return false;
+  return true;
+#endif
+}
+
+bool pipeline_arm_latency_probe() {
+#if LATENCY_CAL_ENABLE
+  return probe.arm();
+#else
+  return false;
+#endif
+}
+
+bool pipeline_poll_latency(LatencyResult* out) {
+#if LATENCY_CAL_ENABLE
+  if (probe.state() != LatencyProbe::CAPTURED) return false;
+  *out = probe.analyze();
+  return true;
+#else
+  return false;
+#endif
+}
+
+void pipeline_get_stats(PipelineStats* out) {
+  out->rx_blocks      = stats.rx_blocks;
+  out->rx_dropped     = stats.rx_dropped;
+  out->dsp_blocks     = stats.dsp_blocks;
+  out->dsp_dropped    = stats.dsp_dropped;
+  out->tx_blocks      = stats.tx_blocks;
+  out->latency_max_us = stats.latency_max_us;
+#if HOWL_ENABLE
+  out->howl_notches   = howl.notch_count();
+  out->howl_deployed  = howl.stats().deployed;
+#else
+  out->howl_notches   = 0;
+  out->howl_deployed  = 0;
+#endif
+#if POP_GUARD_ENABLE
+  out->pop_events     = pop_guard.stats().events;
+  out->pop_muted_samples = pop_guard.stats().muted_samples;
+#else
+  out->pop_events     = 0;
+  out->pop_muted_samples = 0;
+#endif
+#if AGC_ENABLE
+  out->agc_gain_db    = agc.gain_db();
+  out->agc_level_db   = agc.level_db();
+  out->agc_floor_db   = agc.floor_db();
+  out->agc_soft_clipped = agc.soft_clipped();
+#else
+#if DSP_HOTSWAP_ENABLE
+  out->agc_gain_db    = 20.0f * log10f((float)rt_shadow.gain_q12 / GAIN_Q_ONE + 1e-6f);
+#else
+  out->agc_gain_db    = 20.0f * log10f(MIC_GAIN);
+#endif
+  out->agc_level_db   = 0;
+  out->agc_floor_db   = 0;
+  out->agc_soft_clipped = 0;
+#endif
+}
+
+void pipeline_reset_latency_max() {
+  stats.latency_max_us = 0;
+}
@@ -0,0 +1,93 @@
+#include "capture.h"
+
+#if CAPTURE_ENABLE
+
+#include <atomic>
+#include <esp_heap_caps.h>
+
+#define CAPTURE_PRE_SAMPLES  ((uint32_t)((uint64_t)SAMPLE_RATE * CAPTURE_PRE_MS / 1000))
+#define CAPTURE_POST_SAMPLES ((uint32_t)((uint64_t)SAMPLE_RATE * CAPTURE_POST_MS / 1000))
+
+static_assert(CAPTURE_DRAIN_PERCENT > 100, "CAPTURE_DRAIN_PERCENT 不超过实时就永远追不上");
+
+static PretriggerBuffer* ring = NULL;
+static std::atomic<int> pending{-1};   // 挂起的触发原因，-1 = 没有
+static CaptureStats stats = {};
+static uint32_t budget = 0;            // 读出额度（样本 × 100）
+
+bool capture_start() {
+  // 读速高于实时时读位置离写位置不超过 pre，所以容量 = pre + 一块，向上取 2 的幂
+  uint32_t cap = 1;
+  while (cap < CAPTURE_PRE_SAMPLES + BUFFER_SAMPLES_MAX) cap <<= 1;
+  void* mem = heap_caps_malloc(cap * sizeof(int16_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (mem == NULL) return false;
+  static PretriggerBuffer buf((int16_t*)mem, cap, SAMPLE_RATE);
+  ring = &buf;
+  return true;
+}
+
+bool capture_trigger(uint8_t reason) {
+  int expected = -1;
+  return pending.compare_exchange_strong(expected, reason);
+}
+
+void capture_feed(const int16_t* mono, int samples, uint32_t t_capture) {
+  if (ring == NULL) return;
+  ring->write(mono, samples, t_capture);
+
+#if CAPTURE_LEVEL_TRIGGER
+  // 过门限触发一次，峰值回落到门限以下才重新待触发（持续的大声音不会连着触发）
+  static bool armed = true;
+  static const int32_t threshold = (int32_t)(32768.0f * powf(10.0f, CAPTURE_LEVEL_DBFS / 20.0f));
+  int32_t peak = 0;
+  for (int i = 0; i < samples; i++) {
+    const int32_t a = mono[i] < 0 ? -mono[i] : mono[i];
+    if (a > peak) peak = a;
+  }
+  if (peak >= threshold) {
+    if (armed && !ring->busy()) capture_trigger(CAPTURE_REASON_LEVEL);
+    armed = false;
+  } else {
+    armed = true;
+  }
+#endif
+
+  const int reason = pending.exchange(-1);
+  if (reason >= 0) {
+    if (ring->trigger((uint8_t)reason, CAPTURE_PRE_SAMPLES, CAPTURE_POST_SAMPLES)) {
+      stats.jobs++;
+    } else {
+      stats.busy++;
+    }
+  }
+
+  // 额度只在有捕获时累积，封顶两块，空闲之后不会一下子猛发
+  if (ring->busy()) {
+    budget += (uint32_t)samples * CAPTURE_DRAIN_PERCENT;
+    if (budget > 2 * CAPTURE_CHUNK_SAMPLES * 100) budget = 2 * CAPTURE_CHUNK_SAMPLES * 100;
+  } else {
+    budget = 0;
+  }
+}
+
+uint32_t capture_read(int16_t* out, uint32_t max, CaptureChunk* info) {
+  if (ring == NULL || budget < max * 100) return 0;
+  const uint32_t n = ring->read(out, max, info);
+  if (n == 0) return 0;
+  budget -= n * 100;
+  stats.chunks++;
+  stats.lost = ring->lost_samples();
+  return n;
+}
+
+void capture_get_stats(CaptureStats* out) { *out = stats; }
+
+#else
+
+bool capture_start() { return true; }
+bool capture_trigger(uint8_t) { return false; }
+void capture_feed(const int16_t*, int, uint32_t) {}
+uint32_t capture_read(int16_t*, uint32_t, CaptureChunk*) { return 0; }
+void capture_get_stats(CaptureStats* out) { *out = CaptureStats{}; }
+
+#endif  // CAPTURE_ENABLE
@@ -0,0 +1,273 @@
+#include "control.h"
+#include <atomic>
+#include <frame_decoder.h>
+#include <command_record.h>
+#include <gain_kernel.h>
+#include <agc.h>
+#include "audio_pipeline.h"
+#include "uplink.h"
+#include "capture.h"
+#include "link_port.h"
+
+#if CONTROL_ACTIVE
+
+static AudioIo* io = NULL;
+static ControlStats stats = {};                 // commands / errors 只由命令任务写
+static std::atomic<uint32_t> bulk_waits{0};     // 上行、遥测、捕获任务都会写
+
+// 滤波的类型 / 频率：DspParams 里只有算好的系数，这里记下最近一次设成功的
+static int   filter_type = FILTER_TYPE;
+static float filter_lo   = FILTER_FREQ_LOW;
+static float filter_hi   = FILTER_FREQ_HIGH;
+
+void control_write_bulk(const uint8_t* data, size_t len) {
+  if (link_write_bulk(*link_port(), data, len, [] { vTaskDelay(1); })) {
+    bulk_waits.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+// =================================================
+// 参数读写
+// =================================================
+static bool is_dsp_param(uint16_t id) {
+  return id >= PARAM_GAIN && id <= PARAM_AGC_MAX_DB;
+}
+
+static uint8_t get_param(uint16_t id, float* v) {
+#if DSP_HOTSWAP_ENABLE
+  DspParams p;
+  pipeline_get_params(&p);
+#endif
+  if (is_dsp_param(id) && !DSP_HOTSWAP_ENABLE) return CMD_ERR_UNSUPPORTED;
+  switch (id) {
+#if DSP_HOTSWAP_ENABLE
+    case PARAM_GAIN:          *v = (float)p.gain_q12 / GAIN_Q_ONE; break;
+    case PARAM_CEILING_DB:    *v = p.ceiling >= 32767 ? 0.0f : 20.0f * log10f(p.ceiling / 32767.0f); break;
+    case PARAM_FILTER:        *v = (float)filter_type; break;
+    case PARAM_FILTER_LO:     *v = filter_lo; break;
+    case PARAM_FILTER_HI:     *v = filter_hi; break;
+    case PARAM_AGC_TARGET_DB: *v = p.agc_target_db; break;
+    case PARAM_AGC_MAX_DB:    *v = p.agc_max_gain_db; break;
+#endif
+    case PARAM_STREAM:        *v = uplink_streaming() ? 1.0f : 0.0f; break;
+    case PARAM_SAMPLE_RATE:   *v = (float)SAMPLE_RATE; break;
+    case PARAM_UPLINK_RATE:   *v = (float)UPLINK_SAMPLE_RATE; break;
+    case PARAM_BLOCK:         *v = (float)io->block_frames(); break;
+    default:                  return CMD_ERR_UNKNOWN;
+  }
+  return CMD_OK;
+}
+
+// 所有项先在副本上改、检查，最后一次 pipeline_set_params，要么全生效要么都不生效
+static uint8_t set_params(const CommandRecord& cmd) {
+  for (int i = 0; i < cmd.count; i++) {
+    const uint16_t id = cmd.item[i].id;
+    if (!command_param_name(id)) return CMD_ERR_UNKNOWN;
+    if (!command_param_writable(id)) return CMD_ERR_ARGS;
+    if (is_dsp_param(id) && !DSP_HOTSWAP_ENABLE) return CMD_ERR_UNSUPPORTED;
+  }
+
+  int stream = -1;
+#if DSP_HOTSWAP_ENABLE
+  DspParams p;
+  pipeline_get_params(&p);
+  int type = filter_type;
+  float lo = filter_lo, hi = filter_hi;
+  bool dsp = false, filter = false;
+#endif
+  for (int i = 0; i < cmd.count; i++) {
+    const float v = cmd.item[i].value;
+    switch (cmd.item[i].id) {
+#if DSP_HOTSWAP_ENABLE
+      case PARAM_GAIN:
+        if (!dsp_params_set_gain(&p, v)) return CMD_ERR_ARGS;
+        dsp = true;
+        break;
+      case PARAM_CEILING_DB:
+        if (!(v > -96.0f)) return CMD_ERR_ARGS;
+        dsp_params_set_ceiling(&p, v);
+        dsp = true;
+        break;
+      case PARAM_FILTER:
+        if (!(v >= FILTER_NONE && v <= FILTER_HIGHPASS) || v != (int)v) return CMD_ERR_ARGS;
+        type = (int)v;
+        filter = true;
+        break;
+      case PARAM_FILTER_LO: lo = v; filter = true; break;
+      case PARAM_FILTER_HI: hi = v; filter = true; break;
+      case PARAM_AGC_TARGET_DB:
+        if (!(v < 0 && v > -60)) return CMD_ERR_ARGS;
+        p.agc_target_db = v;
+        dsp = true;
+        break;
+      case PARAM_AGC_MAX_DB:
+        if (!(v >= 0 && v <= AGC_MAX_GAIN_DB)) return CMD_ERR_ARGS;
+        p.agc_max_gain_db = v;
+        dsp = true;
+        break;
+#endif
+      case PARAM_STREAM: stream = v != 0; break;
+    }
+  }
+
+#if DSP_HOTSWAP_ENABLE
+  if (filter && !dsp_params_set_butter(&p, SAMPLE_RATE, type, lo, hi)) return CMD_ERR_ARGS;
+  if ((dsp || filter) && !pipeline_set_params(p)) return CMD_ERR_BUSY;
+  if (filter) {
+    filter_type = type;
+    filter_lo   = lo;
+    filter_hi   = hi;
+  }
+#endif
+  if (stream >= 0) uplink_set_streaming(stream);
+  return CMD_OK;
+}
+
+// GET 不带参数项：全部读回，没编进来的跳过
+static void read_all(CommandRecord* resp) {
+  for (uint16_t id = PARAM_GAIN; id <= PARAM_BLOCK && resp->count < COMMAND_MAX_ITEMS; id++) {
+    float v;
+    if (get_param(id, &v) == CMD_OK) resp->item[resp->count++] = {id, v};
+  }
+}
+
+// 按命令里的顺序读回；有一项读不了就整条失败，不带参数项
+static uint8_t read_back(const CommandRecord& cmd, CommandRecord* resp) {
+  for (int i = 0; i < cmd.count; i++) {
+    float v;
+    const uint8_t s = get_param(cmd.item[i].id, &v);
+    if (s != CMD_OK) {
+      resp->count = 0;
+      return s;
+    }
+    resp->item[resp->count++] = {cmd.item[i].id, v};
+  }
+  return CMD_OK;
+}
+
+// =================================================
+// 命令分发：在 FrameDecoder::push 里回调，当场回应答
+// =================================================
+static void fill_stats(DeviceStatsRecord* s) {
+  PipelineStats st;
+  pipeline_get_stats(&st);
+  UplinkStats up;
+  uplink_get_stats(&up);
+  s->flags          = uplink_streaming() ? DEVICE_STATS_STREAMING : 0;
+  s->uptime_ms      = millis();
+  s->rx_blocks      = st.rx_blocks;
+  s->rx_dropped     = st.rx_dropped;
+  s->dsp_blocks     = st.dsp_blocks;
+  s->dsp_dropped    = st.dsp_dropped;
+  s->tx_blocks      = st.tx_blocks;
+  s->uplink_frames  = up.frames;
+  s->uplink_dropped = up.dropped;
+  s->pop_events     = st.pop_events;
+  s->howl_notches   = st.howl_notches;
+  s->agc_gain_cdb   = (int32_t)lrintf(st.agc_gain_db * 100);
+  s->agc_level_cdb  = (int32_t)lrintf(st.agc_level_db * 100);
+  s->cmd_frames     = stats.commands;
+  s->cmd_errors     = stats.errors;
+  s->bulk_waits     = bulk_waits.load(std::memory_order_relaxed);
+}
+
+static void respond(uint16_t seq, const CommandRecord& r, const DeviceStatsRecord* st) {
+  static uint8_t payload[COMMAND_RECORD_MAX_SIZE + DEVICE_STATS_SIZE];
+  static uint8_t frame[FRAME_HEADER_SIZE + sizeof(payload) + FRAME_TRAILER_SIZE];
+  size_t len = command_encode(r, payload, sizeof(payload));
+  if (st) len += device_stats_encode(*st, payload + len, sizeof(payload) - len);
+
+  FrameHeader h = {};
+  h.type      = FRAME_TYPE_RESPONSE;
+  h.seq       = seq;
+  h.timestamp = micros();
+  h.length    = len;
+  // 不经 control_write_bulk：应答直接进发送缓冲，排在已有的积压后面
+  link_port()->write(frame, frame_encode(frame, sizeof(frame), h, payload));
+}
+
+static void on_frame(const FrameHeader& h, const uint8_t* payload, void* ctx) {
+  if (h.type != FRAME_TYPE_COMMAND) return;
+  stats.commands++;
+
+  static CommandRecord cmd, resp;
+  resp = CommandRecord{};
+  DeviceStatsRecord ds;
+  const DeviceStatsRecord* with_stats = NULL;
+  if (!command_decode(payload, h.length, &cmd)) {
+    resp.status = CMD_ERR_ARGS;
+  } else {
+    resp.op = cmd.op;
+    switch (cmd.op) {
+      case CMD_PING:
+        break;
+      case CMD_GET:
+      case CMD_SET:
+        if (cmd.op == CMD_SET) {
+          resp.status = set_params(cmd);
+        } else if (cmd.count == 0) {
+          read_all(&resp);
+          break;
+        }
+        if (resp.status == CMD_OK) resp.status = read_back(cmd, &resp);
+        break;
+      case CMD_STREAM_START:
+      case CMD_STREAM_STOP:
+        uplink_set_streaming(cmd.op == CMD_STREAM_START);
+        break;
+      case CMD_STATS:
+        fill_stats(&ds);
+        with_stats = &ds;
+        break;
+      case CMD_CALIBRATE:
+        // 结果由 latency_cal_task（src/main.cpp）取走，随下一条遥测帧发出
+        if (!LATENCY_CAL_ENABLE) resp.status = CMD_ERR_UNSUPPORTED;
+        else if (!pipeline_arm_latency_probe()) resp.status = CMD_ERR_BUSY;
+        break;
+      case CMD_CAPTURE:
+#if CAPTURE_ENABLE
+        if (!capture_trigger(CAPTURE_REASON_MANUAL)) resp.status = CMD_ERR_BUSY;
+#else
+        resp.status = CMD_ERR_UNSUPPORTED;
+#endif
+        break;
+      default:
+        resp.status = CMD_ERR_UNKNOWN;
+        break;
+    }
+  }
+  if (resp.status != CMD_OK) stats.errors++;
+  if (with_stats) ds.cmd_errors = stats.errors;
+  respond(h.seq, resp, with_stats);
+}
+
+static void control_task(void* arg) {
+  static FrameDecoder decoder(on_frame, NULL);
+  static uint8_t buf[256];
+  Link* link = link_port();
+  for (;;) {
+    vTaskDelay(pdMS_TO_TICKS(CONTROL_POLL_MS));
+    size_t n;
+    while ((n = link->read(buf, sizeof(buf))) > 0) decoder.push(buf, n);
+  }
+}
+
+bool control_start(AudioIo* audio_io) {
+  io = audio_io;
+  return xTaskCreatePinnedToCore(control_task, "control", CONTROL_STACK, NULL,
+                                 CONTROL_PRIO, NULL,
+                                 PIPELINE_IO_CORE) == pdPASS;
+}
+
+void control_get_stats(ControlStats* out) {
+  *out = stats;
+  out->bulk_waits = bulk_waits.load(std::memory_order_relaxed);
+}
+
+#else
+
+bool control_start(AudioIo*) { return true; }
+void control_write_bulk(const uint8_t* data, size_t len) { link_port()->write(data, len); }
+void control_get_stats(ControlStats* out) { *out = ControlStats{}; }
+
+#endif  // CONTROL_ACTIVE
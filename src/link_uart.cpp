@@ -0,0 +1,46 @@
+#include "link_port.h"
+
+#if LINK_TRANSPORT == LINK_UART
+
+#include <Arduino.h>
+
+// =================================================
+// UART0 后端：经板上 USB 转串口桥，日志也走同一个口（解码端当垃圾字节跳过）
+// Serial.write 在驱动里整段持锁，拷进 SERIAL_TX_BUFFER 字节的发送环；
+// availableForWrite = 发送环空位 + 硬件 FIFO 空位，积压按发送环算（最多少算一个 FIFO）
+// =================================================
+class UartLink : public Link {
+ public:
+  bool begin() override {
+    Serial.setTxBufferSize(SERIAL_TX_BUFFER);
+    Serial.setRxBufferSize(SERIAL_RX_BUFFER);
+    Serial.begin(SERIAL_BAUD);
+    return true;
+  }
+
+  size_t write(const uint8_t* data, size_t len) override { return Serial.write(data, len); }
+
+  size_t tx_queued() override {
+    const int queued = SERIAL_TX_BUFFER - (int)Serial.availableForWrite();
+    return queued > 0 ? queued : 0;
+  }
+
+  size_t bulk_watermark() const override { return CONTROL_BULK_WATERMARK; }
+
+  size_t read(uint8_t* data, size_t cap) override {
+    int n = Serial.available();
+    if (n <= 0) return 0;
+    if (n > (int)cap) n = cap;
+    return Serial.read(data, n);
+  }
+
+  bool connected() override { return true; }
+  const char* name() const override { return "UART"; }
+};
+
+Link* link_port() {
+  static UartLink link;
+  return &link;
+}
+
+#endif  // LINK_TRANSPORT == LINK_UART
@@ -0,0 +1,59 @@
+#include "link_port.h"
+
+#if LINK_TRANSPORT == LINK_USB_CDC
+
+#if ARDUINO_USB_MODE
+#error "LINK_USB_CDC 需要 -DARDUINO_USB_MODE=0（TinyUSB 接管 OTG 口，见 env:esp32-s3-usb）"
+#endif
+#if ARDUINO_USB_CDC_ON_BOOT
+#error "LINK_USB_CDC 要求 ARDUINO_USB_CDC_ON_BOOT=0：Serial 留给 UART0 打日志，CDC 口只走帧"
+#endif
+
+#include <Arduino.h>
+#include <USB.h>
+
+// =================================================
+// 原生 USB 后端：S3 的 OTG 口（GPIO19/20）上的 CDC-ACM，TinyUSB 驱动
+// - 全速 12 Mbit/s，bulk 64 字节包，主机每 1 ms 帧轮询；波特率没有意义，主机端照样当串口打开
+// - USBCDC::write 整段持锁，TinyUSB 发送 FIFO（CONFIG_TINYUSB_CDC_TX_BUFSIZE）只有几十字节，
+//   写者在锁里边发边补，积压天然不超过 FIFO：大块数据不用等水位，应答最多排在正在写的那一帧后面
+// - 主机没打开端口（DTR 低）时 write 直接丢，不阻塞上行任务
+// =================================================
+class UsbCdcLink : public Link {
+ public:
+  bool begin() override {
+    cdc_.setRxBufferSize(SERIAL_RX_BUFFER);
+    cdc_.begin();
+    USB.productName("ESP32-S3 Audio");
+    return USB.begin();
+  }
+
+  size_t write(const uint8_t* data, size_t len) override { return cdc_.write(data, len); }
+
+  size_t tx_queued() override {
+    const int queued = CONFIG_TINYUSB_CDC_TX_BUFSIZE - cdc_.availableForWrite();
+    return queued > 0 ? queued : 0;
+  }
+
+  size_t bulk_watermark() const override { return CONFIG_TINYUSB_CDC_TX_BUFSIZE; }
+
+  size_t read(uint8_t* data, size_t cap) override {
+    int n = cdc_.available();
+    if (n <= 0) return 0;
+    if (n > (int)cap) n = cap;
+    return cdc_.read(data, n);
+  }
+
+  bool connected() override { return (bool)cdc_; }
+  const char* name() const override { return "USB CDC"; }
+
+ private:
+  USBCDC cdc_;
+};
+
+Link* link_port() {
+  static UsbCdcLink link;
+  return &link;
+}
+
+#endif  // LINK_TRANSPORT == LINK_USB_CDC
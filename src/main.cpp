@@ -1,163 +1,245 @@
 #include <Arduino.h>
-#include <driver/i2s.h>
-
-// =================================================
-// 硬件引脚定义
+#include "audio_config.h"
+#include "audio_io_i2s.h"
+#include "audio_pipeline.h"
+#include "uplink.h"
+#include "ui.h"
+#include "recorder.h"
+#include "capture.h"
+#include "telemetry.h"
+#include "control.h"
+#include "link_port.h"
+
+AudioIo* io = NULL;
+static bool ready = false;   // setup() 中途失败时保持 false，loop() 不碰半初始化的系统
+
+#if LATENCY_CAL_ENABLE
 // =================================================
-
-// -------- PDM 麦克风（I2S RX）--------
-#define I2S_MIC_PORT     I2S_NUM_0
-#define PDM_CLK_PIN      5
-#define PDM_DATA_PIN     4
-
-// -------- I2S DAC（PCM5102）--------
-#define I2S_SPK_PORT     I2S_NUM_1
-#define PIN_I2S_BCK      17
-#define PIN_I2S_WS       18
-#define PIN_I2S_DOUT     8
-
+// 回环延迟实测：到点 arm，录满后做互相关（约 0.1~0.2 s）
+// 放在 IO 核上单独的低优先级任务里，LOOP 模式下 loop() 就是音频路径，不能在那里算
+// 结果交给遥测任务，随遥测记录一起发出
 // =================================================
-#define SAMPLE_RATE      44100
-#define BUFFER_SAMPLES   8
-#define MIC_GAIN         3.0f
+static unsigned long next_cal_ms = LATENCY_CAL_BOOT_MS;
+static bool cal_scheduled = true;
 
-// PCM5102 经验内部延迟（ms）
-#define DAC_LATENCY_MS  0.8f
+static void latency_cal_tick() {
+  unsigned long now = millis();
+  if (cal_scheduled && now >= next_cal_ms && pipeline_arm_latency_probe()) {
+    cal_scheduled = LATENCY_CAL_PERIOD_MS > 0;
+    next_cal_ms = now + LATENCY_CAL_PERIOD_MS;
+  }
 
-// 日志周期
-#define LOG_INTERVAL_MS 1000
+  LatencyResult r;
+  if (!pipeline_poll_latency(&r)) return;
+  if (r.valid) {
+    telemetry_set_loop_latency_us((int32_t)(r.delay_ms * 1000.0f));
+    Serial.printf("📏 实测回环延迟 %.2f ms（%.1f 样本，置信 %.1f）\n",
+                  r.delay_ms, r.delay_samples, r.confidence);
+  } else {
+    Serial.printf("⚠️ 回环延迟测量失败（置信 %.1f），检查扬声器和麦克风摆放\n",
+                  r.confidence);
+  }
+}
 
-unsigned long last_log_time = 0;
+static void latency_cal_task(void*) {
+  for (;;) {
+    vTaskDelay(pdMS_TO_TICKS(LOG_INTERVAL_MS));
+    latency_cal_tick();
+  }
+}
+#endif
 
 void setup() {
-  Serial.begin(115200);
+#if LINK_TRANSPORT != LINK_UART
+  Serial.begin(SERIAL_BAUD);   // 帧走 USB，UART0 只打日志
+#endif
+  Link* link = link_port();
+  const bool link_ok = link->begin();   // LINK_UART 时就是 Serial.begin
   delay(300);
   Serial.println("\n🎤 ESP32-S3 实时音频延迟分析启动");
+  if (!link_ok) {
+    Serial.printf("❌ 链路（%s）初始化失败\n", link->name());
+    return;
+  }
+  Serial.printf("🔌 帧链路：%s\n", link->name());
 
   // =================================================
-  // I2S RX - PDM 麦克风
+  // I2S RX（PDM 麦克风）+ TX（PCM5102）
   // =================================================
-  i2s_config_t mic_config = {
-    .mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_PDM),
-    .sample_rate = SAMPLE_RATE,
-    .bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT,
-    .channel_format = I2S_CHANNEL_FMT_ONLY_LEFT,
-    .communication_format = I2S_COMM_FORMAT_STAND_I2S,
-    .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
-    .dma_buf_count = 4,
-    .dma_buf_len = BUFFER_SAMPLES,
-    .use_apll = true,
-    .tx_desc_auto_clear = false,
-    .fixed_mclk = 0
-  };
-
-  i2s_pin_config_t mic_pins = {
-    .mck_io_num = I2S_PIN_NO_CHANGE,
-    .bck_io_num = I2S_PIN_NO_CHANGE,
-    .ws_io_num  = PDM_CLK_PIN,
-    .data_out_num = I2S_PIN_NO_CHANGE,
-    .data_in_num  = PDM_DATA_PIN
-  };
-
-  i2s_driver_install(I2S_MIC_PORT, &mic_config, 0, NULL);
-  i2s_set_pin(I2S_MIC_PORT, &mic_pins);
-  i2s_set_clk(I2S_MIC_PORT, SAMPLE_RATE,
-              I2S_BITS_PER_SAMPLE_16BIT,
-              I2S_CHANNEL_MONO);
+  io = audio_io_create();
+  if (!io->begin()) {
+    Serial.println("❌ I2S 初始化失败");
+    return;
+  }
 
-  // =================================================
-  // I2S TX - PCM5102
-  // =================================================
-  i2s_config_t spk_config = {
-    .mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_TX),
-    .sample_rate = SAMPLE_RATE,
-    .bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT,
-    .channel_format = I2S_CHANNEL_FMT_RIGHT_LEFT,
-    .communication_format = I2S_COMM_FORMAT_STAND_I2S,
-    .intr_alloc_flags = ESP_INTR_FLAG_LEVEL1,
-    .dma_buf_count = 4,
-    .dma_buf_len = BUFFER_SAMPLES,
-    .use_apll = false,
-    .tx_desc_auto_clear = true,
-    .fixed_mclk = 0
-  };
-
-  i2s_pin_config_t spk_pins = {
-    .mck_io_num = I2S_PIN_NO_CHANGE,
-    .bck_io_num = PIN_I2S_BCK,
-    .ws_io_num  = PIN_I2S_WS,
-    .data_out_num = PIN_I2S_DOUT,
-    .data_in_num  = I2S_PIN_NO_CHANGE
-  };
-
-  i2s_driver_install(I2S_SPK_PORT, &spk_config, 0, NULL);
-  i2s_set_pin(I2S_SPK_PORT, &spk_pins);
+#if RECORDER_ENABLE
+  if (!recorder_start()) {
+    Serial.println("❌ 录音分区挂载失败");
+    return;
+  }
+  RecorderStats rs;
+  recorder_get_stats(&rs);
+  Serial.printf("💾 录音恢复：有效段=%u 待上传=%u 损坏段=%u\n",
+                rs.recovered, rs.pending, rs.invalid);
+#endif
+
+#if CAPTURE_ENABLE
+  if (!capture_start()) {
+    Serial.println("❌ 事件捕获缓冲分配失败（需要 PSRAM）");
+    return;
+  }
+  Serial.printf("🎯 事件捕获：触发前 %u ms + 触发后 %u ms\n", CAPTURE_PRE_MS, CAPTURE_POST_MS);
+#endif
 
+  if (!uplink_start()) {
+    Serial.println("❌ 上行任务创建失败");
+    return;
+  }
+  if (!telemetry_start(io)) {
+    Serial.println("❌ 遥测任务创建失败");
+    return;
+  }
+  if (!control_start(io)) {
+    Serial.println("❌ 命令任务创建失败");
+    return;
+  }
+  if (!ui_start()) {
+    Serial.println("❌ 屏幕初始化失败");
+    return;
+  }
+#if LATENCY_CAL_ENABLE
+  if (xTaskCreatePinnedToCore(latency_cal_task, "latency_cal", LATENCY_CAL_STACK, NULL,
+                              LATENCY_CAL_PRIO, NULL, PIPELINE_IO_CORE) != pdPASS) {
+    Serial.println("❌ 延迟测量任务创建失败");
+    return;
+  }
+#endif
+
+#if AUDIO_PIPELINE_MODE != PIPELINE_LOOP
+  if (!pipeline_start(io)) {
+    Serial.println("❌ 流水线任务创建失败");
+    return;
+  }
+#if AUDIO_PIPELINE_MODE == PIPELINE_DIRECT
+  Serial.println("✅ 初始化完成，直通模式（DSP@core1 直接处理 I/O 缓冲）\n");
+#else
+  Serial.println("✅ 初始化完成，流水线模式（RX/TX@core0, DSP@core1）\n");
+#endif
+#else
   Serial.println("✅ 初始化完成，开始监听\n");
+#endif
+  ready = true;
 }
 
+#if AUDIO_PIPELINE_MODE != PIPELINE_LOOP
+
+// 流水线模式下 loop() 不碰音频，只做低频日志
 void loop() {
-  static int16_t mic_buffer[BUFFER_SAMPLES];
-  static int16_t out_buffer[BUFFER_SAMPLES * 2];
+  vTaskDelay(pdMS_TO_TICKS(LOG_INTERVAL_MS));
+  if (!ready) return;
+
+  PipelineStats st;
+  pipeline_get_stats(&st);
+  pipeline_reset_latency_max();
+  UplinkStats up;
+  uplink_get_stats(&up);
+  float frame_ms = (float)io->block_frames() / SAMPLE_RATE * 1000.0f;
+
+  Serial.printf(
+    "⏱ RX=%u drop=%u | DSP=%u drop=%u | TX=%u | queue max=%.3f ms | frame=%.3f ms | UP=%u drop=%u\n",
+    st.rx_blocks, st.rx_dropped,
+    st.dsp_blocks, st.dsp_dropped,
+    st.tx_blocks,
+    st.latency_max_us / 1000.0f,
+    frame_ms,
+    up.frames, up.dropped
+  );
+
+#if HOWL_ENABLE
+  Serial.printf("🔇 啸叫陷波 %u 个（累计部署 %u）\n", st.howl_notches, st.howl_deployed);
+#endif
+
+#if POP_GUARD_ENABLE
+  Serial.printf("💥 爆音保护 事件=%u 累计静音=%.1f ms\n", st.pop_events,
+                st.pop_muted_samples * 1000.0f / SAMPLE_RATE);
+#endif
+
+#if AGC_ENABLE
+  Serial.printf("🎚 AGC 增益=%.1f dB 电平=%.1f dBFS 噪底=%.1f dBFS 软削波=%u\n",
+                st.agc_gain_db, st.agc_level_db, st.agc_floor_db, st.agc_soft_clipped);
+#endif
+
+#if VAD_ENABLE
+  VadStats vs;
+  uplink_get_vad_stats(&vs);
+  Serial.printf("🗣 语音门控 占空=%.1f%% 段=%u\n",
+                vs.frames ? 100.0f * vs.active_frames / vs.frames : 0.0f, vs.segments);
+#endif
+
+#if CAPTURE_ENABLE
+  CaptureStats cs;
+  capture_get_stats(&cs);
+  Serial.printf("🎯 捕获=%u 忙时触发=%u 块=%u 覆盖样本=%u\n", cs.jobs, cs.busy, cs.chunks, cs.lost);
+#endif
+
+#if RECORDER_ENABLE
+  RecorderStats rs;
+  recorder_get_stats(&rs);
+  Serial.printf("💾 段=%u 待上传=%u 已上传=%u 丢帧=%u 覆盖=%u\n",
+                rs.segments, rs.pending, rs.uploaded, rs.dropped, rs.overwritten);
+#endif
+
+#if CONTROL_ACTIVE
+  ControlStats ctl;
+  control_get_stats(&ctl);
+  Serial.printf("🕹 命令=%u 出错=%u 上行让路=%u\n", ctl.commands, ctl.errors, ctl.bulk_waits);
+#endif
+
+#if UI_ENABLE
+  UiStats ui;
+  ui_get_stats(&ui);
+  Serial.printf("🖥 UI 帧=%u 跳过=%u 最近一帧推送 %u 像素\n", ui.frames, ui.skipped, ui.pixels);
+#endif
+}
 
-  size_t bytes_read = 0;
-  size_t bytes_written = 0;
+#else
 
-  // ===== 时间戳 =====
-  uint32_t t0, t1, t2, t3;
+// LOOP 模式：loop() 就是音频路径，这里只埋点，打印交给遥测任务
+void loop() {
+  if (!ready) {
+    vTaskDelay(pdMS_TO_TICKS(LOG_INTERVAL_MS));
+    return;
+  }
+  pipeline_service_reconfig(io);
+
+  // ===== 时间戳（CPU 周期）=====
+  uint32_t c0, c1, c2, c3;
 
   // 1️⃣ 等 RX DMA buffer
-  t0 = micros();
-  i2s_read(I2S_MIC_PORT,
-           mic_buffer,
-           sizeof(mic_buffer),
-           &bytes_read,
-           portMAX_DELAY);
-  t1 = micros();
-
-  int samples = bytes_read / sizeof(int16_t);
-
-  // 2️⃣ CPU 处理
-  for (int i = 0; i < samples; i++) {
-    float s = mic_buffer[i] * MIC_GAIN;
-    if (s > 32767) s = 32767;
-    if (s < -32768) s = -32768;
-    int16_t v = (int16_t)s;
-    out_buffer[i * 2]     = v;
-    out_buffer[i * 2 + 1] = v;
+  c0 = cycle_now();
+  RxBuffer rb;
+  if (!io->acquire_rx(&rb, UINT32_MAX)) return;
+  c1 = cycle_now();
+
+  // 2️⃣ CPU 处理（直接写进后端借出的 TX 缓冲）
+  int16_t* out_buffer = io->acquire_tx(UINT32_MAX);
+  if (out_buffer == NULL) {
+    io->release_rx();
+    return;
   }
-  t2 = micros();
+  c2 = cycle_now();
+  const int16_t* mono = dsp_process_block(rb.data, out_buffer, rb.samples);
+  uplink_push(mono, rb.samples, rb.t_capture);
+  ui_push(mono, rb.samples);
+  io->release_rx();
+  c3 = cycle_now();
 
   // 3️⃣ TX DMA buffer
-  i2s_write(I2S_SPK_PORT,
-            out_buffer,
-            samples * 2 * sizeof(int16_t),
-            &bytes_written,
-            portMAX_DELAY);
-  t3 = micros();
+  io->commit_tx(rb.samples);
 
-  // =================================================
-  // 日志
-  // =================================================
-  unsigned long now = millis();
-  if (now - last_log_time >= LOG_INTERVAL_MS) {
-    last_log_time = now;
-
-    float rx_wait_ms  = (t1 - t0) / 1000.0f;
-    float cpu_ms      = (t2 - t1) / 1000.0f;
-    float tx_wait_ms  = (t3 - t2) / 1000.0f;
-    float frame_ms    = (float)BUFFER_SAMPLES / SAMPLE_RATE * 1000.0f;
-
-    float estimated_total =
-        frame_ms * 2 + DAC_LATENCY_MS + cpu_ms;
-
-    Serial.printf(
-      "⏱ RX wait=%.3f ms | CPU=%.3f ms | TX wait=%.3f ms | frame=%.3f ms | total≈%.2f ms\n",
-      rx_wait_ms,
-      cpu_ms,
-      tx_wait_ms,
-      frame_ms,
-      estimated_total
-    );
-  }
+  telem_record(TELEM_STAGE_RX_WAIT, c1 - c0);
+  telem_record(TELEM_STAGE_DSP, c3 - c2);
+  telem_record(TELEM_STAGE_TX_WAIT, (c2 - c1) + (cycle_now() - c3));
 }
+
+#endif  // AUDIO_PIPELINE_MODE
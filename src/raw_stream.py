@@ -0,0 +1,25 @@
+import time
+
+# 旧脚本（listen_realtime.py / to_voice.py / 声音滤波.py）按裸 int16 流读串口，只能配 -DUPLINK_MODE=UPLINK_RAW 的固件。
+# 固件默认是 UPLINK_FRAMED：A5 5A 开头的 CRC 帧流，夹着文本日志，当 PCM 播出来全是噪声；
+# 帧流用 ./tools/bin/frame_dump（解成裸 PCM，可以接 ffplay）或 ./tools/bin/rt_player 收
+FRAME_MAGIC = b'\xA5\x5A'
+
+
+def check_raw_stream(ser, probe_bytes=16384, timeout=1.0):
+    """读一小段串口数据，确认不是帧流；是帧流就打印提示并退出
+
+    帧流里每帧都有一个 magic（PCM16 256 样本一帧约 530 字节，16 KB 里有 30 个左右），
+    裸 PCM 里碰巧出现的概率是每字节 1/65536，16 KB 平均不到 0.3 个
+    """
+    data = bytearray()
+    start = time.time()
+    while len(data) < probe_bytes and time.time() - start < timeout:
+        data.extend(ser.read(probe_bytes - len(data)))
+    if data.count(FRAME_MAGIC) >= 8:
+        raise SystemExit(
+            "✗ 串口上是 UPLINK_FRAMED 帧流（A5 5A 帧头），不是裸 int16。\n"
+            "  这个脚本要配 -DUPLINK_MODE=UPLINK_RAW 编的固件；默认固件请用\n"
+            "    ./tools/bin/frame_dump <串口> | ffplay -f s16le -ar 48000 -ac 1 -\n"
+            "  或 ./tools/bin/rt_player <串口>")
+    return bytes(data)
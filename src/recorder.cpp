@@ -0,0 +1,224 @@
+#include "recorder.h"
+
+#if RECORDER_ENABLE
+
+#include <WiFi.h>
+#include <esp_partition.h>
+#include <freertos/semphr.h>
+#include <spsc_queue.h>
+#include <segment_log.h>
+#include <audio_frame.h>
+#include <adpcm.h>
+
+// =================================================
+// esp_partition 上的 FlashDev
+// =================================================
+class PartitionFlash : public FlashDev {
+ public:
+  explicit PartitionFlash(const esp_partition_t* part) : part_(part) {}
+
+  bool read(uint32_t addr, void* buf, size_t len) override {
+    return esp_partition_read(part_, addr, buf, len) == ESP_OK;
+  }
+  bool write(uint32_t addr, const void* buf, size_t len) override {
+    return esp_partition_write(part_, addr, buf, len) == ESP_OK;
+  }
+  bool erase_sector(uint32_t addr) override {
+    return esp_partition_erase_range(part_, addr, SPI_FLASH_SEC_SIZE) == ESP_OK;
+  }
+  uint32_t size() const override { return part_->size; }
+  uint32_t sector_size() const override { return SPI_FLASH_SEC_SIZE; }
+
+ private:
+  const esp_partition_t* part_;
+};
+
+// 一个 RAM 段，大小等于一个扇区的 payload
+#define REC_SEG_BYTES (SPI_FLASH_SEC_SIZE - SEGLOG_HEADER_SIZE)
+
+// 每段装整数个帧，帧不跨段
+#if UPLINK_CODEC == SAMPLE_FMT_ADPCM
+#define REC_PAYLOAD_BYTES (ADPCM_BLOCK_HEADER + (UPLINK_FRAME_SAMPLES + 1) / 2)
+#elif UPLINK_CODEC == SAMPLE_FMT_ULAW
+#define REC_PAYLOAD_BYTES UPLINK_FRAME_SAMPLES
+#else
+#define REC_PAYLOAD_BYTES (UPLINK_FRAME_SAMPLES * 2)
+#endif
+#define REC_FRAME_BYTES (FRAME_HEADER_SIZE + REC_PAYLOAD_BYTES + FRAME_TRAILER_SIZE)
+#define REC_SEG_FRAMES  (REC_SEG_BYTES / REC_FRAME_BYTES)
+
+// 连续录音时分区能保留多久（ms）：写指针前面那个扇区随时会被擦，只算 扇区数 - 1 段
+#define REC_RETAIN_MS ((uint64_t)(RECORDER_PARTITION_BYTES / SPI_FLASH_SEC_SIZE - 1) * \
+                       REC_SEG_FRAMES * UPLINK_FRAME_SAMPLES * 1000 / UPLINK_SAMPLE_RATE)
+
+static_assert(REC_RETAIN_MS * 100 >= (uint64_t)UPLOAD_PERIOD_MS * RECORDER_DUTY_PERCENT,
+              "录音分区装不下一个 UPLOAD_PERIOD_MS：换 ADPCM、降 UPLINK_SAMPLE_RATE、开 VAD_ENABLE "
+              "或缩短上传周期（见 audio_config.h 本地录音一节）");
+
+struct RecSegment {
+  uint16_t len;
+  uint8_t  data[REC_SEG_BYTES];
+};
+
+// 上行任务 → 录音任务：两段轮换，一段在攒帧，一段在写 flash
+static SpscQueue<RecSegment, 2> seg_q;
+static RecSegment* filling = NULL;
+
+static PartitionFlash* flash = NULL;
+static SegmentLog* seglog = NULL;
+static SemaphoreHandle_t log_mutex = NULL;   // 录音任务和上传任务共用 seglog
+static TaskHandle_t rec_handle = NULL;
+static RecorderStats stats = {};
+
+void recorder_append(const uint8_t* frame, size_t len) {
+  if (filling && filling->len + len > REC_SEG_BYTES) {
+    seg_q.commit_write();
+    xTaskNotifyGive(rec_handle);
+    filling = NULL;
+  }
+  if (filling == NULL) {
+    filling = seg_q.write_slot();
+    if (filling == NULL) {
+      stats.dropped++;
+      return;
+    }
+    filling->len = 0;
+  }
+  memcpy(filling->data + filling->len, frame, len);
+  filling->len += len;
+}
+
+static void refresh_log_stats() {
+  const SegmentLogStats& ls = seglog->stats();
+  stats.pending     = ls.pending;
+  stats.overwritten = ls.overwritten;
+}
+
+// =================================================
+// 录音任务：把攒满的段写进 flash
+// =================================================
+static void recorder_task(void* arg) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    RecSegment* seg;
+    while ((seg = seg_q.read_slot()) != NULL) {
+      xSemaphoreTake(log_mutex, portMAX_DELAY);
+      if (seglog->append(seg->data, seg->len)) stats.segments++;
+      refresh_log_stats();
+      xSemaphoreGive(log_mutex);
+      seg_q.commit_read();
+    }
+  }
+}
+
+// =================================================
+// 上传任务：周期性连 WiFi，按序号从老到新发送待上传段
+// =================================================
+static bool send_all(const uint8_t* p, size_t len, WiFiClient& client) {
+  while (len > 0) {
+    size_t n = client.write(p, len);
+    if (n == 0) return false;
+    p   += n;
+    len -= n;
+  }
+  return true;
+}
+
+static bool upload_one(WiFiClient& client, const SegmentInfo& info, uint8_t* buf) {
+  uint32_t hdr[4] = { UPLOAD_MAGIC, info.seq, info.length, info.crc };  // 小端
+  if (!send_all((const uint8_t*)hdr, sizeof(hdr), client)) return false;
+  if (!send_all(buf, info.length, client)) return false;
+
+  uint32_t start = millis();
+  while (!client.available()) {
+    if (!client.connected() || millis() - start > 5000) return false;
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+  return client.read() == UPLOAD_ACK;
+}
+
+static void upload_task(void* arg) {
+  static uint8_t buf[REC_SEG_BYTES];
+
+  for (;;) {
+    vTaskDelay(pdMS_TO_TICKS(UPLOAD_PERIOD_MS));
+
+    xSemaphoreTake(log_mutex, portMAX_DELAY);
+    uint32_t pending = seglog->stats().pending;
+    xSemaphoreGive(log_mutex);
+    if (pending == 0) continue;
+
+    WiFi.mode(WIFI_STA);
+    WiFi.begin(WIFI_SSID, WIFI_PASS);
+    for (int i = 0; i < 100 && WiFi.status() != WL_CONNECTED; i++) {
+      vTaskDelay(pdMS_TO_TICKS(100));
+    }
+
+    WiFiClient client;
+    if (WiFi.status() == WL_CONNECTED && client.connect(UPLOAD_HOST, UPLOAD_PORT)) {
+      for (;;) {
+        SegmentInfo info;
+        xSemaphoreTake(log_mutex, portMAX_DELAY);
+        bool ok = seglog->oldest_pending(&info) && seglog->read(info, buf);
+        xSemaphoreGive(log_mutex);
+        if (!ok) break;
+
+        // 发送期间不持锁：录音任务覆盖了这个扇区的话 mark_uploaded 会发现序号不符
+        if (!upload_one(client, info, buf)) break;
+
+        xSemaphoreTake(log_mutex, portMAX_DELAY);
+        if (seglog->mark_uploaded(info)) stats.uploaded++;
+        refresh_log_stats();
+        xSemaphoreGive(log_mutex);
+      }
+      client.stop();
+    }
+
+    // 上传完就关 WiFi 省电
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+  }
+}
+
+bool recorder_start() {
+  const esp_partition_t* part = esp_partition_find_first(
+      ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, RECORDER_PARTITION);
+  if (part == NULL) return false;
+  if (part->size < RECORDER_PARTITION_BYTES) {
+    Serial.printf("❌ 录音分区 %s 只有 %u 字节，要 %u（分区表用 partitions_recorder.csv）\n",
+                  RECORDER_PARTITION, (unsigned)part->size, (unsigned)RECORDER_PARTITION_BYTES);
+    return false;
+  }
+  Serial.printf("💾 录音分区 %u 段，连续可录 %u s，上传周期 %u s\n",
+                (unsigned)(part->size / SPI_FLASH_SEC_SIZE), (unsigned)(REC_RETAIN_MS / 1000),
+                (unsigned)(UPLOAD_PERIOD_MS / 1000));
+
+  flash  = new PartitionFlash(part);
+  seglog = new SegmentLog(flash);
+  if (!seglog->mount()) return false;
+
+  stats.recovered = seglog->stats().valid;
+  stats.invalid   = seglog->stats().invalid;
+  refresh_log_stats();
+
+  log_mutex = xSemaphoreCreateMutex();
+  if (xTaskCreatePinnedToCore(recorder_task, "recorder", RECORDER_STACK, NULL,
+                              RECORDER_PRIO, &rec_handle,
+                              PIPELINE_IO_CORE) != pdPASS) return false;
+  return xTaskCreatePinnedToCore(upload_task, "upload", UPLOAD_STACK, NULL,
+                                 RECORDER_PRIO, NULL,
+                                 PIPELINE_IO_CORE) == pdPASS;
+}
+
+void recorder_get_stats(RecorderStats* out) {
+  *out = stats;
+}
+
+#else
+
+bool recorder_start() { return true; }
+void recorder_append(const uint8_t*, size_t) {}
+void recorder_get_stats(RecorderStats* out) { memset(out, 0, sizeof(*out)); }
+
+#endif  // RECORDER_ENABLE
@@ -0,0 +1,89 @@
+#include "telemetry.h"
+#include <audio_frame.h>
+#include "audio_pipeline.h"
+#include "control.h"
+
+LatencyHistogram telem_hist[TELEM_STAGES];
+
+static AudioIo* io = NULL;
+static volatile int32_t loop_latency_us = -1;
+
+void telemetry_set_loop_latency_us(int32_t us) {
+  loop_latency_us = us;
+}
+
+static uint32_t cycles_to_ns(uint32_t cycles, uint32_t mhz) {
+  uint64_t ns = (uint64_t)cycles * 1000 / mhz;
+  return ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns;
+}
+
+static void telemetry_task(void* arg) {
+  const uint32_t mhz = getCpuFrequencyMhz();
+  TickType_t wake = xTaskGetTickCount();
+  XrunStats last_xr = {};
+#if UPLINK_BINARY
+  static uint8_t frame[FRAME_HEADER_SIZE + TELEMETRY_RECORD_SIZE + FRAME_TRAILER_SIZE];
+  uint16_t seq = 0;
+#endif
+
+  for (;;) {
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(TELEMETRY_PERIOD_MS));
+
+    TelemetryRecord r;
+    r.uptime_ms       = millis();
+    r.loop_latency_us = loop_latency_us;
+    for (int i = 0; i < TELEM_STAGES; i++) {
+      HistSummary s = telem_hist[i].window();
+      r.stage[i].count  = s.count;
+      r.stage[i].p50_ns = cycles_to_ns(s.p50, mhz);
+      r.stage[i].p99_ns = cycles_to_ns(s.p99, mhz);
+      r.stage[i].max_ns = cycles_to_ns(s.max, mhz);
+    }
+    XrunStats xr;
+    io->xrun_stats(&xr);
+    r.rx_overruns  = xr.rx_overruns;
+    r.tx_underruns = xr.tx_underruns;
+
+    const uint32_t xruns = (xr.rx_overruns - last_xr.rx_overruns) +
+                           (xr.tx_underruns - last_xr.tx_underruns);
+    last_xr = xr;
+    pipeline_tune_buffers(xruns, r.stage[TELEM_STAGE_DSP].p99_ns);
+
+#if UPLINK_BINARY
+    uint8_t payload[TELEMETRY_RECORD_SIZE];
+    FrameHeader h = {};
+    h.type      = FRAME_TYPE_TELEMETRY;
+    h.seq       = seq++;
+    h.timestamp = micros();
+    h.length    = telemetry_encode(r, payload, sizeof(payload));
+    size_t len = frame_encode(frame, sizeof(frame), h, payload);
+    control_write_bulk(frame, len);
+#else
+    const TelemetryStage* st = r.stage;
+    Serial.printf(
+      "📊 RX wait p50/p99/max=%.1f/%.1f/%.1f us | DSP=%.1f/%.1f/%.1f us | TX wait=%.1f/%.1f/%.1f us",
+      st[TELEM_STAGE_RX_WAIT].p50_ns / 1000.0f, st[TELEM_STAGE_RX_WAIT].p99_ns / 1000.0f,
+      st[TELEM_STAGE_RX_WAIT].max_ns / 1000.0f,
+      st[TELEM_STAGE_DSP].p50_ns / 1000.0f, st[TELEM_STAGE_DSP].p99_ns / 1000.0f,
+      st[TELEM_STAGE_DSP].max_ns / 1000.0f,
+      st[TELEM_STAGE_TX_WAIT].p50_ns / 1000.0f, st[TELEM_STAGE_TX_WAIT].p99_ns / 1000.0f,
+      st[TELEM_STAGE_TX_WAIT].max_ns / 1000.0f);
+    Serial.printf(" | xrun RX=%u TX=%u", r.rx_overruns, r.tx_underruns);
+    if (r.loop_latency_us >= 0) {
+      Serial.printf(" | 回环实测=%.2f ms\n", r.loop_latency_us / 1000.0f);
+    } else {
+      // 没有实测值时按 2 帧缓冲 + DAC + DSP 中位数估算
+      float frame_ms = (float)io->block_frames() / SAMPLE_RATE * 1000.0f;
+      Serial.printf(" | total≈%.2f ms\n",
+                    frame_ms * 2 + DAC_LATENCY_MS + st[TELEM_STAGE_DSP].p50_ns / 1e6f);
+    }
+#endif
+  }
+}
+
+bool telemetry_start(AudioIo* audio_io) {
+  io = audio_io;
+  return xTaskCreatePinnedToCore(telemetry_task, "telemetry", TELEMETRY_STACK, NULL,
+                                 TELEMETRY_PRIO, NULL,
+                                 PIPELINE_IO_CORE) == pdPASS;
+}
@@ -0,0 +1,116 @@
+#include "ui.h"
+
+#if UI_ENABLE
+
+#include <TFT_eSPI.h>
+#include <math.h>
+#include <audio_ui.h>
+#include <sample_ring.h>
+#include <spectrum.h>
+
+// =================================================
+// TFT_eSPI 后端：整帧持有 SPI（startWrite），矩形用 pushImageDMA 推，
+// pushImageDMA 自己会先等上一次 DMA 完成，正好对上 Display 的双缓冲约定
+// =================================================
+class TftDisplay : public Display {
+ public:
+  bool begin() {
+    tft_.init();
+    tft_.setRotation(UI_ROTATION);
+    tft_.fillScreen(TFT_BLACK);
+    tft_.setSwapBytes(true);   // 缓冲里是本机字节序 RGB565，DMA 前就地换成屏幕要的大端
+    w_ = tft_.width();
+    h_ = tft_.height();
+    return tft_.initDMA();
+  }
+
+  int width() const override { return w_; }
+  int height() const override { return h_; }
+
+  void begin_frame() override { tft_.startWrite(); }
+  void push_rect(int x, int y, int w, int h, uint16_t* pixels) override {
+    tft_.pushImageDMA(x, y, w, h, pixels);
+  }
+  void end_frame() override {
+    tft_.dmaWait();
+    tft_.endWrite();
+  }
+
+ private:
+  TFT_eSPI tft_;
+  int w_ = 0, h_ = 0;
+};
+
+static TftDisplay display;
+static SampleRing<UI_RING_SAMPLES> ring;
+static UiStats stats = {};
+
+static void ui_task(void* arg) {
+  static AudioUi ui(&display, UI_SPEC_BANDS);
+  static SpectrumAnalyzer analyzer(SAMPLE_RATE, UI_FFT_SIZE, UI_FFT_SIZE / 2, UI_SPEC_BANDS,
+                                   SPECTRUM_F_LO, SPECTRUM_F_HI);
+  static int16_t chunk[UI_RING_SAMPLES / 2];
+  float db[UI_SPEC_BANDS];
+
+  uint32_t pos = ring.head();
+  uint32_t frame = 0;
+  TickType_t wake = xTaskGetTickCount();
+
+  for (;;) {
+    vTaskDelayUntil(&wake, pdMS_TO_TICKS(UI_FRAME_MS));
+
+    // 取上一帧以来的新样本；落后超过半个环就跳到最近的半个环
+    const uint32_t head = ring.head();
+    uint32_t n = head - pos;
+    if (n > UI_RING_SAMPLES / 2) {
+      pos = head - UI_RING_SAMPLES / 2;
+      n   = UI_RING_SAMPLES / 2;
+      stats.skipped++;
+    }
+    if (n > 0 && !ring.read(pos, n, chunk)) {
+      pos = ring.head();   // 拷贝期间被覆盖：这帧不更新
+      stats.skipped++;
+      continue;
+    }
+    pos += n;
+
+    int32_t peak = 0;
+    int64_t sumsq = 0;
+    for (uint32_t i = 0; i < n; i++) {
+      const int32_t v = chunk[i];
+      const int32_t a = v < 0 ? -v : v;
+      if (a > peak) peak = a;
+      sumsq += v * v;
+    }
+    const float peak_db = 20.0f * log10f(peak / 32768.0f + 1e-6f);
+    const float rms_db  = n ? 10.0f * log10f((float)sumsq / n / (32768.0f * 32768.0f) + 1e-12f)
+                            : UI_METER_FLOOR_DB;
+    ui.set_levels(peak_db, rms_db);
+
+    analyzer.push(chunk, n);
+    if (++frame % UI_SPEC_COLUMN_FRAMES == 0 && analyzer.read(db)) ui.add_column(db);
+
+    stats.pixels = ui.render();
+    stats.frames++;
+  }
+}
+
+bool ui_start() {
+  if (!display.begin()) return false;
+  return xTaskCreatePinnedToCore(ui_task, "ui", UI_STACK, NULL, UI_PRIO, NULL,
+                                 UI_CORE) == pdPASS;
+}
+
+void ui_push(const int16_t* mono, int samples) {
+  ring.write(mono, samples);
+}
+
+void ui_get_stats(UiStats* out) { *out = stats; }
+
+#else
+
+bool ui_start() { return true; }
+void ui_push(const int16_t*, int) {}
+void ui_get_stats(UiStats* out) { out->frames = out->skipped = out->pixels = 0; }
+
+#endif  // UI_ENABLE
@@ -0,0 +1,336 @@
+#include "uplink.h"
+#include <spsc_queue.h>
+#include <audio_frame.h>
+#include <adpcm.h>
+#include <resampler.h>
+#include <spectrum.h>
+#include <spectrum_record.h>
+#include <vad.h>
+#include <sample_ring.h>
+#include <capture_record.h>
+#include "recorder.h"
+#include "capture.h"
+#include "control.h"
+
+// 本地录音复用上行的分帧和编码，所以只要开了录音，上行任务也要跑；事件捕获的环也在上行任务里读写
+#define UPLINK_ACTIVE      (UPLINK_MODE != UPLINK_OFF || RECORDER_ENABLE || CAPTURE_ENABLE)
+#define UPLINK_NEED_FRAMES (UPLINK_MODE == UPLINK_FRAMED || RECORDER_ENABLE)
+// 需要攒音频帧（UPLINK_SPECTRUM 只发频谱，除非还要录音）
+#define UPLINK_AUDIO       (UPLINK_MODE == UPLINK_RAW || UPLINK_NEED_FRAMES)
+
+// 命令通道开停的只是写串口；攒帧、录音、事件捕获照常
+static volatile bool streaming = true;
+
+void uplink_set_streaming(bool on) { streaming = on; }
+bool uplink_streaming() { return streaming; }
+
+#if UPLINK_ACTIVE
+
+struct UplinkBlock {
+  uint32_t t_capture;
+  uint16_t samples;
+  int16_t  data[BUFFER_SAMPLES_MAX];
+};
+
+static SpscQueue<UplinkBlock, UPLINK_QUEUE_DEPTH> uplink_q;
+static TaskHandle_t uplink_handle = NULL;
+static UplinkStats stats = {};
+
+static_assert(UPLINK_FRAME_SAMPLES * sizeof(int16_t) <= FRAME_MAX_PAYLOAD,
+              "UPLINK_FRAME_SAMPLES 超出帧 payload 上限");
+
+#if UPLINK_NEED_FRAMES
+// 把一帧 PCM 编成 audio_frame 帧，返回帧长度
+static size_t encode_frame(const int16_t* pcm, uint32_t t_first, uint8_t* frame) {
+  static uint16_t seq = 0;
+#if UPLINK_CODEC != SAMPLE_FMT_PCM16
+  static uint8_t coded[UPLINK_FRAME_SAMPLES * 2];
+#endif
+#if UPLINK_CODEC == SAMPLE_FMT_ADPCM
+  static AdpcmState adpcm = {0, 0};
+#endif
+
+  FrameHeader h = {};
+  h.type      = FRAME_TYPE_AUDIO;
+  h.format    = UPLINK_CODEC;
+  h.seq       = seq++;
+  h.timestamp = t_first;
+  h.samples   = UPLINK_FRAME_SAMPLES;
+  h.channels  = 1;
+#if UPLINK_CODEC == SAMPLE_FMT_ADPCM
+  // 编码器状态跨帧延续，块头带上起始状态，丢帧后下一帧照样能解
+  h.length = adpcm_encode_block(&adpcm, pcm, UPLINK_FRAME_SAMPLES, coded);
+  const uint8_t* payload = coded;
+#elif UPLINK_CODEC == SAMPLE_FMT_ULAW
+  for (int k = 0; k < UPLINK_FRAME_SAMPLES; k++) coded[k] = ulaw_encode(pcm[k]);
+  h.length = UPLINK_FRAME_SAMPLES;
+  const uint8_t* payload = coded;
+#else
+  h.length = UPLINK_FRAME_SAMPLES * sizeof(int16_t);
+  const uint8_t* payload = (const uint8_t*)pcm;
+#endif
+  return frame_encode(frame, FRAME_MAX_SIZE, h, payload);
+}
+#endif
+
+#if UPLINK_MODE == UPLINK_SPECTRUM
+static_assert(SPECTRUM_BANDS <= SPECTRUM_RECORD_MAX_BANDS, "SPECTRUM_BANDS 超出频谱记录上限");
+
+// 频谱按采集采样率算（不经过重采样），每 SPECTRUM_PERIOD_MS 的样本数发一帧，
+// 期间的 FFT 在分析器里做功率平均
+static void spectrum_feed(const int16_t* mono, int samples, uint32_t t_capture) {
+  static SpectrumAnalyzer analyzer(SAMPLE_RATE, SPECTRUM_FFT_SIZE, SPECTRUM_HOP,
+                                   SPECTRUM_BANDS, SPECTRUM_F_LO, SPECTRUM_F_HI);
+  static uint8_t frame[FRAME_HEADER_SIZE + SPECTRUM_HEADER_SIZE + SPECTRUM_BANDS + FRAME_TRAILER_SIZE];
+  static uint16_t seq = 0;
+  static uint32_t due = 0;
+  const uint32_t period = (uint32_t)SAMPLE_RATE * SPECTRUM_PERIOD_MS / 1000;
+
+  analyzer.push(mono, samples);
+  due += samples;
+  if (due < period) return;
+  due -= period;
+
+  float db[SPECTRUM_BANDS];
+  SpectrumRecord r;
+  if (!analyzer.read(db, &r.frames)) return;
+  r.bands       = SPECTRUM_BANDS;
+  r.fft_size    = analyzer.fft_size();
+  r.sample_rate = SAMPLE_RATE;
+  r.f_lo        = SPECTRUM_F_LO;
+  r.f_hi        = SPECTRUM_F_HI;
+  r.hop         = SPECTRUM_HOP;
+  for (int k = 0; k < SPECTRUM_BANDS; k++) r.level[k] = spectrum_level(db[k]);
+
+  uint8_t payload[SPECTRUM_HEADER_SIZE + SPECTRUM_BANDS];
+  FrameHeader h = {};
+  h.type      = FRAME_TYPE_SPECTRUM;
+  h.seq       = seq++;
+  h.timestamp = t_capture;
+  h.length    = spectrum_encode(r, payload, sizeof(payload));
+  if (!streaming) return;
+  control_write_bulk(frame, frame_encode(frame, sizeof(frame), h, payload));
+  stats.frames++;
+}
+#endif
+
+#if UPLINK_AUDIO
+// ---------- 音频帧：重采样 → 攒满 UPLINK_FRAME_SAMPLES → 串口 / 录音 ----------
+
+#define UPLINK_RESAMPLE (UPLINK_SAMPLE_RATE != SAMPLE_RATE)
+
+static int16_t pcm[UPLINK_FRAME_SAMPLES];
+static int fill = 0;
+#if UPLINK_NEED_FRAMES
+static uint8_t frame[FRAME_MAX_SIZE];
+static uint32_t t_first = 0;
+#endif
+
+static void emit_frame() {
+  fill = 0;
+#if UPLINK_NEED_FRAMES
+  size_t len = encode_frame(pcm, t_first, frame);
+#endif
+#if UPLINK_MODE == UPLINK_FRAMED
+  if (streaming) control_write_bulk(frame, len);
+#elif UPLINK_MODE == UPLINK_RAW
+  if (streaming) control_write_bulk((const uint8_t*)pcm, sizeof(pcm));
+#endif
+#if RECORDER_ENABLE
+  recorder_append(frame, len);
+#endif
+  stats.frames++;
+}
+
+// 一次最多 BUFFER_SAMPLES_MAX 个采集样本
+static void emit_samples(const int16_t* in, int n, uint32_t t_capture) {
+#if UPLINK_RESAMPLE
+  // 放在上行任务里：低优先级、不占音频任务的时间；组延迟 RESAMPLE_TAPS/2 个样本（约 0.5 ms）
+  static Resampler resampler(SAMPLE_RATE, UPLINK_SAMPLE_RATE);
+  static int16_t resampled[(uint64_t)BUFFER_SAMPLES_MAX * UPLINK_SAMPLE_RATE / SAMPLE_RATE + 2];
+  const int samples = resampler.process(in, n, resampled);
+  const int16_t* data = resampled;
+#else
+  const int samples = n;
+  const int16_t* data = in;
+#endif
+  for (int i = 0; i < samples; ) {
+#if UPLINK_NEED_FRAMES
+    if (fill == 0) t_first = t_capture;
+#else
+    (void)t_capture;
+#endif
+    int k = samples - i;
+    if (k > UPLINK_FRAME_SAMPLES - fill) k = UPLINK_FRAME_SAMPLES - fill;
+    memcpy(pcm + fill, data + i, k * sizeof(int16_t));
+    fill += k;
+    i    += k;
+    if (fill == UPLINK_FRAME_SAMPLES) emit_frame();
+  }
+}
+#endif  // UPLINK_AUDIO
+
+#define UPLINK_VAD (VAD_ENABLE && UPLINK_AUDIO)
+
+#if UPLINK_VAD
+#define VAD_PREROLL_SAMPLES ((uint32_t)SAMPLE_RATE * VAD_PREROLL_MS / 1000)
+#define VAD_HANGOVER_FRAMES ((int)((uint32_t)SAMPLE_RATE * VAD_HANGOVER_MS / 1000 / VAD_FRAME))
+static_assert(VAD_PREROLL_SAMPLES + BUFFER_SAMPLES_MAX <= VAD_PREROLL_RING,
+              "VAD_PREROLL_RING 装不下预录");
+
+static VadStats vad_stats = {};
+
+// 门控：每块先写进预录环再喂 VAD。门打开的那一块从 VAD_PREROLL_MS 之前开始补发
+// （把起判延迟和被判成静音的弱起音补回来），之后每块跟着实时发；
+// 门关上（拖尾结束）时把不满的一帧补零发掉，直到下次打开都不再编码、写串口或写 flash
+static void vad_feed(const int16_t* mono, int samples, uint32_t t_capture) {
+  static Vad vad(SAMPLE_RATE, VAD_FRAME, VAD_ONSET_FRAMES, VAD_HANGOVER_FRAMES, VAD_WEIGHTS);
+  static SampleRing<VAD_PREROLL_RING> ring;
+  static int16_t chunk[BUFFER_SAMPLES_MAX];
+  static uint32_t buffered = 0;   // 环里可补发的样本数（封顶 VAD_PREROLL_SAMPLES）
+  static uint32_t sent = 0;       // 下一个要发的样本序号
+  static bool open = false;
+
+  const uint32_t base = ring.head();
+  ring.write(mono, samples);
+  const uint32_t head = base + samples;
+  if (buffered < VAD_PREROLL_SAMPLES) buffered += samples;
+
+  const int frames = vad.push(mono, samples);
+  vad_stats.frames += frames;
+  if (vad.active()) vad_stats.active_frames += frames;
+
+  if (vad.active() != open) {
+    open = vad.active();
+    if (open) {
+      vad_stats.segments++;
+#if CAPTURE_ENABLE && CAPTURE_VAD_TRIGGER
+      capture_trigger(CAPTURE_REASON_VAD);
+#endif
+      sent = head - (buffered < VAD_PREROLL_SAMPLES ? buffered : VAD_PREROLL_SAMPLES);
+    } else {
+      if (fill > 0) {
+        memset(pcm + fill, 0, (UPLINK_FRAME_SAMPLES - fill) * sizeof(int16_t));
+        emit_frame();
+      }
+      return;
+    }
+  }
+  if (!open) return;
+
+  // 补发 / 实时发 [sent, head)，时间戳按采样率从本块的 t_capture 往前推
+  while (sent != head) {
+    uint32_t n = head - sent;
+    if (n > BUFFER_SAMPLES_MAX) n = BUFFER_SAMPLES_MAX;
+    if (!ring.read(sent, n, chunk)) break;   // 单线程读写，不会发生
+    const int32_t offset = (int32_t)(sent - base);   // 补发时为负
+    emit_samples(chunk, n, t_capture + (int32_t)((int64_t)offset * 1000000 / SAMPLE_RATE));
+    sent += n;
+  }
+}
+#endif  // UPLINK_VAD
+
+#if CAPTURE_ENABLE
+#if !UPLINK_BINARY && !RECORDER_ENABLE
+#error "CAPTURE_ENABLE 需要 UPLINK_FRAMED / UPLINK_SPECTRUM 或 RECORDER_ENABLE 来送出捕获"
+#endif
+static_assert(CAPTURE_HEADER_SIZE + CAPTURE_CHUNK_SAMPLES * sizeof(int16_t) <= FRAME_MAX_PAYLOAD,
+              "CAPTURE_CHUNK_SAMPLES 超出帧 payload 上限");
+
+// 捕获块编成 FRAME_TYPE_CAPTURE 帧（PCM16，采集采样率，不重采样），和音频帧走同样的出口
+static void capture_drain() {
+  static int16_t pcm[CAPTURE_CHUNK_SAMPLES];
+  static uint8_t payload[CAPTURE_HEADER_SIZE + CAPTURE_CHUNK_SAMPLES * sizeof(int16_t)];
+  static uint8_t cframe[FRAME_HEADER_SIZE + sizeof(payload) + FRAME_TRAILER_SIZE];
+  static uint16_t seq = 0;
+
+  CaptureChunk c;
+  uint32_t n;
+  while ((n = capture_read(pcm, CAPTURE_CHUNK_SAMPLES, &c)) > 0) {
+    const CaptureRecord r = {c.reason, c.job, SAMPLE_RATE, c.offset, c.trigger, c.flags};
+    size_t plen = capture_encode(r, payload, sizeof(payload));
+    memcpy(payload + plen, pcm, n * sizeof(int16_t));
+    plen += n * sizeof(int16_t);
+
+    FrameHeader h = {};
+    h.type      = FRAME_TYPE_CAPTURE;
+    h.format    = SAMPLE_FMT_PCM16;
+    h.seq       = seq++;
+    h.timestamp = c.t_first;
+    h.samples   = n;
+    h.channels  = 1;
+    h.length    = plen;
+    const size_t len = frame_encode(cframe, sizeof(cframe), h, payload);
+#if UPLINK_BINARY
+    control_write_bulk(cframe, len);
+#endif
+#if RECORDER_ENABLE
+    recorder_append(cframe, len);
+#endif
+  }
+}
+#endif  // CAPTURE_ENABLE
+
+static void uplink_task(void* arg) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+    UplinkBlock* blk;
+    while ((blk = uplink_q.read_slot()) != NULL) {
+#if UPLINK_MODE == UPLINK_SPECTRUM
+      spectrum_feed(blk->data, blk->samples, blk->t_capture);
+#endif
+#if UPLINK_VAD
+      vad_feed(blk->data, blk->samples, blk->t_capture);
+#elif UPLINK_AUDIO
+      emit_samples(blk->data, blk->samples, blk->t_capture);
+#endif
+#if CAPTURE_ENABLE
+      capture_feed(blk->data, blk->samples, blk->t_capture);
+      capture_drain();
+#endif
+      uplink_q.commit_read();
+    }
+  }
+}
+
+bool uplink_start() {
+  return xTaskCreatePinnedToCore(uplink_task, "uplink", UPLINK_STACK, NULL,
+                                 UPLINK_PRIO, &uplink_handle,
+                                 PIPELINE_IO_CORE) == pdPASS;
+}
+
+void uplink_push(const int16_t* mono, int samples, uint32_t t_capture) {
+  UplinkBlock* blk = uplink_q.write_slot();
+  if (blk == NULL) {
+    stats.dropped++;
+    return;
+  }
+  blk->t_capture = t_capture;
+  blk->samples   = samples;
+  memcpy(blk->data, mono, samples * sizeof(int16_t));
+  uplink_q.commit_write();
+  xTaskNotifyGive(uplink_handle);
+}
+
+void uplink_get_stats(UplinkStats* out) {
+  out->frames  = stats.frames;
+  out->dropped = stats.dropped;
+}
+
+void uplink_get_vad_stats(VadStats* out) {
+#if UPLINK_VAD
+  *out = vad_stats;
+#else
+  *out = VadStats{};
+#endif
+}
+
+#else
+
+bool uplink_start() { return true; }
+void uplink_push(const int16_t*, int, uint32_t) {}
+void uplink_get_stats(UplinkStats* out) { out->frames = out->dropped = 0; }
+void uplink_get_vad_stats(VadStats* out) { *out = VadStats{}; }
+
+#endif  // UPLINK_ACTIVE
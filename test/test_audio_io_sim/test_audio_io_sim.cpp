@@ -0,0 +1,266 @@
+// =================================================
+// SimAudioIo 主机测试（lib/audio_io/audio_io_sim.h）
+//
+//   pio test -e native -f test_audio_io_sim
+//
+// 按 PIPELINE_DIRECT 的写法（direct_task：acquire_rx → DSP 写进 acquire_tx 借出的缓冲 → commit_tx）
+// 经 AudioIo 接口驱动运行时 DSP 链（带通 + 增益），和整段一次过链的结果逐位比对：
+// 分块、借缓冲、重建都不能改变输出
+// 再用 stall() 注入调用方卡顿，核对 xrun 计数和 RX seq 缺口（和 I2S 后端约定一致：
+// RX 丢块时 seq 照样前进，消费端看到的缺口 = rx_overruns）
+// zero_copy 模型另外覆盖零拷贝后端跳过过期 DMA 块的路径
+// =================================================
+
+#include <audio_io_sim.h>
+#include <runtime_chain.h>
+#include <unity.h>
+#include <math.h>
+#include <vector>
+
+void setUp() {}
+void tearDown() {}
+
+static const int kRate  = 44100;
+static const int kBlock = 8;
+
+// 按绝对样本号生成，和块大小无关
+static int16_t sample_at(uint32_t n) {
+  return (int16_t)lrint(6000 * sin(2 * 3.14159265358979 * 440 * n / kRate) +
+                        3000 * sin(2 * 3.14159265358979 * 2500 * n / kRate));
+}
+
+static DspParams chain_params() {
+  DspParams p = {};
+  dsp_params_set_butter(&p, kRate, RT_FILTER_BANDPASS, 100, 3000);
+  dsp_params_set_gain(&p, 3.0f);
+  dsp_params_set_ceiling(&p, 0);
+  return p;
+}
+
+// direct_task 的一次迭代；返回这块的 seq
+static uint32_t direct_block(AudioIo* io, RuntimeChain& rt, int16_t* work) {
+  RxBuffer rb;
+  io->acquire_rx(&rb, UINT32_MAX);
+  int16_t* dst = io->acquire_tx(UINT32_MAX);
+  rt.update();
+  rt.output(rt.filter(rb.data, work, rb.samples), dst, rb.samples);
+  io->release_rx();
+  io->commit_tx(rb.samples);
+  return rb.seq;
+}
+
+// 参考：整段一次过链
+static std::vector<int16_t> reference(uint32_t samples) {
+  std::vector<int16_t> in(samples), out(2 * samples), work(samples);
+  for (uint32_t i = 0; i < samples; i++) in[i] = sample_at(i);
+  RuntimeChain rt(kRate, chain_params());
+  rt.update();
+  rt.output(rt.filter(in.data(), work.data(), samples), out.data(), samples);
+  return out;
+}
+
+static void test_direct_matches_reference() {
+  SimAudioIo sim(kBlock, [](int16_t* mono, uint16_t n, uint32_t seq) {
+    for (uint16_t i = 0; i < n; i++) mono[i] = sample_at(seq * kBlock + i);
+  });
+  AudioIo* io = &sim;
+  TEST_ASSERT_TRUE(io->begin());
+  RuntimeChain rt(kRate, chain_params());
+  int16_t work[kBlock];
+
+  const uint32_t blocks = 5000;
+  for (uint32_t b = 0; b < blocks; b++) TEST_ASSERT_EQUAL_UINT32(b, direct_block(io, rt, work));
+
+  const std::vector<int16_t> ref = reference(blocks * kBlock);
+  TEST_ASSERT_EQUAL(ref.size(), sim.played.size());
+  TEST_ASSERT_TRUE(ref == sim.played);
+
+  XrunStats x;
+  io->xrun_stats(&x);
+  TEST_ASSERT_EQUAL_UINT32(0, x.rx_overruns);
+  TEST_ASSERT_EQUAL_UINT32(0, x.tx_underruns);
+}
+
+// 自适应缓冲换档：重建后块大小变了，DSP 照常跑，环从空开始，不计 xrun
+static void test_direct_across_reconfigure() {
+  uint32_t base = 0;   // 重建那一刻之前的样本数，seq 从那里按新块长继续
+  uint32_t base_seq = 0;
+  uint32_t frames = kBlock;
+  SimAudioIo sim(kBlock, [&](int16_t* mono, uint16_t n, uint32_t seq) {
+    for (uint16_t i = 0; i < n; i++) mono[i] = sample_at(base + (seq - base_seq) * frames + i);
+  });
+  AudioIo* io = &sim;
+  RuntimeChain rt(kRate, chain_params());
+  int16_t work[64];
+
+  uint32_t seq = 0;
+  for (int b = 0; b < 1000; b++) seq = direct_block(io, rt, work);
+  base     = (seq + 1) * kBlock;
+  base_seq = seq + 1;
+  frames   = 32;
+  TEST_ASSERT_TRUE(io->reconfigure(32, 6));
+  TEST_ASSERT_EQUAL(32, io->block_frames());
+  for (int b = 0; b < 250; b++) {
+    const uint32_t s = direct_block(io, rt, work);
+    TEST_ASSERT_EQUAL_UINT32(base_seq + b, s);
+  }
+
+  const std::vector<int16_t> ref = reference(base + 250 * 32);
+  TEST_ASSERT_TRUE(ref == sim.played);
+  TEST_ASSERT_EQUAL(1, sim.reconfigures);
+  XrunStats x;
+  io->xrun_stats(&x);
+  TEST_ASSERT_EQUAL_UINT32(0, x.rx_overruns);
+  TEST_ASSERT_EQUAL_UINT32(0, x.tx_underruns);
+}
+
+// 锁步跑 n 块，返回最后一块的 seq
+static uint32_t lockstep(AudioIo* io, int n) {
+  RxBuffer rb;
+  for (int b = 0; b < n; b++) {
+    io->acquire_rx(&rb, UINT32_MAX);
+    io->acquire_tx(UINT32_MAX);
+    io->release_rx();
+    io->commit_tx(rb.samples);
+  }
+  return rb.seq;
+}
+
+// 4 深的环卡 10 块：RX 环攒满 4 块后再来的 6 块把最老的挤掉；
+// 锁步时 TX 环里只有 1 块，播完之后 9 拍没数据
+static void test_stall_counts_xruns() {
+  SimAudioIo sim(kBlock, nullptr, 4);
+  AudioIo* io = &sim;
+  const uint32_t before = lockstep(io, 100);
+  XrunStats x;
+  io->xrun_stats(&x);
+  TEST_ASSERT_EQUAL_UINT32(0, x.rx_overruns);
+  TEST_ASSERT_EQUAL_UINT32(0, x.tx_underruns);
+
+  sim.stall(10);
+  io->xrun_stats(&x);
+  TEST_ASSERT_EQUAL_UINT32(6, x.rx_overruns);
+  TEST_ASSERT_EQUAL_UINT32(9, x.tx_underruns);
+
+  // 下一块是环里剩下最老的：缺口正好是被挤掉的 6 块
+  RxBuffer rb;
+  io->acquire_rx(&rb, UINT32_MAX);
+  TEST_ASSERT_EQUAL_UINT32(before + 1 + 6, rb.seq);
+  io->release_rx();
+  io->acquire_tx(UINT32_MAX);
+  io->commit_tx(rb.samples);
+
+  // 追上之后不再计数
+  const uint32_t last = lockstep(io, 1000);
+  TEST_ASSERT_EQUAL_UINT32(rb.seq + 1000, last);
+  io->xrun_stats(&x);
+  TEST_ASSERT_EQUAL_UINT32(6, x.rx_overruns);
+  TEST_ASSERT_EQUAL_UINT32(9, x.tx_underruns);
+}
+
+// 卡顿没超过 RX 环深度：采集不丢块、seq 连续，只有 TX 欠载
+static void test_short_stall_only_underruns() {
+  SimAudioIo sim(kBlock, nullptr, 4);
+  AudioIo* io = &sim;
+  const uint32_t before = lockstep(io, 100);
+  sim.stall(4);
+  XrunStats x;
+  io->xrun_stats(&x);
+  TEST_ASSERT_EQUAL_UINT32(0, x.rx_overruns);
+  TEST_ASSERT_EQUAL_UINT32(3, x.tx_underruns);
+  TEST_ASSERT_EQUAL_UINT32(before + 4 + 100, lockstep(io, 100 + 4));
+}
+
+// 计数自启动累计：多次卡顿相加，重建端口也不清零
+static void test_xruns_accumulate_across_reconfigure() {
+  SimAudioIo sim(kBlock, nullptr, 4);
+  AudioIo* io = &sim;
+  lockstep(io, 10);
+  sim.stall(10);
+  lockstep(io, 10);
+  TEST_ASSERT_TRUE(io->reconfigure(32, 6));
+  lockstep(io, 10);
+  sim.stall(10);   // 6 深：RX 丢 4 块；TX 锁步时同样只有 1 块在排队
+  XrunStats x;
+  io->xrun_stats(&x);
+  TEST_ASSERT_EQUAL_UINT32(6 + 4, x.rx_overruns);
+  TEST_ASSERT_EQUAL_UINT32(9 + 9, x.tx_underruns);
+}
+
+// zero_copy 模型（I2sChannelIo 的记账）：4 深的环卡 10 块，中断照常往队列里推了 10 个；
+// 下一次取块时排队超过 深度 - 2 的 8 个已被 DMA 覆盖，跳过并计数，之后锁步不再计数
+static void test_zero_copy_skips_stale() {
+  SimAudioIo sim(kBlock, nullptr, 4, true);
+  AudioIo* io = &sim;
+  const uint32_t before = lockstep(io, 100);
+  XrunStats x;
+  io->xrun_stats(&x);
+  TEST_ASSERT_EQUAL_UINT32(0, x.rx_overruns);
+  TEST_ASSERT_EQUAL_UINT32(0, x.tx_underruns);
+
+  sim.stall(10);
+  RxBuffer rb;
+  io->acquire_rx(&rb, UINT32_MAX);
+  TEST_ASSERT_EQUAL_UINT32(before + 1 + 8, rb.seq);
+  io->release_rx();
+  io->acquire_tx(UINT32_MAX);
+  io->commit_tx(rb.samples);
+  io->xrun_stats(&x);
+  TEST_ASSERT_EQUAL_UINT32(8, x.rx_overruns);
+  TEST_ASSERT_EQUAL_UINT32(8, x.tx_underruns);
+
+  // 跳过之后队列状态必须还是对的：剩下的块按序取完，再往后每块都要等一拍
+  const uint32_t last = lockstep(io, 1000);
+  TEST_ASSERT_EQUAL_UINT32(rb.seq + 1000, last);
+  io->xrun_stats(&x);
+  TEST_ASSERT_EQUAL_UINT32(8, x.rx_overruns);
+  TEST_ASSERT_EQUAL_UINT32(8, x.tx_underruns);
+}
+
+// 卡得比指针队列（16）还久：中断推不进的 4 个也算 overrun，seq 在那里同样有缺口
+static void test_zero_copy_queue_full() {
+  SimAudioIo sim(kBlock, nullptr, 4, true);
+  AudioIo* io = &sim;
+  const uint32_t before = lockstep(io, 100);
+  sim.stall(20);
+  RxBuffer rb;
+  io->acquire_rx(&rb, UINT32_MAX);
+  TEST_ASSERT_EQUAL_UINT32(before + 1 + 14, rb.seq);
+  io->release_rx();
+  io->acquire_tx(UINT32_MAX);
+  io->commit_tx(rb.samples);
+  XrunStats x;
+  io->xrun_stats(&x);
+  TEST_ASSERT_EQUAL_UINT32(4 + 14, x.rx_overruns);
+  TEST_ASSERT_EQUAL_UINT32(4 + 14, x.tx_underruns);
+  // 队列里剩下的最后一块是 before + 16，之后中断没推进去的 4 块是缺口
+  TEST_ASSERT_EQUAL_UINT32(before + 16, lockstep(io, 1));
+  TEST_ASSERT_EQUAL_UINT32(before + 21, lockstep(io, 1));
+}
+
+// 最小深度 AUDIO_IO_MIN_DMA_DEPTH 下锁步不误跳（深度 2 时阈值为 0，每块都会被丢）
+static void test_zero_copy_min_depth() {
+  SimAudioIo sim(kBlock, nullptr, 4, true);
+  AudioIo* io = &sim;
+  lockstep(io, 10);
+  TEST_ASSERT_TRUE(io->reconfigure(kBlock, AUDIO_IO_MIN_DMA_DEPTH));
+  const uint32_t first = lockstep(io, 1);
+  TEST_ASSERT_EQUAL_UINT32(first + 1000, lockstep(io, 1000));
+  XrunStats x;
+  io->xrun_stats(&x);
+  TEST_ASSERT_EQUAL_UINT32(0, x.rx_overruns);
+  TEST_ASSERT_EQUAL_UINT32(0, x.tx_underruns);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_direct_matches_reference);
+  RUN_TEST(test_direct_across_reconfigure);
+  RUN_TEST(test_stall_counts_xruns);
+  RUN_TEST(test_short_stall_only_underruns);
+  RUN_TEST(test_xruns_accumulate_across_reconfigure);
+  RUN_TEST(test_zero_copy_skips_stale);
+  RUN_TEST(test_zero_copy_queue_full);
+  RUN_TEST(test_zero_copy_min_depth);
+  return UNITY_END();
+}
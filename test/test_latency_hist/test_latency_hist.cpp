@@ -0,0 +1,129 @@
+// =================================================
+// LatencyHistogram 单元测试（lib/telemetry/latency_hist.h）
+//
+//   pio test -e native -f test_latency_hist
+//
+// 分桶：bucket_of / bucket_low / bucket_width 在 0..100000 和 uint32 两端互为逆映射，
+//       240 个桶首尾相接覆盖整个 uint32，相对宽度 ≤ 1/8
+// 窗口：window() 只统计上次调用以来的样本，max 每个窗口清零
+// 百分位：均匀 / 双峰 / 常数分布上 p50、p99 落在真实百分位所在桶的中点（不超过 max）
+// =================================================
+
+#include <latency_hist.h>
+#include <unity.h>
+#include <stdint.h>
+
+void setUp() {}
+void tearDown() {}
+
+// 真实百分位 v 所在桶的中点，和 window() 的取法一致
+static uint32_t bucket_mid(uint32_t v, uint32_t max) {
+  const int i = LatencyHistogram::bucket_of(v);
+  const uint32_t mid = LatencyHistogram::bucket_low(i) + LatencyHistogram::bucket_width(i) / 2;
+  return mid < max ? mid : max;
+}
+
+static void test_bucket_round_trip() {
+  int prev = -1;
+  for (uint32_t v = 0; v <= 100000; v++) {
+    const int i = LatencyHistogram::bucket_of(v);
+    const uint32_t lo = LatencyHistogram::bucket_low(i);
+    const uint32_t w  = LatencyHistogram::bucket_width(i);
+    TEST_ASSERT_TRUE_MESSAGE(i >= 0 && i < HIST_BUCKETS, "桶下标越界");
+    TEST_ASSERT_TRUE_MESSAGE(lo <= v && v - lo < w, "值不在自己的桶里");
+    TEST_ASSERT_TRUE_MESSAGE(i == prev || i == prev + 1, "桶下标不单调或跳桶");
+    prev = i;
+  }
+  TEST_ASSERT_EQUAL_INT(0, LatencyHistogram::bucket_of(0));
+  TEST_ASSERT_EQUAL_INT(HIST_SUB - 1, LatencyHistogram::bucket_of(HIST_SUB - 1));
+  TEST_ASSERT_EQUAL_INT(HIST_SUB, LatencyHistogram::bucket_of(HIST_SUB));
+}
+
+static void test_bucket_extremes() {
+  TEST_ASSERT_EQUAL_INT(HIST_BUCKETS - 1, LatencyHistogram::bucket_of(0xFFFFFFFFu));
+  TEST_ASSERT_EQUAL_INT(HIST_BUCKETS - HIST_SUB, LatencyHistogram::bucket_of(0x80000000u));
+  TEST_ASSERT_EQUAL_INT(HIST_BUCKETS - HIST_SUB - 1, LatencyHistogram::bucket_of(0x7FFFFFFFu));
+
+  // 所有桶首尾相接，最后一个桶正好收在 0xFFFFFFFF
+  uint64_t next = 0;
+  for (int i = 0; i < HIST_BUCKETS; i++) {
+    const uint32_t lo = LatencyHistogram::bucket_low(i);
+    const uint32_t w  = LatencyHistogram::bucket_width(i);
+    TEST_ASSERT_TRUE_MESSAGE(lo == next, "桶之间有缝或重叠");
+    TEST_ASSERT_EQUAL_INT(i, LatencyHistogram::bucket_of(lo));
+    TEST_ASSERT_EQUAL_INT(i, LatencyHistogram::bucket_of((uint32_t)(lo + (uint64_t)w - 1)));
+    if (i >= HIST_SUB) TEST_ASSERT_TRUE_MESSAGE((uint64_t)w * HIST_SUB <= lo, "相对宽度超过 1/8");
+    next = (uint64_t)lo + w;
+  }
+  TEST_ASSERT_TRUE(next == 0x100000000ull);
+}
+
+static void test_window_diff() {
+  static LatencyHistogram h;
+
+  HistSummary s = h.window();
+  TEST_ASSERT_EQUAL_UINT32(0, s.count);
+  TEST_ASSERT_EQUAL_UINT32(0, s.p50);
+  TEST_ASSERT_EQUAL_UINT32(0, s.max);
+
+  for (int k = 0; k < 100; k++) h.record(5000);
+  s = h.window();
+  TEST_ASSERT_EQUAL_UINT32(100, s.count);
+  TEST_ASSERT_EQUAL_UINT32(5000, s.max);
+  TEST_ASSERT_EQUAL_UINT32(bucket_mid(5000, 5000), s.p50);
+
+  // 第二个窗口只看到新样本，上个窗口的 5000 不再影响百分位和 max
+  for (int k = 0; k < 10; k++) h.record(3);
+  s = h.window();
+  TEST_ASSERT_EQUAL_UINT32(10, s.count);
+  TEST_ASSERT_EQUAL_UINT32(3, s.p50);
+  TEST_ASSERT_EQUAL_UINT32(3, s.p99);
+  TEST_ASSERT_EQUAL_UINT32(3, s.max);
+
+  s = h.window();
+  TEST_ASSERT_EQUAL_UINT32(0, s.count);
+  TEST_ASSERT_EQUAL_UINT32(0, s.max);
+}
+
+static void test_percentiles() {
+  static LatencyHistogram h;
+
+  // 均匀 1..1000：第 500 / 990 个值
+  for (uint32_t v = 1; v <= 1000; v++) h.record(v);
+  HistSummary s = h.window();
+  TEST_ASSERT_EQUAL_UINT32(1000, s.count);
+  TEST_ASSERT_EQUAL_UINT32(1000, s.max);
+  TEST_ASSERT_EQUAL_UINT32(bucket_mid(500, 1000), s.p50);
+  TEST_ASSERT_EQUAL_UINT32(bucket_mid(990, 1000), s.p99);
+  TEST_ASSERT_TRUE(s.p50 >= 500 - 500 / HIST_SUB && s.p50 <= 500 + 500 / HIST_SUB);
+
+  // 双峰：10 个 50000 正好不够进 p99（第 990 个还是 100）
+  for (int k = 0; k < 990; k++) h.record(100);
+  for (int k = 0; k < 10; k++) h.record(50000);
+  s = h.window();
+  TEST_ASSERT_EQUAL_UINT32(bucket_mid(100, 50000), s.p50);
+  TEST_ASSERT_EQUAL_UINT32(bucket_mid(100, 50000), s.p99);
+  TEST_ASSERT_EQUAL_UINT32(50000, s.max);
+
+  // 再多一个就进了 p99；50000 所在桶的中点（51200）超过 max，取 max
+  for (int k = 0; k < 989; k++) h.record(100);
+  for (int k = 0; k < 11; k++) h.record(50000);
+  s = h.window();
+  TEST_ASSERT_EQUAL_UINT32(bucket_mid(100, 50000), s.p50);
+  TEST_ASSERT_EQUAL_UINT32(50000, s.p99);
+
+  // 常数：精确桶内取值不变
+  for (int k = 0; k < 1000; k++) h.record(7);
+  s = h.window();
+  TEST_ASSERT_EQUAL_UINT32(7, s.p50);
+  TEST_ASSERT_EQUAL_UINT32(7, s.p99);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_bucket_round_trip);
+  RUN_TEST(test_bucket_extremes);
+  RUN_TEST(test_window_diff);
+  RUN_TEST(test_percentiles);
+  return UNITY_END();
+}
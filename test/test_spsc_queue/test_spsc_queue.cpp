@@ -0,0 +1,170 @@
+// =================================================
+// SpscQueue 单元 / 压力测试（lib/spsc_queue/spsc_queue.h）
+//
+//   pio test -e native -f test_spsc_queue
+//
+// 单线程：空 / 满边界、先进先出、原地读写、discard 丢弃
+// 双线程：生产者连续推序号，消费者逐个检查序号连续（不丢、不重、不乱序）
+//         和整块内容自洽（不会读到写了一半的槽位）；两边各用一种接口
+// =================================================
+
+#include <spsc_queue.h>
+#include <unity.h>
+#include <stdint.h>
+#include <thread>
+
+void setUp() {}
+void tearDown() {}
+
+// 和音频块一样是多字大块，撕裂读能从内容上看出来
+struct Item {
+  uint32_t seq;
+  uint32_t data[15];
+};
+
+static void fill(Item* it, uint32_t seq) {
+  it->seq = seq;
+  for (int k = 0; k < 15; k++) it->data[k] = seq * 2654435761u + k;
+}
+
+static bool consistent(const Item& it) {
+  for (int k = 0; k < 15; k++)
+    if (it.data[k] != it.seq * 2654435761u + k) return false;
+  return true;
+}
+
+static void test_empty_full() {
+  static SpscQueue<uint32_t, 4> q;
+  uint32_t v;
+  TEST_ASSERT_TRUE(q.empty());
+  TEST_ASSERT_FALSE(q.pop(v));
+  TEST_ASSERT_NULL(q.read_slot());
+  for (uint32_t i = 0; i < 4; i++) TEST_ASSERT_TRUE(q.push(i));
+  TEST_ASSERT_EQUAL(4u, q.size());
+  TEST_ASSERT_FALSE(q.push(99));
+  TEST_ASSERT_NULL(q.write_slot());
+  for (uint32_t i = 0; i < 4; i++) {
+    TEST_ASSERT_TRUE(q.pop(v));
+    TEST_ASSERT_EQUAL_UINT32(i, v);
+  }
+  TEST_ASSERT_TRUE(q.empty());
+}
+
+static void test_slots_wrap() {
+  static SpscQueue<Item, 8> q;
+  // 绕环很多圈，每次存取不同个数
+  uint32_t next_in = 0, next_out = 0;
+  for (int round = 0; round < 1000; round++) {
+    const int n = 1 + round % 8;
+    for (int i = 0; i < n; i++) {
+      Item* s = q.write_slot();
+      TEST_ASSERT_NOT_NULL(s);
+      fill(s, next_in++);
+      q.commit_write();
+    }
+    for (int i = 0; i < n; i++) {
+      const Item* s = q.read_slot();
+      TEST_ASSERT_NOT_NULL(s);
+      TEST_ASSERT_EQUAL_UINT32(next_out++, s->seq);
+      TEST_ASSERT_TRUE(consistent(*s));
+      q.commit_read();
+    }
+    TEST_ASSERT_TRUE(q.empty());
+  }
+}
+
+// 消费者先读过一次（head 缓存停在旧值），生产者又推了几个，再 discard 掉一部分：
+// 剩下的照常按序读出，读空之后 read_slot() 必须返回空、size() 不能下溢
+// （零拷贝 I2S 后端跳过过期 DMA 块的用法）
+static void test_discard_refreshes_head_cache() {
+  static SpscQueue<uint32_t, 16> q;
+  uint32_t v;
+  TEST_ASSERT_TRUE(q.push(0));
+  TEST_ASSERT_TRUE(q.pop(v));
+  for (uint32_t i = 1; i <= 10; i++) TEST_ASSERT_TRUE(q.push(i));
+  for (int i = 0; i < 8; i++) TEST_ASSERT_TRUE(q.discard());
+  TEST_ASSERT_EQUAL(2u, q.size());
+  TEST_ASSERT_TRUE(q.pop(v));
+  TEST_ASSERT_EQUAL_UINT32(9, v);
+  TEST_ASSERT_TRUE(q.pop(v));
+  TEST_ASSERT_EQUAL_UINT32(10, v);
+  TEST_ASSERT_NULL(q.read_slot());
+  TEST_ASSERT_FALSE(q.discard());
+  TEST_ASSERT_EQUAL(0u, q.size());
+}
+
+// 生产者用 write_slot/commit_write（流水线 rx_task 的写法），消费者用 pop（拷贝）
+static void test_two_thread_stress() {
+  static const uint32_t kCount = 2000000;
+  static SpscQueue<Item, 16> q;
+  std::thread producer([] {
+    for (uint32_t seq = 0; seq < kCount;) {
+      Item* s = q.write_slot();
+      if (!s) {
+        std::this_thread::yield();
+        continue;
+      }
+      fill(s, seq++);
+      q.commit_write();
+    }
+  });
+
+  uint32_t expect = 0, gaps = 0, torn = 0;
+  Item it;
+  while (expect < kCount) {
+    if (!q.pop(it)) {
+      std::this_thread::yield();   // 单核主机上也要让生产者跑起来
+      continue;
+    }
+    if (it.seq != expect) gaps++;
+    if (!consistent(it)) torn++;
+    expect = it.seq + 1;
+  }
+  producer.join();
+
+  TEST_ASSERT_EQUAL_UINT32(0, gaps);
+  TEST_ASSERT_EQUAL_UINT32(0, torn);
+  TEST_ASSERT_EQUAL_UINT32(kCount, expect);
+  TEST_ASSERT_TRUE(q.empty());
+}
+
+// 反过来：生产者 push，消费者 read_slot/commit_read（dsp_task 的写法）
+static void test_two_thread_stress_in_place() {
+  static const uint32_t kCount = 2000000;
+  static SpscQueue<Item, 4> q;   // 浅队列，满 / 空切换更频繁
+  std::thread producer([] {
+    Item it;
+    for (uint32_t seq = 0; seq < kCount; seq++) {
+      fill(&it, seq);
+      while (!q.push(it)) std::this_thread::yield();
+    }
+  });
+
+  uint32_t expect = 0, gaps = 0, torn = 0;
+  while (expect < kCount) {
+    const Item* s = q.read_slot();
+    if (!s) {
+      std::this_thread::yield();
+      continue;
+    }
+    if (s->seq != expect) gaps++;
+    if (!consistent(*s)) torn++;
+    expect = s->seq + 1;
+    q.commit_read();
+  }
+  producer.join();
+
+  TEST_ASSERT_EQUAL_UINT32(0, gaps);
+  TEST_ASSERT_EQUAL_UINT32(0, torn);
+  TEST_ASSERT_EQUAL_UINT32(kCount, expect);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_empty_full);
+  RUN_TEST(test_slots_wrap);
+  RUN_TEST(test_discard_refreshes_head_cache);
+  RUN_TEST(test_two_thread_stress);
+  RUN_TEST(test_two_thread_stress_in_place);
+  return UNITY_END();
+}
@@ -1,3 +1,5 @@
+# 只适用于 -DUPLINK_MODE=UPLINK_RAW 编的固件（裸 int16 流）。默认固件是 UPLINK_FRAMED 帧流，
+# 用 ./tools/bin/rt_player 或 ./tools/bin/frame_dump 收；连上后会先探测，看到 A5 5A 帧头直接报错退出
 
 
 import serial
@@ -7,6 +9,7 @@ import sys
 import struct
 import numpy as np
 from datetime import datetime
+from src.raw_stream import check_raw_stream
 
 # 配置参数
 SERIAL_PORT = '/dev/cu.wchusbserial59090740691'
@@ -103,6 +106,7 @@ def main():
         
         # 清空缓冲区
         ser.reset_input_buffer()
+        check_raw_stream(ser)
         time.sleep(0.5)
         
         # # 寻找同步点
@@ -0,0 +1,167 @@
+// =================================================
+// AGC 主机测试（lib/audio_dsp/agc.h）
+//
+//   ./agc_bench
+//
+// 三组信号（和固件一样按 8 样本一块喂）。“类语音”是 1 kHz 正弦按音节包络开关：
+// 每 250 ms 一个 180 ms 的 sin² 音节，中间 70 ms 停顿，底下垫 -70 dBFS 白噪声；电平指整段 RMS
+//   电平阶跃：类语音 -40 → -10 → -40 → -25 dBFS，每段 3 s，打印每段输出电平（最后 1 s）、
+//             增益稳定到终值 ±1 dB 的时间
+//   突发：-40 dBFS 类语音上每 500 ms 一个 0 dBFS、5 ms 的正弦脉冲，打印输出峰值、软削波样本数、增益恢复时间
+//   只有噪声：-65 dBFS 白噪声，打印增益和输出噪声电平（噪底上限）
+// 最后打印 cycles/样本
+// =================================================
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "agc.h"
+#include "cycle_clock.h"
+
+static const double kPi = 3.14159265358979323846;
+static const int kRate  = 44100;
+static const int kBlock = 8;
+
+struct Trace {
+  std::vector<int16_t> out;
+  std::vector<float> gain_db;   // 每块一个
+  uint64_t cycles = 0;
+  uint32_t soft = 0;
+};
+
+static Trace run(const std::vector<int16_t>& in) {
+  Agc agc(kRate);
+  Trace t;
+  t.out.resize(in.size());
+  for (size_t pos = 0; pos + kBlock <= in.size(); pos += kBlock) {
+    const uint32_t c0 = cycle_now();
+    agc.process(in.data() + pos, t.out.data() + pos, kBlock);
+    t.cycles += cycle_now() - c0;
+    t.gain_db.push_back(agc.gain_db());
+  }
+  t.soft = agc.soft_clipped();
+  return t;
+}
+
+static double rms_db(const std::vector<int16_t>& x, size_t a, size_t b) {
+  double s = 0;
+  for (size_t i = a; i < b; i++) s += (double)x[i] * x[i];
+  return 10 * log10(s / (b - a) / (32768.0 * 32768.0) + 1e-20);
+}
+
+// 从 block 开始，增益最后一次偏离 [终值 ± tol] 之后的时间（ms）
+static double settle_ms(const std::vector<float>& g, size_t from, size_t to, float tol) {
+  const float final = g[to - 1];
+  size_t last = from;
+  for (size_t i = from; i < to; i++)
+    if (fabsf(g[i] - final) > tol) last = i + 1;
+  return (double)(last - from) * kBlock * 1000.0 / kRate;
+}
+
+static uint32_t g_seed = 1;
+static double gauss() {
+  g_seed = g_seed * 1664525u + 1013904223u;
+  const double u1 = ((g_seed >> 8) + 1) / 16777217.0;
+  g_seed = g_seed * 1664525u + 1013904223u;
+  const double u2 = (g_seed >> 8) / 16777216.0;
+  return sqrt(-2 * log(u1)) * cos(2 * kPi * u2);
+}
+
+static void speechy(std::vector<int16_t>& x, size_t a, size_t b, double dbfs) {
+  std::vector<double> v(b - a);
+  double sum = 0;
+  for (size_t i = a; i < b; i++) {
+    const double t = fmod((double)i / kRate, 0.25);
+    const double env = t < 0.18 ? pow(sin(kPi * t / 0.18), 2) : 0;
+    v[i - a] = env * sin(2 * kPi * 1000 * i / kRate);
+    sum += v[i - a] * v[i - a];
+  }
+  const double gain = 32768.0 * pow(10, dbfs / 20) / sqrt(sum / (b - a));
+  const double bed  = 32768.0 * pow(10, -70 / 20.0);
+  for (size_t i = a; i < b; i++) {
+    const double y = gain * v[i - a] + bed * gauss();
+    x[i] = (int16_t)(y > 32767 ? 32767 : (y < -32768 ? -32768 : lrint(y)));
+  }
+}
+
+static void sine(std::vector<int16_t>& x, size_t a, size_t b, double dbfs) {
+  const double amp = 32768.0 * pow(10, dbfs / 20) * sqrt(2.0);   // dBFS 按满量程方波算：正弦峰值 = √2·RMS
+  for (size_t i = a; i < b; i++) {
+    const double v = amp * sin(2 * kPi * 1000 * i / kRate);
+    x[i] = (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : lrint(v)));
+  }
+}
+
+int main() {
+  printf("目标 %.0f dBFS，最大增益 %.0f dB，前视 %d 样本（%.2f ms），控制周期 %d 样本\n\n",
+         AGC_TARGET_DB, AGC_MAX_GAIN_DB, AGC_LOOKAHEAD, 1000.0 * AGC_LOOKAHEAD / kRate, AGC_CONTROL);
+  uint64_t cycles = 0, samples = 0;
+
+  // ---------- 电平阶跃 ----------
+  {
+    static const double kLevels[] = {-40, -10, -40, -25};
+    const size_t seg = (size_t)kRate * 3;
+    std::vector<int16_t> in(seg * 4);
+    for (int k = 0; k < 4; k++) speechy(in, seg * k, seg * (k + 1), kLevels[k]);
+    Trace t = run(in);
+    cycles += t.cycles;
+    samples += in.size();
+    printf("电平阶跃（类语音）\n");
+    for (int k = 0; k < 4; k++) {
+      const size_t b0 = seg * k / kBlock, b1 = seg * (k + 1) / kBlock;
+      printf("  输入 %4.0f dBFS：输出 %6.1f dBFS（最后 1 s），增益 %5.1f dB，稳定到 ±1 dB 用 %6.1f ms\n",
+             kLevels[k], rms_db(t.out, seg * (k + 1) - kRate, seg * (k + 1)), t.gain_db[b1 - 1],
+             settle_ms(t.gain_db, b0, b1, 1.0f));
+    }
+    int32_t peak = 0;
+    for (int16_t v : t.out) peak = abs(v) > peak ? abs(v) : peak;
+    printf("  输出峰值 %.2f dBFS，软削波样本 %u\n\n", 20 * log10(peak / 32768.0), t.soft);
+  }
+
+  // ---------- 突发 ----------
+  {
+    const size_t n = (size_t)kRate * 5;
+    std::vector<int16_t> in(n);
+    speechy(in, 0, n, -40);
+    const size_t burst = (size_t)kRate * 5 / 1000, period = (size_t)kRate / 2;
+    for (size_t p = kRate; p + burst < n; p += period) sine(in, p, p + burst, 0);
+    Trace t = run(in);
+    cycles += t.cycles;
+    samples += in.size();
+    int32_t peak = 0;
+    for (int16_t v : t.out) peak = abs(v) > peak ? abs(v) : peak;
+    // 最后一个脉冲之后增益回到脉冲前 ±1 dB 的时间
+    size_t last = kRate;
+    while (last + period + burst < n) last += period;
+    const size_t b_before = last / kBlock - 1, b_end = (last + burst) / kBlock;
+    const float before = t.gain_db[b_before];
+    size_t b = b_end;
+    while (b < t.gain_db.size() && fabsf(t.gain_db[b] - before) > 1.0f) b++;
+    float dip = before;
+    for (size_t i = b_before; i < b; i++) dip = t.gain_db[i] < dip ? t.gain_db[i] : dip;
+    printf("突发（-40 dBFS 类语音 + 0 dBFS 5 ms 脉冲）\n");
+    printf("  输出峰值 %.2f dBFS（限幅 %.1f），软削波样本 %u\n", 20 * log10(peak / 32768.0),
+           AGC_LIMIT_DB, t.soft);
+    printf("  脉冲前增益 %.1f dB，最低 %.1f dB，脉冲结束后 %.1f ms 恢复到 ±1 dB\n\n", before, dip,
+           (b - b_end) * kBlock * 1000.0 / kRate);
+  }
+
+  // ---------- 只有噪声 ----------
+  {
+    const size_t n = (size_t)kRate * 5;
+    std::vector<int16_t> in(n);
+    const double amp = 32768.0 * pow(10, -65 / 20.0);
+    for (size_t i = 0; i < n; i++) in[i] = (int16_t)lrint(amp * gauss());
+    Trace t = run(in);
+    cycles += t.cycles;
+    samples += in.size();
+    printf("只有噪声（-65 dBFS 白噪声）\n");
+    printf("  增益 %.1f dB，输出 %.1f dBFS（噪底上限 %.0f dBFS）\n\n", t.gain_db.back(),
+           rms_db(t.out, n - kRate, n), AGC_NOISE_CEILING_DB);
+  }
+
+  printf("%.1f cycles/样本（周期按 %d MHz 计）\n", (double)cycles / samples, CYCLE_CLOCK_HOST_MHZ);
+  return 0;
+}
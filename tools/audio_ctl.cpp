@@ -0,0 +1,702 @@
+// =================================================
+// 命令行控制工具：和固件的命令通道对话（include/control.h，帧格式见 lib/audio_proto/command_record.h）
+//
+//   ./audio_ctl /dev/ttyUSB0 ping [次数]                 # 往返时间，音频照常在发
+//   ./audio_ctl /dev/ttyUSB0 get                         # 全部参数
+//   ./audio_ctl /dev/ttyUSB0 get gain agc_target
+//   ./audio_ctl /dev/ttyUSB0 set filter=bandpass lo=300 hi=3400 gain=2   # 一条命令，一起生效
+//   ./audio_ctl /dev/ttyUSB0 stream off                  # on / off
+//   ./audio_ctl /dev/ttyUSB0 stats
+//   ./audio_ctl /dev/ttyUSB0 calibrate                   # 等遥测帧带回实测回环延迟
+//   ./audio_ctl /dev/ttyUSB0 capture                     # 手动触发一次事件捕获
+//   ./audio_ctl --standin ping 200                       # pty 板子替身代替真串口（CI 用）
+//   ./audio_ctl --standin --no-priority ping 200         # 替身按改之前的做法写串口，对比应答延迟
+//   ./audio_ctl --standin --busy ping 200                # 替身同时在发事件捕获，串口满载
+//   ./audio_ctl --standin --link usb --busy ping 200     # 替身换成 USB 全速 CDC（pio run -e esp32-s3-usb）
+//
+// 选项：-b 波特率（默认 1500000），-t 每条命令的超时 ms（默认 500）
+//       --busy 替身一启动就发一次事件捕获（和音频加起来超过串口带宽，发送环一直是满的）
+//       --link 替身的链路模型：uart（默认，按 -b）或 usb（全速 CDC，约 1 MB/s）；真板子走 USB 时串口填 /dev/ttyACM0
+// 应答按帧头 seq 配对；同一串口上的音频 / 遥测帧照常解码、跳过（遥测里的回环延迟给 calibrate 用）
+// 参数名：gain ceiling filter(none|bandpass|lowpass|highpass) lo hi agc_target agc_max_gain stream
+//         只读 sample_rate uplink_rate block
+// 返回值：0 成功，1 板子回了错误或超时，2 用法错误
+// =================================================
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "capture_record.h"
+#include "command_record.h"
+#include "frame_decoder.h"
+#include "link_sim.h"
+#include "runtime_chain.h"
+#include "serial_port.h"
+#include "telemetry_record.h"
+
+static uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void sleep_until(uint64_t t) {
+  struct timespec ts = {(time_t)(t / 1000000000ull), (long)(t % 1000000000ull)};
+  while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+  }
+}
+
+static bool write_all(int fd, const uint8_t* p, size_t len) {
+  while (len > 0) {
+    const ssize_t w = write(fd, p, len);
+    if (w < 0 && errno == EINTR) continue;
+    if (w <= 0) return false;
+    p += w;
+    len -= (size_t)w;
+  }
+  return true;
+}
+
+static const char* const kFilterNames[] = {"none", "bandpass", "lowpass", "highpass"};
+
+// =================================================
+// 板子替身：pty 主端扮演固件
+//   - 按 UPLINK_FRAMED 的节奏发 48 kHz PCM16 音频帧（256 样本，约 5.3 ms 一帧）和每秒一条遥测
+//   - 收命令帧，参数检查用固件同一套 dsp_params_*，应答和固件一样
+//   - 链路用 lib/link/link_sim.h 按 UART（-b 波特率）或 USB 全速 CDC 建模，每毫秒把上线的字节放进 pty；
+//     写法和固件相同：大块数据 link_write_bulk 等水位，应答直接写，命令每 CONTROL_POLL_MS 从链路读一次；
+//     --no-priority 时大块数据也直接写（改之前的做法）
+//   - CMD_CAPTURE 按固件的读出限速（实时的 150%）发 7 s 的 FRAME_TYPE_CAPTURE 帧，和音频一起把 UART 占满
+// =================================================
+class Standin {
+ public:
+  static const int kRate  = 48000;
+  static const int kFrame = 256;
+
+  bool start(const SimLinkModel& model, bool priority, bool busy) {
+    link_.reset(new SimLink(model));
+    priority_ = priority;
+    capture_  = busy;
+    master_   = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master_ < 0 || grantpt(master_) != 0 || unlockpt(master_) != 0) return false;
+    path_ = ptsname(master_);
+    fcntl(master_, F_SETFL, fcntl(master_, F_GETFL) | O_NONBLOCK);   // 没人读时 stop() 不会卡在 write 里
+    // 从端先配成 raw 并一直开着：否则回显会把发出去的帧又送回主端，最后一个从端关掉时主端读到 EIO
+    slave_ = open(path_.c_str(), O_RDWR | O_NOCTTY);
+    if (slave_ < 0 || !serial_configure(slave_, 1500000)) return false;
+    t0_ = now_ns();
+    threads_.emplace_back(&Standin::wire_thread, this);
+    threads_.emplace_back(&Standin::audio_thread, this);
+    threads_.emplace_back(&Standin::telemetry_thread, this);
+    threads_.emplace_back(&Standin::control_thread, this);
+    threads_.emplace_back(&Standin::capture_thread, this);
+    return true;
+  }
+
+  void stop() {
+    running_ = false;
+    link_->close();
+    for (std::thread& t : threads_) t.join();
+    close(slave_);
+    close(master_);
+  }
+
+  const char* path() const { return path_.c_str(); }
+
+ private:
+  void bulk_write(const uint8_t* p, size_t len) {
+    if (!priority_) {
+      link_->write(p, len);
+    } else if (link_write_bulk(*link_, p, len, [] { sleep_until(now_ns() + 1000000); })) {
+      bulk_waits_++;   // 上面是 vTaskDelay(1)
+    }
+  }
+
+  // ---------- 线路：每毫秒把上线的字节放进 pty，主机写来的字节交给链路接收 ----------
+  void wire_thread() {
+    uint8_t buf[4096];
+    for (uint64_t t = now_ns(); running_;) {
+      t += 1000000;
+      sleep_until(t);
+      ssize_t r;
+      while ((r = read(master_, buf, sizeof(buf))) > 0) link_->feed(buf, (size_t)r);
+      const size_t n = link_->tick(buf, sizeof(buf));
+      for (size_t off = 0; off < n && running_;) {
+        const ssize_t w = write(master_, buf + off, n - off);
+        if (w > 0) off += (size_t)w;
+        else if (w < 0 && errno != EAGAIN && errno != EINTR) return;
+        else sleep_until(now_ns() + 1000000);
+      }
+    }
+  }
+
+  // ---------- 固件的上行 / 遥测任务 ----------
+  void audio_thread() {
+    int16_t pcm[kFrame];
+    uint8_t frame[FRAME_MAX_SIZE];
+    uint16_t seq = 0;
+    for (uint64_t n = 0; running_; n += kFrame) {
+      sleep_until(t0_ + (n + kFrame) * 1000000000ull / kRate);
+      for (int i = 0; i < kFrame; i++)
+        pcm[i] = (int16_t)lrint(8000 * sin(2 * 3.14159265358979 * 440 * (double)(n + i) / kRate));
+      FrameHeader h = {};
+      h.type      = FRAME_TYPE_AUDIO;
+      h.format    = SAMPLE_FMT_PCM16;
+      h.seq       = seq++;
+      h.length    = kFrame * sizeof(int16_t);
+      h.timestamp = (uint32_t)((t0_ + n * 1000000000ull / kRate) / 1000);
+      h.samples   = kFrame;
+      h.channels  = 1;
+      const size_t len = frame_encode(frame, sizeof(frame), h, (const uint8_t*)pcm);
+      if (streaming_) {
+        bulk_write(frame, len);
+        audio_frames_++;
+      }
+    }
+  }
+
+  // CAPTURE_PRE_MS + CAPTURE_POST_MS，每帧 CAPTURE_CHUNK_SAMPLES，CAPTURE_DRAIN_PERCENT
+  void capture_thread() {
+    static const int kChunk = 512;
+    static const uint32_t kTotal = 44100 * 7;
+    int16_t pcm[kChunk] = {};
+    uint8_t payload[CAPTURE_HEADER_SIZE + sizeof(pcm)];
+    uint8_t frame[FRAME_HEADER_SIZE + sizeof(payload) + FRAME_TRAILER_SIZE];
+    uint16_t seq = 0, job = 0;
+    while (running_) {
+      if (!capture_) {
+        sleep_until(now_ns() + 10000000);
+        continue;
+      }
+      const uint64_t t0 = now_ns();
+      for (uint32_t off = 0; off < kTotal && running_; off += kChunk) {
+        sleep_until(t0 + (uint64_t)off * 1000000000ull * 100 / 150 / 44100);
+        const CaptureRecord r = {CAPTURE_REASON_MANUAL, job, 44100, off, 44100 * 5,
+                                 (uint8_t)((off == 0 ? CAPTURE_FLAG_FIRST : 0) |
+                                           (off + kChunk >= kTotal ? CAPTURE_FLAG_LAST : 0))};
+        const size_t plen = capture_encode(r, payload, sizeof(payload));
+        memcpy(payload + plen, pcm, sizeof(pcm));
+        FrameHeader h = {};
+        h.type      = FRAME_TYPE_CAPTURE;
+        h.format    = SAMPLE_FMT_PCM16;
+        h.seq       = seq++;
+        h.timestamp = (uint32_t)(now_ns() / 1000);
+        h.samples   = kChunk;
+        h.channels  = 1;
+        h.length    = plen + sizeof(pcm);
+        bulk_write(frame, frame_encode(frame, sizeof(frame), h, payload));
+      }
+      job++;
+      capture_ = false;
+    }
+  }
+
+  void telemetry_thread() {
+    uint8_t payload[TELEMETRY_RECORD_SIZE];
+    uint8_t frame[FRAME_HEADER_SIZE + TELEMETRY_RECORD_SIZE + FRAME_TRAILER_SIZE];
+    uint16_t seq = 0;
+    for (uint64_t t = t0_; running_; ) {
+      t += 1000000000ull;
+      while (running_ && now_ns() < t) sleep_until(std::min(t, now_ns() + 50000000));
+      // 回环测量“做完”了就带上结果（真板子上是 loop() 取走结果再交给遥测任务）
+      if (cal_done_ns_ && now_ns() >= cal_done_ns_) {
+        loop_latency_us_ = 5200 + (int32_t)(now_ns() / 1000 % 200);
+        cal_done_ns_ = 0;
+      }
+      TelemetryRecord r = {};
+      r.uptime_ms       = (uint32_t)((now_ns() - t0_) / 1000000);
+      r.loop_latency_us = loop_latency_us_;
+      FrameHeader h = {};
+      h.type      = FRAME_TYPE_TELEMETRY;
+      h.seq       = seq++;
+      h.timestamp = (uint32_t)(now_ns() / 1000);
+      h.length    = telemetry_encode(r, payload, sizeof(payload));
+      bulk_write(frame, frame_encode(frame, sizeof(frame), h, payload));
+    }
+  }
+
+  // ---------- 固件的命令任务 ----------
+  void control_thread() {
+    FrameDecoder dec(&Standin::on_frame, this);
+    uint8_t buf[256];
+    for (uint64_t t = now_ns(); running_;) {
+      t += 2000000;   // CONTROL_POLL_MS
+      sleep_until(t);
+      size_t n;
+      while ((n = link_->read(buf, sizeof(buf))) > 0) dec.push(buf, n);
+    }
+  }
+
+  static void on_frame(const FrameHeader& h, const uint8_t* payload, void* ctx) {
+    if (h.type == FRAME_TYPE_COMMAND) ((Standin*)ctx)->handle(h, payload);
+  }
+
+  uint8_t get_param(uint16_t id, float* v) const {
+    switch (id) {
+      case PARAM_GAIN:          *v = gain_; break;
+      case PARAM_CEILING_DB:    *v = ceiling_db_; break;
+      case PARAM_FILTER:        *v = (float)filter_; break;
+      case PARAM_FILTER_LO:     *v = lo_; break;
+      case PARAM_FILTER_HI:     *v = hi_; break;
+      case PARAM_AGC_TARGET_DB: *v = agc_target_; break;
+      case PARAM_AGC_MAX_DB:    *v = agc_max_; break;
+      case PARAM_STREAM:        *v = streaming_ ? 1.0f : 0.0f; break;
+      case PARAM_SAMPLE_RATE:   *v = 44100; break;
+      case PARAM_UPLINK_RATE:   *v = kRate; break;
+      case PARAM_BLOCK:         *v = 8; break;
+      default:                  return CMD_ERR_UNKNOWN;
+    }
+    return CMD_OK;
+  }
+
+  // 和固件 set_params 一样：先全部检查，再一起生效
+  uint8_t set_params(const CommandRecord& cmd) {
+    float gain = gain_, ceiling = ceiling_db_, lo = lo_, hi = hi_, target = agc_target_, max = agc_max_;
+    int filter = filter_, stream = -1;
+    for (int i = 0; i < cmd.count; i++) {
+      const float v = cmd.item[i].value;
+      if (!command_param_name(cmd.item[i].id)) return CMD_ERR_UNKNOWN;
+      if (!command_param_writable(cmd.item[i].id)) return CMD_ERR_ARGS;
+      switch (cmd.item[i].id) {
+        case PARAM_GAIN:          gain = v; break;
+        case PARAM_CEILING_DB:    ceiling = v; break;
+        case PARAM_FILTER:        filter = (int)v; if (v != filter) return CMD_ERR_ARGS; break;
+        case PARAM_FILTER_LO:     lo = v; break;
+        case PARAM_FILTER_HI:     hi = v; break;
+        case PARAM_AGC_TARGET_DB: target = v; break;
+        case PARAM_AGC_MAX_DB:    max = v; break;
+        case PARAM_STREAM:        stream = v != 0; break;
+      }
+    }
+    DspParams p = {};
+    if (!dsp_params_set_gain(&p, gain) || !(ceiling > -96.0f) ||
+        !dsp_params_set_butter(&p, 44100, filter, lo, hi) ||
+        !(target < 0 && target > -60) || !(max >= 0 && max <= 24))
+      return CMD_ERR_ARGS;
+    gain_ = gain;
+    ceiling_db_ = ceiling >= 0 ? 0 : ceiling;
+    filter_ = filter;
+    lo_ = lo;
+    hi_ = hi;
+    agc_target_ = target;
+    agc_max_ = max;
+    if (stream >= 0) streaming_ = stream;
+    return CMD_OK;
+  }
+
+  void handle(const FrameHeader& h, const uint8_t* payload) {
+    cmd_frames_++;
+    CommandRecord cmd, resp = {};
+    DeviceStatsRecord ds = {};
+    bool with_stats = false;
+    if (!command_decode(payload, h.length, &cmd)) {
+      resp.status = CMD_ERR_ARGS;
+    } else {
+      resp.op = cmd.op;
+      switch (cmd.op) {
+        case CMD_PING:
+          break;
+        case CMD_GET:
+        case CMD_SET:
+          if (cmd.op == CMD_SET) {
+            resp.status = set_params(cmd);
+          } else if (cmd.count == 0) {
+            for (uint16_t id = PARAM_GAIN; id <= PARAM_BLOCK; id++) {
+              resp.item[resp.count].id = id;
+              get_param(id, &resp.item[resp.count++].value);
+            }
+            break;
+          }
+          for (int i = 0; i < cmd.count && resp.status == CMD_OK; i++) {
+            resp.item[i].id = cmd.item[i].id;
+            resp.status = get_param(cmd.item[i].id, &resp.item[i].value);
+          }
+          resp.count = resp.status == CMD_OK ? cmd.count : 0;
+          break;
+        case CMD_STREAM_START:
+        case CMD_STREAM_STOP:
+          streaming_ = cmd.op == CMD_STREAM_START;
+          break;
+        case CMD_STATS: {
+          const uint32_t blocks = (uint32_t)((now_ns() - t0_) / 1000 * 44100 / 8 / 1000000);
+          ds.flags          = streaming_ ? DEVICE_STATS_STREAMING : 0;
+          ds.uptime_ms      = (uint32_t)((now_ns() - t0_) / 1000000);
+          ds.rx_blocks      = ds.dsp_blocks = ds.tx_blocks = blocks;
+          ds.uplink_frames  = audio_frames_;
+          ds.agc_gain_cdb   = 600;
+          ds.agc_level_cdb  = -2400;
+          ds.bulk_waits     = bulk_waits_;
+          with_stats = true;
+          break;
+        }
+        case CMD_CALIBRATE:
+          if (cal_done_ns_) resp.status = CMD_ERR_BUSY;
+          else cal_done_ns_ = now_ns() + 250000000ull;   // 扫频 + 录音 + 互相关
+          break;
+        case CMD_CAPTURE:
+          if (capture_) resp.status = CMD_ERR_BUSY;
+          else capture_ = true;
+          break;
+        default:
+          resp.status = CMD_ERR_UNKNOWN;
+          break;
+      }
+    }
+    if (resp.status != CMD_OK) cmd_errors_++;
+    ds.cmd_frames = cmd_frames_;
+    ds.cmd_errors = cmd_errors_;
+
+    uint8_t body[COMMAND_RECORD_MAX_SIZE + DEVICE_STATS_SIZE];
+    uint8_t frame[FRAME_HEADER_SIZE + sizeof(body) + FRAME_TRAILER_SIZE];
+    size_t len = command_encode(resp, body, sizeof(body));
+    if (with_stats) len += device_stats_encode(ds, body + len, sizeof(body) - len);
+    FrameHeader rh = {};
+    rh.type      = FRAME_TYPE_RESPONSE;
+    rh.seq       = h.seq;
+    rh.timestamp = (uint32_t)(now_ns() / 1000);
+    rh.length    = len;
+    link_->write(frame, frame_encode(frame, sizeof(frame), rh, body));
+  }
+
+  std::unique_ptr<SimLink> link_;
+  bool priority_ = true;
+  int master_ = -1, slave_ = -1;
+  std::string path_;
+  uint64_t t0_ = 0;
+  std::vector<std::thread> threads_;
+  std::atomic<bool> running_{true};
+
+  // 命令任务写，其他线程读
+  std::atomic<bool> streaming_{true};
+  std::atomic<bool> capture_{false};
+  std::atomic<uint64_t> cal_done_ns_{0};
+  std::atomic<int32_t> loop_latency_us_{-1};
+  std::atomic<uint32_t> audio_frames_{0}, bulk_waits_{0};
+  uint32_t cmd_frames_ = 0, cmd_errors_ = 0;
+  float gain_ = 1, ceiling_db_ = 0, lo_ = 100, hi_ = 3000, agc_target_ = -18, agc_max_ = 24;
+  int filter_ = 0;
+};
+
+// =================================================
+// 主机一侧：发命令帧，边收边解码，等 seq 对得上的应答
+// =================================================
+struct Session {
+  int fd = -1;
+  uint16_t seq = 1;
+  int timeout_ms = 500;
+
+  // 回调写
+  uint16_t want = 0;
+  bool got = false;
+  uint64_t got_ns = 0;
+  CommandRecord resp = {};
+  DeviceStatsRecord stats = {};
+  bool has_stats = false;
+  uint32_t audio_frames = 0, telemetry_frames = 0, capture_frames = 0;
+  int32_t loop_latency_us = -1;
+};
+
+static void on_frame(const FrameHeader& h, const uint8_t* payload, void* ctx) {
+  Session* l = (Session*)ctx;
+  switch (h.type) {
+    case FRAME_TYPE_AUDIO:
+      l->audio_frames++;
+      break;
+    case FRAME_TYPE_CAPTURE:
+      l->capture_frames++;
+      break;
+    case FRAME_TYPE_TELEMETRY: {
+      TelemetryRecord r;
+      if (telemetry_decode(payload, h.length, &r)) {
+        l->telemetry_frames++;
+        l->loop_latency_us = r.loop_latency_us;
+      }
+      break;
+    }
+    case FRAME_TYPE_RESPONSE:
+      if (h.seq != l->want || l->got) break;   // 之前超时的那条迟到了
+      if (command_decode(payload, h.length, &l->resp, &l->stats, &l->has_stats)) {
+        l->got    = true;
+        l->got_ns = now_ns();
+      }
+      break;
+  }
+}
+
+// 收到 until 为真或到 deadline；返回 until 的结果
+template <typename Pred>
+static bool pump(Session& l, FrameDecoder& dec, uint64_t deadline, Pred until) {
+  uint8_t buf[4096];
+  while (!until()) {
+    const uint64_t now = now_ns();
+    if (now >= deadline) return false;
+    struct pollfd p = {l.fd, POLLIN, 0};
+    const int r = poll(&p, 1, (int)((deadline - now + 999999) / 1000000));
+    if (r < 0 && errno != EINTR) return false;
+    if (r <= 0) continue;
+    const ssize_t n = read(l.fd, buf, sizeof(buf));
+    if (n < 0 && errno != EINTR && errno != EAGAIN) return false;
+    if (n > 0) dec.push(buf, (size_t)n);
+  }
+  return true;
+}
+
+// 发一条命令等应答；rtt_ms 是写出到应答解出的时间
+static bool transact(Session& l, FrameDecoder& dec, const CommandRecord& cmd, double* rtt_ms = nullptr) {
+  uint8_t body[COMMAND_RECORD_MAX_SIZE];
+  uint8_t frame[FRAME_HEADER_SIZE + sizeof(body) + FRAME_TRAILER_SIZE];
+  FrameHeader h = {};
+  h.type      = FRAME_TYPE_COMMAND;
+  h.seq       = l.seq++;
+  h.timestamp = (uint32_t)(now_ns() / 1000);
+  h.length    = command_encode(cmd, body, sizeof(body));
+  const size_t len = frame_encode(frame, sizeof(frame), h, body);
+
+  l.want = h.seq;
+  l.got  = false;
+  const uint64_t t0 = now_ns();
+  if (!write_all(l.fd, frame, len)) {
+    fprintf(stderr, "写串口失败: %s\n", strerror(errno));
+    return false;
+  }
+  if (!pump(l, dec, t0 + (uint64_t)l.timeout_ms * 1000000, [&] { return l.got; })) {
+    fprintf(stderr, "%s：%d ms 内没有应答\n", command_op_name(cmd.op), l.timeout_ms);
+    return false;
+  }
+  if (rtt_ms) *rtt_ms = (l.got_ns - t0) / 1e6;
+  if (l.resp.status != CMD_OK) {
+    fprintf(stderr, "%s：板子回 %s\n", command_op_name(cmd.op), command_status_name(l.resp.status));
+    return false;
+  }
+  return true;
+}
+
+static void print_items(const CommandRecord& r) {
+  for (int i = 0; i < r.count; i++) {
+    const CommandItem& it = r.item[i];
+    const char* name = command_param_name(it.id);
+    if (name) printf("%-13s ", name);
+    else printf("#%-12u ", it.id);
+    if (it.id == PARAM_FILTER && it.value >= 0 && it.value < 4) printf("%s\n", kFilterNames[(int)it.value]);
+    else printf("%g\n", it.value);
+  }
+}
+
+// name=value；filter 认类型名，stream 认 on/off
+static bool parse_item(const char* arg, CommandItem* it) {
+  char name[32];
+  const char* eq = strchr(arg, '=');
+  if (!eq || eq - arg >= (int)sizeof(name)) return false;
+  memcpy(name, arg, eq - arg);
+  name[eq - arg] = 0;
+  const char* val = eq + 1;
+  it->id = command_param_id(name);
+  if (it->id == 0) return false;
+  for (int k = 0; k < 4; k++)
+    if (it->id == PARAM_FILTER && strcmp(val, kFilterNames[k]) == 0) {
+      it->value = (float)k;
+      return true;
+    }
+  if (strcmp(val, "on") == 0 || strcmp(val, "off") == 0) {
+    it->value = strcmp(val, "on") == 0;
+    return true;
+  }
+  char* end;
+  it->value = strtof(val, &end);
+  return *val && *end == 0;
+}
+
+static void usage(const char* argv0) {
+  fprintf(stderr,
+          "用法: %s <串口|--standin [--link uart|usb] [--no-priority] [--busy]> [-b 波特率] [-t 超时ms] 命令 [参数...]\n"
+          "  ping [次数] | get [名字...] | set 名字=值... | stream on|off | stats | calibrate | capture\n",
+          argv0);
+}
+
+int main(int argc, char** argv) {
+  const char* port = nullptr;
+  bool standin = false, priority = true, busy = false;
+  const char* transport = "uart";
+  int baud = 1500000, timeout_ms = 500;
+  int i = 1;
+  for (; i < argc && argv[i][0] == '-'; i++) {
+    if (strcmp(argv[i], "--standin") == 0) standin = true;
+    else if (strcmp(argv[i], "--no-priority") == 0) priority = false;
+    else if (strcmp(argv[i], "--busy") == 0) busy = true;
+    else if (strcmp(argv[i], "--link") == 0 && i + 1 < argc) transport = argv[++i];
+    else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) baud = atoi(argv[++i]);
+    else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) timeout_ms = atoi(argv[++i]);
+    else break;
+  }
+  if (!standin) {
+    if (i >= argc) {
+      usage(argv[0]);
+      return 2;
+    }
+    port = argv[i++];
+    for (; i < argc && argv[i][0] == '-' && argv[i][1] != 0; i++) {
+      if (strcmp(argv[i], "-b") == 0 && i + 1 < argc) baud = atoi(argv[++i]);
+      else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) timeout_ms = atoi(argv[++i]);
+      else break;
+    }
+  }
+  if (i >= argc) {
+    usage(argv[0]);
+    return 2;
+  }
+  const char* verb = argv[i++];
+  char** args = argv + i;
+  const int nargs = argc - i;
+
+  static Standin device;
+  if (standin) {
+    SimLinkModel model = kSimLinkUart;
+    if (strcmp(transport, "usb") == 0) {
+      model = kSimLinkUsbFs;
+    } else if (strcmp(transport, "uart") == 0) {
+      model.bytes_per_ms = (size_t)baud / 10 / 1000;   // 8N1
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+    if (!device.start(model, priority, busy)) {
+      fprintf(stderr, "创建 pty 替身失败: %s\n", strerror(errno));
+      return 1;
+    }
+    port = device.path();
+  }
+
+  Session link;
+  link.timeout_ms = timeout_ms;
+  link.fd = open(port, O_RDWR | O_NOCTTY);
+  if (link.fd < 0) {
+    fprintf(stderr, "打开 %s 失败: %s\n", port, strerror(errno));
+    return 1;
+  }
+  if (isatty(link.fd) && !serial_configure(link.fd, baud)) {
+    fprintf(stderr, "配置串口失败: %s\n", strerror(errno));
+    return 1;
+  }
+  static FrameDecoder dec(on_frame, &link);
+
+  CommandRecord cmd = {};
+  int rc = 0;
+  if (strcmp(verb, "ping") == 0) {
+    const int n = nargs > 0 ? atoi(args[0]) : 1;
+    if (n <= 0) {
+      usage(argv[0]);
+      return 2;
+    }
+    // 先跑半秒，让发送积压进入稳态
+    if (standin) pump(link, dec, now_ns() + 500000000ull, [] { return false; });
+    cmd.op = CMD_PING;
+    std::vector<double> rtt;
+    const uint32_t audio0 = link.audio_frames, capture0 = link.capture_frames;
+    const uint64_t t0 = now_ns();
+    uint32_t rnd = 1;
+    for (int k = 0; k < n; k++) {
+      double ms;
+      if (!transact(link, dec, cmd, &ms)) {
+        rc = 1;
+        break;
+      }
+      rtt.push_back(ms);
+      // 间隔随机 0~10 ms，和音频帧的相位错开
+      rnd = rnd * 1664525u + 1013904223u;
+      const uint64_t gap = (rnd >> 8) % 10000000;
+      pump(link, dec, now_ns() + gap, [] { return false; });
+    }
+    if (!rtt.empty()) {
+      std::vector<double> s = rtt;
+      std::sort(s.begin(), s.end());
+      double sum = 0;
+      for (double v : s) sum += v;
+      printf("ping %zu 次：往返 min/p50/p99/max = %.2f/%.2f/%.2f/%.2f ms，平均 %.2f ms\n", s.size(), s[0],
+             s[s.size() / 2], s[std::min(s.size() - 1, s.size() * 99 / 100)], s.back(), sum / s.size());
+      const double secs = (now_ns() - t0) / 1e9;
+      printf("同时收到音频帧 %u（%.1f 帧/s）、捕获帧 %u\n", link.audio_frames - audio0,
+             (link.audio_frames - audio0) / secs, link.capture_frames - capture0);
+    }
+  } else if (strcmp(verb, "get") == 0 || strcmp(verb, "set") == 0) {
+    cmd.op = verb[0] == 'g' ? CMD_GET : CMD_SET;
+    if (nargs > COMMAND_MAX_ITEMS || (cmd.op == CMD_SET && nargs == 0)) {
+      usage(argv[0]);
+      return 2;
+    }
+    for (int k = 0; k < nargs; k++) {
+      CommandItem& it = cmd.item[cmd.count++];
+      if (cmd.op == CMD_SET ? !parse_item(args[k], &it) : (it.id = command_param_id(args[k])) == 0) {
+        fprintf(stderr, "不认识的参数：%s\n", args[k]);
+        return 2;
+      }
+    }
+    if (transact(link, dec, cmd)) print_items(link.resp);
+    else rc = 1;
+  } else if (strcmp(verb, "stream") == 0) {
+    if (nargs != 1 || (strcmp(args[0], "on") != 0 && strcmp(args[0], "off") != 0)) {
+      usage(argv[0]);
+      return 2;
+    }
+    cmd.op = strcmp(args[0], "on") == 0 ? CMD_STREAM_START : CMD_STREAM_STOP;
+    rc = transact(link, dec, cmd) ? 0 : 1;
+  } else if (strcmp(verb, "stats") == 0) {
+    cmd.op = CMD_STATS;
+    if (!transact(link, dec, cmd) || !link.has_stats) {
+      rc = 1;
+    } else {
+      const DeviceStatsRecord& s = link.stats;
+      printf("运行 %.1f s，音频上行%s\n", s.uptime_ms / 1000.0, s.flags & DEVICE_STATS_STREAMING ? "开" : "关");
+      printf("RX=%u drop=%u | DSP=%u drop=%u | TX=%u\n", s.rx_blocks, s.rx_dropped, s.dsp_blocks,
+             s.dsp_dropped, s.tx_blocks);
+      printf("上行帧=%u drop=%u | 让路=%u\n", s.uplink_frames, s.uplink_dropped, s.bulk_waits);
+      printf("爆音保护=%u 啸叫陷波=%u | AGC 增益=%.2f dB 电平=%.2f dBFS\n", s.pop_events, s.howl_notches,
+             s.agc_gain_cdb / 100.0, s.agc_level_cdb / 100.0);
+      printf("命令=%u 出错=%u\n", s.cmd_frames, s.cmd_errors);
+    }
+  } else if (strcmp(verb, "calibrate") == 0) {
+    cmd.op = CMD_CALIBRATE;
+    // 先等一条遥测，记下旧值
+    pump(link, dec, now_ns() + 1500000000ull, [&] { return link.telemetry_frames > 0; });
+    const int32_t before = link.loop_latency_us;
+    if (!transact(link, dec, cmd)) {
+      rc = 1;
+    } else {
+      // 板子 loop() 每秒取一次结果，下一条遥测带出来
+      const bool changed = pump(link, dec, now_ns() + 3500000000ull,
+                                [&] { return link.loop_latency_us >= 0 && link.loop_latency_us != before; });
+      if (changed) {
+        printf("回环延迟 %.2f ms\n", link.loop_latency_us / 1000.0);
+      } else {
+        fprintf(stderr, "遥测里的回环延迟没有更新（测量失败或没收到遥测，看板子日志）\n");
+        rc = 1;
+      }
+    }
+  } else if (strcmp(verb, "capture") == 0) {
+    cmd.op = CMD_CAPTURE;
+    rc = transact(link, dec, cmd) ? 0 : 1;
+  } else {
+    usage(argv[0]);
+    rc = 2;
+  }
+
+  const FrameDecoderStats ds = dec.stats();
+  if (ds.header_errors + ds.crc_errors)
+    fprintf(stderr, "（帧错误 %u）\n", ds.header_errors + ds.crc_errors);
+  close(link.fd);
+  if (standin) device.stop();
+  return rc;
+}
@@ -0,0 +1,202 @@
+// =================================================
+// biquad 级联主机测试（lib/audio_dsp/biquad.h + biquad_design.h）
+//
+//   ./biquad_bench [输出目录]
+//   python3 tools/biquad_check.py 输出目录      # 和 scipy.signal.lfilter 比对（需要 numpy / scipy）
+//
+// 三组 4 阶 Butterworth（audio_filter.py 的配置，44.1 kHz）：低通 3000、高通 100、带通 100~3000
+// 设计：各段级联的 |H| 和双线性变换 Butterworth 的解析幅频逐点比对（20 Hz ~ 20 kHz，对数 200 点）
+// 实现：2 s 输入（对数扫频 -12 dBFS + 白噪声 -20 dBFS），8 样本一块送进 BiquadCascadeF32 / Q28，
+//       和 double 精度的逐段 DF2T（scipy lfilter 的同一递推）比，打印最大 / RMS 误差（LSB）
+// 给了输出目录就把输入、两种输出、系数写进去，由 biquad_check.py 拿 scipy 的设计和 lfilter 再核一遍：
+//   cases.txt           每行：名字 类型 fs f1 f2
+//   <名字>_in.s16       输入，int16 小端
+//   <名字>_f32.s16      BiquadCascadeF32 输出
+//   <名字>_q28.s16      BiquadCascadeQ28 输出
+//   <名字>_sos.txt      系数，每段一行 b0 b1 b2 a1 a2
+// 返回值：0 全部通过，1 有断言失败
+// =================================================
+
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "biquad.h"
+
+static const double kPi = 3.14159265358979323846;
+static const int kRate  = 44100;
+static const int kBlock = 8;
+static const int kOrder = 4;
+
+// 误差上限（LSB）：F32 出口截断，留 1 LSB 内部舍入的余量；
+// Q28 出口四舍五入，但高通 100 Hz 的极点贴近单位圆，段间 8 位保护位的舍入被放大到 2~3 LSB
+static const double kMaxErrF32 = 2.0;
+static const double kMaxErrQ28 = 4.0;
+// 幅频和解析式的偏差上限（系数存成 float）
+static const double kMaxMagErr = 1e-3;
+
+static uint32_t g_seed = 1;
+static double uniform() {
+  g_seed = g_seed * 1664525u + 1013904223u;
+  return (g_seed >> 8) / 16777216.0;
+}
+static double gauss() {
+  const double u1 = uniform() + 1e-9, u2 = uniform();
+  return sqrt(-2 * log(u1)) * cos(2 * kPi * u2);
+}
+
+static std::vector<int16_t> make_input() {
+  const int n = 2 * kRate;
+  std::vector<int16_t> x(n);
+  const double f0 = 20, f1 = 20000, T = (double)n / kRate;
+  const double k = log(f1 / f0);
+  for (int i = 0; i < n; i++) {
+    const double t = (double)i / kRate;
+    const double sweep = sin(2 * kPi * f0 * T / k * (exp(t / T * k) - 1));
+    x[i] = (int16_t)lrint(32768 * (0.25 * sweep + 0.1 * gauss()));
+  }
+  return x;
+}
+
+// 双线性变换 Butterworth 的解析 |H|
+static double analytic_mag(char type, double f, double f1, double f2) {
+  const double w = tan(kPi * f / kRate);
+  double r = 0;
+  if (type == 'L') r = w / tan(kPi * f2 / kRate);
+  if (type == 'H') r = tan(kPi * f1 / kRate) / w;
+  if (type == 'B') {
+    const double wl = tan(kPi * f1 / kRate), wh = tan(kPi * f2 / kRate);
+    r = (w * w - wl * wh) / ((wh - wl) * w);
+  }
+  return 1 / sqrt(1 + pow(r * r, kOrder));
+}
+
+template <int N>
+static double cascade_mag(const Sos<N>& sos, double f) {
+  const double w = 2 * kPi * f / kRate;
+  double m = 1;
+  for (int k = 0; k < N; k++) {
+    const BiquadCoeffs& c = sos.s[k];
+    const double nr = c.b0 + c.b1 * cos(w) + c.b2 * cos(2 * w), ni = -c.b1 * sin(w) - c.b2 * sin(2 * w);
+    const double dr = 1 + c.a1 * cos(w) + c.a2 * cos(2 * w), di = -c.a1 * sin(w) - c.a2 * sin(2 * w);
+    m *= sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+  }
+  return m;
+}
+
+// double 逐段 DF2T，和 scipy.signal.lfilter(b, a, x) 每段的递推相同
+template <int N>
+static std::vector<double> reference(const Sos<N>& sos, const std::vector<int16_t>& x) {
+  std::vector<double> y(x.begin(), x.end());
+  for (int k = 0; k < N; k++) {
+    const BiquadCoeffs& c = sos.s[k];
+    double s1 = 0, s2 = 0;
+    for (double& v : y) {
+      const double in = v, out = c.b0 * in + s1;
+      s1 = c.b1 * in - c.a1 * out + s2;
+      s2 = c.b2 * in - c.a2 * out;
+      v = out;
+    }
+  }
+  return y;
+}
+
+static bool write_file(const std::string& path, const void* data, size_t bytes) {
+  FILE* f = fopen(path.c_str(), "wb");
+  if (!f) return false;
+  const bool ok = fwrite(data, 1, bytes, f) == bytes;
+  fclose(f);
+  return ok;
+}
+
+struct Err {
+  double max = 0, rms = 0;
+};
+
+static Err error_lsb(const std::vector<int16_t>& y, const std::vector<double>& ref) {
+  Err e;
+  for (size_t i = 0; i < y.size(); i++) {
+    const double r = fmax(-32768, fmin(32767, ref[i]));
+    const double d = fabs(y[i] - r);
+    e.max = fmax(e.max, d);
+    e.rms += d * d;
+  }
+  e.rms = sqrt(e.rms / y.size());
+  return e;
+}
+
+template <int N>
+static bool run_case(const char* name, char type, double f1, double f2, const Sos<N>& sos,
+                     const std::vector<int16_t>& x, const char* dir, FILE* cases) {
+  // 设计
+  double mag_err = 0;
+  for (int i = 0; i < 200; i++) {
+    const double f = 20 * pow(1000.0, i / 199.0);
+    mag_err = fmax(mag_err, fabs(cascade_mag(sos, f) - analytic_mag(type, f, f1, f2)));
+  }
+
+  // 实现：8 样本一块，和固件一样
+  const size_t n = x.size();
+  std::vector<int16_t> yf(n), yq(n);
+  BiquadCascadeF32<N> bf(sos);
+  BiquadCascadeQ28<N> bq(sos);
+  float fs[kBlock];
+  int32_t qs[kBlock];
+  for (size_t pos = 0; pos < n; pos += kBlock) {
+    bf.process(&x[pos], &yf[pos], fs, kBlock);
+    bq.process(&x[pos], &yq[pos], qs, kBlock);
+  }
+  const std::vector<double> ref = reference(sos, x);
+  const Err ef = error_lsb(yf, ref), eq = error_lsb(yq, ref);
+
+  const bool ok = mag_err <= kMaxMagErr && ef.max <= kMaxErrF32 && eq.max <= kMaxErrQ28;
+  printf("  %-18s |H| 偏差 %.1e   F32 最大 %.2f / RMS %.3f LSB   Q28 最大 %.2f / RMS %.3f LSB  %s\n", name,
+         mag_err, ef.max, ef.rms, eq.max, eq.rms, ok ? "通过" : "超限！");
+
+  if (dir) {
+    const std::string base = std::string(dir) + "/" + name;
+    bool w = write_file(base + "_in.s16", x.data(), n * 2) && write_file(base + "_f32.s16", yf.data(), n * 2) &&
+             write_file(base + "_q28.s16", yq.data(), n * 2);
+    FILE* f = fopen((base + "_sos.txt").c_str(), "w");
+    if (f) {
+      for (int k = 0; k < N; k++)
+        fprintf(f, "%.9g %.9g %.9g %.9g %.9g\n", sos.s[k].b0, sos.s[k].b1, sos.s[k].b2, sos.s[k].a1, sos.s[k].a2);
+      fclose(f);
+    }
+    fprintf(cases, "%s %c %d %g %g\n", name, type, kRate, f1, f2);
+    if (!w || !f) {
+      printf("  写 %s_* 失败\n", base.c_str());
+      return false;
+    }
+  }
+  return ok;
+}
+
+int main(int argc, char** argv) {
+  const char* dir = argc > 1 ? argv[1] : nullptr;
+  FILE* cases = nullptr;
+  if (dir) {
+    cases = fopen((std::string(dir) + "/cases.txt").c_str(), "w");
+    if (!cases) {
+      printf("打不开 %s/cases.txt\n", dir);
+      return 1;
+    }
+  }
+
+  const std::vector<int16_t> x = make_input();
+  static constexpr auto kLow  = butter_lowpass<kOrder>(kRate, 3000);
+  static constexpr auto kHigh = butter_highpass<kOrder>(kRate, 100);
+  static constexpr auto kBand = butter_bandpass<kOrder>(kRate, 100, 3000);
+
+  printf("4 阶 Butterworth，%d Hz，%zu 样本，%d 样本一块（误差相对 double 逐段 DF2T）：\n", kRate, x.size(), kBlock);
+  bool ok = true;
+  ok &= run_case("lowpass_3000", 'L', 0, 3000, kLow, x, dir, cases);
+  ok &= run_case("highpass_100", 'H', 100, 0, kHigh, x, dir, cases);
+  ok &= run_case("bandpass_100_3000", 'B', 100, 3000, kBand, x, dir, cases);
+  if (cases) {
+    fclose(cases);
+    printf("已写入 %s，用 tools/biquad_check.py 和 scipy 比对\n", dir);
+  }
+  return ok ? 0 : 1;
+}
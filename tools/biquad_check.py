@@ -0,0 +1,84 @@
+import argparse
+import os
+import sys
+
+import numpy as np
+from scipy import signal
+
+# biquad_bench 输出和 scipy 的比对
+#   ./tools/bin/biquad_bench /tmp/bq && python3 tools/biquad_check.py /tmp/bq
+# 每组滤波器：
+#   设计  scipy.signal.butter(4, ..., output='sos') 的幅频和 biquad_design.h 的系数逐点比（分段顺序可以不同）
+#   实现  scipy 的系数逐段 lfilter（float64）当金标准，写成 <名字>_lfilter.f64 放在同一目录，
+#         BiquadCascadeF32 / Q28 的输出和它比最大误差（LSB）
+# 不用 butter 的 b, a 整体 lfilter：带通 8 阶、低边 100 Hz，多项式形式在 double 下也已经病态
+# 任何一项超限返回 1
+#
+# 未实测：写这个脚本的机器上没有 numpy / scipy，只做过语法检查，MAX_ERR 是由 biquad_bench 的上限推出来的。
+# 第一次在有 scipy 的机器上跑完，把各组的 |H| 偏差和最大误差回填到这里
+
+ORDER = 4
+MAX_MAG_ERR = 1e-3
+# biquad_bench 的上限再加 1 LSB：这里的金标准用 double 系数，固件系数是 float
+MAX_ERR = {'f32': 3.0, 'q28': 5.0}
+BTYPE = {'L': 'lowpass', 'H': 'highpass', 'B': 'bandpass'}
+
+
+def load_s16(path):
+    return np.fromfile(path, dtype='<i2').astype(np.float64)
+
+
+def golden(sos, x):
+    """逐段 lfilter，和 DF2T 级联同一递推"""
+    y = x
+    for sec in sos:
+        y = signal.lfilter(sec[:3], sec[3:], y)
+    return y
+
+
+def check_case(d, name, btype, fs, f1, f2):
+    wn = {'L': f2, 'H': f1, 'B': [f1, f2]}[btype]
+    ref_sos = signal.butter(ORDER, wn, btype=BTYPE[btype], fs=fs, output='sos')
+
+    ours = np.loadtxt(os.path.join(d, name + '_sos.txt'), ndmin=2)
+    ours_sos = np.hstack([ours[:, :3], np.ones((len(ours), 1)), ours[:, 3:]])
+    freqs = np.geomspace(20, 20000, 200)
+    _, h_ref = signal.sosfreqz(ref_sos, worN=freqs, fs=fs)
+    _, h_ours = signal.sosfreqz(ours_sos, worN=freqs, fs=fs)
+    mag_err = np.max(np.abs(np.abs(h_ours) - np.abs(h_ref)))
+
+    x = load_s16(os.path.join(d, name + '_in.s16'))
+    y = np.clip(golden(ref_sos, x), -32768, 32767)
+    y.astype('<f8').tofile(os.path.join(d, name + '_lfilter.f64'))
+
+    ok = mag_err <= MAX_MAG_ERR
+    line = '  %-18s |H| 偏差 %.1e' % (name, mag_err)
+    for impl in ('f32', 'q28'):
+        out = load_s16(os.path.join(d, '%s_%s.s16' % (name, impl)))
+        if len(out) != len(y):
+            print('  %s_%s.s16 长度不对' % (name, impl))
+            return False
+        err = np.abs(out - y)
+        line += '   %s 最大 %.2f / RMS %.3f LSB' % (impl.upper(), err.max(), np.sqrt(np.mean(err ** 2)))
+        ok &= err.max() <= MAX_ERR[impl]
+    print(line + ('  通过' if ok else '  超限！'))
+    return ok
+
+
+def main():
+    parser = argparse.ArgumentParser(description='biquad_bench 输出和 scipy.signal.lfilter 比对')
+    parser.add_argument('dir', help='biquad_bench 的输出目录')
+    args = parser.parse_args()
+
+    ok = True
+    with open(os.path.join(args.dir, 'cases.txt')) as f:
+        for line in f:
+            if not line.strip():
+                continue
+            name, btype, fs, f1, f2 = line.split()
+            ok &= check_case(args.dir, name, btype, float(fs), float(f1), float(f2))
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == '__main__':
+    main()
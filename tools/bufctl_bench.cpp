@@ -0,0 +1,171 @@
+// =================================================
+// 自适应缓冲控制律主机测试（lib/audio_io/buffer_controller.h）
+//
+//   ./bufctl_bench
+//
+// 档位和阈值与 audio_config.h 的默认值相同（8/16/32/64/128 帧，升档 xrun ≥ 1 或负载 > 0.70，
+// 降档负载 < 0.30 且连续 30 个干净窗口，冷却 3 个窗口），按脚本逐窗口喂 update(xruns, dsp_p99_ns)：
+//   升档      xrun / 高负载立即升一档；冷却期内再多 xrun 也不动；顶档不再升
+//   迟滞      负载落在 0.30 ~ 0.70 之间时不升不降，并把干净计数清零
+//   降档      正好第 30 个干净窗口降一档；底档不再降
+//   退避      降档后紧接着升档：下次降档要 60、120 ... 最多 480 个干净窗口；
+//             连着两次降档都撑住后归位到 30
+//   force_level  拉回指定档位并进入冷却
+//   周期性卡顿  每 45 个窗口一次卡顿，0 / 1 档的环吸收不了（出 xrun），2 档起吸收得了；
+//               跑 3000 个窗口，要求停在 2 档，打印切换次数（没有退避时每 45 个窗口在 1、2 档之间来回切一次）
+// 返回值：0 全部通过，1 有断言失败
+// =================================================
+
+#include <stdio.h>
+
+#include "buffer_controller.h"
+
+static const float kRate = 44100;
+static const BufferLevel kLevels[] = {{8, 4}, {16, 4}, {32, 4}, {64, 6}, {128, 8}};
+static const int kCount = sizeof(kLevels) / sizeof(kLevels[0]);
+static const BufferControllerConfig kCfg = {1, 0.70f, 0.30f, 30, 3};
+
+static int g_failures = 0;
+
+#define CHECK(cond)                                                \
+  do {                                                             \
+    if (!(cond)) {                                                 \
+      printf("    失败：%s（第 %d 行）\n", #cond, __LINE__);       \
+      g_failures++;                                                \
+    }                                                              \
+  } while (0)
+
+// 当前档位下负载为 load 的 p99
+static uint32_t p99_for(const BufferController& c, float load) {
+  return (uint32_t)(load * c.current().block_frames * 1e9f / kRate);
+}
+
+// 连续 n 个窗口喂同样的数据，返回档位变化次数
+static int feed(BufferController& c, int n, uint32_t xruns, float load) {
+  int changes = 0;
+  for (int i = 0; i < n; i++) changes += c.update(xruns, p99_for(c, load));
+  return changes;
+}
+
+// 喂干净窗口直到降档，返回用了几个窗口（limit 内没降返回 -1）
+static int windows_to_shrink(BufferController& c, int limit) {
+  for (int i = 1; i <= limit; i++)
+    if (c.update(0, p99_for(c, 0.1f))) return i;
+  return -1;
+}
+
+static void test_grow() {
+  printf("升档：\n");
+  BufferController c(kLevels, kCount, kRate, kCfg);
+  CHECK(c.update(1, p99_for(c, 0.1f)) && c.level() == 1);
+  CHECK(feed(c, 3, 5, 0.9f) == 0 && c.level() == 1);   // 冷却
+  CHECK(c.update(0, p99_for(c, 0.75f)) && c.level() == 2);
+  CHECK(c.last_load() > 0.70f);
+  feed(c, 3, 0, 0.1f);
+  CHECK(c.update(1, 0) && c.level() == 3);
+  feed(c, 3, 0, 0.1f);
+  CHECK(c.update(1, 0) && c.level() == 4);
+  feed(c, 3, 0, 0.1f);
+  CHECK(feed(c, 50, 10, 0.95f) == 0 && c.level() == kCount - 1);   // 顶档
+  printf("  xrun / 负载立即升档、冷却 3 窗口、顶档不再升：%s\n", g_failures ? "有失败" : "通过");
+}
+
+static void test_hysteresis() {
+  printf("迟滞：\n");
+  const int before = g_failures;
+  BufferController c(kLevels, kCount, kRate, kCfg);
+  c.update(1, 0);
+  feed(c, 3, 0, 0.1f);
+  // 负载 0.5 落在迟滞带里：既不升也不降
+  const uint32_t p99 = p99_for(c, 0.5f);
+  int changes = 0;
+  for (int i = 0; i < 500; i++) changes += c.update(0, p99);
+  CHECK(changes == 0 && c.level() == 1);
+
+  // 29 个干净窗口 + 1 个迟滞带窗口：计数清零，再要 30 个
+  CHECK(feed(c, 29, 0, 0.1f) == 0);
+  CHECK(feed(c, 1, 0, 0.5f) == 0);
+  CHECK(windows_to_shrink(c, 100) == 30 && c.level() == 0);
+  // 底档
+  feed(c, 3, 0, 0.1f);
+  CHECK(feed(c, 200, 0, 0.1f) == 0 && c.level() == 0);
+  printf("  迟滞带内 500 窗口不动、干净计数被打断后重新计、底档不再降：%s\n",
+         g_failures == before ? "通过" : "有失败");
+}
+
+static void test_backoff() {
+  printf("退避：\n");
+  const int before = g_failures;
+  BufferController c(kLevels, kCount, kRate, kCfg);
+  c.update(1, 0);
+  feed(c, 3, 0, 0.1f);
+
+  // 在 0/1 档之间来回：每次降档后立刻 xrun
+  const int expect[] = {30, 60, 120, 240, 480, 480};
+  printf("  降档所需干净窗口：");
+  for (int want : expect) {
+    const int got = windows_to_shrink(c, 1000);
+    printf("%d ", got);
+    CHECK(got == want && c.level() == 0);
+    CHECK(feed(c, 3, 5, 0.1f) == 0);   // 降档后的冷却里 xrun 不算
+    CHECK(c.update(1, 0) && c.level() == 1);
+    feed(c, 3, 0, 0.1f);
+  }
+  printf("\n");
+
+  // 撑住的降档：升到 3 档，3→2 还要 480（退避值），这次撑住了；
+  // 2→1 是连着的第二次降档，用的仍是 480，降完归位，1→0 只要 30
+  CHECK(c.update(1, 0) && c.level() == 2);
+  feed(c, 3, 0, 0.1f);
+  CHECK(c.update(1, 0) && c.level() == 3);
+  feed(c, 3, 0, 0.1f);
+  CHECK(windows_to_shrink(c, 1000) == 480 && c.level() == 2);
+  feed(c, 3, 0, 0.1f);
+  CHECK(windows_to_shrink(c, 1000) == 480 && c.level() == 1);
+  feed(c, 3, 0, 0.1f);
+  const int reset = windows_to_shrink(c, 1000);
+  printf("  连续两次降档撑住后，再降档需要 %d 个\n", reset);
+  CHECK(reset == 30 && c.level() == 0);
+  printf("  %s\n", g_failures == before ? "通过" : "有失败");
+}
+
+static void test_force_level() {
+  printf("force_level：\n");
+  const int before = g_failures;
+  BufferController c(kLevels, kCount, kRate, kCfg);
+  c.update(1, 0);
+  feed(c, 3, 0, 0.1f);
+  CHECK(c.update(1, 0) && c.level() == 2);
+  c.force_level(1);   // 重建失败，退回实际档位
+  CHECK(c.level() == 1 && c.current().block_frames == 16);
+  CHECK(feed(c, 3, 5, 0.9f) == 0);   // 重新冷却
+  CHECK(c.update(1, 0) && c.level() == 2);
+  printf("  %s\n", g_failures == before ? "通过" : "有失败");
+}
+
+static void test_periodic_xruns() {
+  printf("周期性卡顿（每 45 窗口一次，2 档起不出 xrun，3000 窗口）：\n");
+  BufferController c(kLevels, kCount, kRate, kCfg);
+  int grows = 0, shrinks = 0, max_level = 0;
+  for (int w = 0; w < 3000; w++) {
+    const int lv = c.level();
+    const uint32_t xruns = w % 45 == 0 && lv < 2 ? 1 : 0;
+    if (c.update(xruns, p99_for(c, 0.1f))) (c.level() > lv ? grows : shrinks)++;
+    if (c.level() > max_level) max_level = c.level();
+  }
+  const int naive = 2 * 3000 / 45;
+  printf("  升档 %d 次、降档 %d 次（无退避约 %d 次切换），最高到 %d 档，最后停在 %d 档\n", grows, shrinks, naive,
+         max_level, c.level());
+  CHECK(grows + shrinks <= naive / 4);
+  CHECK(c.level() == 2);
+}
+
+int main() {
+  test_grow();
+  test_hysteresis();
+  test_backoff();
+  test_force_level();
+  test_periodic_xruns();
+  printf("\n%s\n", g_failures ? "有断言失败" : "全部通过");
+  return g_failures ? 1 : 0;
+}
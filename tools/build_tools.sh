@@ -0,0 +1,39 @@
+#!/bin/bash
+# 编译 PC 端 C++ 工具，与固件共用 lib/ 下的可移植代码
+# 用法: ./tools/build_tools.sh    产物在 tools/bin/
+
+set -e
+cd "$(dirname "$0")"
+mkdir -p bin
+
+CXX=${CXX:-g++}
+CXXFLAGS="-std=c++17 -O2 -Wall -I../lib/audio_proto"
+PROTO="../lib/audio_proto/adpcm.cpp ../lib/audio_proto/crc.cpp ../lib/audio_proto/audio_frame.cpp ../lib/audio_proto/frame_decoder.cpp ../lib/audio_proto/telemetry_record.cpp ../lib/audio_proto/spectrum_record.cpp ../lib/audio_proto/capture_record.cpp ../lib/audio_proto/command_record.cpp"
+
+$CXX $CXXFLAGS -o bin/frame_dump frame_dump.cpp serial_port.cpp $PROTO
+$CXX $CXXFLAGS -o bin/frame_fuzz frame_fuzz.cpp $PROTO
+$CXX $CXXFLAGS -o bin/codec_bench codec_bench.cpp ../lib/audio_proto/adpcm.cpp
+$CXX $CXXFLAGS -I../lib/flash_log -o bin/seglog_crash seglog_crash.cpp ../lib/flash_log/segment_log.cpp ../lib/audio_proto/crc.cpp
+$CXX -std=c++17 -O2 -Wall -I../lib/audio_dsp -I../lib/telemetry -o bin/gain_bench gain_bench.cpp ../lib/audio_dsp/gain_kernel.cpp
+$CXX -std=c++17 -O2 -Wall -I../lib/audio_dsp -o bin/biquad_bench biquad_bench.cpp
+$CXX -std=c++17 -O2 -Wall -I../lib/audio_dsp -I../lib/telemetry -o bin/resample_bench resample_bench.cpp ../lib/audio_dsp/resampler.cpp
+$CXX -std=c++17 -O2 -Wall -I../lib/audio_dsp -I../lib/telemetry -o bin/spectrum_bench spectrum_bench.cpp ../lib/audio_dsp/fft.cpp ../lib/audio_dsp/spectrum.cpp
+$CXX -std=c++17 -O2 -Wall -I../lib/ui -I../lib/audio_dsp -I../lib/spsc_queue -o bin/ui_preview ui_preview.cpp ../lib/ui/audio_ui.cpp ../lib/audio_dsp/fft.cpp ../lib/audio_dsp/spectrum.cpp
+$CXX -std=c++17 -O2 -Wall -I../lib/audio_dsp -I../lib/telemetry -o bin/vad_runner vad_runner.cpp ../lib/audio_dsp/vad.cpp ../lib/audio_dsp/fft.cpp ../lib/audio_dsp/resampler.cpp
+$CXX -std=c++17 -O2 -Wall -I../lib/audio_dsp -I../lib/telemetry -o bin/agc_bench agc_bench.cpp ../lib/audio_dsp/agc.cpp
+$CXX -std=c++17 -O2 -Wall -I../lib/audio_dsp -o bin/howl_bench howl_bench.cpp ../lib/audio_dsp/howl_suppressor.cpp
+$CXX -std=c++17 -O2 -Wall -I../lib/audio_dsp -o bin/latency_bench latency_bench.cpp ../lib/audio_dsp/latency_probe.cpp
+$CXX -std=c++17 -O2 -Wall -I../lib/audio_dsp -o bin/pdm_bench pdm_bench.cpp ../lib/audio_dsp/pdm_decimator.cpp
+$CXX -std=c++17 -O2 -Wall -I../lib/audio_dsp -DPDM_CIC_KERNEL=PDM_CIC_KERNEL_LUT -o bin/pdm_bench_lut pdm_bench.cpp ../lib/audio_dsp/pdm_decimator.cpp
+$CXX -std=c++17 -O2 -Wall -I../lib/audio_dsp -I../lib/telemetry -o bin/pop_bench pop_bench.cpp ../lib/audio_dsp/pop_guard.cpp
+$CXX -std=c++17 -O2 -Wall -I../lib/audio_io -o bin/bufctl_bench bufctl_bench.cpp ../lib/audio_io/buffer_controller.cpp
+$CXX -std=c++17 -O2 -Wall -I../lib/audio_dsp -I../lib/telemetry -o bin/graph_bench graph_bench.cpp
+$CXX -std=c++17 -O2 -Wall -pthread -I../lib/audio_dsp -I../lib/telemetry -I../lib/spsc_queue -o bin/hotswap_bench hotswap_bench.cpp ../lib/audio_dsp/runtime_chain.cpp ../lib/audio_dsp/gain_kernel.cpp
+
+# rt_player / audio_ctl 只支持 Linux（pty 替身用 posix_openpt）；有 libasound 才编 ALSA 输出，没有时只能 --null
+if [ "$(uname)" = "Linux" ]; then
+  RT_ALSA=""
+  if pkg-config --exists alsa 2>/dev/null; then RT_ALSA="-DHAVE_ALSA=1 $(pkg-config --cflags --libs alsa)"; fi
+  $CXX $CXXFLAGS -pthread -I../lib/audio_dsp -I../lib/spsc_queue -I../lib/link -o bin/audio_ctl audio_ctl.cpp serial_port.cpp $PROTO ../lib/audio_dsp/runtime_chain.cpp ../lib/audio_dsp/gain_kernel.cpp
+  $CXX $CXXFLAGS -pthread -I../lib/spsc_queue -I../lib/telemetry -o bin/rt_player rt_player.cpp pcm_sink.cpp serial_port.cpp $PROTO $RT_ALSA
+fi
@@ -0,0 +1,218 @@
+// =================================================
+// 上行编解码主机测试（lib/audio_proto/adpcm.h）
+//
+//   ./codec_bench
+//
+// IMA-ADPCM（按 UPLINK_FRAME_SAMPLES = 256 样本一块，编码状态跨块保持，和上行任务一样）
+//   对称：逐块独立解码的输出和编码器内部的重建值逐位相同；打乱块的顺序解码结果不变（丢帧后下一块照常解）；
+//         奇数长度的块（255 样本）也一样
+//   SNR：双音 -12 dBFS、类语音 -20 dBFS、白噪声 -20 dBFS、1 kHz -1 dBFS，各 5 s
+// G.711 µ-law
+//   全部 65536 个输入：往返误差不超过所在段量化步长的一半；全部 256 个码字 encode(decode(c)) == c（-0 除外）
+//   SNR：同上四种信号
+// 最后打印编码 / 解码 ns/样本
+// 返回值：0 全部通过，1 有断言失败
+// =================================================
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "adpcm.h"
+
+static const double kPi = 3.14159265358979323846;
+static const int kRate  = 44100;
+static const int kBlock = 256;
+
+static uint32_t g_seed = 1;
+static double uniform() {
+  g_seed = g_seed * 1664525u + 1013904223u;
+  return (g_seed >> 8) / 16777216.0;
+}
+static double gauss() {
+  const double u1 = uniform() + 1e-9, u2 = uniform();
+  return sqrt(-2 * log(u1)) * cos(2 * kPi * u2);
+}
+
+static std::vector<int16_t> scale_to(const std::vector<double>& v, double dbfs) {
+  double sum = 0;
+  for (double x : v) sum += x * x;
+  const double g = 32768.0 * pow(10, dbfs / 20) / sqrt(sum / v.size());
+  std::vector<int16_t> out(v.size());
+  for (size_t i = 0; i < v.size(); i++) {
+    const double s = g * v[i];
+    out[i] = (int16_t)(s > 32767 ? 32767 : (s < -32768 ? -32768 : lrint(s)));
+  }
+  return out;
+}
+
+struct Signal {
+  const char* name;
+  std::vector<int16_t> pcm;
+};
+
+static std::vector<Signal> signals() {
+  const size_t n = kRate * 5;
+  std::vector<double> two(n), speech(n), noise(n), sine(n);
+  for (size_t i = 0; i < n; i++) {
+    const double t = (double)i / kRate;
+    two[i]    = sin(2 * kPi * 440 * t) + sin(2 * kPi * 2500 * t);
+    const double ph = fmod(t, 0.25);
+    speech[i] = (ph < 0.18 ? pow(sin(kPi * ph / 0.18), 2) : 0) * sin(2 * kPi * 1000 * t) + 0.003 * gauss();
+    noise[i]  = gauss();
+    sine[i]   = sin(2 * kPi * 1000 * t);
+  }
+  return {{"双音 -12 dBFS", scale_to(two, -12)},
+          {"类语音 -20 dBFS", scale_to(speech, -20)},
+          {"白噪声 -20 dBFS", scale_to(noise, -20)},
+          {"1 kHz -1 dBFS", scale_to(sine, -1)}};
+}
+
+static double snr_db(const std::vector<int16_t>& ref, const std::vector<int16_t>& out) {
+  double s = 0, e = 0;
+  for (size_t i = 0; i < ref.size(); i++) {
+    s += (double)ref[i] * ref[i];
+    e += ((double)ref[i] - out[i]) * ((double)ref[i] - out[i]);
+  }
+  return 10 * log10(s / fmax(e, 1e-9));
+}
+
+// 按块编码；recon 是编码器自己的重建值（每样本编码后的 predictor）
+static std::vector<std::vector<uint8_t>> adpcm_encode_all(const std::vector<int16_t>& x, size_t block,
+                                                          std::vector<int16_t>* recon) {
+  std::vector<std::vector<uint8_t>> blocks;
+  AdpcmState st = {0, 0};
+  for (size_t pos = 0; pos < x.size(); pos += block) {
+    const size_t n = std::min(block, x.size() - pos);
+    std::vector<uint8_t> b(adpcm_block_bytes(n));
+    // 重建值：用同一个状态逐样本再走一遍（encode_block 内部就是这么做的）
+    AdpcmState shadow = st;
+    for (size_t i = 0; i < n; i++) {
+      adpcm_encode_sample(&shadow, x[pos + i]);
+      recon->push_back(shadow.predictor);
+    }
+    const size_t len = adpcm_encode_block(&st, &x[pos], n, b.data());
+    if (len != b.size() || st.predictor != shadow.predictor || st.index != shadow.index) {
+      printf("  块 %zu：编码长度 / 状态不对！\n", pos / block);
+      exit(1);
+    }
+    blocks.push_back(b);
+  }
+  return blocks;
+}
+
+static bool adpcm_symmetry(const std::vector<int16_t>& x, size_t block) {
+  std::vector<int16_t> recon;
+  const auto blocks = adpcm_encode_all(x, block, &recon);
+
+  // 逐块独立解码
+  std::vector<int16_t> dec(x.size());
+  for (size_t b = 0; b < blocks.size(); b++) {
+    const size_t pos = b * block, n = std::min(block, x.size() - pos);
+    if (adpcm_decode_block(blocks[b].data(), blocks[b].size(), &dec[pos], n) != n) return false;
+  }
+  if (dec != recon) return false;
+
+  // 打乱顺序再解一遍，结果不变
+  std::vector<size_t> order(blocks.size());
+  for (size_t i = 0; i < order.size(); i++) order[i] = i;
+  for (size_t i = order.size() - 1; i > 0; i--) std::swap(order[i], order[(size_t)(uniform() * (i + 1))]);
+  std::vector<int16_t> shuffled(x.size());
+  for (size_t b : order) {
+    const size_t pos = b * block, n = std::min(block, x.size() - pos);
+    adpcm_decode_block(blocks[b].data(), blocks[b].size(), &shuffled[pos], n);
+  }
+  return shuffled == recon;
+}
+
+int main() {
+  bool ok = true;
+  const std::vector<Signal> sigs = signals();
+
+  // ---------- ADPCM ----------
+  printf("IMA-ADPCM（%d 样本一块）：\n", kBlock);
+  {
+    bool sym = true;
+    for (const Signal& s : sigs) sym &= adpcm_symmetry(s.pcm, kBlock) && adpcm_symmetry(s.pcm, kBlock - 1);
+    printf("  逐块解码 = 编码器重建值、打乱块顺序不变、255 样本块：%s\n", sym ? "逐位一致" : "不一致！");
+    ok &= sym;
+  }
+  // 每种信号的下限：ADPCM 靠相邻样本相关，白噪声没有可预测的部分，SNR 最低
+  const double kAdpcmMin[] = {30, 30, 12, 30};
+  for (size_t k = 0; k < sigs.size(); k++) {
+    std::vector<int16_t> recon;
+    adpcm_encode_all(sigs[k].pcm, kBlock, &recon);
+    const double snr = snr_db(sigs[k].pcm, recon);
+    printf("  %-16s SNR %5.1f dB（下限 %.0f）\n", sigs[k].name, snr, kAdpcmMin[k]);
+    ok &= snr >= kAdpcmMin[k];
+  }
+
+  // ---------- µ-law ----------
+  printf("\nG.711 µ-law：\n");
+  {
+    int worst_excess = 0, bad_codes = 0;
+    for (int v = -32768; v <= 32767; v++) {
+      const uint8_t c = ulaw_encode((int16_t)v);
+      const int y = ulaw_decode(c);
+      // 所在段的步长：指数 e 段是 2^(e+3)；削顶（|v| > 32635）之外误差不超过半步
+      const int e = ((uint8_t)~c >> 4) & 7;
+      const int half = 1 << (e + 2);
+      const int clip = 32635 - 32124;   // 最大码字 32124 到削顶点的距离
+      const int lim = abs(v) > 32124 ? clip + half : half;
+      worst_excess = std::max(worst_excess, abs(v - y) - lim);
+    }
+    for (int c = 0; c < 256; c++) {
+      if (c == 0x7F) continue;   // -0，解出来是 0，再编回 0xFF
+      bad_codes += ulaw_encode(ulaw_decode((uint8_t)c)) != c;
+    }
+    printf("  全部 int16 往返误差 ≤ 半步：%s；码字往返：%d 个不一致\n", worst_excess <= 0 ? "是" : "否！", bad_codes);
+    ok &= worst_excess <= 0 && bad_codes == 0;
+  }
+  for (const Signal& s : sigs) {
+    std::vector<int16_t> y(s.pcm.size());
+    for (size_t i = 0; i < y.size(); i++) y[i] = ulaw_decode(ulaw_encode(s.pcm[i]));
+    const double snr = snr_db(s.pcm, y);
+    printf("  %-16s SNR %5.1f dB（下限 30）\n", s.name, snr);
+    ok &= snr >= 30;
+  }
+
+  // ---------- 开销 ----------
+  {
+    const std::vector<int16_t>& x = sigs[1].pcm;
+    std::vector<uint8_t> enc(adpcm_block_bytes(kBlock));
+    std::vector<int16_t> dec(kBlock);
+    std::vector<uint8_t> u(x.size());
+    const int reps = 20;
+    double t[4] = {};
+    volatile uint32_t sink = 0;
+    for (int r = 0; r < reps; r++) {
+      auto t0 = std::chrono::steady_clock::now();
+      AdpcmState st = {0, 0};
+      for (size_t pos = 0; pos + kBlock <= x.size(); pos += kBlock) {
+        adpcm_encode_block(&st, &x[pos], kBlock, enc.data());
+        sink += enc[7];
+      }
+      auto t1 = std::chrono::steady_clock::now();
+      for (size_t pos = 0; pos + kBlock <= x.size(); pos += kBlock) {
+        adpcm_decode_block(enc.data(), enc.size(), dec.data(), kBlock);
+        sink += dec[7];
+      }
+      auto t2 = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < x.size(); i++) u[i] = ulaw_encode(x[i]);
+      auto t3 = std::chrono::steady_clock::now();
+      for (size_t i = 0; i < x.size(); i++) sink += ulaw_decode(u[i]);
+      auto t4 = std::chrono::steady_clock::now();
+      t[0] += std::chrono::duration<double>(t1 - t0).count();
+      t[1] += std::chrono::duration<double>(t2 - t1).count();
+      t[2] += std::chrono::duration<double>(t3 - t2).count();
+      t[3] += std::chrono::duration<double>(t4 - t3).count();
+    }
+    const double n = (double)reps * x.size() / 1e9;
+    printf("\nns/样本：ADPCM 编码 %.1f、解码 %.1f；µ-law 编码 %.1f、解码 %.1f\n", t[0] / n, t[1] / n, t[2] / n,
+           t[3] / n);
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+// =================================================
+// 串口帧解码工具（Linux / macOS）
+//
+//   ./frame_dump /dev/ttyUSB0 > out.pcm        # 打开串口（1500000 波特）
+//   ./frame_dump capture.bin  > out.pcm        # 解码离线抓包
+//   ./frame_dump - < capture.bin > out.pcm     # 从 stdin 读
+//
+// 音频 payload（PCM16 / ADPCM / µ-law）统一解成 int16 小端单声道写到 stdout，统计每秒打印到 stderr，
+// 可以直接接 `ffplay -f s16le -ar 48000 -ac 1 -` 或 sox 等工具
+// 遥测帧（各级耗时 p50/p99/max）逐条打印到 stderr
+// 事件捕获帧（固件 CAPTURE_ENABLE）按 job 写到当前目录的 capture_<job>.pcm（采集采样率，
+// 一般是 44100），每次捕获结束打一行；中途有样本被覆盖时按 offset 补零
+// =================================================
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "adpcm.h"
+#include "capture_record.h"
+#include "frame_decoder.h"
+#include "serial_port.h"
+#include "telemetry_record.h"
+
+static void print_telemetry(const uint8_t* payload, size_t len) {
+  static const char* const kNames[TELEM_STAGES] = {"rx_wait", "dsp", "tx_wait"};
+  TelemetryRecord r;
+  if (!telemetry_decode(payload, len, &r)) return;
+
+  fprintf(stderr, "[%10.3f s]", r.uptime_ms / 1000.0);
+  for (int i = 0; i < TELEM_STAGES; i++) {
+    const TelemetryStage& s = r.stage[i];
+    fprintf(stderr, " %s n=%u p50/p99/max=%.1f/%.1f/%.1f us", kNames[i], s.count,
+            s.p50_ns / 1000.0, s.p99_ns / 1000.0, s.max_ns / 1000.0);
+  }
+  fprintf(stderr, " xrun rx=%u tx=%u", r.rx_overruns, r.tx_underruns);
+  if (r.loop_latency_us >= 0) fprintf(stderr, " loop=%.2f ms", r.loop_latency_us / 1000.0);
+  fputc('\n', stderr);
+}
+
+static void save_capture(const FrameHeader& h, const uint8_t* payload) {
+  static FILE* out = NULL;
+  static int job = -1;
+  static uint32_t written = 0;
+  static bool lost = false;
+  CaptureRecord r;
+  if (!capture_decode(payload, h.length, &r)) return;
+  if (h.length < CAPTURE_HEADER_SIZE + h.samples * sizeof(int16_t)) return;
+
+  if (r.job != job || (r.flags & CAPTURE_FLAG_FIRST)) {
+    if (out) fclose(out);
+    char name[64];
+    snprintf(name, sizeof(name), "capture_%05u.pcm", r.job);
+    out = fopen(name, "wb");
+    job = r.job;
+    written = 0;
+    lost = false;
+  }
+  lost |= (r.flags & CAPTURE_FLAG_LOST) != 0;
+  if (!out) return;
+  static const int16_t zeros[256] = {};
+  while (written < r.offset) {
+    const uint32_t n = r.offset - written < 256 ? r.offset - written : 256;
+    fwrite(zeros, sizeof(int16_t), n, out);
+    written += n;
+  }
+  fwrite(payload + CAPTURE_HEADER_SIZE, sizeof(int16_t), h.samples, out);
+  written += h.samples;
+  if (r.flags & CAPTURE_FLAG_LAST) {
+    static const char* const kReasons[] = {"手动", "电平", "语音"};
+    fprintf(stderr, "捕获 #%u（%s）%.2f s，触发点 %.2f s，%u Hz%s → capture_%05u.pcm\n", r.job,
+            r.reason < 3 ? kReasons[r.reason] : "?", (double)written / r.sample_rate,
+            (double)r.trigger / r.sample_rate, r.sample_rate, lost ? "，有丢失" : "",
+            r.job);
+    fclose(out);
+    out = NULL;
+    job = -1;
+  }
+}
+
+static void on_frame(const FrameHeader& h, const uint8_t* payload, void*) {
+  if (h.type == FRAME_TYPE_TELEMETRY) {
+    print_telemetry(payload, h.length);
+    return;
+  }
+  if (h.type == FRAME_TYPE_CAPTURE) {
+    save_capture(h, payload);
+    return;
+  }
+  if (h.type != FRAME_TYPE_AUDIO) return;
+
+  static int16_t pcm[FRAME_MAX_PAYLOAD * 2];
+  size_t n = 0;
+  switch (h.format) {
+    case SAMPLE_FMT_PCM16:
+      fwrite(payload, 1, h.length, stdout);
+      return;
+    case SAMPLE_FMT_ADPCM:
+      n = adpcm_decode_block(payload, h.length, pcm, h.samples);
+      break;
+    case SAMPLE_FMT_ULAW:
+      for (n = 0; n < h.length; n++) pcm[n] = ulaw_decode(payload[n]);
+      break;
+    default:
+      return;
+  }
+  fwrite(pcm, sizeof(int16_t), n, stdout);
+}
+
+static void print_stats(const FrameDecoderStats& st) {
+  fprintf(stderr,
+          "frames=%u gaps=%u lost=%u hdr_err=%u crc_err=%u skipped=%llu\n",
+          st.frames, st.gaps, st.lost_frames, st.header_errors,
+          st.crc_errors, (unsigned long long)st.skipped_bytes);
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    fprintf(stderr, "用法: %s <串口设备|文件|-> [波特率]\n", argv[0]);
+    return 1;
+  }
+  int baud = argc > 2 ? atoi(argv[2]) : 1500000;
+
+  int fd;
+  if (strcmp(argv[1], "-") == 0) {
+    fd = STDIN_FILENO;
+  } else {
+    fd = open(argv[1], O_RDONLY | O_NOCTTY);
+    if (fd < 0) {
+      fprintf(stderr, "打开 %s 失败: %s\n", argv[1], strerror(errno));
+      return 1;
+    }
+    if (isatty(fd) && !serial_configure(fd, baud)) {
+      fprintf(stderr, "配置串口失败: %s\n", strerror(errno));
+      return 1;
+    }
+  }
+
+  static FrameDecoder dec(on_frame, NULL);
+  uint8_t buf[4096];
+  time_t last = time(NULL);
+
+  for (;;) {
+    ssize_t n = read(fd, buf, sizeof(buf));
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) break;
+    dec.push(buf, (size_t)n);
+
+    time_t now = time(NULL);
+    if (now != last) {
+      last = now;
+      print_stats(dec.stats());
+    }
+  }
+  fflush(stdout);
+  print_stats(dec.stats());
+  return 0;
+}
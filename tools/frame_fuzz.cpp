@@ -0,0 +1,206 @@
+// =================================================
+// 帧解码器模糊 / 吞吐测试（lib/audio_proto/frame_decoder.h）
+//
+//   ./frame_fuzz [种子]
+//
+// 按 UPLINK_FRAMED 的样子造流：256 样本 PCM16 音频帧，每 50 帧夹一条遥测帧，每 20 帧夹一行文本日志
+// 四种损伤，各 20000 帧，每帧以 5% 概率（首尾两帧不动）被：
+//   翻转 1~3 个比特 / 删掉 1~3 个字节 / 帧内插入 1~8 个随机字节 / 截断成前半截
+// 插入那一组在帧之间再加随机垃圾（一半概率带 0xA5 0x5A 假 magic）
+// 按 1~1500 字节随机切块喂进去，断言：
+//   - 解出来的音频帧正好是没被动过的那些（损伤帧后面的第一帧就重新锁定，不多丢）
+//   - gaps = 连续损伤段数，lost_frames = 损伤帧数，遥测帧一个不少
+// 吞吐：干净流 / 随机垃圾 / 全是假 magic 的垃圾各解码约 0.5 s，打印 MB/s 和相对 1.5 Mbaud（150 kB/s）的倍数，
+//       最慢的也要 ≥ 10 倍
+// 返回值：0 全部通过，1 有断言失败
+// =================================================
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "frame_decoder.h"
+
+static const int kSamples   = 256;
+static const double kLinkBps = 150000;   // 1.5 Mbaud 8N1
+
+static uint32_t g_seed = 1;
+static uint32_t rnd() {
+  g_seed ^= g_seed << 13;
+  g_seed ^= g_seed >> 17;
+  g_seed ^= g_seed << 5;
+  return g_seed;
+}
+static uint32_t rnd(uint32_t lo, uint32_t hi) { return lo + rnd() % (hi - lo + 1); }   // [lo, hi]
+
+enum Damage { DMG_BITFLIP, DMG_DROP, DMG_INSERT, DMG_TRUNCATE, DMG_KINDS };
+static const char* const kDamageNames[DMG_KINDS] = {"翻转比特", "删字节", "插入垃圾", "截断"};
+
+static void append_frame(std::vector<uint8_t>& out, uint8_t type, uint16_t seq, const uint8_t* payload,
+                         uint16_t len) {
+  uint8_t frame[FRAME_MAX_SIZE];
+  FrameHeader h = {};
+  h.type      = type;
+  h.format    = SAMPLE_FMT_PCM16;
+  h.seq       = seq;
+  h.length    = len;
+  h.timestamp = seq * 5333u;
+  h.samples   = type == FRAME_TYPE_AUDIO ? kSamples : 0;
+  h.channels  = 1;
+  const size_t n = frame_encode(frame, sizeof(frame), h, payload);
+  out.insert(out.end(), frame, frame + n);
+}
+
+struct Stream {
+  std::vector<uint8_t> bytes;
+  std::vector<uint16_t> expect;   // 应该解出来的音频 seq
+  uint32_t damaged   = 0;
+  uint32_t runs      = 0;          // 连续损伤段数
+  uint32_t telemetry = 0;
+};
+
+static Stream build(int kind, uint32_t frames, uint32_t rate_pct) {
+  Stream s;
+  int16_t pcm[kSamples];
+  uint8_t tel[64];
+  bool prev_damaged = false;
+  for (uint32_t seq = 0; seq < frames; seq++) {
+    for (int i = 0; i < kSamples; i++)
+      pcm[i] = (int16_t)lrint(12000 * sin(0.0571 * (seq * kSamples + i)) + (int)(rnd() % 64) - 32);
+    std::vector<uint8_t> f;
+    append_frame(f, FRAME_TYPE_AUDIO, (uint16_t)seq, (const uint8_t*)pcm, sizeof(pcm));
+
+    const bool dmg = kind >= 0 && seq > 0 && seq + 1 < frames && rnd() % 100 < rate_pct;
+    if (dmg) {
+      switch (kind) {
+        case DMG_BITFLIP:
+          for (uint32_t k = rnd(1, 3); k > 0; k--) f[rnd() % f.size()] ^= (uint8_t)(1u << (rnd() % 8));
+          break;
+        case DMG_DROP:
+          for (uint32_t k = rnd(1, 3); k > 0; k--) f.erase(f.begin() + rnd() % f.size());
+          break;
+        case DMG_INSERT:
+          for (uint32_t k = rnd(1, 8); k > 0; k--) f.insert(f.begin() + rnd(1, (uint32_t)f.size() - 1), (uint8_t)rnd());
+          break;
+        case DMG_TRUNCATE:
+          f.resize(rnd(1, (uint32_t)f.size() - 1));
+          break;
+      }
+      s.damaged++;
+      if (!prev_damaged) s.runs++;
+    } else {
+      s.expect.push_back((uint16_t)seq);
+    }
+    prev_damaged = dmg;
+    s.bytes.insert(s.bytes.end(), f.begin(), f.end());
+
+    if (seq % 50 == 25) {
+      for (uint8_t& b : tel) b = (uint8_t)rnd();
+      append_frame(s.bytes, FRAME_TYPE_TELEMETRY, (uint16_t)(seq / 50), tel, sizeof(tel));
+      s.telemetry++;
+    }
+    if (seq % 20 == 10) {
+      char line[64];
+      const int n = snprintf(line, sizeof(line), "🎤 RX=%u drop=0 | DSP=%u\r\n", seq * 8, seq * 8);
+      s.bytes.insert(s.bytes.end(), line, line + n);
+    }
+    if (kind == DMG_INSERT && rnd() % 4 == 0) {
+      for (uint32_t k = rnd(1, 40); k > 0; k--) {
+        if (rnd() % 2) {
+          s.bytes.push_back(FRAME_MAGIC0);
+          s.bytes.push_back(FRAME_MAGIC1);
+        } else {
+          s.bytes.push_back((uint8_t)rnd());
+        }
+      }
+    }
+  }
+  return s;
+}
+
+struct Sink {
+  std::vector<uint16_t> audio;
+  uint32_t telemetry = 0;
+};
+
+static void on_frame(const FrameHeader& h, const uint8_t*, void* ctx) {
+  Sink* s = (Sink*)ctx;
+  if (h.type == FRAME_TYPE_AUDIO) s->audio.push_back(h.seq);
+  else if (h.type == FRAME_TYPE_TELEMETRY) s->telemetry++;
+}
+
+static void feed_chunked(FrameDecoder& dec, const std::vector<uint8_t>& bytes) {
+  for (size_t pos = 0; pos < bytes.size();) {
+    const size_t n = std::min<size_t>(rnd(1, 1500), bytes.size() - pos);
+    dec.push(&bytes[pos], n);
+    pos += n;
+  }
+}
+
+static bool check(const char* name, int kind) {
+  const Stream s = build(kind, 20000, kind < 0 ? 0 : 5);
+  Sink sink;
+  FrameDecoder dec(on_frame, &sink);
+  feed_chunked(dec, s.bytes);
+  const FrameDecoderStats& st = dec.stats();
+
+  const bool ok = sink.audio == s.expect && sink.telemetry == s.telemetry && st.gaps == s.runs &&
+                  st.lost_frames == s.damaged;
+  printf("  %-10s 损伤 %5u 帧 / %4u 段：解出 %5zu/%5zu 音频帧、%u/%u 遥测帧，gaps %u，lost %u，"
+         "帧头错 %u，CRC 错 %u，跳过 %llu 字节  %s\n",
+         name, s.damaged, s.runs, sink.audio.size(), s.expect.size(), sink.telemetry, s.telemetry, st.gaps,
+         st.lost_frames, st.header_errors, st.crc_errors, (unsigned long long)st.skipped_bytes,
+         ok ? "通过" : "不一致！");
+  return ok;
+}
+
+// 反复解码 bytes 约 0.5 s，返回 MB/s
+static double throughput(const std::vector<uint8_t>& bytes) {
+  Sink sink;
+  FrameDecoder dec(on_frame, &sink);
+  const auto t0 = std::chrono::steady_clock::now();
+  double secs = 0;
+  size_t total = 0;
+  while (secs < 0.5) {
+    for (size_t pos = 0; pos < bytes.size(); pos += 256) {
+      dec.push(&bytes[pos], std::min<size_t>(256, bytes.size() - pos));
+    }
+    total += bytes.size();
+    sink.audio.clear();
+    secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  }
+  return total / secs / 1e6;
+}
+
+int main(int argc, char** argv) {
+  g_seed = argc > 1 ? (uint32_t)strtoul(argv[1], nullptr, 0) : 1;
+  if (g_seed == 0) g_seed = 1;
+  bool ok = true;
+
+  printf("模糊（种子 %u，20000 帧，5%% 损伤，随机切块）：\n", g_seed);
+  ok &= check("干净", -1);
+  for (int k = 0; k < DMG_KINDS; k++) ok &= check(kDamageNames[k], k);
+  printf("\n");
+
+  printf("吞吐（256 字节一块 push）：\n");
+  const std::vector<uint8_t> clean = build(-1, 8000, 0).bytes;
+  std::vector<uint8_t> noise(4 << 20), magic(4 << 20);
+  for (uint8_t& b : noise) b = (uint8_t)rnd();
+  for (size_t i = 0; i < magic.size(); i++) magic[i] = i % 2 ? FRAME_MAGIC1 : FRAME_MAGIC0;
+  struct {
+    const char* name;
+    const std::vector<uint8_t>* bytes;
+  } cases[] = {{"干净帧流", &clean}, {"随机垃圾", &noise}, {"全是假 magic", &magic}};
+  double worst = 1e30;
+  for (auto& c : cases) {
+    const double mbs = throughput(*c.bytes);
+    printf("  %-14s %8.1f MB/s（1.5 Mbaud 的 %.0f 倍）\n", c.name, mbs, mbs * 1e6 / kLinkBps);
+    worst = fmin(worst, mbs);
+  }
+  ok &= worst * 1e6 >= 10 * kLinkBps;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,119 @@
+// =================================================
+// 定点增益内核主机测试（lib/audio_dsp/gain_kernel.h）
+//
+//   ./gain_bench
+//
+// 逐位：全部 65536 个 int16 输入 × 一组增益，float 参考 / Q12 两种输出逐位比对
+//   固件用到的增益（MIC_GAIN 3.0、0 ~ 15.875 的 1/8 步进）必须一致；
+//   另外扫一遍全部 Q12 增益（0 ~ 65535/4096），打印和 float 路径不一致的增益个数和样本数
+//   （gain×512 是整数的增益必须一致）
+// 长度 1~17：和 float 路径一致，且不写出 2n 个样本之外
+// 最后打印两种实现在 8 / 256 样本块上的 cycles/样本
+// =================================================
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "cycle_clock.h"
+#include "gain_kernel.h"
+
+static const int kAll = 65536;
+
+// -32768 ~ 32767 各一次
+static std::vector<int16_t> all_inputs() {
+  std::vector<int16_t> x(kAll);
+  for (int i = 0; i < kAll; i++) x[i] = (int16_t)(i - 32768);
+  return x;
+}
+
+// 返回 a、b 不一致的样本数（左右声道都比，也查左右是否相同）
+static size_t diff(const std::vector<int16_t>& a, const std::vector<int16_t>& b) {
+  size_t d = 0;
+  for (size_t i = 0; i < a.size(); i += 2) d += a[i] != b[i] || a[i + 1] != b[i + 1] || a[i] != a[i + 1];
+  return d;
+}
+
+int main() {
+  const std::vector<int16_t> in = all_inputs();
+  std::vector<int16_t> f(2 * kAll), r(2 * kAll);
+  bool ok = true;
+
+  // ---------- 固件用到的增益 ----------
+  printf("逐位（全部 int16 输入）：\n");
+  for (int k8 = 0; k8 < 16 * 8; k8++) {
+    const float gain = k8 / 8.0f;
+    const int32_t q  = gain_to_q12(gain);
+    gain_interleave_float(in.data(), f.data(), kAll, gain);
+    gain_interleave_q12_ref(in.data(), r.data(), kAll, q);
+    const size_t df = diff(f, r);
+    if (df) {
+      printf("  增益 %.3f：float/Q12 %zu 处不同\n", gain, df);
+      ok = false;
+    }
+  }
+  printf("  0 ~ 15.875（1/8 步进，128 个）：%s\n", ok ? "两种实现逐位一致" : "不一致！");
+
+  // ---------- 全部 Q12 增益 ----------
+  {
+    size_t gains_off = 0, samples_off = 0, coarse_off = 0;
+    int32_t first_off = -1;
+    for (int32_t q = 0; q < 16 * GAIN_Q_ONE; q++) {
+      gain_interleave_float(in.data(), f.data(), kAll, (float)q / GAIN_Q_ONE);
+      gain_interleave_q12_ref(in.data(), r.data(), kAll, q);
+      const size_t d = diff(f, r);
+      if (d) {
+        gains_off++;
+        samples_off += d;
+        if (first_off < 0) first_off = q;
+        if (q % 8 == 0) coarse_off++;
+      }
+    }
+    printf("  全部 %d 个 Q12 增益：float/Q12 有 %zu 个增益不一致（共 %zu 个样本",
+           16 * GAIN_Q_ONE, gains_off, samples_off);
+    if (first_off >= 0) printf("，最小的是 %d/4096", first_off);
+    printf("）\n");
+    printf("  其中 gain×512 是整数的：%zu 个不一致\n", coarse_off);
+    printf("  （float 尾数 24 位，|x| ≥ 2^12 时 ulp 已粗于 2^-12，截断前可能把 n - 2^-12 舍入成 n）\n");
+    ok &= coarse_off == 0;
+  }
+
+  // ---------- 奇数长度 ----------
+  {
+    size_t bad = 0;
+    for (int n = 1; n <= 17; n++) {
+      int16_t a[2 * 17 + 2], b[2 * 17 + 2];
+      memset(a, 0x55, sizeof(a));
+      memset(b, 0x55, sizeof(b));
+      gain_interleave_float(&in[30000], a, n, 3.0f);
+      gain_interleave_q12_ref(&in[30000], b, n, gain_to_q12(3.0f));
+      bad += memcmp(a, b, sizeof(a)) != 0;   // 包括越界写：2n 之后的哨兵也要一样
+    }
+    printf("  长度 1~17：%s\n\n", bad ? "不一致！" : "一致，不越界");
+    ok &= bad == 0;
+  }
+
+  // ---------- 开销 ----------
+  printf("cycles/样本（增益 3.0，周期按 %d MHz 计）：\n", CYCLE_CLOCK_HOST_MHZ);
+  const int blocks[] = {8, 256};
+  for (int blk : blocks) {
+    const int reps = 200;
+    double c[2];
+    for (int impl = 0; impl < 2; impl++) {
+      uint64_t cyc = 0;
+      for (int rep = 0; rep < reps; rep++) {
+        const uint32_t c0 = cycle_now();
+        for (int pos = 0; pos + blk <= kAll; pos += blk) {
+          int16_t* out = r.data() + 2 * pos;
+          if (impl == 0) gain_interleave_float(&in[pos], out, blk, 3.0f);
+          else gain_interleave_q12_ref(&in[pos], out, blk, gain_to_q12(3.0f));
+        }
+        cyc += cycle_now() - c0;
+      }
+      c[impl] = (double)cyc / ((double)reps * kAll);
+    }
+    printf("  块长 %3d：float %.2f   Q12 %.2f\n", blk, c[0], c[1]);
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+// =================================================
+// 编译期流水线主机基准（lib/audio_dsp/static_pipeline.h）
+//
+//   ./graph_bench
+//
+// 两条链：
+//   重链  4 阶 Butterworth 带通 100~3000 Hz（4 段 biquad）→ 增益 3 → 限幅 -1 dBFS → 电平表 → 立体声交织
+//   轻链  增益 3 → 限幅 -1 dBFS → 电平表 → 立体声交织（固件 gain_interleave 那一类每样本几条指令的级）
+// 三种跑法，int32（Q.8）和 float 两种样本类型，块长 8 / 32 / 128：
+//   融合       StaticPipeline::process(in, out)，块长是编译期常量
+//   融合/变长  同一个对象，process(in, out, n)，块长运行时传入
+//   虚函数     每级包成一个 virtual process(buf, n)，按级跑完整块再进下一级（级之间落地到缓冲）
+// 先逐位比对三种输出（和电平表读数），再打印每样本 ns（主机 steady_clock）和相对虚函数版的加速比
+// =================================================
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "static_pipeline.h"
+
+static const double kPi = 3.14159265358979323846;
+static const int kRate = 44100;
+static constexpr auto kSos = butter_bandpass<4>(kRate, 100.0, 3000.0);
+
+// =================================================
+// 虚函数版：级之间通过块缓冲传递
+// =================================================
+template <typename T>
+struct VirtualStage {
+  virtual ~VirtualStage() {}
+  virtual void process(T* buf, int n) = 0;
+};
+
+template <typename T, typename S>
+struct StageAdapter : VirtualStage<T> {
+  explicit StageAdapter(const S& s) : stage(s) {}
+  void process(T* buf, int n) override {
+    for (int i = 0; i < n; i++) buf[i] = stage.tick(buf[i]);
+  }
+  S stage;
+};
+
+template <typename T>
+class VirtualPipeline {
+ public:
+  void add(VirtualStage<T>* s) { stages_.emplace_back(s); }
+
+  void process(const int16_t* in, int16_t* out, int n) {
+    for (int i = 0; i < n; i++) buf_[i] = SampleTraits<T>::from_i16(in[i]);
+    for (auto& s : stages_) s->process(buf_, n);
+    InterleaveStereo<T> sink;
+    for (int i = 0; i < n; i++) sink.put(out, i, buf_[i]);
+  }
+
+ private:
+  std::vector<std::unique_ptr<VirtualStage<T>>> stages_;
+  T buf_[1024];
+};
+
+// =================================================
+template <typename T, int N, bool Heavy>
+struct ChainOf;
+
+template <typename T, int N>
+struct ChainOf<T, N, true> {
+  using Fused = StaticPipeline<T, N, InterleaveStereo<T>, Biquad<T, kSos.kSections>, Gain<T>,
+                               Limiter<T>, Meter<T>>;
+  static constexpr size_t kMeter = 3;
+  static Fused fused() {
+    return Fused(Biquad<T, kSos.kSections>(kSos), Gain<T>(3.0f), Limiter<T>(-1.0f), Meter<T>());
+  }
+  static void add_front(VirtualPipeline<T>* p) {
+    p->add(new StageAdapter<T, Biquad<T, kSos.kSections>>(Biquad<T, kSos.kSections>(kSos)));
+  }
+};
+
+template <typename T, int N>
+struct ChainOf<T, N, false> {
+  using Fused = StaticPipeline<T, N, InterleaveStereo<T>, Gain<T>, Limiter<T>, Meter<T>>;
+  static constexpr size_t kMeter = 2;
+  static Fused fused() { return Fused(Gain<T>(3.0f), Limiter<T>(-1.0f), Meter<T>()); }
+  static void add_front(VirtualPipeline<T>*) {}
+};
+
+template <typename T, int N, bool Heavy>
+static VirtualPipeline<T>* make_virtual(Meter<T>** meter) {
+  auto* p = new VirtualPipeline<T>();
+  ChainOf<T, N, Heavy>::add_front(p);
+  p->add(new StageAdapter<T, Gain<T>>(Gain<T>(3.0f)));
+  p->add(new StageAdapter<T, Limiter<T>>(Limiter<T>(-1.0f)));
+  auto* m = new StageAdapter<T, Meter<T>>(Meter<T>());
+  *meter = &m->stage;
+  p->add(m);
+  return p;
+}
+
+// 两个正弦 + 噪声，幅度够大让限幅真的起作用
+static std::vector<int16_t> signal(size_t n) {
+  std::vector<int16_t> x(n);
+  uint32_t s = 1;
+  for (size_t i = 0; i < n; i++) {
+    s = s * 1664525u + 1013904223u;
+    const double v = 9000 * sin(2 * kPi * 440 * i / kRate) + 6000 * sin(2 * kPi * 2500 * i / kRate) +
+                     1000.0 * ((int32_t)(s >> 16) - 32768) / 32768.0;
+    x[i] = (int16_t)lrint(v);
+  }
+  return x;
+}
+
+template <typename F>
+static double ns_per_sample(F&& f, size_t samples, int reps) {
+  double best = 1e30;
+  for (int r = 0; r < reps; r++) {
+    const auto t0 = std::chrono::steady_clock::now();
+    f();
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    if (ns < best) best = ns;
+  }
+  return best / samples;
+}
+
+template <typename T, int N, bool Heavy>
+static bool bench(const char* tname) {
+  using C = ChainOf<T, N, Heavy>;
+  const size_t blocks = (size_t)kRate * 4 / N;
+  const size_t n = blocks * N;
+  const std::vector<int16_t> in = signal(n);
+  std::vector<int16_t> out_fused(2 * n), out_var(2 * n), out_virt(2 * n);
+
+  // ---------- 逐位比对 ----------
+  auto fused = C::fused();
+  auto var   = C::fused();
+  Meter<T>* vmeter;
+  std::unique_ptr<VirtualPipeline<T>> virt(make_virtual<T, N, Heavy>(&vmeter));
+  volatile int n_rt = N;   // 不让编译器把运行时块长当常量
+  for (size_t b = 0; b < blocks; b++) {
+    fused.process(&in[b * N], &out_fused[2 * b * N]);
+    var.process(&in[b * N], &out_var[2 * b * N], n_rt);
+    virt->process(&in[b * N], &out_virt[2 * b * N], n_rt);
+  }
+  const bool same = out_fused == out_var && out_fused == out_virt &&
+                    fused.template stage<C::kMeter>().peak() == vmeter->peak() &&
+                    fused.template stage<C::kMeter>().rms() == vmeter->rms();
+
+  // ---------- 计时：每种跑若干遍取最快 ----------
+  const double t_fused = ns_per_sample([&] {
+    for (size_t b = 0; b < blocks; b++) fused.process(&in[b * N], &out_fused[2 * b * N]);
+  }, n, 5);
+  const double t_var = ns_per_sample([&] {
+    for (size_t b = 0; b < blocks; b++) var.process(&in[b * N], &out_var[2 * b * N], n_rt);
+  }, n, 5);
+  const double t_virt = ns_per_sample([&] {
+    for (size_t b = 0; b < blocks; b++) virt->process(&in[b * N], &out_virt[2 * b * N], n_rt);
+  }, n, 5);
+
+  printf("  %-7s N=%-4d %s  融合 %6.2f  融合/变长 %6.2f  虚函数 %6.2f ns/样本  加速 %.2fx / %.2fx\n", tname,
+         N, same ? "逐位一致" : "不一致！", t_fused, t_var, t_virt, t_virt / t_fused, t_virt / t_var);
+  return same;
+}
+
+template <bool Heavy>
+static bool bench_all() {
+  bool ok = true;
+  ok &= bench<int32_t, 8, Heavy>("int32");
+  ok &= bench<int32_t, 32, Heavy>("int32");
+  ok &= bench<int32_t, 128, Heavy>("int32");
+  ok &= bench<float, 8, Heavy>("float");
+  ok &= bench<float, 32, Heavy>("float");
+  ok &= bench<float, 128, Heavy>("float");
+  return ok;
+}
+
+int main() {
+  printf("4 s 44.1 kHz，每种跑 5 遍取最快\n\n重链：带通 4 段 biquad → 增益 3 → 限幅 -1 dBFS → 电平表 → 立体声交织\n");
+  bool ok = bench_all<true>();
+  printf("\n轻链：增益 3 → 限幅 -1 dBFS → 电平表 → 立体声交织\n");
+  ok &= bench_all<false>();
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+// =================================================
+// 啸叫抑制闭环仿真（lib/audio_dsp/howl_suppressor.h）
+//
+//   ./howl_bench
+//
+// 和固件一样 8 样本一块处理（44.1 kHz），输出经“声学路径”回到麦克风：
+//   麦克风 = 声源（白噪声 -30 dBFS）+ 环路增益 × 房间共振（RBJ 带通，2500 Hz，Q 5，峰值 0 dB）× 延迟 5 ms 的输出
+//   共振峰附近几个梳状频点的环路增益 > 1，闭环后从噪声里长出啸叫，直到削顶
+// 场景（各 5 s，第 1 s 末闭环）：
+//   稳定环路   环路增益 0.8：不该部署任何陷波（误报）
+//   啸叫环路   环路增益 1.5，不开抑制：确认会啸（最后 1 s 电平 > -6 dBFS）
+//   啸叫环路   环路增益 1.5，开抑制：打印每个陷波的部署时刻 / 频率 / last_detect_ms，
+//              抑制时间 = 闭环到输出 10 ms 电平最后一次超过 -20 dBFS 的时间，要求 ≤ 500 ms，之后一直稳定
+// 附加延迟：部署好陷波的抑制器上喂 1 s 白噪声，打印输入输出互相关峰的位置（样本）和 1 kHz 群延迟，
+//   陷波是 DF2T biquad，应该是 0 样本、远离陷波处群延迟 < 0.05 ms
+// 返回值：0 全部通过，1 有断言失败
+// =================================================
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+#include "howl_suppressor.h"
+
+static const double kPi = 3.14159265358979323846;
+static const int kRate  = 44100;
+static const int kBlock = 8;
+static const int kDelay = kRate * 5 / 1000;   // 声学延迟（不含一块的处理延迟）
+static const double kCloseAt = 1.0;            // 闭环时刻（s）
+static const double kSeconds = 5.0;
+static const double kLoudDb  = -20.0;          // 判定“还在啸”的 10 ms 电平
+static const double kMaxSuppressMs = 500;
+
+static uint32_t g_seed = 1;
+static double uniform() {
+  g_seed = g_seed * 1664525u + 1013904223u;
+  return (g_seed >> 8) / 16777216.0;
+}
+static double gauss() {
+  const double u1 = uniform() + 1e-9, u2 = uniform();
+  return sqrt(-2 * log(u1)) * cos(2 * kPi * u2);
+}
+
+static int16_t clip16(double v) { return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : lrint(v))); }
+
+// RBJ 带通（峰值 0 dB），double DF2T
+struct Resonator {
+  double b0, b2, a1, a2, s1 = 0, s2 = 0;
+  Resonator(double f0, double q) {
+    const double w0 = 2 * kPi * f0 / kRate, alpha = sin(w0) / (2 * q), norm = 1 / (1 + alpha);
+    b0 = alpha * norm;
+    b2 = -alpha * norm;
+    a1 = -2 * cos(w0) * norm;
+    a2 = (1 - alpha) * norm;
+  }
+  double step(double x) {
+    const double y = b0 * x + s1;
+    s1 = -a1 * y + s2;
+    s2 = b2 * x - a2 * y;
+    return y;
+  }
+};
+
+struct Deploy {
+  double t;
+  float freq;
+  uint32_t detect_ms;
+};
+
+struct Result {
+  std::vector<double> level_db;   // 每 10 ms 输出电平（dBFS）
+  std::vector<Deploy> deploys;
+};
+
+// howl 为空时不做抑制
+static Result simulate(double loop_gain, HowlSuppressor* howl) {
+  const int total = (int)(kSeconds * kRate) / kBlock * kBlock, close = (int)(kCloseAt * kRate), win = kRate / 100;
+  Resonator room(2500, 5);
+  std::vector<double> played(total, 0.0);
+  Result r;
+  int16_t buf[kBlock];
+  double acc = 0;
+  uint32_t deployed = 0;
+  g_seed = 1;
+  for (int pos = 0; pos < total; pos += kBlock) {
+    for (int i = 0; i < kBlock; i++) {
+      const int n = pos + i;
+      // 这一块的麦克风采样：kDelay + kBlock 之前播出的样本已经回到麦克风
+      const int back = n - kDelay - kBlock;
+      const double fb = room.step(back >= 0 ? played[back] : 0.0);
+      const double g  = n >= close ? loop_gain : 0.0;
+      buf[i] = clip16(32768 * 0.0316 * gauss() + g * fb);
+    }
+    if (howl) {
+      howl->process(buf, kBlock);
+      if (deployed < howl->stats().deployed) {
+        // 新部署的是之前没有的那个频率（满了会替换最老的，不一定在末尾）
+        deployed = howl->stats().deployed;
+        float freq = 0;
+        for (int j = 0; j < howl->notch_count(); j++) {
+          bool seen = false;
+          for (const Deploy& d : r.deploys) seen |= d.freq == howl->notch_freq(j);
+          if (!seen) freq = howl->notch_freq(j);
+        }
+        r.deploys.push_back({(double)(pos + kBlock) / kRate, freq, howl->stats().last_detect_ms});
+      }
+    }
+    for (int i = 0; i < kBlock; i++) {
+      played[pos + i] = buf[i];
+      acc += (double)buf[i] * buf[i];
+      if ((pos + i + 1) % win == 0) {
+        r.level_db.push_back(10 * log10(acc / win / (32768.0 * 32768.0) + 1e-12));
+        acc = 0;
+      }
+    }
+  }
+  return r;
+}
+
+static double tail_level_db(const Result& r) {
+  double m = -200;
+  for (size_t i = r.level_db.size() - 100; i < r.level_db.size(); i++) m = fmax(m, r.level_db[i]);
+  return m;
+}
+
+int main() {
+  bool ok = true;
+
+  printf("闭环仿真：声源白噪声 -30 dBFS，房间共振 2500 Hz Q 5，声学延迟 %d 样本 + 一块 %d 样本，%.0f s 末闭环\n\n",
+         kDelay, kBlock, kCloseAt);
+
+  {
+    HowlSuppressor h(kRate);
+    const Result r = simulate(0.8, &h);
+    printf("稳定环路（增益 0.8）：部署陷波 %u 个，最后 1 s 最大电平 %.1f dBFS  %s\n", h.stats().deployed,
+           tail_level_db(r), h.stats().deployed == 0 ? "通过" : "误报！");
+    ok &= h.stats().deployed == 0;
+  }
+  {
+    const Result r = simulate(1.5, nullptr);
+    const double tail = tail_level_db(r);
+    printf("啸叫环路（增益 1.5）不抑制：最后 1 s 最大电平 %.1f dBFS  %s\n", tail, tail > -6 ? "确实会啸" : "没啸起来！");
+    ok &= tail > -6;
+  }
+
+  HowlSuppressor h(kRate);
+  {
+    const Result r = simulate(1.5, &h);
+    printf("啸叫环路（增益 1.5）开抑制：\n");
+    for (const Deploy& d : r.deploys)
+      printf("  闭环后 %6.1f ms 部署陷波 %7.1f Hz（last_detect_ms %u）\n", (d.t - kCloseAt) * 1000, d.freq,
+             d.detect_ms);
+    const size_t close_win = (size_t)(kCloseAt * 100);
+    size_t last_loud = close_win;
+    for (size_t i = close_win; i < r.level_db.size(); i++)
+      if (r.level_db[i] > kLoudDb) last_loud = i + 1;
+    const double suppress_ms = (last_loud - close_win) * 10.0;
+    const double tail = tail_level_db(r);
+    const bool pass = !r.deploys.empty() && suppress_ms <= kMaxSuppressMs && tail < kLoudDb;
+    printf("  抑制时间 %.0f ms（上限 %.0f），生效陷波 %d 个，最后 1 s 最大电平 %.1f dBFS  %s\n", suppress_ms,
+           kMaxSuppressMs, h.notch_count(), tail, pass ? "通过" : "失败！");
+    ok &= pass;
+  }
+
+  // ---------- 附加延迟 ----------
+  {
+    HowlSuppressor d = h;   // 带着刚才部署的陷波
+    std::vector<int16_t> zeros(4096, 0);
+    d.process(zeros.data(), (int)zeros.size());   // 陷波状态归零
+
+    const int n = kRate / kBlock * kBlock;
+    std::vector<int16_t> in(n), out;
+    for (int i = 0; i < n; i++) in[i] = clip16(3000 * gauss());
+    out = in;
+    for (int pos = 0; pos < n; pos += kBlock) d.process(&out[pos], kBlock);
+    int best_lag = 0;
+    double best = -1e300;
+    for (int lag = -32; lag <= 32; lag++) {
+      double c = 0;
+      for (int i = 64; i < n - 64; i++) c += (double)in[i] * out[i + lag];
+      if (c > best) best = c, best_lag = lag;
+    }
+
+    // 1 kHz 群延迟：同一段白噪声在 1 kHz 和 1.01 kHz 上 Y/X 的相位差 / 角频率差
+    // （不能用正弦测：持续的单音正是啸叫的样子，会被部署一个陷波）
+    double phase[2];
+    for (int k = 0; k < 2; k++) {
+      const double f = 1000.0 + 10.0 * k;
+      double xr = 0, xi = 0, yr = 0, yi = 0;
+      for (int i = 0; i < n; i++) {
+        const double c = cos(2 * kPi * f * i / kRate), sn = sin(2 * kPi * f * i / kRate);
+        xr += in[i] * c, xi -= in[i] * sn, yr += out[i] * c, yi -= out[i] * sn;
+      }
+      phase[k] = atan2(yi, yr) - atan2(xi, xr);
+    }
+    const double gd_ms = -(phase[1] - phase[0]) / (2 * kPi * 10.0) * 1000;
+    const bool pass = best_lag == 0 && fabs(gd_ms) < 0.05 && d.notch_count() == h.notch_count();
+    printf("\n附加延迟（%d 个陷波）：白噪声互相关峰 %d 样本，1 kHz 群延迟 %.4f ms  %s\n", d.notch_count(), best_lag,
+           gd_ms, pass ? "通过" : "失败！");
+    ok &= pass;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+#pragma once
+// =================================================
+// 主机播放器的抖动缓冲：单生产者（串口 I/O 线程）/ 单消费者（播放线程），无锁
+// -------------------------------------------------
+// 样本环 + 一条标记队列（lib/spsc_queue），标记记下每帧第一个样本的序号、到达时刻和板上时间戳，
+// 播放线程放出这个样本时就知道它在缓冲里待了多久
+//
+// 消费者状态机：
+//   PREFILL  缓冲到 target 之前只出静音（开播和每次欠载之后）
+//   PLAYING  每次取一个周期；不够一个周期算欠载，已有的放掉、剩下补零，回到 PREFILL
+//   积压超过 target + slack（板子时钟比声卡快、或者串口一次涌进来一大堆）时丢掉最老的样本回到 target
+// 生产者满了丢新来的样本并计数，从不等待
+// =================================================
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "spsc_queue.h"
+
+struct JitterMark {
+  uint64_t pos;          // 帧第一个样本的绝对序号
+  uint64_t arrival_ns;   // I/O 线程读到它的时刻（CLOCK_MONOTONIC）
+  uint32_t device_us;    // 帧头 timestamp
+};
+
+struct JitterStats {
+  uint32_t underruns;      // 播放中缓冲见底
+  uint32_t overflow;       // 环满丢掉的新样本
+  uint32_t catchup;        // 追赶丢掉的老样本
+  uint32_t silence;        // 按 seq 缺口补的静音样本
+};
+
+template <size_t N>
+class JitterBuffer {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "JitterBuffer: N 必须是 2 的幂");
+
+ public:
+  static constexpr size_t kCapacity = N;
+
+  JitterBuffer(size_t target, size_t slack)
+      : target_(target < N / 2 ? target : N / 2),
+        slack_(target_ + slack < N ? slack : N - target_) {}
+
+  // ---------- 生产者 ----------
+
+  // 追加一帧；返回写进去的样本数
+  size_t write(const int16_t* x, size_t n, uint64_t arrival_ns, uint32_t device_us) {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    const size_t room = N - (size_t)(head - tail_.load(std::memory_order_acquire));
+    if (n > room) {
+      overflow_.store(overflow_.load(std::memory_order_relaxed) + (uint32_t)(n - room),
+                      std::memory_order_relaxed);
+      n = room;
+    }
+    if (n == 0) return 0;
+    marks_.push({head, arrival_ns, device_us});   // 标记队列满了就少一个延迟样本，不影响音频
+    copy_in(head, x, n);
+    head_.store(head + n, std::memory_order_release);
+    return n;
+  }
+
+  // 丢帧处补静音，保持后面样本的时间位置
+  void write_silence(size_t n) {
+    static const int16_t zeros[256] = {};
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    const size_t room = N - (size_t)(head - tail_.load(std::memory_order_acquire));
+    if (n > room) n = room;
+    for (size_t done = 0; done < n;) {
+      const size_t k = n - done < 256 ? n - done : 256;
+      copy_in(head + done, zeros, k);
+      done += k;
+    }
+    head_.store(head + n, std::memory_order_release);
+    silence_.store(silence_.load(std::memory_order_relaxed) + (uint32_t)n,
+                   std::memory_order_relaxed);
+  }
+
+  // ---------- 消费者 ----------
+
+  // 取一个周期，始终填满 n 个（不够的补零）；返回其中真实样本数。
+  // mark 非空时写入本周期里最后一个帧标记，offset 是它在 out 里的位置；没有新标记返回时 offset = -1
+  size_t read(int16_t* out, size_t n, JitterMark* mark = nullptr, long* offset = nullptr) {
+    uint64_t tail = tail_.load(std::memory_order_relaxed);
+    size_t level = (size_t)(head_.load(std::memory_order_acquire) - tail);
+
+    if (level > target_ + slack_) {
+      const size_t drop = level - target_;
+      tail  += drop;
+      level -= drop;
+      catchup_.store(catchup_.load(std::memory_order_relaxed) + (uint32_t)drop,
+                     std::memory_order_relaxed);
+    }
+
+    size_t take = 0;
+    if (playing_) {
+      take = level < n ? level : n;
+      if (take < n) {
+        playing_ = false;
+        underruns_.store(underruns_.load(std::memory_order_relaxed) + 1,
+                         std::memory_order_relaxed);
+      }
+    } else if (level >= target_) {
+      playing_ = true;
+      take = n;
+    }
+
+    copy_out(tail, out, take);
+    memset(out + take, 0, (n - take) * sizeof(int16_t));
+    pop_marks(tail, tail + take, mark, offset);
+    tail_.store(tail + take, std::memory_order_release);
+    return take;
+  }
+
+  // 有多少取多少（不走 PREFILL / 欠载状态机，吞吐测试用）
+  size_t drain(int16_t* out, size_t max, JitterMark* mark = nullptr, long* offset = nullptr) {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t level = (size_t)(head_.load(std::memory_order_acquire) - tail);
+    const size_t take = level < max ? level : max;
+    copy_out(tail, out, take);
+    pop_marks(tail, tail + take, mark, offset);
+    tail_.store(tail + take, std::memory_order_release);
+    return take;
+  }
+
+  // ---------- 任意线程（快照）----------
+
+  size_t level() const {
+    return (size_t)(head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire));
+  }
+  size_t target() const { return target_; }
+
+  JitterStats stats() const {
+    return {underruns_.load(std::memory_order_relaxed), overflow_.load(std::memory_order_relaxed),
+            catchup_.load(std::memory_order_relaxed), silence_.load(std::memory_order_relaxed)};
+  }
+
+ private:
+  void copy_in(uint64_t at, const int16_t* x, size_t n) {
+    const size_t pos = (size_t)(at & (N - 1));
+    const size_t first = n < N - pos ? n : N - pos;
+    memcpy(buf_ + pos, x, first * sizeof(int16_t));
+    memcpy(buf_, x + first, (n - first) * sizeof(int16_t));
+  }
+
+  void copy_out(uint64_t at, int16_t* out, size_t n) const {
+    const size_t pos = (size_t)(at & (N - 1));
+    const size_t first = n < N - pos ? n : N - pos;
+    memcpy(out, buf_ + pos, first * sizeof(int16_t));
+    memcpy(out + first, buf_, (n - first) * sizeof(int16_t));
+  }
+
+  // 丢掉序号 < from 的标记（被追赶跳过的），报告 [from, to) 里的最后一个
+  void pop_marks(uint64_t from, uint64_t to, JitterMark* mark, long* offset) {
+    if (offset) *offset = -1;
+    JitterMark* m;
+    while ((m = marks_.read_slot()) != nullptr && m->pos < to) {
+      if (m->pos >= from) {
+        if (mark) *mark = *m;
+        if (offset) *offset = (long)(m->pos - from);
+      }
+      marks_.commit_read();
+    }
+  }
+
+  const size_t target_, slack_;
+  bool playing_ = false;   // 只有消费者读写
+
+  alignas(SPSC_CACHE_LINE) std::atomic<uint64_t> head_{0};
+  std::atomic<uint32_t> overflow_{0};
+  std::atomic<uint32_t> silence_{0};
+  alignas(SPSC_CACHE_LINE) std::atomic<uint64_t> tail_{0};
+  std::atomic<uint32_t> underruns_{0};
+  std::atomic<uint32_t> catchup_{0};
+
+  SpscQueue<JitterMark, 1024> marks_;
+  alignas(SPSC_CACHE_LINE) int16_t buf_[N];
+};
@@ -0,0 +1,137 @@
+// =================================================
+// 回环延迟探测主机测试（lib/audio_dsp/latency_probe.h）
+//
+//   ./latency_bench
+//
+// 和固件一样的参数（LATENCY_CAL_CHIRP 4096、LATENCY_CAL_MAX_DELAY 4096，44.1 kHz），8 样本一块：
+//   arm() → 每块 process(mic, spk) → analyze()，麦克风 = 之前播出的 spk 经分数延迟（加窗 sinc 插值）
+//   衰减 26 dB 的回声 + 白噪声
+// 精度：几组分数延迟（48 ~ 4000 样本）× 回声 SNR（20 / 0 / -10 dB），
+//       要求 valid 且 |误差| ≤ 0.25 样本（-10 dB 放宽到 0.5），打印误差和 confidence
+// 多径：主回声后 3 ms 加一条 -12 dB 的反射，要测到主回声（confidence 是主峰 / 最大旁瓣，
+//       -6 dB 的反射会让它掉到 2，按设计判为不可信）
+// 置信度门限：没有回声（只有噪声）时 10 个种子都必须 valid = false，打印最大 confidence；
+//            回声 SNR -30 dB 时打印 confidence（低于门限时不给结果，高于门限时结果要对）
+// 返回值：0 全部通过，1 有断言失败
+// =================================================
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+#include "latency_probe.h"
+
+static const double kPi = 3.14159265358979323846;
+static const int kRate  = 44100;
+static const int kBlock = 8;
+static const int kChirp = 4096;
+static const int kMaxDelay = 4096;
+static const int kHalf  = 32;          // sinc 插值半长
+static const double kEcho = 0.05;      // 回声幅度（-26 dB）
+
+static uint32_t g_seed = 1;
+static double uniform() {
+  g_seed = g_seed * 1664525u + 1013904223u;
+  return (g_seed >> 8) / 16777216.0;
+}
+static double gauss() {
+  const double u1 = uniform() + 1e-9, u2 = uniform();
+  return sqrt(-2 * log(u1)) * cos(2 * kPi * u2);
+}
+
+static int16_t clip16(double v) { return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : lrint(v))); }
+
+// spk 在时刻 t（可以是分数）的带限插值，Blackman 窗 sinc
+static double interp(const std::vector<int16_t>& spk, double t) {
+  const int c = (int)floor(t);
+  double acc = 0;
+  for (int j = c - kHalf + 1; j <= c + kHalf; j++) {
+    if (j < 0 || j >= (int)spk.size()) continue;
+    const double x = t - j;
+    const double sinc = fabs(x) < 1e-12 ? 1.0 : sin(kPi * x) / (kPi * x);
+    const double u = (x + kHalf) / (2.0 * kHalf);
+    const double w = 0.42 - 0.5 * cos(2 * kPi * u) + 0.08 * cos(4 * kPi * u);
+    acc += spk[j] * sinc * w;
+  }
+  return acc;
+}
+
+struct Path {
+  double delay;
+  double gain;
+};
+
+// snr_db 是噪声相对 -26 dB 扫频回声 RMS 的比；paths 为空时只有噪声
+static LatencyResult run(const std::vector<Path>& paths, double snr_db, uint32_t seed) {
+  LatencyProbe probe(kRate, kChirp, kMaxDelay);
+  double chirp_rms = 0;
+  for (int i = 0; i < kChirp; i++) chirp_rms += (double)probe.chirp()[i] * probe.chirp()[i];
+  chirp_rms = sqrt(chirp_rms / kChirp);
+  const double noise = kEcho * chirp_rms * pow(10, -snr_db / 20);
+
+  g_seed = seed;
+  std::vector<int16_t> spk;
+  int16_t mic[kBlock], out[kBlock];
+  if (!probe.arm()) return LatencyResult{false, 0, 0, 0};
+  for (int pos = 0; probe.state() != LatencyProbe::CAPTURED; pos += kBlock) {
+    for (int i = 0; i < kBlock; i++) {
+      double v = noise * gauss();
+      for (const Path& p : paths) v += p.gain * interp(spk, pos + i - p.delay);
+      mic[i] = clip16(v);
+    }
+    if (!probe.process(mic, out, kBlock)) break;
+    spk.insert(spk.end(), out, out + kBlock);
+  }
+  return probe.analyze();
+}
+
+int main() {
+  bool ok = true;
+
+  printf("精度（扫频 %d 样本，%d 样本一块，回声 -26 dB）：\n", kChirp, kBlock);
+  const double delays[] = {48.0, 100.25, 777.5, 1234.75, 2500.1, 3999.66};
+  const double snrs[]   = {20, 0, -10};
+  double worst[3] = {0, 0, 0};
+  uint32_t seed = 1;
+  for (int s = 0; s < 3; s++) {
+    for (double d : delays) {
+      const LatencyResult r = run({{d, kEcho}}, snrs[s], seed++);
+      const double err = r.delay_samples - d;
+      const double lim = snrs[s] < 0 ? 0.5 : 0.25;
+      const bool pass = r.valid && fabs(err) <= lim;
+      worst[s] = fmax(worst[s], fabs(err));
+      printf("  SNR %+3.0f dB  延迟 %8.2f：测得 %8.2f（误差 %+.3f）confidence %6.1f  %s\n", snrs[s], d,
+             r.delay_samples, err, r.confidence, pass ? "通过" : "失败！");
+      ok &= pass;
+    }
+  }
+  printf("  最大误差：SNR 20 dB %.3f、0 dB %.3f、-10 dB %.3f 样本\n\n", worst[0], worst[1], worst[2]);
+
+  {
+    const LatencyResult r = run({{700.4, kEcho}, {700.4 + kRate * 0.003, kEcho / 4}}, 20, seed++);
+    const bool pass = r.valid && fabs(r.delay_samples - 700.4) <= 0.25;
+    printf("多径（700.4 + 3 ms 后 -12 dB 反射）：测得 %.2f，confidence %.1f  %s\n\n", r.delay_samples,
+           r.confidence, pass ? "通过" : "失败！");
+    ok &= pass;
+  }
+
+  {
+    float max_conf = 0;
+    int false_valid = 0;
+    for (uint32_t s = 0; s < 10; s++) {
+      const LatencyResult r = run({}, 0, 1000 + s);
+      max_conf = fmaxf(max_conf, r.confidence);
+      false_valid += r.valid;
+    }
+    printf("没有回声（10 个种子）：valid %d 次，最大 confidence %.2f（门限 3）  %s\n", false_valid, max_conf,
+           false_valid == 0 ? "通过" : "误报！");
+    ok &= false_valid == 0;
+
+    const LatencyResult r = run({{1500.5, kEcho}}, -30, seed++);
+    const bool pass = !r.valid || fabs(r.delay_samples - 1500.5) <= 1.0;
+    printf("回声 SNR -30 dB：valid %d，测得 %.2f，confidence %.2f  %s\n", r.valid, r.delay_samples, r.confidence,
+           pass ? "通过" : "给出了错误结果！");
+    ok &= pass;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,163 @@
+#include "pcm_sink.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <time.h>
+
+#if HAVE_ALSA
+#include <alsa/asoundlib.h>
+#endif
+
+uint64_t mono_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// =================================================
+// null
+// =================================================
+class NullSink : public PcmSink {
+ public:
+  NullSink(unsigned rate, unsigned period, unsigned periods, bool paced)
+      : rate_(rate), buffer_((uint64_t)period * periods), paced_(paced) {}
+
+  bool write(const int16_t*, size_t frames) override {
+    if (!paced_) return true;
+    const uint64_t now = mono_ns();
+    if (written_ == 0) start_ns_ = now;
+    // 缓冲里放不下就睡到“声卡”播掉足够多样本
+    const uint64_t need = written_ + frames > buffer_ ? written_ + frames - buffer_ : 0;
+    if (played(now) < need) {
+      const uint64_t wake = start_ns_ + (need * 1000000000ull + rate_ - 1) / rate_;
+      struct timespec ts = {(time_t)(wake / 1000000000ull), (long)(wake % 1000000000ull)};
+      while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+      }
+    }
+    // 写晚了（缓冲已经放空）就是欠载：模拟声卡从现在重新开始
+    if (written_ > 0 && played(mono_ns()) > written_) {
+      xruns_++;
+      start_ns_ = mono_ns();
+      written_  = 0;
+    }
+    written_ += frames;
+    return true;
+  }
+
+  long delay_frames() override {
+    if (!paced_ || written_ == 0) return 0;
+    const uint64_t p = played(mono_ns());
+    return p >= written_ ? 0 : (long)(written_ - p);
+  }
+
+  uint32_t xruns() const override { return xruns_; }
+
+ private:
+  uint64_t played(uint64_t now) const { return (now - start_ns_) * rate_ / 1000000000ull; }
+
+  const uint64_t rate_, buffer_;
+  const bool paced_;
+  uint64_t start_ns_ = 0;
+  uint64_t written_  = 0;
+  uint32_t xruns_    = 0;
+};
+
+PcmSink* pcm_sink_open_null(unsigned rate, unsigned period, unsigned periods, bool paced) {
+  return new NullSink(rate, period, periods, paced);
+}
+
+// =================================================
+// ALSA
+// =================================================
+#if HAVE_ALSA
+
+class AlsaSink : public PcmSink {
+ public:
+  explicit AlsaSink(snd_pcm_t* pcm) : pcm_(pcm) {}
+  ~AlsaSink() override {
+    snd_pcm_drain(pcm_);
+    snd_pcm_close(pcm_);
+  }
+
+  bool write(const int16_t* pcm, size_t frames) override {
+    while (frames > 0) {
+      snd_pcm_sframes_t n = snd_pcm_writei(pcm_, pcm, frames);
+      if (n == -EAGAIN) continue;
+      if (n < 0) {
+        if (n == -EPIPE) xruns_++;
+        if (snd_pcm_recover(pcm_, (int)n, 1) < 0) {
+          fprintf(stderr, "ALSA 写失败: %s\n", snd_strerror((int)n));
+          return false;
+        }
+        continue;
+      }
+      pcm    += n;
+      frames -= (size_t)n;
+    }
+    return true;
+  }
+
+  long delay_frames() override {
+    snd_pcm_sframes_t d = 0;
+    return snd_pcm_delay(pcm_, &d) == 0 && d > 0 ? (long)d : 0;
+  }
+
+  uint32_t xruns() const override { return xruns_; }
+
+ private:
+  snd_pcm_t* pcm_;
+  uint32_t xruns_ = 0;
+};
+
+PcmSink* pcm_sink_open_alsa(const char* device, unsigned rate, unsigned period, unsigned periods) {
+  snd_pcm_t* pcm = NULL;
+  int err = snd_pcm_open(&pcm, device, SND_PCM_STREAM_PLAYBACK, 0);
+  if (err < 0) {
+    fprintf(stderr, "打开 ALSA 设备 %s 失败: %s\n", device, snd_strerror(err));
+    return nullptr;
+  }
+
+  snd_pcm_hw_params_t* hw;
+  snd_pcm_hw_params_alloca(&hw);
+  snd_pcm_uframes_t period_size = period;
+  snd_pcm_uframes_t buffer_size = (snd_pcm_uframes_t)period * periods;
+  unsigned rate_near = rate;
+  if ((err = snd_pcm_hw_params_any(pcm, hw)) < 0 ||
+      (err = snd_pcm_hw_params_set_access(pcm, hw, SND_PCM_ACCESS_RW_INTERLEAVED)) < 0 ||
+      (err = snd_pcm_hw_params_set_format(pcm, hw, SND_PCM_FORMAT_S16_LE)) < 0 ||
+      (err = snd_pcm_hw_params_set_channels(pcm, hw, 1)) < 0 ||
+      (err = snd_pcm_hw_params_set_rate_near(pcm, hw, &rate_near, NULL)) < 0 ||
+      (err = snd_pcm_hw_params_set_period_size_near(pcm, hw, &period_size, NULL)) < 0 ||
+      (err = snd_pcm_hw_params_set_buffer_size_near(pcm, hw, &buffer_size)) < 0 ||
+      (err = snd_pcm_hw_params(pcm, hw)) < 0) {
+    fprintf(stderr, "配置 ALSA 设备 %s 失败: %s\n", device, snd_strerror(err));
+    snd_pcm_close(pcm);
+    return nullptr;
+  }
+
+  // 缓冲里攒够一个周期就开始播（默认要等整个缓冲满，白白多一截延迟）
+  snd_pcm_sw_params_t* sw;
+  snd_pcm_sw_params_alloca(&sw);
+  if ((err = snd_pcm_sw_params_current(pcm, sw)) < 0 ||
+      (err = snd_pcm_sw_params_set_start_threshold(pcm, sw, period_size)) < 0 ||
+      (err = snd_pcm_sw_params_set_avail_min(pcm, sw, period_size)) < 0 ||
+      (err = snd_pcm_sw_params(pcm, sw)) < 0) {
+    fprintf(stderr, "配置 ALSA 软件参数失败: %s\n", snd_strerror(err));
+    snd_pcm_close(pcm);
+    return nullptr;
+  }
+
+  if (rate_near != rate || period_size != period || buffer_size != (snd_pcm_uframes_t)period * periods)
+    fprintf(stderr, "ALSA 实际配置: %u Hz，周期 %lu，缓冲 %lu\n", rate_near,
+            (unsigned long)period_size, (unsigned long)buffer_size);
+  return new AlsaSink(pcm);
+}
+
+#else
+
+PcmSink* pcm_sink_open_alsa(const char*, unsigned, unsigned, unsigned) {
+  fprintf(stderr, "编译时没有 libasound，只能用 --null\n");
+  return nullptr;
+}
+
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+// =================================================
+// 主机播放器的输出端：单声道 int16，一次写一个周期
+//   ALSA（编译时有 libasound 才有，-DHAVE_ALSA）：按周期大小 / 周期数配置硬件缓冲，阻塞写，欠载自动恢复
+//   null：不出声。paced 时按采样率模拟一块同样配置的声卡（缓冲满了就睡到有空位），
+//         用来在 CI 里测延迟；不 paced 时写了就返回，测吞吐
+// =================================================
+
+#include <stddef.h>
+#include <stdint.h>
+
+class PcmSink {
+ public:
+  virtual ~PcmSink() {}
+
+  // 写 frames 个样本，缓冲满时阻塞；出错返回 false
+  virtual bool write(const int16_t* pcm, size_t frames) = 0;
+
+  // 已写入、还没播出去的样本数（估计播出时刻用）
+  virtual long delay_frames() = 0;
+
+  // 设备端欠载次数（ALSA 的 xrun）
+  virtual uint32_t xruns() const = 0;
+};
+
+// period：每周期样本数，periods：硬件缓冲的周期数；失败返回 nullptr 并打印原因
+PcmSink* pcm_sink_open_alsa(const char* device, unsigned rate, unsigned period, unsigned periods);
+PcmSink* pcm_sink_open_null(unsigned rate, unsigned period, unsigned periods, bool paced);
+
+// CLOCK_MONOTONIC 纳秒
+uint64_t mono_ns();
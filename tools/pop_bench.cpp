@@ -0,0 +1,214 @@
+// =================================================
+// 爆音保护主机测试（lib/audio_dsp/pop_guard.h）
+//
+//   ./pop_bench
+//
+// 和固件一样按 8 样本一块喂（44.1 kHz）
+//   注入：-20 dBFS 类语音（1 kHz 音节，见 agc_bench）上每隔 1 s 注入一种爆音：
+//         单样本尖峰、一块 DMA 垃圾（满量程随机）、10 ms 直流台阶、20 ms 饱和正弦（3 倍满量程削顶）、
+//         拔插式半个满量程方波（5 ms）
+//         每种打印：是否检测到、从注入到输出归零的样本数、注入区间内输出峰值（相对注入前的信号峰值）、静音时长
+//   启动：开头是衰减的 20000 直流台阶 + 噪声，打印启动静音期间的输出峰值
+//   误报：各 5 s 的干净信号（类语音 -10 dBFS、-1 dBFS 1 kHz、-6 dBFS 8 kHz、-10 dBFS 白噪声）
+//         打印启动之后的触发次数；再加一个从静音突然开始的 -6 dBFS 6 kHz 正弦，打印触发次数和恢复时间
+// 最后打印 cycles/样本
+// =================================================
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "cycle_clock.h"
+#include "pop_guard.h"
+
+static const double kPi = 3.14159265358979323846;
+static const int kRate  = 44100;
+static const int kBlock = 8;
+
+static uint64_t g_cycles = 0, g_samples = 0;
+
+static std::vector<int16_t> run(PopGuard& g, const std::vector<int16_t>& in) {
+  std::vector<int16_t> out(in.size());
+  for (size_t pos = 0; pos < in.size(); pos += kBlock) {
+    const int n = in.size() - pos < (size_t)kBlock ? (int)(in.size() - pos) : kBlock;
+    const uint32_t c0 = cycle_now();
+    g.process(in.data() + pos, out.data() + pos, n);
+    g_cycles += cycle_now() - c0;
+  }
+  g_samples += in.size();
+  return out;
+}
+
+static uint32_t g_seed = 1;
+static double uniform() {
+  g_seed = g_seed * 1664525u + 1013904223u;
+  return (g_seed >> 8) / 16777216.0;
+}
+static double gauss() {
+  const double u1 = uniform() + 1e-9, u2 = uniform();
+  return sqrt(-2 * log(u1)) * cos(2 * kPi * u2);
+}
+
+static int16_t clip16(double v) {
+  return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : lrint(v)));
+}
+
+// 1 kHz 音节（250 ms 一个，180 ms sin² 包络），-70 dBFS 底噪；电平是整段 RMS
+static std::vector<double> speechy(size_t n, double dbfs) {
+  std::vector<double> v(n);
+  double sum = 0;
+  for (size_t i = 0; i < n; i++) {
+    const double t = fmod((double)i / kRate, 0.25);
+    const double env = t < 0.18 ? pow(sin(kPi * t / 0.18), 2) : 0;
+    v[i] = env * sin(2 * kPi * 1000 * i / kRate);
+    sum += v[i] * v[i];
+  }
+  const double gain = 32768.0 * pow(10, dbfs / 20) / sqrt(sum / n);
+  const double bed  = 32768.0 * pow(10, -70 / 20.0);
+  for (size_t i = 0; i < n; i++) v[i] = gain * v[i] + bed * gauss();
+  return v;
+}
+
+static std::vector<int16_t> to16(const std::vector<double>& v) {
+  std::vector<int16_t> x(v.size());
+  for (size_t i = 0; i < v.size(); i++) x[i] = clip16(v[i]);
+  return x;
+}
+
+static int32_t peak(const std::vector<int16_t>& x, size_t a, size_t b) {
+  int32_t p = 0;
+  for (size_t i = a; i < b && i < x.size(); i++) p = abs(x[i]) > p ? abs(x[i]) : p;
+  return p;
+}
+
+static double db(double r) { return 20 * log10(r + 1e-9); }
+
+int main() {
+  printf("跳变门限 max(%d, %d × 平均差分)，饱和 %d 个 ≥ %d，保持 %d ms，淡入 %d ms，启动静音 %d ms\n\n",
+         POP_JUMP_MIN, POP_JUMP_RATIO, POP_CLIP_SAMPLES, POP_CLIP_LEVEL, POP_HOLD_MS, POP_RAMP_MS,
+         POP_STARTUP_MS);
+
+  // ---------- 注入 ----------
+  {
+    static const char* const kNames[] = {"单样本尖峰", "DMA 垃圾块", "直流台阶 10 ms", "饱和 20 ms",
+                                         "半量程方波 5 ms"};
+    const int kinds = 5;
+    const size_t n = (size_t)kRate * (kinds + 2);
+    std::vector<double> v = speechy(n, -20);
+    std::vector<size_t> at(kinds), len(kinds);
+    for (int k = 0; k < kinds; k++) {
+      // 故意不对齐到块边界
+      const size_t p = (size_t)kRate * (k + 1) + 60 + 3 * k;
+      at[k] = p;
+      switch (k) {
+        case 0:
+          len[k] = 1;
+          v[p] = 32767;
+          break;
+        case 1:
+          len[k] = 128;
+          for (size_t i = 0; i < len[k]; i++) v[p + i] = (uniform() * 2 - 1) * 32768;
+          break;
+        case 2:
+          len[k] = kRate / 100;
+          for (size_t i = 0; i < len[k]; i++) v[p + i] += 15000;
+          break;
+        case 3:
+          len[k] = kRate / 50;
+          for (size_t i = 0; i < len[k]; i++) v[p + i] = 3 * 32768 * sin(2 * kPi * 300 * i / kRate);
+          break;
+        case 4:
+          len[k] = kRate / 200;
+          for (size_t i = 0; i < len[k]; i++) v[p + i] = (i / 22) % 2 ? -16384 : 16384;
+          break;
+      }
+    }
+    const std::vector<int16_t> in = to16(v);
+    PopGuard g(kRate);
+    const std::vector<int16_t> out = run(g, in);
+
+    printf("注入（-20 dBFS 类语音底）：共检测 %u 次（跳变 %u，饱和 %u）\n", g.stats().events,
+           g.stats().jumps, g.stats().clips);
+    for (int k = 0; k < kinds; k++) {
+      const size_t p = at[k];
+      // 归零：注入点之后第一段连续 16 个 0 的开头；静音时长到这段 0 结束
+      size_t zero = p, end = p;
+      for (; zero < p + len[k] + kRate / 10; zero = end + 1) {
+        end = zero;
+        while (end < out.size() && out[end] == 0) end++;
+        if (end - zero >= 16) break;
+      }
+      const int32_t ref = peak(in, p - kRate / 4, p);
+      const int32_t leak = peak(out, p, p + len[k]);
+      printf("  %-16s 归零延迟 %3zu 样本，注入区间输出峰值 %6.1f dB（相对注入前），静音 %5.1f ms\n",
+             kNames[k], zero - p, db((double)leak / ref), (end - zero) * 1000.0 / kRate);
+    }
+    printf("\n");
+  }
+
+  // ---------- 启动 ----------
+  {
+    const size_t n = (size_t)kRate;
+    std::vector<double> v = speechy(n, -20);
+    for (size_t i = 0; i < n; i++)
+      v[i] += 20000 * exp(-(double)i / (kRate * 0.02)) + 3000 * gauss() * exp(-(double)i / (kRate * 0.01));
+    const std::vector<int16_t> in = to16(v);
+    PopGuard g(kRate);
+    const std::vector<int16_t> out = run(g, in);
+    const size_t startup = (size_t)kRate * POP_STARTUP_MS / 1000;
+    printf("启动（衰减直流台阶 + 噪声）：输入峰值 %.1f dBFS，启动静音内输出峰值 %d，之后触发 %u 次\n\n",
+           db(peak(in, 0, startup) / 32768.0), peak(out, 0, startup), g.stats().events);
+  }
+
+  // ---------- 误报 ----------
+  {
+    printf("误报（干净信号 5 s）\n");
+    const size_t n = (size_t)kRate * 5;
+    for (int k = 0; k < 4; k++) {
+      std::vector<double> v;
+      const char* name = "";
+      switch (k) {
+        case 0:
+          v = speechy(n, -10);
+          name = "类语音 -10 dBFS";
+          break;
+        case 1:
+        case 2: {
+          const double f = k == 1 ? 1000 : 8000, a = 32768 * pow(10, (k == 1 ? -1 : -6) / 20.0);
+          v.resize(n);
+          for (size_t i = 0; i < n; i++) v[i] = a * sin(2 * kPi * f * i / kRate);
+          name = k == 1 ? "1 kHz 峰值 -1 dBFS" : "8 kHz 峰值 -6 dBFS";
+          break;
+        }
+        case 3:
+          v.resize(n);
+          for (size_t i = 0; i < n; i++) v[i] = 32768 * pow(10, -10 / 20.0) * gauss();
+          name = "白噪声 -10 dBFS";
+          break;
+      }
+      PopGuard g(kRate);
+      run(g, to16(v));
+      printf("  %-20s 触发 %u 次\n", name, g.stats().events);
+    }
+
+    // 静音里突然开始的高频大信号：第一下像台阶，会触发一次，平均差分跟上之后放行
+    std::vector<double> v(n, 0.0);
+    const size_t onset = (size_t)kRate;
+    for (size_t i = onset; i < n; i++) v[i] = 32768 * 0.5 * sin(2 * kPi * 6000 * (i - onset) / kRate + 1.0);
+    PopGuard g(kRate);
+    const std::vector<int16_t> out = run(g, to16(v));
+    size_t back = out.size();
+    for (size_t i = out.size(); i-- > onset;) {
+      if (abs(out[i]) < 100 && abs((int)lrint(v[i])) > 8000) {
+        back = i + 1;
+        break;
+      }
+    }
+    printf("  %-20s 触发 %u 次，%.1f ms 后恢复直通\n\n", "突发 6 kHz -6 dBFS", g.stats().events,
+           back < out.size() ? (back - onset) * 1000.0 / kRate : 0.0);
+  }
+
+  printf("%.1f cycles/样本（周期按 %d MHz 计）\n", (double)g_cycles / g_samples, CYCLE_CLOCK_HOST_MHZ);
+  return 0;
+}
@@ -0,0 +1,150 @@
+// =================================================
+// 重采样器主机基准（lib/audio_dsp/resampler.h）
+//
+//   ./resample_bench                 # 44100 → 48000 和 48000 → 44100，FIXED 和 ARBITRARY 都测
+//   ./resample_bench 48000 16000     # 任意 in / out
+//
+// 每种模式打印：
+//   - 速度：每输出样本 cycles（lib/telemetry/cycle_clock.h，主机按 CYCLE_CLOCK_HOST_MHZ 计），按块调用
+//   - THD+N：-1 dBFS 正弦过一遍，在输出上按已知频率做最小二乘正弦拟合，
+//     残差（谐波 + 噪声 + 混叠）对信号的比值，扫几个通带内频率；1 ~ 10 kHz 上限 -75 dB
+//   - 阻带（降采样时）：输入、输出两个 Nyquist 中点处（48000 → 44100 时约 23 kHz）的正弦
+//     过完还剩多少，上限 -70 dB
+// 返回值：0 全部通过，1 有断言失败
+// =================================================
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "cycle_clock.h"
+#include "resampler.h"
+
+static const double kPi = 3.14159265358979323846;
+static const int kBlock = 64;   // 和固件 BUFFER_SAMPLES 量级一致
+static const double kMaxThdnDb     = -75;   // 1 ~ 10 kHz
+static const double kMaxStopbandDb = -70;
+
+static std::vector<int16_t> run(Resampler& rs, const std::vector<int16_t>& in) {
+  rs.reset();
+  std::vector<int16_t> out;
+  std::vector<int16_t> tmp(rs.max_output(kBlock));
+  for (size_t i = 0; i < in.size(); i += kBlock) {
+    const int n = (int)(in.size() - i < (size_t)kBlock ? in.size() - i : kBlock);
+    const int m = rs.process(in.data() + i, n, tmp.data());
+    out.insert(out.end(), tmp.begin(), tmp.begin() + m);
+  }
+  return out;
+}
+
+// 1 s 的 -1 dBFS 正弦
+static std::vector<int16_t> sine(uint32_t fs, double f) {
+  std::vector<int16_t> v(fs);
+  for (size_t i = 0; i < v.size(); i++)
+    v[i] = (int16_t)lrint(0.89 * 32767 * sin(2 * kPi * f * i / fs));
+  return v;
+}
+
+// 输出上拟合 a·cos + b·sin + c，返回 THD+N（dB）
+static double thdn_db(const std::vector<int16_t>& y, double f, double fs, size_t skip) {
+  const double w = 2 * kPi * f / fs;
+  double scc = 0, sss = 0, ssc = 0, sc = 0, ss = 0, syc = 0, sys = 0, sy = 0, n = 0;
+  for (size_t i = skip; i < y.size(); i++) {
+    const double c = cos(w * i), s = sin(w * i), v = y[i];
+    scc += c * c; sss += s * s; ssc += s * c; sc += c; ss += s;
+    syc += v * c; sys += v * s; sy += v; n += 1;
+  }
+  // 3×3 正规方程
+  double A[3][4] = {{scc, ssc, sc, syc}, {ssc, sss, ss, sys}, {sc, ss, n, sy}};
+  for (int k = 0; k < 3; k++) {
+    for (int r = k + 1; r < 3; r++) {
+      const double m = A[r][k] / A[k][k];
+      for (int j = k; j < 4; j++) A[r][j] -= m * A[k][j];
+    }
+  }
+  double x[3];
+  for (int k = 2; k >= 0; k--) {
+    double v = A[k][3];
+    for (int j = k + 1; j < 3; j++) v -= A[k][j] * x[j];
+    x[k] = v / A[k][k];
+  }
+  double sig = 0, res = 0;
+  for (size_t i = skip; i < y.size(); i++) {
+    const double fit = x[0] * cos(w * i) + x[1] * sin(w * i);
+    const double e = y[i] - fit - x[2];
+    sig += fit * fit;
+    res += e * e;
+  }
+  return 10 * log10(res / sig);
+}
+
+// 返回是否通过
+static bool bench(uint32_t in_rate, uint32_t out_rate, Resampler::Mode mode, const char* name) {
+  Resampler rs(in_rate, out_rate, mode);
+  if (rs.mode() != mode) {
+    printf("%-9s  不支持 %u:%u（L > %d）\n", name, in_rate, out_rate, RESAMPLE_MAX_PHASES);
+    return true;
+  }
+  bool ok = true;
+
+  // ---------- 速度：10 s 白噪声 ----------
+  std::vector<int16_t> noise(in_rate * 10);
+  srand(1);
+  for (auto& v : noise) v = (int16_t)((rand() & 0xFFFF) - 32768) / 4;
+  std::vector<int16_t> tmp(rs.max_output(kBlock));
+  size_t produced = 0;
+  const uint32_t c0 = cycle_now();
+  for (size_t i = 0; i + kBlock <= noise.size(); i += kBlock)
+    produced += rs.process(noise.data() + i, kBlock, tmp.data());
+  const uint32_t cycles = cycle_now() - c0;
+  const double ns = cycles * 1000.0 / CYCLE_CLOCK_HOST_MHZ;
+  printf("%-9s  %u 相  %.1f cycles/输出样本（按 %d MHz 计）  实时 %.0f×\n",
+         name, rs.phases(), (double)cycles / produced, CYCLE_CLOCK_HOST_MHZ, 10e9 / ns);
+
+  // ---------- THD+N（通带内）----------
+  const double fmin_rate = in_rate < out_rate ? in_rate : out_rate;
+  const double freqs[] = {100, 1000, 5000, 10000, 0.4 * fmin_rate};
+  printf("           THD+N:");
+  for (double f : freqs) {
+    if (f > 0.4 * fmin_rate) continue;
+    const double db = thdn_db(run(rs, sine(in_rate, f)), f, out_rate, out_rate / 10);
+    const bool bad = f >= 1000 && f <= 10000 && db > kMaxThdnDb;
+    printf("  %.0f Hz %.1f dB%s", f, db, bad ? "（超限！）" : "");
+    ok &= !bad;
+  }
+  printf("\n");
+
+  // ---------- 阻带（降采样时）：输出 Nyquist 以上的输入应当被滤掉，不混叠回来 ----------
+  if (out_rate < in_rate) {
+    const double f = 0.25 * (out_rate + in_rate);   // 两个 Nyquist 的中点
+    const std::vector<int16_t> y = run(rs, sine(in_rate, f));
+    double e = 0;
+    for (size_t i = out_rate / 10; i < y.size(); i++) e += (double)y[i] * y[i];
+    e /= y.size() - out_rate / 10;
+    const double db = 10 * log10(e / (0.5 * 0.89 * 32767 * 0.89 * 32767));
+    printf("           阻带: %.0f Hz 输入 → 输出 %.1f dB（相对输入，上限 %.0f）%s\n", f, db,
+           kMaxStopbandDb, db > kMaxStopbandDb ? "  超限！" : "");
+    ok &= db <= kMaxStopbandDb;
+  }
+  return ok;
+}
+
+static bool bench_pair(uint32_t in_rate, uint32_t out_rate) {
+  printf("%u → %u，每相 %d 抽头，块长 %d\n", in_rate, out_rate, RESAMPLE_TAPS, kBlock);
+  bool ok = bench(in_rate, out_rate, Resampler::FIXED, "FIXED");
+  ok &= bench(in_rate, out_rate, Resampler::ARBITRARY, "ARBITRARY");
+  return ok;
+}
+
+int main(int argc, char** argv) {
+  bool ok;
+  if (argc >= 3) {
+    ok = bench_pair((uint32_t)atoi(argv[1]), (uint32_t)atoi(argv[2]));
+  } else {
+    ok = bench_pair(44100, 48000);
+    ok &= bench_pair(48000, 44100);   // 阻带：23 kHz 不能混叠回通带
+  }
+  printf("%s\n", ok ? "全部通过" : "有断言失败");
+  return ok ? 0 : 1;
+}
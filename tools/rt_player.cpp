@@ -0,0 +1,383 @@
+// =================================================
+// 低延迟实时收听（Linux），替代 listen_realtime.py
+//
+//   ./rt_player /dev/ttyUSB0                          # ALSA default，周期 256，2 个周期，目标缓冲 20 ms
+//   ./rt_player /dev/ttyUSB0 -p 128 -n 3 -t 10 -D hw:1,0
+//   ./rt_player --loopback --null -s 10               # 板子替身 + 按实时节奏的 null 输出：测延迟（CI 用）
+//   ./rt_player --loopback --null --fast -s 5         # 替身全速发、null 不限速：测吞吐
+//
+// 线程：
+//   I/O 线程   阻塞 read 串口 → FrameDecoder → 解码（PCM16 / ADPCM / µ-law）→ 抖动缓冲（jitter_buffer.h）
+//              按音频帧 seq 的缺口补静音，保持后面的时间位置
+//   播放线程   每次从抖动缓冲取一个周期写给 PcmSink（pcm_sink.h），尽量拿 SCHED_FIFO
+//   主线程     每秒打印一行统计到 stderr
+// 延迟：每帧第一个样本记下到达时刻，播出时刻 = 写入时刻 + 声卡里还没播的样本，
+//   “缓冲延迟”是两者之差（串口到达 → 出声）；--loopback 时替身用同一个单调时钟打时间戳，
+//   再加一项“端到端”（替身“采集”→ 出声，包括 pty 传输和帧拼装）
+// 只收 FRAMED 模式的音频帧；采样率帧里没有，用 -r 指定（默认 UPLINK_SAMPLE_RATE 48000）
+// 运行到 -s 秒或 Ctrl-C，最后打印整段的汇总；没收到任何音频返回 1
+// =================================================
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <thread>
+
+#include "adpcm.h"
+#include "frame_decoder.h"
+#include "jitter_buffer.h"
+#include "latency_hist.h"
+#include "pcm_sink.h"
+#include "serial_port.h"
+
+static const size_t kRing = 1 << 16;   // 48 kHz 下 1.37 s
+
+struct Options {
+  const char* port   = nullptr;
+  const char* device = "default";
+  int baud           = 1500000;
+  unsigned rate      = 48000;
+  unsigned period    = 256;
+  unsigned periods   = 2;
+  double target_ms   = 20;
+  double slack_ms    = 40;
+  double seconds     = 0;
+  bool null_sink     = false;
+  bool fast          = false;
+  bool loopback      = false;
+  double jitter_ms   = 0;
+};
+
+static Options opt;
+static std::atomic<bool> running{true};
+static JitterBuffer<kRing>* jb;
+
+// I/O 线程写、主线程读
+static std::atomic<uint64_t> rx_bytes{0};
+static std::atomic<uint64_t> rx_samples{0};
+
+// 播放线程写、主线程读
+static LatencyHistogram buf_hist, e2e_hist;   // 每秒窗口（微秒）
+static LatencyHistogram buf_total, e2e_total;  // 整段（只在最后读一次）
+static std::atomic<uint64_t> played{0};
+
+static void on_signal(int) { running = false; }
+
+// =================================================
+// 板子替身：pty 主端按 FRAMED 格式发 440 Hz 正弦（PCM16，每帧 256 样本）
+// 时间戳用本机 CLOCK_MONOTONIC 的微秒；每帧发送时刻加 [0, jitter] 的随机延迟，模拟 USB 转串口成批到达
+// =================================================
+static void standin_thread(int master) {
+  static const size_t kFrame = 256;
+  int16_t pcm[kFrame];
+  uint8_t frame[FRAME_MAX_SIZE];
+  uint16_t seq = 0;
+  uint64_t n = 0;
+  uint32_t rnd = 1;
+  const uint64_t t0 = mono_ns();
+
+  while (running) {
+    const uint64_t t_capture = t0 + n * 1000000000ull / opt.rate;
+    const uint64_t t_ready   = t0 + (n + kFrame) * 1000000000ull / opt.rate;
+    if (!opt.fast) {
+      rnd = rnd * 1664525u + 1013904223u;
+      const uint64_t jitter = (uint64_t)(opt.jitter_ms * 1e6 * (rnd >> 8) / 16777216.0);
+      const uint64_t wake = t_ready + jitter;
+      struct timespec ts = {(time_t)(wake / 1000000000ull), (long)(wake % 1000000000ull)};
+      while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+      }
+    }
+    for (size_t i = 0; i < kFrame; i++)
+      pcm[i] = (int16_t)lrint(8000 * sin(2 * 3.14159265358979 * 440 * (double)(n + i) / opt.rate));
+
+    FrameHeader h = {};
+    h.type      = FRAME_TYPE_AUDIO;
+    h.format    = SAMPLE_FMT_PCM16;
+    h.seq       = seq++;
+    h.length    = kFrame * sizeof(int16_t);
+    h.timestamp = (uint32_t)((opt.fast ? mono_ns() : t_capture) / 1000);
+    h.samples   = kFrame;
+    h.channels  = 1;
+    const size_t len = frame_encode(frame, sizeof(frame), h, (const uint8_t*)pcm);
+    for (size_t off = 0; off < len && running;) {
+      const ssize_t w = write(master, frame + off, len - off);
+      if (w < 0 && errno == EINTR) continue;
+      if (w <= 0) return;
+      off += (size_t)w;
+    }
+    n += kFrame;
+  }
+}
+
+// =================================================
+// I/O 线程
+// =================================================
+struct RxState {
+  uint64_t arrival_ns;
+  bool have_seq;
+  uint16_t last_seq;
+};
+
+static void on_frame(const FrameHeader& h, const uint8_t* payload, void* ctx) {
+  RxState* st = (RxState*)ctx;
+  if (h.type != FRAME_TYPE_AUDIO) return;
+
+  static int16_t pcm[FRAME_MAX_PAYLOAD * 2];
+  size_t n = 0;
+  switch (h.format) {
+    case SAMPLE_FMT_PCM16:
+      n = h.length / sizeof(int16_t);
+      memcpy(pcm, payload, n * sizeof(int16_t));
+      break;
+    case SAMPLE_FMT_ADPCM:
+      n = adpcm_decode_block(payload, h.length, pcm, h.samples);
+      break;
+    case SAMPLE_FMT_ULAW:
+      for (n = 0; n < h.length; n++) pcm[n] = ulaw_decode(payload[n]);
+      break;
+    default:
+      return;
+  }
+
+  // 丢帧补静音（最多补一个目标缓冲的量，断线很久之后不要一上来先放一大段静音）
+  if (st->have_seq) {
+    const uint16_t lost = (uint16_t)(h.seq - st->last_seq - 1);
+    if (lost > 0 && lost < 0x8000) {
+      const size_t fill = (size_t)lost * h.samples;
+      jb->write_silence(fill < jb->target() ? fill : jb->target());
+    }
+  }
+  st->have_seq = true;
+  st->last_seq = h.seq;
+
+  jb->write(pcm, n, st->arrival_ns, h.timestamp);
+  rx_samples.fetch_add(n, std::memory_order_relaxed);
+}
+
+static RxState rx = {};
+static FrameDecoder dec(on_frame, &rx);   // 统计由主线程按快照读
+
+static void io_thread(int fd) {
+  uint8_t buf[4096];
+  // 替身模式读到主端关闭（EIO）为止，免得替身卡在写满的 pty 上
+  while (running || opt.loopback) {
+    const ssize_t n = read(fd, buf, sizeof(buf));
+    if (n < 0 && errno == EINTR) continue;
+    if (n <= 0) break;
+    rx.arrival_ns = mono_ns();
+    rx_bytes.fetch_add((uint64_t)n, std::memory_order_relaxed);
+    dec.push(buf, (size_t)n);
+  }
+  running = false;
+}
+
+// =================================================
+// 播放线程
+// =================================================
+static void record_latency(PcmSink* sink, uint64_t written_ns, size_t n, const JitterMark& m,
+                           long offset) {
+  // 声卡里没播的样本包括刚写的这一周期，这个样本之前还有 delay - (n - offset) 个
+  long ahead = sink->delay_frames() - (long)n + offset;
+  if (ahead < 0) ahead = 0;
+  const uint64_t out_ns = written_ns + (uint64_t)ahead * 1000000000ull / opt.rate;
+  const uint32_t buf_us = (uint32_t)((out_ns - m.arrival_ns) / 1000);
+  buf_hist.record(buf_us);
+  buf_total.record(buf_us);
+  if (opt.loopback) {
+    const uint32_t e2e_us = (uint32_t)(out_ns / 1000) - m.device_us;
+    e2e_hist.record(e2e_us);
+    e2e_total.record(e2e_us);
+  }
+}
+
+static void play_thread(PcmSink* sink) {
+  struct sched_param sp = {};
+  sp.sched_priority = sched_get_priority_min(SCHED_FIFO) + 10;
+  if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &sp) != 0)
+    fprintf(stderr, "拿不到 SCHED_FIFO（需要 CAP_SYS_NICE / rtprio），按普通优先级播放\n");
+
+  static int16_t pcm[kRing / 2];
+  const bool unpaced = opt.null_sink && opt.fast;
+  while (running) {
+    JitterMark m;
+    long offset;
+    size_t n = opt.period;
+    if (unpaced) {
+      n = jb->drain(pcm, sizeof(pcm) / sizeof(pcm[0]), &m, &offset);
+      if (n == 0) {
+        usleep(200);
+        continue;
+      }
+    } else {
+      jb->read(pcm, n, &m, &offset);
+    }
+    if (!sink->write(pcm, n)) break;
+    if (offset >= 0) record_latency(sink, mono_ns(), n, m, offset);
+    played.fetch_add(n, std::memory_order_relaxed);
+  }
+  running = false;
+}
+
+// =================================================
+static void usage(const char* argv0) {
+  fprintf(stderr,
+          "用法: %s <串口设备|--loopback> [选项]\n"
+          "  -b 波特率        默认 1500000\n"
+          "  -r 采样率        默认 48000（要和固件 UPLINK_SAMPLE_RATE 一致）\n"
+          "  -p 周期样本数    默认 256\n"
+          "  -n 周期数        声卡缓冲 = 周期 × 周期数，默认 2\n"
+          "  -t 目标缓冲 ms   抖动缓冲开播 / 追赶到的水位，默认 20\n"
+          "  -S 余量 ms       积压超过 目标 + 余量 时丢老样本，默认 40\n"
+          "  -D ALSA 设备     默认 default\n"
+          "  -s 秒            运行时长，0 = 直到 Ctrl-C\n"
+          "  --null           不出声，按采样率节奏消费（--fast 时不限速）\n"
+          "  --fast           --loopback 替身全速发送，和 --null 一起测吞吐\n"
+          "  --jitter ms      --loopback 替身每帧发送时刻的随机抖动\n",
+          argv0);
+}
+
+static bool parse(int argc, char** argv) {
+  static const struct option kLong[] = {
+      {"null", no_argument, NULL, 'N'},       {"fast", no_argument, NULL, 'F'},
+      {"loopback", no_argument, NULL, 'L'},   {"jitter", required_argument, NULL, 'J'},
+      {"help", no_argument, NULL, 'h'},       {NULL, 0, NULL, 0}};
+  int c;
+  while ((c = getopt_long(argc, argv, "b:r:p:n:t:S:D:s:h", kLong, NULL)) != -1) {
+    switch (c) {
+      case 'b': opt.baud      = atoi(optarg); break;
+      case 'r': opt.rate      = (unsigned)atoi(optarg); break;
+      case 'p': opt.period    = (unsigned)atoi(optarg); break;
+      case 'n': opt.periods   = (unsigned)atoi(optarg); break;
+      case 't': opt.target_ms = atof(optarg); break;
+      case 'S': opt.slack_ms  = atof(optarg); break;
+      case 'D': opt.device    = optarg; break;
+      case 's': opt.seconds   = atof(optarg); break;
+      case 'N': opt.null_sink = true; break;
+      case 'F': opt.fast      = true; break;
+      case 'L': opt.loopback  = true; break;
+      case 'J': opt.jitter_ms = atof(optarg); break;
+      default: return false;
+    }
+  }
+  if (optind < argc) opt.port = argv[optind];
+  if (!opt.port && !opt.loopback) return false;
+  if (opt.rate == 0 || opt.period == 0 || opt.period > kRing / 4 || opt.periods < 2) {
+    fprintf(stderr, "参数不合理：周期 1 ~ %zu，周期数 ≥ 2\n", kRing / 4);
+    return false;
+  }
+  return true;
+}
+
+static void print_hist(const char* name, const HistSummary& s) {
+  if (s.count == 0) return;
+  fprintf(stderr, " %s p50/p99/max=%.1f/%.1f/%.1f ms", name, s.p50 / 1000.0, s.p99 / 1000.0,
+          s.max / 1000.0);
+}
+
+int main(int argc, char** argv) {
+  if (!parse(argc, argv)) {
+    usage(argv[0]);
+    return 2;
+  }
+  signal(SIGINT, on_signal);
+  signal(SIGTERM, on_signal);
+
+  // ---------- 输入：串口或者 pty 替身 ----------
+  int master = -1;
+  const char* path = opt.port;
+  if (opt.loopback) {
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+      fprintf(stderr, "创建 pty 失败: %s\n", strerror(errno));
+      return 1;
+    }
+    path = ptsname(master);
+  }
+  const int fd = open(path, O_RDONLY | O_NOCTTY);
+  if (fd < 0) {
+    fprintf(stderr, "打开 %s 失败: %s\n", path, strerror(errno));
+    return 1;
+  }
+  if (isatty(fd) && !serial_configure(fd, opt.baud)) {
+    fprintf(stderr, "配置串口失败: %s\n", strerror(errno));
+    return 1;
+  }
+
+  // ---------- 输出 ----------
+  PcmSink* sink = opt.null_sink ? pcm_sink_open_null(opt.rate, opt.period, opt.periods, !opt.fast)
+                                : pcm_sink_open_alsa(opt.device, opt.rate, opt.period, opt.periods);
+  if (!sink) return 1;
+
+  static JitterBuffer<kRing> buffer((size_t)(opt.target_ms * opt.rate / 1000),
+                                    (size_t)(opt.slack_ms * opt.rate / 1000));
+  jb = &buffer;
+
+  fprintf(stderr, "%s → %s，%u Hz，周期 %u × %u（%.2f ms），目标缓冲 %.1f ms\n",
+          opt.loopback ? "pty 替身" : path,
+          opt.null_sink ? (opt.fast ? "null（不限速）" : "null") : opt.device, opt.rate,
+          opt.period, opt.periods, 1000.0 * opt.period / opt.rate, opt.target_ms);
+
+  std::thread io(io_thread, fd);
+  std::thread play(play_thread, sink);
+  std::thread standin;
+  if (opt.loopback) standin = std::thread(standin_thread, master);
+
+  // ---------- 统计 ----------
+  const uint64_t t_start = mono_ns();
+  uint64_t last_bytes = 0, last_samples = 0;
+  while (running) {
+    for (int i = 0; i < 10 && running; i++) usleep(100000);
+    const double elapsed = (mono_ns() - t_start) / 1e9;
+    const uint64_t bytes = rx_bytes.load(), samples = rx_samples.load();
+    const JitterStats js = jb->stats();
+    fprintf(stderr, "[%6.1f s] %6.1f KB/s %7llu 样本/s | 缓冲 %5.1f ms | 欠载=%u 溢出=%u 追赶=%u xrun=%u",
+            elapsed, (bytes - last_bytes) / 1024.0, (unsigned long long)(samples - last_samples),
+            1000.0 * jb->level() / opt.rate, js.underruns, js.overflow, js.catchup, sink->xruns());
+    print_hist("缓冲延迟", buf_hist.window());
+    if (opt.loopback) print_hist("端到端", e2e_hist.window());
+    const FrameDecoderStats ds = dec.stats();
+    fprintf(stderr, " | 帧=%u 丢=%u 错=%u", ds.frames, ds.lost_frames, ds.header_errors + ds.crc_errors);
+    fputc('\n', stderr);
+    last_bytes   = bytes;
+    last_samples = samples;
+    if (opt.seconds > 0 && elapsed >= opt.seconds) running = false;
+  }
+
+  // I/O 线程可能正阻塞在 read 里：替身关掉主端它就会返回；真串口直接分离，进程退出时一起结束
+  if (opt.loopback) {
+    if (standin.joinable()) standin.join();
+    close(master);
+  }
+  play.join();
+  if (opt.loopback) io.join();
+  else io.detach();
+
+  const double elapsed = (mono_ns() - t_start) / 1e9;
+  const JitterStats js = jb->stats();
+  fprintf(stderr, "\n==== 汇总（%.1f s）====\n", elapsed);
+  fprintf(stderr, "接收 %.2f MB，%llu 样本（%.2f 倍实时），播放 %llu 样本\n",
+          rx_bytes.load() / 1048576.0, (unsigned long long)rx_samples.load(),
+          rx_samples.load() / (elapsed * opt.rate), (unsigned long long)played.load());
+  fprintf(stderr, "欠载 %u，溢出丢 %u，追赶丢 %u，补静音 %u，声卡 xrun %u\n", js.underruns,
+          js.overflow, js.catchup, js.silence, sink->xruns());
+  const FrameDecoderStats ds = dec.stats();
+  fprintf(stderr, "帧 %u，丢帧 %u，帧头错 %u，CRC 错 %u\n", ds.frames, ds.lost_frames,
+          ds.header_errors, ds.crc_errors);
+  fprintf(stderr, "延迟");
+  print_hist("缓冲", buf_total.window());
+  if (opt.loopback) print_hist("端到端", e2e_total.window());
+  fputc('\n', stderr);
+
+  delete sink;
+  return rx_samples.load() > 0 ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+#include "serial_port.h"
+
+#include <sys/ioctl.h>
+
+#if defined(__linux__)
+#include <asm/termbits.h>
+
+bool serial_configure(int fd, int baud) {
+  struct termios2 tio;
+  if (ioctl(fd, TCGETS2, &tio) != 0) return false;
+  tio.c_iflag = 0;
+  tio.c_oflag = 0;
+  tio.c_lflag = 0;
+  tio.c_cflag = CS8 | CREAD | CLOCAL | BOTHER;
+  tio.c_ispeed = baud;
+  tio.c_ospeed = baud;
+  tio.c_cc[VMIN]  = 1;
+  tio.c_cc[VTIME] = 0;
+  return ioctl(fd, TCSETS2, &tio) == 0;
+}
+
+#else
+#include <termios.h>
+#if defined(__APPLE__)
+#include <IOKit/serial/ioss.h>
+#endif
+
+bool serial_configure(int fd, int baud) {
+  struct termios tio;
+  if (tcgetattr(fd, &tio) != 0) return false;
+  cfmakeraw(&tio);
+  tio.c_cflag |= CREAD | CLOCAL;
+  tio.c_cc[VMIN]  = 1;
+  tio.c_cc[VTIME] = 0;
+  if (tcsetattr(fd, TCSANOW, &tio) != 0) return false;
+#if defined(__APPLE__)
+  speed_t speed = baud;
+  return ioctl(fd, IOSSIOSPEED, &speed) == 0;
+#else
+  return cfsetspeed(&tio, baud) == 0 && tcsetattr(fd, TCSANOW, &tio) == 0;
+#endif
+}
+#endif
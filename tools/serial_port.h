@@ -0,0 +1,4 @@
+#pragma once
+// 主机工具共用：把 tty 配成 raw 8N1，任意波特率
+// Linux 用 termios2 设置非标准波特率（1500000），macOS 走 IOSSIOSPEED
+bool serial_configure(int fd, int baud);
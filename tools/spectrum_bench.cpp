@@ -0,0 +1,89 @@
+// =================================================
+// 频谱级主机基准（lib/audio_dsp/fft.h、spectrum.h）
+//
+//   ./spectrum_bench
+//
+// 打印并检查：
+//   - RealFft 256 ~ 2048 点：和双精度直接 DFT（即 numpy.fft.rfft 的定义）比的最大误差
+//     （相对最大幅值，dB），上限 -120 dB；每次变换 cycles
+//   - SpectrumAnalyzer（按固件默认参数）：处理 1 s 音频的 cycles；
+//     满幅 1 kHz 正弦要落在 1 kHz 所在的频带，电平在 0 dBFS ±1 dB 内，±2 带以外不高于 -35 dBFS
+// 返回值：0 全部通过，1 有断言失败
+// =================================================
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <memory>
+#include <vector>
+
+#include "cycle_clock.h"
+#include "fft.h"
+#include "spectrum.h"
+
+static const double kPi = 3.14159265358979323846;
+static const double kMaxFftErrDb = -120;
+
+static bool check_fft(int n) {
+  std::unique_ptr<RealFft> fft(new RealFft(n));
+  std::vector<float> x(n), re(n / 2 + 1), im(n / 2 + 1);
+  srand(n);
+  for (auto& v : x) v = (float)((rand() & 0xFFFF) - 32768);
+
+  fft->forward(x.data(), re.data(), im.data());
+  double err = 0, peak = 0;
+  for (int k = 0; k <= n / 2; k++) {
+    double dr = 0, di = 0;
+    for (int i = 0; i < n; i++) {
+      dr += x[i] * cos(2 * kPi * k * i / n);
+      di -= x[i] * sin(2 * kPi * k * i / n);
+    }
+    err  = fmax(err, hypot(re[k] - dr, im[k] - di));
+    peak = fmax(peak, hypot(dr, di));
+  }
+
+  const int reps = 2000;
+  const uint32_t c0 = cycle_now();
+  for (int r = 0; r < reps; r++) fft->forward(x.data(), re.data(), im.data());
+  const uint32_t cycles = cycle_now() - c0;
+  const double err_db = 20 * log10(err / peak);
+  printf("RealFft %5d  误差 %.1f dB（上限 %.0f）  %.0f cycles/次（按 %d MHz 计）%s\n",
+         n, err_db, kMaxFftErrDb, (double)cycles / reps, CYCLE_CLOCK_HOST_MHZ,
+         err_db > kMaxFftErrDb ? "  超限！" : "");
+  return err_db <= kMaxFftErrDb;
+}
+
+int main() {
+  bool ok = true;
+  for (int n : {256, 512, 1024, 2048}) ok &= check_fft(n);
+
+  const uint32_t fs = 44100;
+  const int fft_size = 1024, hop = 512, bands = 64;
+  static SpectrumAnalyzer sa(fs, fft_size, hop, bands, 50, 16000);
+  std::vector<int16_t> x(fs);
+  for (size_t i = 0; i < x.size(); i++)
+    x[i] = (int16_t)lrint(32767 * sin(2 * kPi * 1000 * i / fs));
+
+  const uint32_t c0 = cycle_now();
+  for (size_t i = 0; i < x.size(); i += 64) sa.push(x.data() + i, 64);
+  const uint32_t cycles = cycle_now() - c0;
+
+  float db[SPECTRUM_MAX_BANDS];
+  uint16_t frames = 0;
+  sa.read(db, &frames);
+  int top = 0;
+  for (int k = 1; k < bands; k++) if (db[k] > db[top]) top = k;
+  float rest = -200;
+  for (int k = 0; k < bands; k++) if (k < top - 2 || k > top + 2) rest = fmaxf(rest, db[k]);
+  printf("SpectrumAnalyzer %u Hz / %d 点 / hop %d / %d 带：1 s 音频 %.2f M cycles，%u 次 FFT\n",
+         fs, fft_size, hop, bands, cycles / 1e6, frames);
+  // 1 kHz 按对数等分应落在的频带
+  const int expect = (int)(bands * log(1000.0 / 50) / log(16000.0 / 50));
+  const bool band_ok = top == expect && fabsf(db[top]) <= 1.0f && rest <= -35;
+  printf("  1 kHz 满幅正弦：第 %d 带（应为 %d）%.2f dBFS，±2 带以外最高 %.1f dBFS%s\n",
+         top, expect, db[top], rest, band_ok ? "" : "  超限！");
+  ok &= band_ok;
+
+  printf("%s\n", ok ? "全部通过" : "有断言失败");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,98 @@
+// =================================================
+// 屏幕绘制逻辑的主机预览（lib/ui/audio_ui.h + framebuffer_display.h）
+//
+//   ./ui_preview [out.ppm] [宽 高]      # 默认 320×240，写 ui_preview.ppm
+//
+// 按固件 UI 任务的节拍（UI_FRAME_MS、每 UI_SPEC_COLUMN_FRAMES 帧一列）喂 10 s 合成信号：
+// 100 Hz → 10 kHz 对数扫频，幅度按 2 s 周期起伏，另加 1 kHz 的短促脉冲。
+// 打印每帧推送像素（只有电平表的帧 / 带语谱图的帧），越界推送计数，最后一帧导出 PPM
+// 返回值：0 没有越界推送，1 有越界 / 帧外推送（fb.errors）或 PPM 写不出来
+// =================================================
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "audio_ui.h"
+#include "framebuffer_display.h"
+#include "sample_ring.h"
+#include "spectrum.h"
+
+static const double kPi = 3.14159265358979323846;
+
+// 和 include/audio_config.h 的默认值一致
+static const int kSampleRate = 44100;
+static const int kBlock      = 64;
+static const int kFrameMs    = 33;
+static const int kColumnEvery = 3;
+static const int kFftSize    = 512;
+static const int kBands      = 48;
+
+int main(int argc, char** argv) {
+  const char* out = argc > 1 ? argv[1] : "ui_preview.ppm";
+  const int w = argc > 3 ? atoi(argv[2]) : 320;
+  const int h = argc > 3 ? atoi(argv[3]) : 240;
+
+  FramebufferDisplay fb(w, h);
+  static AudioUi ui(&fb, kBands);
+  static SpectrumAnalyzer analyzer(kSampleRate, kFftSize, kFftSize / 2, kBands, 50, 16000);
+  static SampleRing<4096> ring;
+  static int16_t chunk[2048];
+
+  const int total = kSampleRate * 10;
+  const int per_frame = kSampleRate * kFrameMs / 1000;
+  double phase = 0;
+  int written = 0, frame = 0;
+  uint32_t pos = 0;
+  uint64_t meter_px = 0, spec_px = 0;
+  int meter_frames = 0, spec_frames = 0;
+
+  while (written < total) {
+    // 音频侧：按块写进快照环
+    for (int done = 0; done < per_frame; done += kBlock, written += kBlock) {
+      int16_t blk[kBlock];
+      for (int i = 0; i < kBlock; i++) {
+        const double t = (double)(written + i) / kSampleRate;
+        const double f = 100 * pow(100.0, t / 10);
+        phase += 2 * kPi * f / kSampleRate;
+        const double env = 0.05 + 0.45 * (1 - cos(2 * kPi * t / 2));
+        double v = env * sin(phase);
+        if (fmod(t, 1.0) < 0.02) v += 0.4 * sin(2 * kPi * 1000 * t);
+        blk[i] = (int16_t)lrint(v * 32767);
+      }
+      ring.write(blk, kBlock);
+    }
+
+    // UI 侧：和 src/ui.cpp 的 ui_task 一样
+    const uint32_t head = ring.head();
+    const uint32_t n = head - pos;
+    if (!ring.read(pos, n, chunk)) { fprintf(stderr, "快照读取失败\n"); return 1; }
+    pos += n;
+    int32_t peak = 0;
+    double sumsq = 0;
+    for (uint32_t i = 0; i < n; i++) {
+      peak = abs(chunk[i]) > peak ? abs(chunk[i]) : peak;
+      sumsq += (double)chunk[i] * chunk[i];
+    }
+    ui.set_levels(20 * log10f(peak / 32768.0f + 1e-6f),
+                  10 * log10f((float)(sumsq / n / (32768.0 * 32768.0)) + 1e-12f));
+    analyzer.push(chunk, n);
+    bool column = false;
+    float db[kBands];
+    if (++frame % kColumnEvery == 0 && analyzer.read(db)) {
+      ui.add_column(db);
+      column = true;
+    }
+    const uint32_t px = ui.render();
+    if (frame == 1) continue;   // 首帧整屏清底，不计入
+    if (column) { spec_px += px; spec_frames++; } else { meter_px += px; meter_frames++; }
+  }
+
+  printf("%d×%d，%d 帧：只有电平表的帧平均推 %.0f 像素，带语谱图的帧平均推 %.0f 像素（整屏 %d）\n",
+         w, h, frame, (double)meter_px / meter_frames, (double)spec_px / spec_frames, w * h);
+  printf("越界 / 帧外推送 %u 次\n", fb.errors);
+  if (!fb.save_ppm(out)) { perror(out); return 1; }
+  printf("已写 %s\n", out);
+  return fb.errors ? 1 : 0;
+}
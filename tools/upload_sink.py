@@ -0,0 +1,87 @@
+import argparse
+import os
+import socket
+import struct
+import zlib
+
+# 本地上传服务器：接收固件录音任务上传的 flash 段
+# 协议见 lib/flash_log/segment_log.h：
+#   设备 → 服务器  magic 'UPLD', seq, length, crc32, payload
+#   服务器 → 设备  0x06 ACK / 0x15 NAK
+# 每个段存成 seg_<seq>.bin，内容是连续的音频帧，可以直接喂给 tools/bin/frame_dump
+
+UPLOAD_MAGIC = 0x444C5055
+UPLOAD_ACK = b'\x06'
+UPLOAD_NAK = b'\x15'
+HEADER = struct.Struct('<IIII')
+
+
+def recv_exact(conn, n):
+    """读满 n 字节，对端关闭返回 None"""
+    buf = bytearray()
+    while len(buf) < n:
+        chunk = conn.recv(n - len(buf))
+        if not chunk:
+            return None
+        buf.extend(chunk)
+    return bytes(buf)
+
+
+def seg_crc(seq, length, payload):
+    """与固件一致：CRC-32 覆盖 seq、length 和 payload"""
+    crc = zlib.crc32(struct.pack('<II', seq, length))
+    return zlib.crc32(payload, crc) & 0xFFFFFFFF
+
+
+def handle(conn, out_dir):
+    while True:
+        hdr = recv_exact(conn, HEADER.size)
+        if hdr is None:
+            return
+        magic, seq, length, crc = HEADER.unpack(hdr)
+        if magic != UPLOAD_MAGIC or length > 65536:
+            print(f"✗ 非法段头 magic={magic:#x} length={length}，断开")
+            return
+
+        payload = recv_exact(conn, length)
+        if payload is None:
+            return
+
+        if seg_crc(seq, length, payload) != crc:
+            print(f"✗ 段 {seq} CRC 错误")
+            conn.sendall(UPLOAD_NAK)
+            continue
+
+        # 设备掉电后可能重传已确认的段，按序号覆盖写即可去重
+        path = os.path.join(out_dir, f"seg_{seq:08d}.bin")
+        with open(path, 'wb') as f:
+            f.write(payload)
+            f.flush()
+            os.fsync(f.fileno())
+        conn.sendall(UPLOAD_ACK)
+        print(f"✓ 段 {seq}: {length} 字节 → {path}")
+
+
+def main():
+    parser = argparse.ArgumentParser(description='ESP32 录音段上传接收端')
+    parser.add_argument('--port', type=int, default=9000)
+    parser.add_argument('--out', default='uploads')
+    args = parser.parse_args()
+
+    os.makedirs(args.out, exist_ok=True)
+    srv = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    srv.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    srv.bind(('0.0.0.0', args.port))
+    srv.listen(1)
+    print(f"监听 0.0.0.0:{args.port}，保存到 {args.out}/")
+
+    while True:
+        conn, addr = srv.accept()
+        print(f"设备连接: {addr[0]}")
+        with conn:
+            handle(conn, args.out)
+        print("设备断开")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,4 +1,6 @@
 
+# 只适用于 -DUPLINK_MODE=UPLINK_RAW 编的固件（裸 int16 流）。默认固件是 UPLINK_FRAMED 帧流，
+# 用 ./tools/bin/rt_player 或 ./tools/bin/frame_dump 收；连上后会先探测，看到 A5 5A 帧头直接报错退出
 import sounddevice as sd
 import numpy as np
 import serial
@@ -6,6 +8,7 @@ import time
 import sys
 from src.test_voice import test_audio_output, test_serial_connection, safe_serial_connection
 from src.audio_filter import SimpleAudioProcessor 
+from src.raw_stream import check_raw_stream
 import warnings
 warnings.filterwarnings("ignore")
 
@@ -26,6 +29,7 @@ VOLUME_THRESHOLD = 15.0           # 音量阈值百分比
 CHECK_DURATION = 0.5              # 检测时长(秒)
 THRESHOLD_RATIO = 0.5             # 超过阈值的比例阈值
 MAX_RETRIES = 3                   # 最大重试次数
+AUTO_RECONNECT = False            # 检测到爆音时断开重连；UPLINK_RAW 固件同样带 POP_GUARD_ENABLE（板上逐块静音），只有没有爆音保护的老固件才需要
 # ===================================
 
 
@@ -37,7 +41,10 @@ def main():
     print(f"采样率: {SAMPLE_RATE}Hz")
     print(f"增益: {GAIN_DB:.1f}dB")
     print(f"滤波器: {FILTER_TYPE} ({FREQ_LOW}-{FREQ_HIGH}Hz)")
-    print(f"爆音保护: 音量>{VOLUME_THRESHOLD}%持续{THRESHOLD_RATIO*100:.0f}%时间时重启")
+    if AUTO_RECONNECT:
+        print(f"爆音保护: 音量>{VOLUME_THRESHOLD}%持续{THRESHOLD_RATIO*100:.0f}%时间时重启")
+    else:
+        print("爆音保护: 由固件处理（POP_GUARD_ENABLE）")
     print("-" * 60)
     
     # 初始化音频处理器
@@ -63,6 +70,7 @@ def main():
                             VOLUME_THRESHOLD=VOLUME_THRESHOLD, 
                             THRESHOLD_RATIO=THRESHOLD_RATIO
                         )
+        check_raw_stream(ser)
         
         # 创建音频输出流
         stream = sd.OutputStream(
@@ -133,7 +141,7 @@ def main():
                         if total_samples_count >= 50:  # 每50个样本检查一次
                             high_ratio = over_threshold_count / total_samples_count
                             
-                            if high_ratio > THRESHOLD_RATIO:
+                            if AUTO_RECONNECT and high_ratio > THRESHOLD_RATIO:
                                 print(f"\n⚠ 爆音检测: 最近{total_samples_count}个样本中，"
                                       f"{over_threshold_count}个超过阈值 ({high_ratio*100:.1f}%)")
                                 print("自动重新连接中...")